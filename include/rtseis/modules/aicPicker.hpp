@@ -0,0 +1,278 @@
+#ifndef RTSEIS_MODULES_AICPICKER_HPP
+#define RTSEIS_MODULES_AICPICKER_HPP 1
+#include <memory>
+#include "rtseis/enums.h"
+
+namespace RTSeis
+{
+namespace Modules
+{
+
+/*!
+ * @brief A pick made by the AIC picker.
+ * @ingroup rtseis_modules_aic
+ */
+struct AICPick
+{
+    /*!< The index of the first sample following the split point, i.e., the
+         onset.  This is relative to the start of the window.  If negative
+         then the window was too short to pick. */
+    int index = -1;
+    /*!< The Akaike weight of the pick.  This is the relative likelihood of
+         the chosen split point among all split points and is in (0, 1].
+         Sharp onsets have a quality near 1. */
+    double quality = 0;
+};
+
+/*!
+ * @defgroup rtseis_modules_aic_parameters Parameters
+ * @brief Defines the parameters for the AIC picker module.
+ * @ingroup rtseis_modules_aic
+ * @copyright Ben Baker distributed under the MIT license.
+ */
+class AICPickerParameters
+{
+    public:
+        /*!
+         * @brief Default constructor.  This module will not yet be usable
+         *        until the parameters are set.
+         * @ingroup rtseis_modules_aic_parameters
+         */
+        AICPickerParameters(void);
+        /*!
+         * @brief Copy constructor.
+         * @param[in] parameters  Class from which to initialize.
+         * @ingroup rtseis_modules_aic_parameters
+         */
+        AICPickerParameters(const AICPickerParameters &parameters);
+        /*!
+         * @brief Copy operator.
+         * @param[in] parameters  Class to copy.
+         * @result A deep copy of the AIC picker parameter class.
+         * @ingroup rtseis_modules_aic_parameters
+         */
+        AICPickerParameters& operator=(const AICPickerParameters &parameters);
+        /*!
+         * @brief Initializes the AIC picker parameters.
+         * @param[in] nmin  The minimum number of samples on either side of
+         *                  a split point.  This must be at least 2.
+         * @param[in] precision  Defines the precision.  By default this
+         *                       is a double precision module.
+         * @ingroup rtseis_modules_aic_parameters
+         */
+        AICPickerParameters(const int nmin,
+                            const RTSeis::Precision precision = RTSeis::Precision::DOUBLE);
+        /*!
+         * @brief Default destructor.
+         * @ingroup rtseis_modules_aic_parameters
+         */
+        ~AICPickerParameters(void);
+        /*!
+         * @brief Clears variables in class and restores defaults.
+         *        This class will have to be re-initialized to use again.
+         * @ingroup rtseis_modules_aic_parameters
+         */
+        void clear(void);
+        /*!
+         * @brief Determines if the class parameters are valid and can be
+         *        used to initialize the AIC picker.
+         * @retval True indicates that the parameters are valid.
+         * @retval False indicates that the parameters are invalid.
+         * @ingroup rtseis_modules_aic_parameters
+         */
+        bool isValid(void) const;
+        /*!
+         * @brief Sets the minimum number of samples on either side of a
+         *        split point.  This keeps the variance estimates of the
+         *        segments from being degenerate.
+         * @param[in] nmin  The minimum segment length.  This must be at
+         *                  least 2.
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_aic_parameters
+         */
+        int setMinimumSegmentLength(const int nmin);
+        /*!
+         * @brief Gets the minimum number of samples on either side of a
+         *        split point.
+         * @result The minimum segment length.
+         * @ingroup rtseis_modules_aic_parameters
+         */
+        int getMinimumSegmentLength(void) const;
+        /*!
+         * @brief Determines the precision of the class.
+         * @result The precision of the module.
+         * @ingroup rtseis_modules_aic_parameters
+         */
+        RTSeis::Precision getPrecision(void) const;
+    private:
+        /*!< Routine to validate the parameters. */
+        void validate_(void);
+        /*!< Default precision. */
+        const RTSeis::Precision defaultPrecision_ = RTSeis::Precision::DOUBLE;
+        /*!< The minimum segment length. */
+        int nmin_ = 0;
+        /*!< The precision of the module. */
+        RTSeis::Precision precision_ = defaultPrecision_;
+        /*!< Flag indicating that this is a valid module for processing. */
+        bool isValid_ = false;
+};
+
+/*!
+ * @defgroup rtseis_modules_aic AIC Picker
+ * @brief Picks the onset in a window with the variance-based Akaike
+ *        Information Criterion of Maeda (1985).  For a window of \f$ n \f$
+ *        samples split at \f$ k \f$
+ *        \f[
+ *           AIC(k) = k \log \sigma^2(x_{0:k})
+ *                  + (n - k) \log \sigma^2(x_{k:n})
+ *        \f]
+ *        and the onset is the \f$ k \f$ minimizing the AIC.  The variances
+ *        of both segments follow from running sums of \f$ x \f$ and
+ *        \f$ x^2 \f$ so every split point of a window is evaluated in
+ *        \f$ \mathcal{O}(n) \f$ with \f$ \mathcal{O}(1) \f$ memory.
+ *        Windows are independent so batches of windows are picked in
+ *        parallel.
+ * @note The window is demeaned before the sums are formed and the sums are
+ *       compensated so that the variances of short segments remain
+ *       accurate when the window has a large offset.  Segment variances
+ *       are floored at the variance of the quantization noise,
+ *       \f$ q^2/12 \f$, where \f$ q \f$ is the smallest step between
+ *       distinct samples of the window, and at \f$ 10^{-6} \f$ of the
+ *       window's variance.  Hence, runs of identical samples, e.g., digital
+ *       silence or a stuck digitizer, neither produce \f$ \log 0 \f$ nor
+ *       attract the pick.
+ * @ingroup rtseis_modules
+ * @copyright Ben Baker distributed under the MIT license.
+ */
+class AICPicker
+{
+     public:
+        /*!
+         * @brief Default constructor.  This module will not yet be usable
+         *        until the parameters are set.
+         * @ingroup rtseis_modules_aic
+         */
+        AICPicker(void);
+        /*!
+         * @brief Initializes the AIC picker from the parameters.
+         * @param[in] parameters  Parameters from which to initialize
+         *                        the AIC picker.
+         * @ingroup rtseis_modules_aic
+         */
+        AICPicker(const AICPickerParameters &parameters);
+        /*!
+         * @brief Copy constructor.
+         * @param[in] picker  An AIC picker class from which this class is
+         *                    initialized.
+         * @ingroup rtseis_modules_aic
+         */
+        AICPicker(const AICPicker &picker);
+        /*!
+         * @brief Copy operator.
+         * @param[in] picker  An AIC picker class to copy.
+         * @result A deep copy of the input class.
+         * @ingroup rtseis_modules_aic
+         */
+        AICPicker& operator=(const AICPicker &picker);
+        /*!
+         * @brief Default destructor.
+         * @ingroup rtseis_modules_aic
+         */
+        ~AICPicker(void);
+        /*!
+         * @brief Computes the AIC curve of a window.
+         * @param[in] nx    The number of samples in the window.
+         * @param[in] x     The window.  This has dimension [nx].
+         * @param[out] aic  The AIC at each split point.  This has dimension
+         *                  [nx].  Split points leaving fewer than the
+         *                  minimum segment length on either side are set
+         *                  to the largest AIC.  If the window is too short
+         *                  to pick then this is 0.
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_aic
+         */
+        int computeAIC(const int nx, const double x[], double aic[]) const;
+        /*!
+         * @brief Computes the AIC curve of a window.
+         * @param[in] nx    The number of samples in the window.
+         * @param[in] x     The window.  This has dimension [nx].
+         * @param[out] aic  The AIC at each split point.  This has dimension
+         *                  [nx].  Split points leaving fewer than the
+         *                  minimum segment length on either side are set
+         *                  to the largest AIC.  If the window is too short
+         *                  to pick then this is 0.
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_aic
+         */
+        int computeAIC(const int nx, const float x[], float aic[]) const;
+        /*!
+         * @brief Picks the onset in a window.
+         * @param[in] nx     The number of samples in the window.
+         * @param[in] x      The window.  This has dimension [nx].
+         * @param[out] pick  The pick.  If the window has fewer than twice
+         *                   the minimum segment length samples then the
+         *                   index is -1.
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_aic
+         */
+        int apply(const int nx, const double x[], AICPick *pick) const;
+        /*!
+         * @brief Picks the onset in a window.
+         * @param[in] nx     The number of samples in the window.
+         * @param[in] x      The window.  This has dimension [nx].
+         * @param[out] pick  The pick.  If the window has fewer than twice
+         *                   the minimum segment length samples then the
+         *                   index is -1.
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_aic
+         */
+        int apply(const int nx, const float x[], AICPick *pick) const;
+        /*!
+         * @brief Picks the onsets in a batch of windows.
+         * @param[in] nWindows  The number of windows.
+         * @param[in] nx        The number of samples in each window.  This
+         *                      has dimension [nWindows].
+         * @param[in] x         The windows.  x[i] is an array of dimension
+         *                      [nx[i]].
+         * @param[out] picks    The pick in each window.  This has dimension
+         *                      [nWindows].
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_aic
+         */
+        int apply(const int nWindows, const int nx[],
+                  const double *const x[], AICPick picks[]) const;
+        /*!
+         * @brief Picks the onsets in a batch of windows.
+         * @param[in] nWindows  The number of windows.
+         * @param[in] nx        The number of samples in each window.  This
+         *                      has dimension [nWindows].
+         * @param[in] x         The windows.  x[i] is an array of dimension
+         *                      [nx[i]].
+         * @param[out] picks    The pick in each window.  This has dimension
+         *                      [nWindows].
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_aic
+         */
+        int apply(const int nWindows, const int nx[],
+                  const float *const x[], AICPick picks[]) const;
+        /*!
+         * @brief Clears variables in class and restores defaults.
+         *        This class will have to be re-initialized to use again.
+         * @ingroup rtseis_modules_aic
+         */
+        void clear(void);
+        /*!
+         * @brief Determines if the class is initialized.
+         * @retval If true then the class is initialized.
+         * @ingroup rtseis_modules_aic
+         */
+        bool isInitialized(void) const;
+    private:
+        class AICPickerImpl;
+        std::unique_ptr<AICPickerImpl> pPicker_;
+};
+
+};
+};
+
+#endif
@@ -7,6 +7,7 @@ namespace RTSeis
 {
 namespace Modules
 {
+class ThresholdTrigger;
 
 /*!
  * @defgroup rtseis_modules_cSTALTA_parameters Parameters
@@ -138,10 +139,10 @@ class ClassicSTALTAParameters
          */
         bool isValid(void) const;
         /*!
-         * @brief Sets the chunksize.  The real-time FIR filter will be applied
-         *        by looping over chunks of data.  There are three temporary
-         *        storage arrays.  This parameter can help minimize the memory
-         *        footprint of the module.
+         * @brief Sets the chunksize.
+         * @note The averages are now tabulated with running sums that do
+         *       not require temporary storage so this parameter is retained
+         *       only for compatibility.
          * @param[in] chunkSize  The length of the scratch space arrays.
          * @result 0 indicates success.
          * @ingroup rtseis_modules_cSTALTA_parameters 
@@ -241,8 +242,12 @@ class ClassicSTALTAParameters
 
 /*!
  * @defgroup rtseis_modules_cSTALTA Classic STA/LTA
- * @brief Computes the `classic' Short Term to Long Term Average using
- *        an FIR filter.
+ * @brief Computes the `classic' Short Term to Long Term Average.  The
+ *        averages of the squared signal are equivalent to boxcar FIR
+ *        filters but are tabulated with running sums so that the cost per
+ *        sample does not depend on the window lengths.  The running sums
+ *        are compensated and are recomputed once per window to prevent the
+ *        accumulation of round-off error.
  * @ingroup rtseis_modules
  * @copyright Ben Baker distributed under the MIT license.
  */
@@ -302,10 +307,14 @@ class ClassicSTALTA
          * @param[in] nzNum  The length of the numerator initial conditions
          *                   array.  This
          * @param[in] zNum   The numerator initial condition coefficients.
+         *                   These are the squared samples preceding the
+         *                   signal ordered from oldest to most recent.
          *                   This has dimension [nzNum].
          * @param[in] nzDen  The length of the denominator initial conditions
          *                   array.
          * @param[in] zDen   The denominator initial condition coefficients.
+         *                   These are the squared samples preceding the
+         *                   signal ordered from oldest to most recent.
          *                   This has dimension [nzDen].
          */
         int setInitialConditions(const int nzNum, const double zNum[],
@@ -332,6 +341,36 @@ class ClassicSTALTA
          * @ingroup rtseis_modules_cSTALTA
          */ 
         int apply(const int nx, const float x[], float y[]);
+        /*!
+         * @brief Computes the STA/LTA of the input signal and scans it for
+         *        triggers.  The STA/LTA is computed in small blocks that are
+         *        passed directly to the trigger so the full STA/LTA signal
+         *        is never stored.
+         * @param[in] nx   Number of points in signal.
+         * @param[in] x    The signal of which to compute the STA/LTA.  This has
+         *                 dimension [nx].
+         * @param[in,out] trigger  On input this is the initialized trigger.
+         *                         On exit its triggers have been updated as
+         *                         if ThresholdTrigger::apply() were called
+         *                         with the STA/LTA signal.
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_cSTALTA
+         */
+        int apply(const int nx, const double x[], ThresholdTrigger *trigger);
+        /*!
+         * @brief Computes the STA/LTA of the input signal and scans it for
+         *        triggers.
+         * @param[in] nx   Number of points in signal.
+         * @param[in] x    The signal of which to compute the STA/LTA.  This has
+         *                 dimension [nx].
+         * @param[in,out] trigger  On input this is the initialized trigger.
+         *                         On exit its triggers have been updated as
+         *                         if ThresholdTrigger::apply() were called
+         *                         with the STA/LTA signal.
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_cSTALTA
+         */
+        int apply(const int nx, const float x[], ThresholdTrigger *trigger);
         /*!
          * @brief Resets the filter to the initial conditions specified
          *        by setInitialConditions() or the default initial conditions. 
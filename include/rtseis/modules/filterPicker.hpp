@@ -0,0 +1,404 @@
+#ifndef RTSEIS_MODULES_FILTERPICKER_HPP
+#define RTSEIS_MODULES_FILTERPICKER_HPP 1
+#include <memory>
+#include <cstdint>
+#include "rtseis/enums.h"
+
+namespace RTSeis
+{
+namespace Modules
+{
+
+/*!
+ * @brief A pick declared by the filter picker.  Sample indices are counted
+ *        from the first sample after the picker was initialized or reset.
+ * @ingroup rtseis_modules_filterPicker
+ */
+struct FilterPick
+{
+    /*!< The refined pick, i.e., the sample at which the characteristic
+         function of the triggering band began to rise. */
+    int64_t index = 0;
+    /*!< The sample at which the summary characteristic function met or
+         exceeded the first threshold. */
+    int64_t triggerIndex = 0;
+    /*!< The band whose characteristic function was largest at the trigger.
+         Band k has a period of \f$ 2^{k+1} \Delta t \f$. */
+    int band = 0;
+};
+
+/*!
+ * @defgroup rtseis_modules_filterPicker_parameters Parameters
+ * @brief Defines the parameters for the filter picker module.
+ * @ingroup rtseis_modules_filterPicker
+ * @copyright Ben Baker distributed under the MIT license.
+ */
+class FilterPickerParameters
+{
+    public:
+        /*!
+         * @brief Default constructor.  This module will not yet be usable
+         *        until the parameters are set.
+         * @ingroup rtseis_modules_filterPicker_parameters
+         */
+        FilterPickerParameters(void);
+        /*!
+         * @brief Copy constructor.
+         * @param[in] parameters  Class from which to initialize.
+         * @ingroup rtseis_modules_filterPicker_parameters
+         */
+        FilterPickerParameters(const FilterPickerParameters &parameters);
+        /*!
+         * @brief Copy operator.
+         * @param[in] parameters  Class to copy.
+         * @result A deep copy of the filter picker parameter class.
+         * @ingroup rtseis_modules_filterPicker_parameters
+         */
+        FilterPickerParameters& operator=(const FilterPickerParameters &parameters);
+        /*!
+         * @brief Initializes the filter picker parameters.
+         * @param[in] filterWindow    The longest period in seconds of the
+         *                            filter bank.  This must be at least
+         *                            twice the sampling period.
+         * @param[in] longTermWindow  The duration in seconds of the
+         *                            exponentially weighted averages that
+         *                            normalize the characteristic functions.
+         *                            This must be at least the filter window.
+         * @param[in] threshold1      The summary characteristic function
+         *                            triggers when it meets or exceeds this
+         *                            value.  This must be positive.
+         * @param[in] threshold2      A trigger becomes a pick when the
+         *                            average characteristic function over
+         *                            the up-event window meets or exceeds
+         *                            this value.  This must be positive.
+         * @param[in] tUpEvent        The duration in seconds of the up-event
+         *                            window.  This must be at least the
+         *                            sampling period.
+         * @param[in] dt              The sampling period in seconds.  This
+         *                            must be positive.
+         * @param[in] mode  Indicates whether or not this is for real-time.
+         *                  By default this is for post-processing.
+         * @param[in] precision  Defines the precision.  By default this
+         *                       is a double precision module.
+         * @ingroup rtseis_modules_filterPicker_parameters
+         */
+        FilterPickerParameters(
+            const double filterWindow,
+            const double longTermWindow,
+            const double threshold1,
+            const double threshold2,
+            const double tUpEvent,
+            const double dt,
+            const RTSeis::ProcessingMode mode = RTSeis::ProcessingMode::POST_PROCESSING,
+            const RTSeis::Precision precision = RTSeis::Precision::DOUBLE);
+        /*!
+         * @brief Default destructor.
+         * @ingroup rtseis_modules_filterPicker_parameters
+         */
+        ~FilterPickerParameters(void);
+        /*!
+         * @brief Clears variables in class and restores defaults.
+         *        This class will have to be re-initialized to use again.
+         * @ingroup rtseis_modules_filterPicker_parameters
+         */
+        void clear(void);
+        /*!
+         * @brief Determines if the class parameters are valid and can be
+         *        used to initialize the filter picker.
+         * @retval True indicates that the parameters are valid.
+         * @retval False indicates that the parameters are invalid.
+         * @ingroup rtseis_modules_filterPicker_parameters
+         */
+        bool isValid(void) const;
+        /*!
+         * @brief Sets the sampling period.
+         * @param[in] dt  The sampling period in seconds.  This must be
+         *                positive.
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_filterPicker_parameters
+         */
+        int setSamplingPeriod(const double dt);
+        /*!
+         * @brief Gets the sampling period.
+         * @result The sampling period in seconds.
+         * @ingroup rtseis_modules_filterPicker_parameters
+         */
+        double getSamplingPeriod(void) const;
+        /*!
+         * @brief Sets the longest period of the filter bank.  The bands have
+         *        periods \f$ 2 \Delta t, 4 \Delta t, \cdots \f$ up to this
+         *        window.
+         * @param[in] filterWindow  The filter window in seconds.  This must
+         *                          be positive.
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_filterPicker_parameters
+         */
+        int setFilterWindow(const double filterWindow);
+        /*!
+         * @brief Gets the longest period of the filter bank.
+         * @result The filter window in seconds.
+         * @ingroup rtseis_modules_filterPicker_parameters
+         */
+        double getFilterWindow(void) const;
+        /*!
+         * @brief Sets the duration of the averages that normalize the
+         *        characteristic functions.
+         * @param[in] longTermWindow  The long-term window in seconds.  This
+         *                            must be positive.
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_filterPicker_parameters
+         */
+        int setLongTermWindow(const double longTermWindow);
+        /*!
+         * @brief Gets the duration of the long-term averages.
+         * @result The long-term window in seconds.
+         * @ingroup rtseis_modules_filterPicker_parameters
+         */
+        double getLongTermWindow(void) const;
+        /*!
+         * @brief Sets the trigger and pick thresholds.
+         * @param[in] threshold1  The trigger threshold.  This must be
+         *                        positive.
+         * @param[in] threshold2  The pick threshold on the average of the
+         *                        characteristic function over the up-event
+         *                        window.  This must be positive.
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_filterPicker_parameters
+         */
+        int setThresholds(const double threshold1, const double threshold2);
+        /*!
+         * @brief Gets the trigger threshold.
+         * @result The trigger threshold.
+         * @ingroup rtseis_modules_filterPicker_parameters
+         */
+        double getThreshold1(void) const;
+        /*!
+         * @brief Gets the pick threshold.
+         * @result The pick threshold.
+         * @ingroup rtseis_modules_filterPicker_parameters
+         */
+        double getThreshold2(void) const;
+        /*!
+         * @brief Sets the duration of the up-event window over which the
+         *        characteristic function is integrated after a trigger.
+         * @param[in] tUpEvent  The up-event window in seconds.  This must be
+         *                      positive.
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_filterPicker_parameters
+         */
+        int setUpEventWindow(const double tUpEvent);
+        /*!
+         * @brief Gets the duration of the up-event window.
+         * @result The up-event window in seconds.
+         * @ingroup rtseis_modules_filterPicker_parameters
+         */
+        double getUpEventWindow(void) const;
+        /*!
+         * @brief Enables the class as being for real-time application or not.
+         * @param[in] mode  Indicates whether the module is for post-processing
+         *                  or real-time processing.
+         * @ingroup rtseis_modules_filterPicker_parameters
+         */
+        void setProcessingMode(const RTSeis::ProcessingMode mode);
+        /*!
+         * @brief Determines if the class is for real-time application.
+         * @result The processing mode.
+         * @ingroup rtseis_modules_filterPicker_parameters
+         */
+        RTSeis::ProcessingMode getProcessingMode(void) const;
+        /*!
+         * @brief Determines the precision of the class.
+         * @result The precision of the module.
+         * @ingroup rtseis_modules_filterPicker_parameters
+         */
+        RTSeis::Precision getPrecision(void) const;
+    private:
+        /*!< Routine to validate the parameters. */
+        void validate_(void);
+        /*!< Default precision. */
+        const RTSeis::Precision defaultPrecision_ = RTSeis::Precision::DOUBLE;
+        /*!< The sampling period in seconds. */
+        double dt_ = 0;
+        /*!< The longest period of the filter bank in seconds. */
+        double filterWindow_ = 0;
+        /*!< The long-term window in seconds. */
+        double longTermWindow_ = 0;
+        /*!< The trigger threshold. */
+        double threshold1_ = 0;
+        /*!< The pick threshold. */
+        double threshold2_ = 0;
+        /*!< The up-event window in seconds. */
+        double tUpEvent_ = 0;
+        /*!< The precision of the module. */
+        RTSeis::Precision precision_ = defaultPrecision_;
+        /*!< Flag indicating this module is for real-time or post-processing. */
+        RTSeis::ProcessingMode processingMode_ = RTSeis::ProcessingMode::POST_PROCESSING;
+        /*!< Flag indicating that this is a valid module for processing. */
+        bool isValid_ = false;
+};
+
+/*!
+ * @defgroup rtseis_modules_filterPicker Filter Picker
+ * @brief A real-time picker after the FilterPicker of Lomax et al. (2012).
+ *        The signal is passed through a bank of recursive bandpass filters
+ *        with periods \f$ 2^{k+1} \Delta t \f$.  Each band's envelope is its
+ *        squared filtered signal and its characteristic function is the
+ *        envelope standardized by the envelope's long-term mean and
+ *        standard deviation.  The summary characteristic function is the
+ *        largest of the bands'.
+ *
+ *        A trigger occurs when the summary characteristic function meets
+ *        threshold1.  The trigger becomes a pick if the characteristic
+ *        function, limited to twice threshold2 so that a lone spike cannot
+ *        make a pick, averages at least threshold2 over the up-event
+ *        window.  The pick is refined by stepping back from the trigger
+ *        while the triggering band's characteristic function is rising, by
+ *        at most that band's period.  A new trigger requires the summary
+ *        characteristic function to first fall below threshold1.
+ *
+ *        The work per sample is proportional to the number of bands and
+ *        the filters are second order section filters.
+ * @note The long-term averages are not updated during the up-event window
+ *       so that an onset does not normalize itself away before the pick is
+ *       decided.  They are updated otherwise so that the picker adapts to
+ *       the coda rather than re-triggering on it.  The characteristic function
+ *       is 0 and nothing triggers during the first long-term window while
+ *       the averages stabilize.  In real-time mode a trigger pending at the
+ *       end of a packet is continued in the next packet.
+ * @ingroup rtseis_modules
+ * @copyright Ben Baker distributed under the MIT license.
+ */
+class FilterPicker
+{
+     public:
+        /*!
+         * @brief Default constructor.  This module will not yet be usable
+         *        until the parameters are set.
+         * @ingroup rtseis_modules_filterPicker
+         */
+        FilterPicker(void);
+        /*!
+         * @brief Initializes the filter picker from the parameters.
+         * @param[in] parameters  Parameters from which to initialize
+         *                        the filter picker.
+         * @ingroup rtseis_modules_filterPicker
+         */
+        FilterPicker(const FilterPickerParameters &parameters);
+        /*!
+         * @brief Copy constructor.
+         * @param[in] picker  A filter picker class from which this class is
+         *                    initialized.
+         * @ingroup rtseis_modules_filterPicker
+         */
+        FilterPicker(const FilterPicker &picker);
+        /*!
+         * @brief Copy operator.
+         * @param[in] picker  A filter picker class to copy.
+         * @result A deep copy of the input class.
+         * @ingroup rtseis_modules_filterPicker
+         */
+        FilterPicker& operator=(const FilterPicker &picker);
+        /*!
+         * @brief Default destructor.
+         * @ingroup rtseis_modules_filterPicker
+         */
+        ~FilterPicker(void);
+        /*!
+         * @brief Gets the number of bands in the filter bank.
+         * @result The number of bands.  If negative then an error has
+         *         occured.
+         * @ingroup rtseis_modules_filterPicker
+         */
+        int getNumberOfBands(void) const;
+        /*!
+         * @brief Picks the next samples of the signal.  In post-processing
+         *        mode the picks from the previous call are discarded first.
+         * @param[in] nx   Number of points in signal.
+         * @param[in] x    The signal.  This has dimension [nx].
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_filterPicker
+         */
+        int apply(const int nx, const double x[]);
+        /*!
+         * @brief Picks the next samples of the signal.  In post-processing
+         *        mode the picks from the previous call are discarded first.
+         * @param[in] nx   Number of points in signal.
+         * @param[in] x    The signal.  This has dimension [nx].
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_filterPicker
+         */
+        int apply(const int nx, const float x[]);
+        /*!
+         * @brief Picks the next samples of the signal and returns the summary
+         *        characteristic function.
+         * @param[in] nx   Number of points in signal.
+         * @param[in] x    The signal.  This has dimension [nx].
+         * @param[out] cf  The summary characteristic function.  This has
+         *                 dimension [nx].
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_filterPicker
+         */
+        int apply(const int nx, const double x[], double cf[]);
+        /*!
+         * @brief Picks the next samples of the signal and returns the summary
+         *        characteristic function.
+         * @param[in] nx   Number of points in signal.
+         * @param[in] x    The signal.  This has dimension [nx].
+         * @param[out] cf  The summary characteristic function.  This has
+         *                 dimension [nx].
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_filterPicker
+         */
+        int apply(const int nx, const float x[], float cf[]);
+        /*!
+         * @brief Gets the number of picks that have not yet been cleared.
+         * @result The number of picks.  If negative then an error has
+         *         occured.
+         * @ingroup rtseis_modules_filterPicker
+         */
+        int getNumberOfPicks(void) const;
+        /*!
+         * @brief Gets the picks that have not yet been cleared.
+         * @param[in] maxPicks  The maximum number of picks that can be
+         *                      written to picks.  This must be at least
+         *                      getNumberOfPicks().
+         * @param[out] picks    The picks ordered by trigger.  This has
+         *                      dimension [maxPicks] however only the first
+         *                      getNumberOfPicks() are defined.
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_filterPicker
+         */
+        int getPicks(const int maxPicks, FilterPick picks[]) const;
+        /*!
+         * @brief Discards the picks.  A pending trigger is retained.
+         * @ingroup rtseis_modules_filterPicker
+         */
+        void clearPicks(void);
+        /*!
+         * @brief Resets the filters, averages, and trigger so that the next
+         *        sample is sample 0.  The picks are discarded.
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_filterPicker
+         */
+        int resetInitialConditions(void);
+        /*!
+         * @brief Clears variables in class and restores defaults.
+         *        This class will have to be re-initialized to use again.
+         * @ingroup rtseis_modules_filterPicker
+         */
+        void clear(void);
+        /*!
+         * @brief Determines if the class is initialized.
+         * @retval If true then the class is initialized.
+         * @ingroup rtseis_modules_filterPicker
+         */
+        bool isInitialized(void) const;
+    private:
+        class FilterPickerImpl;
+        std::unique_ptr<FilterPickerImpl> pPicker_;
+};
+
+};
+};
+
+#endif
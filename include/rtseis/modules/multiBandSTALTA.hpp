@@ -0,0 +1,335 @@
+#ifndef RTSEIS_MODULES_MULTIBANDSTALTA_HPP
+#define RTSEIS_MODULES_MULTIBANDSTALTA_HPP 1
+#include <memory>
+#include <vector>
+#include "rtseis/enums.h"
+#include "rtseis/utilities/filterRepresentations/sos.hpp"
+
+namespace RTSeis
+{
+namespace Modules
+{
+class ThresholdTrigger;
+
+/*!
+ * @defgroup rtseis_modules_mbSTALTA_parameters Parameters
+ * @brief Defines the parameters for the multi-band STA/LTA module.
+ * @ingroup rtseis_modules_mbSTALTA
+ * @copyright Ben Baker distributed under the MIT license.
+ */
+class MultiBandSTALTAParameters
+{
+    public:
+        /*!
+         * @brief Default constructor.  This module will not yet be usable
+         *        until the parameters are set.
+         * @ingroup rtseis_modules_mbSTALTA_parameters
+         */
+        MultiBandSTALTAParameters(void);
+        /*!
+         * @brief Copy constructor.
+         * @param[in] parameters  Class from which to initialize.
+         * @ingroup rtseis_modules_mbSTALTA_parameters
+         */
+        MultiBandSTALTAParameters(const MultiBandSTALTAParameters &parameters);
+        /*!
+         * @brief Copy operator.
+         * @param[in] parameters  Class to copy.
+         * @result A deep copy of the STA/LTA parameter class.
+         * @ingroup rtseis_modules_mbSTALTA_parameters
+         */
+        MultiBandSTALTAParameters& operator=(const MultiBandSTALTAParameters &parameters);
+        /*!
+         * @brief Initializes the multi-band STA/LTA parameters.  The bands
+         *        must be added with addBand().
+         * @param[in] nsta  Number of samples in the short-term average
+         *                  window.  This must be positive.
+         * @param[in] nlta  Number of samples in the long-term average
+         *                  window.  This must be greater than nsta.
+         * @param[in] mode  Indicates whether or not this is for real-time.
+         *                  By default this is for post-processing.
+         * @param[in] precision  Defines the precision.  By default this
+         *                       is a double precision module.
+         * @ingroup rtseis_modules_mbSTALTA_parameters
+         */
+        MultiBandSTALTAParameters(
+            const int nsta, const int nlta,
+            const RTSeis::ProcessingMode mode = RTSeis::ProcessingMode::POST_PROCESSING,
+            const RTSeis::Precision precision = RTSeis::Precision::DOUBLE);
+        /*!
+         * @brief Default destructor.
+         * @ingroup rtseis_modules_mbSTALTA_parameters
+         */
+        ~MultiBandSTALTAParameters(void);
+        /*!
+         * @brief Clears variables in class and restores defaults.
+         *        This class will have to be re-initialized to use again.
+         * @ingroup rtseis_modules_mbSTALTA_parameters
+         */
+        void clear(void);
+        /*!
+         * @brief Determines if the class parameters are valid and can be
+         *        used to initialize the STA/LTA processing.
+         * @retval True indicates that the parameters are valid.
+         * @retval False indicates that the parameters are invalid.
+         * @ingroup rtseis_modules_mbSTALTA_parameters
+         */
+        bool isValid(void) const;
+        /*!
+         * @brief Sets the short-term and long-term window size in samples.
+         *        These are shared by all bands.
+         * @param[in] nsta  Number of samples in the short-term average
+         *                  window.  This must be positive.
+         * @param[in] nlta  Number of samples in the long-term average
+         *                  window.  This must be greater than nsta.
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_mbSTALTA_parameters
+         */
+        int setShortTermAndLongTermWindowSize(const int nsta, const int nlta);
+        /*!
+         * @brief Gets the number of samples in the long-term window.
+         * @result The number of samples in the long-term window.
+         * @ingroup rtseis_modules_mbSTALTA_parameters
+         */
+        int getLongTermWindowSize(void) const;
+        /*!
+         * @brief Gets the number of samples in the short-term window.
+         * @result The number of samples in the short-term window.
+         * @ingroup rtseis_modules_mbSTALTA_parameters
+         */
+        int getShortTermWindowSize(void) const;
+        /*!
+         * @brief Adds a band.
+         * @param[in] sos  The bandpass filter as second order sections, e.g.,
+         *                 from RTSeis::Utilities::FilterDesign::IIR.  The
+         *                 leading denominator coefficient of each section
+         *                 cannot be zero.
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_mbSTALTA_parameters
+         */
+        int addBand(const RTSeis::Utilities::FilterRepresentations::SOS &sos);
+        /*!
+         * @brief Removes all bands.
+         * @ingroup rtseis_modules_mbSTALTA_parameters
+         */
+        void clearBands(void);
+        /*!
+         * @brief Gets the number of bands.
+         * @result The number of bands.
+         * @ingroup rtseis_modules_mbSTALTA_parameters
+         */
+        int getNumberOfBands(void) const;
+        /*!
+         * @brief Gets a band's filter.
+         * @param[in] band  The band.  This must be in the range
+         *                  [0, getNumberOfBands()-1].
+         * @result The bandpass filter.  If the band is invalid then this
+         *         has no sections.
+         * @ingroup rtseis_modules_mbSTALTA_parameters
+         */
+        RTSeis::Utilities::FilterRepresentations::SOS getBand(const int band) const;
+        /*!
+         * @brief Enables the class as being for real-time application or not.
+         * @param[in] mode  Indicates whether the module is for post-processing
+         *                  or real-time processing.
+         * @ingroup rtseis_modules_mbSTALTA_parameters
+         */
+        void setProcessingMode(const RTSeis::ProcessingMode mode);
+        /*!
+         * @brief Determines if the class is for real-time application.
+         * @result The processing mode.
+         * @ingroup rtseis_modules_mbSTALTA_parameters
+         */
+        RTSeis::ProcessingMode getProcessingMode(void) const;
+        /*!
+         * @brief Determines the precision of the class.
+         * @result The precision of the module.
+         * @ingroup rtseis_modules_mbSTALTA_parameters
+         */
+        RTSeis::Precision getPrecision(void) const;
+    private:
+        /*!< Routine to validate the parameters. */
+        void validate_(void);
+        /*!< Default precision. */
+        const RTSeis::Precision defaultPrecision_ = RTSeis::Precision::DOUBLE;
+        /*!< The bandpass filters. */
+        std::vector<RTSeis::Utilities::FilterRepresentations::SOS> bands_;
+        /*!< The number of samples in the short term average window. */
+        int nsta_ = 0;
+        /*!< The number of samples in the long-term average window. */
+        int nlta_ = 0;
+        /*!< The precision of the module. */
+        RTSeis::Precision precision_ = defaultPrecision_;
+        /*!< Flag indicating this module is for real-time or post-processing. */
+        RTSeis::ProcessingMode processingMode_ = RTSeis::ProcessingMode::POST_PROCESSING;
+        /*!< Flag indicating that this is a valid module for processing. */
+        bool isValid_ = false;
+};
+
+/*!
+ * @defgroup rtseis_modules_mbSTALTA Multi-Band STA/LTA
+ * @brief Computes the classic STA/LTA in several frequency bands.  Each
+ *        band's signal is the input filtered by a bandpass and the detection
+ *        statistic is the largest of the bands' STA/LTA ratios.  The input
+ *        is processed in small blocks that are filtered and averaged for
+ *        every band before moving on so the input is read once and the
+ *        filtered signals are never stored in full.
+ * @note The filters start at rest and the STA/LTAs use the default
+ *       initial conditions of the classic STA/LTA.
+ * @ingroup rtseis_modules
+ * @copyright Ben Baker distributed under the MIT license.
+ */
+class MultiBandSTALTA
+{
+     public:
+        /*!
+         * @brief Default constructor.  This module will not yet be usable
+         *        until the parameters are set.
+         * @ingroup rtseis_modules_mbSTALTA
+         */
+        MultiBandSTALTA(void);
+        /*!
+         * @brief Initializes the multi-band STA/LTA from the parameters.
+         * @param[in] parameters  Parameters from which to initialize
+         *                        the multi-band STA/LTA.
+         * @ingroup rtseis_modules_mbSTALTA
+         */
+        MultiBandSTALTA(const MultiBandSTALTAParameters &parameters);
+        /*!
+         * @brief Copy constructor.
+         * @param[in] mbstalta  A multi-band STA/LTA class from which this
+         *                      class is initialized.
+         * @ingroup rtseis_modules_mbSTALTA
+         */
+        MultiBandSTALTA(const MultiBandSTALTA &mbstalta);
+        /*!
+         * @brief Copy operator.
+         * @param[in] mbstalta  A multi-band STA/LTA class to copy.
+         * @result A deep copy of the input class.
+         * @ingroup rtseis_modules_mbSTALTA
+         */
+        MultiBandSTALTA& operator=(const MultiBandSTALTA &mbstalta);
+        /*!
+         * @brief Default destructor.
+         * @ingroup rtseis_modules_mbSTALTA
+         */
+        ~MultiBandSTALTA(void);
+        /*!
+         * @brief Gets the number of bands.
+         * @result The number of bands.  If negative then an error has
+         *         occured.
+         * @ingroup rtseis_modules_mbSTALTA
+         */
+        int getNumberOfBands(void) const;
+        /*!
+         * @brief Computes the multi-band STA/LTA of the input signal.
+         * @param[in] nx   Number of points in signal.
+         * @param[in] x    The signal of which to compute the STA/LTA.  This has
+         *                 dimension [nx].
+         * @param[out] y   The largest STA/LTA of the bands.  This has
+         *                 dimension [nx].
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_mbSTALTA
+         */
+        int apply(const int nx, const double x[], double y[]);
+        /*!
+         * @brief Computes the multi-band STA/LTA of the input signal.
+         * @param[in] nx   Number of points in signal.
+         * @param[in] x    The signal of which to compute the STA/LTA.  This has
+         *                 dimension [nx].
+         * @param[out] y   The largest STA/LTA of the bands.  This has
+         *                 dimension [nx].
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_mbSTALTA
+         */
+        int apply(const int nx, const float x[], float y[]);
+        /*!
+         * @brief Computes the multi-band STA/LTA of the input signal and
+         *        returns each band's STA/LTA.
+         * @param[in] nx      Number of points in signal.
+         * @param[in] x       The signal of which to compute the STA/LTA.
+         *                    This has dimension [nx].
+         * @param[in] nBands  The number of bands.  This must equal
+         *                    getNumberOfBands().
+         * @param[out] yBands  The STA/LTA of each band.  yBands[i] is an
+         *                     array of dimension [nx].
+         * @param[out] y      The largest STA/LTA of the bands.  This has
+         *                    dimension [nx].
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_mbSTALTA
+         */
+        int apply(const int nx, const double x[],
+                  const int nBands, double *const yBands[], double y[]);
+        /*!
+         * @brief Computes the multi-band STA/LTA of the input signal and
+         *        returns each band's STA/LTA.
+         * @param[in] nx      Number of points in signal.
+         * @param[in] x       The signal of which to compute the STA/LTA.
+         *                    This has dimension [nx].
+         * @param[in] nBands  The number of bands.  This must equal
+         *                    getNumberOfBands().
+         * @param[out] yBands  The STA/LTA of each band.  yBands[i] is an
+         *                     array of dimension [nx].
+         * @param[out] y      The largest STA/LTA of the bands.  This has
+         *                    dimension [nx].
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_mbSTALTA
+         */
+        int apply(const int nx, const float x[],
+                  const int nBands, float *const yBands[], float y[]);
+        /*!
+         * @brief Computes the multi-band STA/LTA of the input signal and
+         *        scans it for triggers.  The largest STA/LTA of the bands is
+         *        passed to the trigger block by block so it is never stored.
+         * @param[in] nx   Number of points in signal.
+         * @param[in] x    The signal of which to compute the STA/LTA.  This has
+         *                 dimension [nx].
+         * @param[in,out] trigger  On input this is the initialized trigger.
+         *                         On exit its triggers have been updated as
+         *                         if ThresholdTrigger::apply() were called
+         *                         with the largest STA/LTA of the bands.
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_mbSTALTA
+         */
+        int apply(const int nx, const double x[], ThresholdTrigger *trigger);
+        /*!
+         * @brief Computes the multi-band STA/LTA of the input signal and
+         *        scans it for triggers.
+         * @param[in] nx   Number of points in signal.
+         * @param[in] x    The signal of which to compute the STA/LTA.  This has
+         *                 dimension [nx].
+         * @param[in,out] trigger  On input this is the initialized trigger.
+         *                         On exit its triggers have been updated as
+         *                         if ThresholdTrigger::apply() were called
+         *                         with the largest STA/LTA of the bands.
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_mbSTALTA
+         */
+        int apply(const int nx, const float x[], ThresholdTrigger *trigger);
+        /*!
+         * @brief Resets the filters and averages to their initial conditions.
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_mbSTALTA
+         */
+        int resetInitialConditions(void);
+        /*!
+         * @brief Clears variables in class and restores defaults.
+         *        This class will have to be re-initialized to use again.
+         * @ingroup rtseis_modules_mbSTALTA
+         */
+        void clear(void);
+        /*!
+         * @brief Determines if the class is initialized.
+         * @retval If true then the class is initialized.
+         * @ingroup rtseis_modules_mbSTALTA
+         */
+        bool isInitialized(void) const;
+    private:
+        class MultiBandSTALTAImpl;
+        std::unique_ptr<MultiBandSTALTAImpl> pSTALTA_;
+};
+
+};
+};
+
+#endif
@@ -0,0 +1,164 @@
+#ifndef RTSEIS_MODULES_MULTICHANNELCLASSICSTALTA_HPP
+#define RTSEIS_MODULES_MULTICHANNELCLASSICSTALTA_HPP 1
+#include <memory>
+#include "rtseis/enums.h"
+#include "rtseis/modules/classicSTALTA.hpp"
+
+namespace RTSeis
+{
+namespace Modules
+{
+
+/*!
+ * @defgroup rtseis_modules_mcSTALTA Multi-Channel Classic STA/LTA
+ * @brief Computes the classic STA/LTA for many channels sharing the same
+ *        windows.  The running sums and windows of every channel are held
+ *        in contiguous arrays indexed by channel, rather than in one module
+ *        per channel, and groups of channels are processed in parallel
+ *        with OpenMP.  When the channels receive packets of equal length
+ *        the windows of a group are updated in lockstep with SIMD
+ *        instructions; otherwise, each channel is updated on its own.
+ *        For each channel the result is identical to that of the
+ *        \c ClassicSTALTA module.
+ * @ingroup rtseis_modules
+ * @copyright Ben Baker distributed under the MIT license.
+ */
+class MultiChannelClassicSTALTA
+{
+     public:
+        /*!
+         * @brief Default constructor.  This module will not yet be usable
+         *        until the parameters are set.
+         * @ingroup rtseis_modules_mcSTALTA
+         */
+        MultiChannelClassicSTALTA(void);
+        /*!
+         * @brief Initializes the multi-channel classic STA/LTA.
+         * @param[in] parameters  The STA/LTA parameters shared by all
+         *                        channels.
+         * @param[in] nChannels   The number of channels.  This must be
+         *                        positive.
+         * @ingroup rtseis_modules_mcSTALTA
+         */
+        MultiChannelClassicSTALTA(const ClassicSTALTAParameters &parameters,
+                                  const int nChannels);
+        /*!
+         * @brief Copy constructor.
+         * @param[in] mcstalta  A multi-channel classic STA/LTA class from
+         *                      which this class is initialized.
+         * @ingroup rtseis_modules_mcSTALTA
+         */
+        MultiChannelClassicSTALTA(const MultiChannelClassicSTALTA &mcstalta);
+        /*!
+         * @brief Copy operator.
+         * @param[in] mcstalta  A multi-channel classic STA/LTA class to copy.
+         * @result A deep copy of the input class.
+         * @ingroup rtseis_modules_mcSTALTA
+         */
+        MultiChannelClassicSTALTA& operator=(const MultiChannelClassicSTALTA &mcstalta);
+        /*!
+         * @brief Default destructor.
+         * @ingroup rtseis_modules_mcSTALTA
+         */
+        ~MultiChannelClassicSTALTA(void);
+        /*!
+         * @brief Returns the number of channels.
+         * @result The number of channels.  If negative then an error has
+         *         occured.
+         * @ingroup rtseis_modules_mcSTALTA
+         */
+        int getNumberOfChannels(void) const;
+        /*!
+         * @brief Returns the number of coefficients in each channel's
+         *        numerator initial conditions array.
+         * @result The number of elements in the numerator initial condition
+         *         array.  If negative then an error has occured.
+         * @ingroup rtseis_modules_mcSTALTA
+         */
+        int getNumeratorInitialConditionLength(void) const;
+        /*!
+         * @brief Returns the number of coefficients in each channel's
+         *        denominator initial conditions array.
+         * @result The number of elements in the denominator initial condition
+         *         array.  If negative then an error has occured.
+         * @ingroup rtseis_modules_mcSTALTA
+         */
+        int getDenominatorInitialConditionLength(void) const;
+        /*!
+         * @brief Sets the initial conditions on a channel.
+         * @param[in] channel  The channel.  This must be in the range
+         *                     [0, getNumberOfChannels()-1].
+         * @param[in] nzNum    The length of the numerator initial conditions
+         *                     array.
+         * @param[in] zNum     The squared samples preceding the signal
+         *                     ordered from oldest to most recent.  This has
+         *                     dimension [nzNum].
+         * @param[in] nzDen    The length of the denominator initial
+         *                     conditions array.
+         * @param[in] zDen     The squared samples preceding the signal
+         *                     ordered from oldest to most recent.  This has
+         *                     dimension [nzDen].
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_mcSTALTA
+         */
+        int setInitialConditions(const int channel,
+                                 const int nzNum, const double zNum[],
+                                 const int nzDen, const double zDen[]);
+        /*!
+         * @brief Computes the STA/LTA of the next packet of each channel.
+         * @param[in] nChannels  The number of channels.  This must equal
+         *                       getNumberOfChannels().
+         * @param[in] nx   The number of samples in each channel's packet.
+         *                 This is an array of dimension [nChannels].
+         *                 Channels without new data can set this to 0.
+         * @param[in] x    The packets.  x[i] is an array of dimension [nx[i]].
+         * @param[out] y   The STA/LTA of the packets.  y[i] is an array of
+         *                 dimension [nx[i]].
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_mcSTALTA
+         */
+        int apply(const int nChannels, const int nx[],
+                  const double *const x[], double *const y[]);
+        /*!
+         * @brief Computes the STA/LTA of the next packet of each channel.
+         * @param[in] nChannels  The number of channels.  This must equal
+         *                       getNumberOfChannels().
+         * @param[in] nx   The number of samples in each channel's packet.
+         *                 This is an array of dimension [nChannels].
+         *                 Channels without new data can set this to 0.
+         * @param[in] x    The packets.  x[i] is an array of dimension [nx[i]].
+         * @param[out] y   The STA/LTA of the packets.  y[i] is an array of
+         *                 dimension [nx[i]].
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_mcSTALTA
+         */
+        int apply(const int nChannels, const int nx[],
+                  const float *const x[], float *const y[]);
+        /*!
+         * @brief Resets every channel to the initial conditions specified
+         *        by setInitialConditions() or the default initial conditions.
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_mcSTALTA
+         */
+        int resetInitialConditions(void);
+        /*!
+         * @brief Clears variables in class and restores defaults.
+         *        This class will have to be re-initialized to use again.
+         * @ingroup rtseis_modules_mcSTALTA
+         */
+        void clear(void);
+        /*!
+         * @brief Determines if the class is initialized.
+         * @retval If true then the class is initialized.
+         * @ingroup rtseis_modules_mcSTALTA
+         */
+        bool isInitialized(void) const;
+    private:
+        class MultiChannelClassicSTALTAImpl;
+        std::unique_ptr<MultiChannelClassicSTALTAImpl> pSTALTA_;
+};
+
+};
+};
+
+#endif
@@ -0,0 +1,323 @@
+#ifndef RTSEIS_MODULES_RECURSIVEHIGHERORDERSTATISTICS_HPP
+#define RTSEIS_MODULES_RECURSIVEHIGHERORDERSTATISTICS_HPP 1
+#include <memory>
+#include "rtseis/enums.h"
+
+namespace RTSeis
+{
+namespace Modules
+{
+
+/*!
+ * @brief Defines the higher order statistic used as the characteristic
+ *        function.
+ * @ingroup rtseis_modules_rHOS
+ */
+enum class HigherOrderStatistic
+{
+    SKEWNESS, /*!< The third standardized moment. */
+    KURTOSIS  /*!< The fourth standardized moment.  This is not the excess
+                   kurtosis so Gaussian noise tends to 3. */
+};
+
+/*!
+ * @defgroup rtseis_modules_rHOS_parameters Parameters
+ * @brief Defines the parameters for the recursive higher order statistics
+ *        module.
+ * @ingroup rtseis_modules_rHOS
+ * @copyright Ben Baker distributed under the MIT license.
+ */
+class RecursiveHigherOrderStatisticsParameters
+{
+    public:
+        /*!
+         * @brief Default constructor.  This module will not yet be usable
+         *        until the parameters are set.
+         * @ingroup rtseis_modules_rHOS_parameters
+         */
+        RecursiveHigherOrderStatisticsParameters(void);
+        /*!
+         * @brief Copy constructor.
+         * @param[in] parameters  Class from which to initialize.
+         * @ingroup rtseis_modules_rHOS_parameters
+         */
+        RecursiveHigherOrderStatisticsParameters(const RecursiveHigherOrderStatisticsParameters &parameters);
+        /*!
+         * @brief Copy operator.
+         * @param[in] parameters  Class to copy.
+         * @result A deep copy of the parameter class.
+         * @ingroup rtseis_modules_rHOS_parameters
+         */
+        RecursiveHigherOrderStatisticsParameters& operator=(const RecursiveHigherOrderStatisticsParameters &parameters);
+        /*!
+         * @brief Initializes the recursive higher order statistics parameters.
+         * @param[in] nwin       Number of samples in the averaging window.
+         *                       This must be at least 2.
+         * @param[in] statistic  The statistic to compute.
+         * @param[in] mode  Indicates whether or not this is for real-time.
+         *                  By default this is for post-processing.
+         * @param[in] precision  Defines the precision of the computations.
+         *                       By default this is a double precision module.
+         * @ingroup rtseis_modules_rHOS_parameters
+         */
+        RecursiveHigherOrderStatisticsParameters(
+            const int nwin,
+            const HigherOrderStatistic statistic,
+            const RTSeis::ProcessingMode mode = RTSeis::ProcessingMode::POST_PROCESSING,
+            const RTSeis::Precision precision = RTSeis::Precision::DOUBLE);
+        /*!
+         * @brief Default destructor.
+         * @ingroup rtseis_modules_rHOS_parameters
+         */
+        ~RecursiveHigherOrderStatisticsParameters(void);
+        /*!
+         * @brief Clears variables in class and restores defaults.
+         *        This class will have to be re-initialized to use again.
+         * @ingroup rtseis_modules_rHOS_parameters
+         */
+        void clear(void);
+        /*!
+         * @brief Determines if the class parameters are valid and can be
+         *        used to initialize the module.
+         * @retval True indicates that the parameters are valid.
+         * @retval False indicates that the parameters are invalid.
+         * @ingroup rtseis_modules_rHOS_parameters
+         */
+        bool isValid(void) const;
+        /*!
+         * @brief Sets the averaging window size in samples.  Each average is
+         *        updated with weight 1/nwin.
+         * @param[in] nwin  Number of samples in the averaging window.  This
+         *                  must be at least 2.
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_rHOS_parameters
+         */
+        int setWindowSize(const int nwin);
+        /*!
+         * @brief Sets the averaging window duration.
+         * @param[in] win  The window duration in seconds.  This must be at
+         *                 least the sampling period.
+         * @param[in] dt   The sampling period in seconds.  This must be
+         *                 positive.
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_rHOS_parameters
+         */
+        int setWindowSize(const double win, const double dt);
+        /*!
+         * @brief Gets the number of samples in the averaging window.
+         * @result The number of samples in the averaging window.
+         * @ingroup rtseis_modules_rHOS_parameters
+         */
+        int getWindowSize(void) const;
+        /*!
+         * @brief Sets the statistic to compute.
+         * @param[in] statistic  The statistic.
+         * @ingroup rtseis_modules_rHOS_parameters
+         */
+        void setStatistic(const HigherOrderStatistic statistic);
+        /*!
+         * @brief Gets the statistic to compute.
+         * @result The statistic.
+         * @ingroup rtseis_modules_rHOS_parameters
+         */
+        HigherOrderStatistic getStatistic(void) const;
+        /*!
+         * @brief Enables the class as being for real-time application or not.
+         * @param[in] mode  Indicates whether the module is for post-processing
+         *                  or real-time processing.
+         * @ingroup rtseis_modules_rHOS_parameters
+         */
+        void setProcessingMode(const RTSeis::ProcessingMode mode);
+        /*!
+         * @brief Determines if the class is for real-time application.
+         * @result The processing mode.
+         * @ingroup rtseis_modules_rHOS_parameters
+         */
+        RTSeis::ProcessingMode getProcessingMode(void) const;
+        /*!
+         * @brief Determines the precision of the class.
+         * @result The precision of the module.
+         * @ingroup rtseis_modules_rHOS_parameters
+         */
+        RTSeis::Precision getPrecision(void) const;
+    private:
+        /*!< Routine to validate the parameters. */
+        void validate_(void);
+        /*!< Default precision. */
+        const RTSeis::Precision defaultPrecision_ = RTSeis::Precision::DOUBLE;
+        /*!< The number of samples in the averaging window. */
+        int nwin_ = 0;
+        /*!< The statistic. */
+        HigherOrderStatistic statistic_ = HigherOrderStatistic::KURTOSIS;
+        /*!< The precision of the module. */
+        RTSeis::Precision precision_ = defaultPrecision_;
+        /*!< Flag indicating this module is for real-time or post-processing. */
+        RTSeis::ProcessingMode processingMode_ = RTSeis::ProcessingMode::POST_PROCESSING;
+        /*!< Flag indicating that this is a valid module for processing. */
+        bool isValid_ = false;
+};
+
+/*!
+ * @defgroup rtseis_modules_rHOS Recursive Higher Order Statistics
+ * @brief Computes an exponentially weighted skewness or kurtosis of the
+ *        signal for use as a characteristic function in picking.  With
+ *        \f$ C = 1/n_{win} \f$ the mean, variance, and statistic are updated
+ *        by
+ *        \f[
+ *           \mu_i = \mu_{i-1} + C (x_i - \mu_{i-1}), \quad
+ *           \sigma_i^2 = (1 - C) \sigma_{i-1}^2 + C (x_i - \mu_i)^2
+ *        \f]
+ *        and
+ *        \f[
+ *           s_i = (1 - C) s_{i-1}
+ *               + C \left( \frac{x_i - \mu_i}{\sigma_i} \right)^p
+ *        \f]
+ *        where \f$ p \f$ is 3 for the skewness and 4 for the kurtosis.  The
+ *        deviation is standardized before it is raised to the power so the
+ *        statistic neither overflows nor underflows for extreme amplitudes.
+ *        Many channels sharing the same parameters can be processed at once;
+ *        the channels' states are interleaved so that the update vectorizes
+ *        across channels.
+ * @note Unless initial conditions are set the first nwin values are 0 while
+ *       the averages stabilize.  Where the variance is 0 the standardized
+ *       deviation is taken to be 0.
+ * @ingroup rtseis_modules
+ * @copyright Ben Baker distributed under the MIT license.
+ */
+class RecursiveHigherOrderStatistics
+{
+     public:
+        /*!
+         * @brief Default constructor.  This module will not yet be usable
+         *        until the parameters are set.
+         * @ingroup rtseis_modules_rHOS
+         */
+        RecursiveHigherOrderStatistics(void);
+        /*!
+         * @brief Initializes the module from the parameters.
+         * @param[in] parameters  Parameters from which to initialize
+         *                        the module.
+         * @param[in] nChannels   The number of channels.  This must be
+         *                        positive.  By default this is 1.
+         * @ingroup rtseis_modules_rHOS
+         */
+        RecursiveHigherOrderStatistics(const RecursiveHigherOrderStatisticsParameters &parameters,
+                                       const int nChannels = 1);
+        /*!
+         * @brief Copy constructor.
+         * @param[in] rhos  A recursive higher order statistics class from
+         *                  which this class is initialized.
+         * @ingroup rtseis_modules_rHOS
+         */
+        RecursiveHigherOrderStatistics(const RecursiveHigherOrderStatistics &rhos);
+        /*!
+         * @brief Copy operator.
+         * @param[in] rhos  A recursive higher order statistics class to copy.
+         * @result A deep copy of the input class.
+         * @ingroup rtseis_modules_rHOS
+         */
+        RecursiveHigherOrderStatistics& operator=(const RecursiveHigherOrderStatistics &rhos);
+        /*!
+         * @brief Default destructor.
+         * @ingroup rtseis_modules_rHOS
+         */
+        ~RecursiveHigherOrderStatistics(void);
+        /*!
+         * @brief Returns the number of channels.
+         * @result The number of channels.  If negative then an error has
+         *         occured.
+         * @ingroup rtseis_modules_rHOS
+         */
+        int getNumberOfChannels(void) const;
+        /*!
+         * @brief Returns the number of coefficients in the initial conditions
+         *        array.
+         * @result The number of elements in the initial condition array
+         *         which is 3.  If negative then an error has occured.
+         * @ingroup rtseis_modules_rHOS
+         */
+        int getInitialConditionLength(void) const;
+        /*!
+         * @brief Sets the initial conditions of every channel.  The
+         *        statistic is computed from the first sample onward.
+         * @param[in] nz  The length of the initial conditions array.  This
+         *                must equal getInitialConditionLength().
+         * @param[in] zi  The mean, variance, and statistic preceding the
+         *                signal.  This has dimension [nz].  The variance
+         *                cannot be negative.
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_rHOS
+         */
+        int setInitialConditions(const int nz, const double zi[]);
+        /*!
+         * @brief Computes the statistic of the input signal.  The module
+         *        must have one channel.
+         * @param[in] nx   Number of points in signal.
+         * @param[in] x    The signal.  This has dimension [nx].
+         * @param[out] y   The statistic.  This has dimension [nx].
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_rHOS
+         */
+        int apply(const int nx, const double x[], double y[]);
+        /*!
+         * @brief Computes the statistic of the input signal.  The module
+         *        must have one channel.
+         * @param[in] nx   Number of points in signal.
+         * @param[in] x    The signal.  This has dimension [nx].
+         * @param[out] y   The statistic.  This has dimension [nx].
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_rHOS
+         */
+        int apply(const int nx, const float x[], float y[]);
+        /*!
+         * @brief Computes the statistic of every channel.
+         * @param[in] nChannels  The number of channels.  This must equal
+         *                       getNumberOfChannels().
+         * @param[in] nx   Number of points in each channel's signal.
+         * @param[in] x    The signals.  x[c] is an array of dimension [nx].
+         * @param[out] y   The statistics.  y[c] is an array of dimension [nx].
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_rHOS
+         */
+        int apply(const int nChannels, const int nx,
+                  const double *const x[], double *const y[]);
+        /*!
+         * @brief Computes the statistic of every channel.
+         * @param[in] nChannels  The number of channels.  This must equal
+         *                       getNumberOfChannels().
+         * @param[in] nx   Number of points in each channel's signal.
+         * @param[in] x    The signals.  x[c] is an array of dimension [nx].
+         * @param[out] y   The statistics.  y[c] is an array of dimension [nx].
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_rHOS
+         */
+        int apply(const int nChannels, const int nx,
+                  const float *const x[], float *const y[]);
+        /*!
+         * @brief Resets every channel to the initial conditions specified
+         *        by setInitialConditions() or the default initial conditions.
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_rHOS
+         */
+        int resetInitialConditions(void);
+        /*!
+         * @brief Clears variables in class and restores defaults.
+         *        This class will have to be re-initialized to use again.
+         * @ingroup rtseis_modules_rHOS
+         */
+        void clear(void);
+        /*!
+         * @brief Determines if the class is initialized.
+         * @retval If true then the class is initialized.
+         * @ingroup rtseis_modules_rHOS
+         */
+        bool isInitialized(void) const;
+    private:
+        class RecursiveHigherOrderStatisticsImpl;
+        std::unique_ptr<RecursiveHigherOrderStatisticsImpl> pHOS_;
+};
+
+};
+};
+
+#endif
@@ -0,0 +1,351 @@
+#ifndef RTSEIS_MODULES_RECURSIVESTALTA_HPP
+#define RTSEIS_MODULES_RECURSIVESTALTA_HPP 1
+#include <memory>
+#include "rtseis/enums.h"
+
+namespace RTSeis
+{
+namespace Modules
+{
+class ThresholdTrigger;
+
+/*!
+ * @defgroup rtseis_modules_rSTALTA_parameters Parameters
+ * @brief Defines the parameters for the recursive STA/LTA module.
+ * @ingroup rtseis_modules_rSTALTA
+ * @copyright Ben Baker distributed under the MIT license.
+ */
+class RecursiveSTALTAParameters
+{
+    public:
+        /*!
+         * @brief Default constructor.  This module will not yet be usable
+         *        until the parameters are set.
+         * @ingroup rtseis_modules_rSTALTA_parameters
+         */
+        RecursiveSTALTAParameters(void);
+        /*!
+         * @brief Copy constructor.
+         * @param[in] parameters  Class from which to initialize.
+         * @ingroup rtseis_modules_rSTALTA_parameters
+         */
+        RecursiveSTALTAParameters(const RecursiveSTALTAParameters &parameters);
+        /*!
+         * @brief Copy operator.
+         * @param[in] parameters  Class to copy.
+         * @result A deep copy of the STA/LTA parameter class.
+         * @ingroup rtseis_modules_rSTALTA_parameters
+         */
+        RecursiveSTALTAParameters& operator=(const RecursiveSTALTAParameters &parameters);
+        /*!
+         * @brief Initializes the recursive STA/LTA parameters.
+         * @param[in] nsta  Number of samples in the short-term average
+         *                  window.  This must be positive.
+         * @param[in] nlta  Number of samples in the long-term average
+         *                  window.  This must be greater than nsta.
+         * @param[in] mode  Indicates whether or not this is for real-time.
+         *                  By default this is for post-processing.
+         * @param[in] precision  Defines the precision.  By default this
+         *                       is a double precision module.
+         * @ingroup rtseis_modules_rSTALTA_parameters
+         */
+        RecursiveSTALTAParameters(
+            const int nsta, const int nlta,
+            const RTSeis::ProcessingMode mode = RTSeis::ProcessingMode::POST_PROCESSING,
+            const RTSeis::Precision precision = RTSeis::Precision::DOUBLE);
+        /*!
+         * @brief Initializes the recursive STA/LTA parameters.
+         * @param[in] staWin  The short-term average window duration in
+         *                    seconds.  This must be non-negative.
+         * @param[in] ltaWin  The long-term average window duration in
+         *                    seconds.  This must be greater than the STA
+         *                    window length plus half the sampling period
+         *                    i.e., \f$ LTA > STA + \frac{\Delta T}{2} \f$.
+         * @param[in] dt      The sampling period in seconds.  This must be
+         *                    positive.
+         * @param[in] mode    Indicates whether or not this is for real-time.
+         *                    By default this is for post-processing.
+         * @param[in] precision  Defines the precision.  By default this
+         *                       is a double precision module.
+         * @ingroup rtseis_modules_rSTALTA_parameters
+         */
+        RecursiveSTALTAParameters(
+            const double staWin, const double ltaWin,
+            const double dt,
+            const RTSeis::ProcessingMode mode = RTSeis::ProcessingMode::POST_PROCESSING,
+            const RTSeis::Precision precision = RTSeis::Precision::DOUBLE);
+        /*!
+         * @brief Default destructor.
+         * @ingroup rtseis_modules_rSTALTA_parameters
+         */
+        ~RecursiveSTALTAParameters(void);
+        /*!
+         * @brief Clears variables in class and restores defaults.
+         *        This class will have to be re-initialized to use again.
+         * @ingroup rtseis_modules_rSTALTA_parameters
+         */
+        void clear(void);
+        /*!
+         * @brief Determines if the class parameters are valid and can be
+         *        used to initialize the STA/LTA processing.
+         * @retval True indicates that the parameters are valid.
+         * @retval False indicates that the parameters are invalid.
+         * @ingroup rtseis_modules_rSTALTA_parameters
+         */
+        bool isValid(void) const;
+        /*!
+         * @brief Sets the short-term and long-term window size in samples.
+         * @param[in] nsta  Number of samples in the short-term average
+         *                  window.  This must be positive.
+         * @param[in] nlta  Number of samples in the long-term average
+         *                  window.  This must be greater than nsta.
+         * @result 0 indicates success.  On failure the number of samples
+         *         in the short-term and long-term windows will remain
+         *         unchanged.
+         * @ingroup rtseis_modules_rSTALTA_parameters
+         */
+        int setShortTermAndLongTermWindowSize(const int nsta, const int nlta);
+        /*!
+         * @brief Sets the short-term and long-term window durations.
+         * @param[in] staWin  The short-term average window duration in
+         *                    seconds.  This must be non-negative.
+         * @param[in] ltaWin  The long-term average window duration in
+         *                    seconds.  This must be greater than the STA
+         *                    window length plus half the sampling period.
+         * @param[in] dt      The sampling period in seconds.  This must be
+         *                    positive.
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_rSTALTA_parameters
+         */
+        int setShortTermAndLongTermWindowSize(const double staWin,
+                                              const double ltaWin,
+                                              const double dt);
+        /*!
+         * @brief Gets the number of samples in the long-term window.
+         * @result The number of samples in the long-term window.
+         * @ingroup rtseis_modules_rSTALTA_parameters
+         */
+        int getLongTermWindowSize(void) const;
+        /*!
+         * @brief Gets the number of samples in the short-term window.
+         * @result The number of samples in the short-term window.
+         * @ingroup rtseis_modules_rSTALTA_parameters
+         */
+        int getShortTermWindowSize(void) const;
+        /*!
+         * @brief Sets the weight, \f$ K \f$, of Allen's (1978)
+         *        characteristic function
+         *        \f$ e_i = x_i^2 + K (x_i - x_{i-1})^2 \f$.
+         *        Allen suggests a K that balances the amplitude and
+         *        derivative terms for the station's typical signal.
+         * @param[in] weight  The weight.  This must be non-negative.  If this
+         *                    is 0 then the characteristic function is the
+         *                    squared signal.
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_rSTALTA_parameters
+         */
+        int setAllenWeight(const double weight);
+        /*!
+         * @brief Gets the weight of Allen's characteristic function.
+         * @result The weight.  0 indicates the squared signal is used.
+         * @ingroup rtseis_modules_rSTALTA_parameters
+         */
+        double getAllenWeight(void) const;
+        /*!
+         * @brief Enables the class as being for real-time application or not.
+         * @param[in] mode  Indicates whether the module is for post-processing
+         *                  or real-time processing.
+         * @ingroup rtseis_modules_rSTALTA_parameters
+         */
+        void setProcessingMode(const RTSeis::ProcessingMode mode);
+        /*!
+         * @brief Determines if the class is for real-time application.
+         * @result The processing mode.
+         * @ingroup rtseis_modules_rSTALTA_parameters
+         */
+        RTSeis::ProcessingMode getProcessingMode(void) const;
+        /*!
+         * @brief Determines the precision of the class.
+         * @result The precision of the module.
+         * @ingroup rtseis_modules_rSTALTA_parameters
+         */
+        RTSeis::Precision getPrecision(void) const;
+    private:
+        /*!< Routine to validate the parameters. */
+        void validate_(void);
+        /*!< Default precision. */
+        const RTSeis::Precision defaultPrecision_ = RTSeis::Precision::DOUBLE;
+        /*!< The weight of the derivative in Allen's characteristic
+             function. */
+        double allenWeight_ = 0;
+        /*!< The number of samples in the short term average window. */
+        int nsta_ = 0;
+        /*!< The number of samples in the long-term average window. */
+        int nlta_ = 0;
+        /*!< The precision of the module. */
+        RTSeis::Precision precision_ = defaultPrecision_;
+        /*!< Flag indicating this module is for real-time or post-processing. */
+        RTSeis::ProcessingMode processingMode_ = RTSeis::ProcessingMode::POST_PROCESSING;
+        /*!< Flag indicating that this is a valid module for processing. */
+        bool isValid_ = false;
+};
+
+/*!
+ * @defgroup rtseis_modules_rSTALTA Recursive STA/LTA
+ * @brief Computes the recursive Short Term to Long Term Average.  The
+ *        averages of the characteristic function, \f$ e \f$, are
+ *        exponentially weighted
+ *        \f[
+ *           STA_i = \frac{1}{n_{sta}} e_i
+ *                 + \left(1 - \frac{1}{n_{sta}} \right) STA_{i-1}
+ *        \f]
+ *        and likewise for the LTA.  The cost per sample and the state are
+ *        independent of the window lengths.
+ * @note Unless initial conditions are set the first nlta ratios are 0
+ *       while the long-term average stabilizes.
+ * @ingroup rtseis_modules
+ * @copyright Ben Baker distributed under the MIT license.
+ */
+class RecursiveSTALTA
+{
+     public:
+        /*!
+         * @brief Default constructor.  This module will not yet be usable
+         *        until the parameters are set.
+         * @ingroup rtseis_modules_rSTALTA
+         */
+        RecursiveSTALTA(void);
+        /*!
+         * @brief Initializes the recursive STA/LTA from the parameters.
+         * @param[in] parameters  Parameters from which to initialize
+         *                        the recursive STA/LTA.
+         * @ingroup rtseis_modules_rSTALTA
+         */
+        RecursiveSTALTA(const RecursiveSTALTAParameters &parameters);
+        /*!
+         * @brief Copy constructor.
+         * @param[in] rstalta  A recursive STA/LTA class from which this
+         *                     class is initialized.
+         * @ingroup rtseis_modules_rSTALTA
+         */
+        RecursiveSTALTA(const RecursiveSTALTA &rstalta);
+        /*!
+         * @brief Copy operator.
+         * @param[in] rstalta  A recursive STA/LTA class to copy.
+         * @result A deep copy of the input class.
+         * @ingroup rtseis_modules_rSTALTA
+         */
+        RecursiveSTALTA& operator=(const RecursiveSTALTA &rstalta);
+        /*!
+         * @brief Default destructor.
+         * @ingroup rtseis_modules_rSTALTA
+         */
+        ~RecursiveSTALTA(void);
+        /*!
+         * @brief Returns the number of coefficients in the numerator initial
+         *        conditions array.
+         * @result The number of elements in the numerator initial condition
+         *         array which is 1.  If negative then an error has occured.
+         * @ingroup rtseis_modules_rSTALTA
+         */
+        int getNumeratorInitialConditionLength(void) const;
+        /*!
+         * @brief Returns the number of coefficients in the denominator initial
+         *        conditions array.
+         * @result The number of elements in the denominator initial condition
+         *         array which is 1.  If negative then an error has occured.
+         * @ingroup rtseis_modules_rSTALTA
+         */
+        int getDenominatorInitialConditionLength(void) const;
+        /*!
+         * @brief Sets the initial conditions on the filter.  The ratios are
+         *        computed from the first sample onward.
+         * @param[in] nzNum  The length of the numerator initial conditions
+         *                   array.
+         * @param[in] zNum   The short-term average preceding the signal.
+         *                   This has dimension [nzNum].
+         * @param[in] nzDen  The length of the denominator initial conditions
+         *                   array.
+         * @param[in] zDen   The long-term average preceding the signal.
+         *                   This has dimension [nzDen].
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_rSTALTA
+         */
+        int setInitialConditions(const int nzNum, const double zNum[],
+                                 const int nzDen, const double zDen[]);
+        /*!
+         * @brief Computes the STA/LTA of the input signal.
+         * @param[in] nx   Number of points in signal.
+         * @param[in] x    The signal of which to compute the STA/LTA.  This has
+         *                 dimension [nx].
+         * @param[in] y    The STA/LTA signal.  This has dimension [nx].
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_rSTALTA
+         */
+        int apply(const int nx, const double x[], double y[]);
+        /*!
+         * @brief Computes the STA/LTA of the input signal.
+         * @param[in] nx   Number of points in signal.
+         * @param[in] x    The signal of which to compute the STA/LTA.  This has
+         *                 dimension [nx].
+         * @param[in] y    The STA/LTA signal.  This has dimension [nx].
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_rSTALTA
+         */
+        int apply(const int nx, const float x[], float y[]);
+        /*!
+         * @brief Computes the STA/LTA of the input signal and scans it for
+         *        triggers.  The STA/LTA is computed in small blocks that are
+         *        passed directly to the trigger so the full STA/LTA signal
+         *        is never stored.
+         * @param[in] nx   Number of points in signal.
+         * @param[in] x    The signal of which to compute the STA/LTA.  This has
+         *                 dimension [nx].
+         * @param[in,out] trigger  On input this is the initialized trigger.
+         *                         On exit its triggers have been updated as
+         *                         if ThresholdTrigger::apply() were called
+         *                         with the STA/LTA signal.
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_rSTALTA
+         */
+        int apply(const int nx, const double x[], ThresholdTrigger *trigger);
+        /*!
+         * @brief Computes the STA/LTA of the input signal and scans it for
+         *        triggers.
+         * @param[in] nx   Number of points in signal.
+         * @param[in] x    The signal of which to compute the STA/LTA.  This has
+         *                 dimension [nx].
+         * @param[in,out] trigger  On input this is the initialized trigger.
+         *                         On exit its triggers have been updated as
+         *                         if ThresholdTrigger::apply() were called
+         *                         with the STA/LTA signal.
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_rSTALTA
+         */
+        int apply(const int nx, const float x[], ThresholdTrigger *trigger);
+        /*!
+         * @brief Resets the filter to the initial conditions specified
+         *        by setInitialConditions() or the default initial conditions.
+         * @result 0 indicates success.
+         */
+        int resetInitialConditions(void);
+        /*!
+         * @brief Clears variables in class and restores defaults.
+         *        This class will have to be re-initialized to use again.
+         * @ingroup rtseis_modules_rSTALTA
+         */
+        void clear(void);
+        /*!
+         * @brief Determines if the class is initialized.
+         * @retval If true then the class is initialized.
+         */
+        bool isInitialized(void) const;
+    private:
+        class RecursiveSTALTAImpl;
+        std::unique_ptr<RecursiveSTALTAImpl> pSTALTA_;
+};
+
+};
+};
+
+#endif
@@ -0,0 +1,363 @@
+#ifndef RTSEIS_MODULES_THRESHOLDTRIGGER_HPP
+#define RTSEIS_MODULES_THRESHOLDTRIGGER_HPP 1
+#include <memory>
+#include <cstdint>
+#include "rtseis/enums.h"
+
+namespace RTSeis
+{
+namespace Modules
+{
+
+/*!
+ * @brief A trigger declared by the threshold trigger.  Sample indices are
+ *        counted from the first sample after the trigger was initialized
+ *        or reset.
+ * @ingroup rtseis_modules_trigger
+ */
+struct TriggerRecord
+{
+    /*!< The first sample at which the characteristic function met or
+         exceeded the on threshold. */
+    int64_t onset = 0;
+    /*!< The sample at which the characteristic function was largest. */
+    int64_t peak = 0;
+    /*!< The largest value of the characteristic function. */
+    double peakValue = 0;
+    /*!< The number of samples from the onset to the first sample at which
+         the characteristic function fell below the off threshold. */
+    int64_t duration = 0;
+    /*!< The first sample of the padded window.  This is the onset less
+         the pre-padding but no less than 0. */
+    int64_t start = 0;
+    /*!< One past the last sample of the padded window.  This is
+         onset + duration plus the post-padding. */
+    int64_t end = 0;
+};
+
+/*!
+ * @defgroup rtseis_modules_trigger_parameters Parameters
+ * @brief Defines the parameters for the threshold trigger module.
+ * @ingroup rtseis_modules_trigger
+ * @copyright Ben Baker distributed under the MIT license.
+ */
+class ThresholdTriggerParameters
+{
+    public:
+        /*!
+         * @brief Default constructor.  This module will not yet be usable
+         *        until the parameters are set.
+         * @ingroup rtseis_modules_trigger_parameters
+         */
+        ThresholdTriggerParameters(void);
+        /*!
+         * @brief Copy constructor.
+         * @param[in] parameters  Class from which to initialize.
+         * @ingroup rtseis_modules_trigger_parameters
+         */
+        ThresholdTriggerParameters(const ThresholdTriggerParameters &parameters);
+        /*!
+         * @brief Copy operator.
+         * @param[in] parameters  Class to copy.
+         * @result A deep copy of the trigger parameter class.
+         * @ingroup rtseis_modules_trigger_parameters
+         */
+        ThresholdTriggerParameters& operator=(const ThresholdTriggerParameters &parameters);
+        /*!
+         * @brief Initializes the threshold trigger parameters.
+         * @param[in] onThreshold   A trigger turns on when the characteristic
+         *                          function meets or exceeds this value.
+         * @param[in] offThreshold  A trigger turns off when the characteristic
+         *                          function falls below this value.  This
+         *                          cannot exceed onThreshold.
+         * @param[in] mode  Indicates whether or not this is for real-time.
+         *                  By default this is for post-processing.
+         * @ingroup rtseis_modules_trigger_parameters
+         */
+        ThresholdTriggerParameters(
+            const double onThreshold, const double offThreshold,
+            const RTSeis::ProcessingMode mode = RTSeis::ProcessingMode::POST_PROCESSING);
+        /*!
+         * @brief Default destructor.
+         * @ingroup rtseis_modules_trigger_parameters
+         */
+        ~ThresholdTriggerParameters(void);
+        /*!
+         * @brief Clears variables in class and restores defaults.
+         *        This class will have to be re-initialized to use again.
+         * @ingroup rtseis_modules_trigger_parameters
+         */
+        void clear(void);
+        /*!
+         * @brief Determines if the class parameters are valid and can be
+         *        used to initialize the threshold trigger.
+         * @retval True indicates that the parameters are valid.
+         * @retval False indicates that the parameters are invalid.
+         * @ingroup rtseis_modules_trigger_parameters
+         */
+        bool isValid(void) const;
+        /*!
+         * @brief Sets the on and off thresholds.
+         * @param[in] onThreshold   A trigger turns on when the characteristic
+         *                          function meets or exceeds this value.
+         * @param[in] offThreshold  A trigger turns off when the characteristic
+         *                          function falls below this value.  This
+         *                          cannot exceed onThreshold.
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_trigger_parameters
+         */
+        int setThresholds(const double onThreshold, const double offThreshold);
+        /*!
+         * @brief Gets the on threshold.
+         * @result The value at which a trigger turns on.
+         * @ingroup rtseis_modules_trigger_parameters
+         */
+        double getOnThreshold(void) const;
+        /*!
+         * @brief Gets the off threshold.
+         * @result The value below which a trigger turns off.
+         * @ingroup rtseis_modules_trigger_parameters
+         */
+        double getOffThreshold(void) const;
+        /*!
+         * @brief Sets the minimum duration of a trigger.  Shorter triggers
+         *        are discarded.
+         * @param[in] nSamples  The minimum duration in samples.  This cannot
+         *                      be negative.  By default this is 0.
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_trigger_parameters
+         */
+        int setMinimumDuration(const int nSamples);
+        /*!
+         * @brief Gets the minimum duration of a trigger.
+         * @result The minimum duration in samples.
+         * @ingroup rtseis_modules_trigger_parameters
+         */
+        int getMinimumDuration(void) const;
+        /*!
+         * @brief Sets the padding added to the trigger windows.
+         * @param[in] nPre   The number of samples to include before the onset.
+         *                   This cannot be negative.
+         * @param[in] nPost  The number of samples to include after the trigger
+         *                   turns off.  This cannot be negative.
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_trigger_parameters
+         */
+        int setPadding(const int nPre, const int nPost);
+        /*!
+         * @brief Gets the number of samples included before the onset.
+         * @result The pre-padding in samples.
+         * @ingroup rtseis_modules_trigger_parameters
+         */
+        int getPrePadding(void) const;
+        /*!
+         * @brief Gets the number of samples included after a trigger turns off.
+         * @result The post-padding in samples.
+         * @ingroup rtseis_modules_trigger_parameters
+         */
+        int getPostPadding(void) const;
+        /*!
+         * @brief Enables the class as being for real-time application or not.
+         * @param[in] mode  Indicates whether the module is for post-processing
+         *                  or real-time processing.
+         * @ingroup rtseis_modules_trigger_parameters
+         */
+        void setProcessingMode(const RTSeis::ProcessingMode mode);
+        /*!
+         * @brief Determines if the class is for real-time application.
+         * @result The processing mode.
+         * @ingroup rtseis_modules_trigger_parameters
+         */
+        RTSeis::ProcessingMode getProcessingMode(void) const;
+    private:
+        /*!< Routine to validate the parameters. */
+        void validate_(void);
+        /*!< The on threshold. */
+        double onThreshold_ = 0;
+        /*!< The off threshold. */
+        double offThreshold_ = 0;
+        /*!< The minimum trigger duration in samples. */
+        int minimumDuration_ = 0;
+        /*!< The number of samples to pad before the onset. */
+        int prePadding_ = 0;
+        /*!< The number of samples to pad after the trigger turns off. */
+        int postPadding_ = 0;
+        /*!< Flag indicating this module is for real-time or post-processing. */
+        RTSeis::ProcessingMode processingMode_ = RTSeis::ProcessingMode::POST_PROCESSING;
+        /*!< Flag indicating the thresholds were set. */
+        bool haveThresholds_ = false;
+        /*!< Flag indicating that this is a valid module for processing. */
+        bool isValid_ = false;
+};
+
+/*!
+ * @defgroup rtseis_modules_trigger Threshold Trigger
+ * @brief Scans a characteristic function, e.g., an STA/LTA ratio, for
+ *        triggers.  A trigger turns on at the first sample meeting the on
+ *        threshold and turns off at the first subsequent sample below the
+ *        off threshold.  Rather than returning a signal this module returns
+ *        a compact record for each trigger.
+ * @note In real-time mode a trigger that is on at the end of a packet is
+ *       continued in the next packet.  In post-processing mode a trigger
+ *       that is on at the end of the signal is turned off there.
+ * @ingroup rtseis_modules
+ * @copyright Ben Baker distributed under the MIT license.
+ */
+class ThresholdTrigger
+{
+     public:
+        /*!
+         * @brief Default constructor.  This module will not yet be usable
+         *        until the parameters are set.
+         * @ingroup rtseis_modules_trigger
+         */
+        ThresholdTrigger(void);
+        /*!
+         * @brief Initializes the threshold trigger from the parameters.
+         * @param[in] parameters  Parameters from which to initialize
+         *                        the trigger.
+         * @ingroup rtseis_modules_trigger
+         */
+        ThresholdTrigger(const ThresholdTriggerParameters &parameters);
+        /*!
+         * @brief Copy constructor.
+         * @param[in] trigger  A threshold trigger class from which this
+         *                     class is initialized.
+         * @ingroup rtseis_modules_trigger
+         */
+        ThresholdTrigger(const ThresholdTrigger &trigger);
+        /*!
+         * @brief Copy operator.
+         * @param[in] trigger  A threshold trigger class to copy.
+         * @result A deep copy of the input class.
+         * @ingroup rtseis_modules_trigger
+         */
+        ThresholdTrigger& operator=(const ThresholdTrigger &trigger);
+        /*!
+         * @brief Default destructor.
+         * @ingroup rtseis_modules_trigger
+         */
+        ~ThresholdTrigger(void);
+        /*!
+         * @brief Scans the next samples of the characteristic function for
+         *        triggers.  In post-processing mode the triggers from the
+         *        previous call are discarded first.
+         * @param[in] nx   Number of points in the characteristic function.
+         * @param[in] cf   The characteristic function.  This has dimension
+         *                 [nx].
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_trigger
+         */
+        int apply(const int nx, const double cf[]);
+        /*!
+         * @brief Scans the next samples of the characteristic function for
+         *        triggers.  In post-processing mode the triggers from the
+         *        previous call are discarded first.
+         * @param[in] nx   Number of points in the characteristic function.
+         * @param[in] cf   The characteristic function.  This has dimension
+         *                 [nx].
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_trigger
+         */
+        int apply(const int nx, const float cf[]);
+        /*!
+         * @brief Starts a characteristic function that will be scanned in
+         *        blocks with scan().  In post-processing mode the triggers
+         *        from the previous signal are discarded.  Together,
+         *        begin(), scan(), and end() are equivalent to apply() on
+         *        the concatenated blocks but let a module pass its
+         *        characteristic function to the trigger as it is computed.
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_trigger
+         */
+        int begin(void);
+        /*!
+         * @brief Scans the next block of the characteristic function started
+         *        by begin().  Unlike apply() this neither discards the
+         *        triggers nor turns off a trigger at the end of the block.
+         * @param[in] nx   Number of points in the block.
+         * @param[in] cf   The block of the characteristic function.  This has
+         *                 dimension [nx].
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_trigger
+         */
+        int scan(const int nx, const double cf[]);
+        /*!
+         * @brief Scans the next block of the characteristic function started
+         *        by begin().
+         * @param[in] nx   Number of points in the block.
+         * @param[in] cf   The block of the characteristic function.  This has
+         *                 dimension [nx].
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_trigger
+         */
+        int scan(const int nx, const float cf[]);
+        /*!
+         * @brief Ends the characteristic function started by begin().  In
+         *        post-processing mode a trigger that is on is turned off at
+         *        the end of the signal.
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_trigger
+         */
+        int end(void);
+        /*!
+         * @brief Gets the number of triggers that have turned off and have
+         *        not yet been cleared.
+         * @result The number of triggers.  If negative then an error has
+         *         occured.
+         * @ingroup rtseis_modules_trigger
+         */
+        int getNumberOfTriggers(void) const;
+        /*!
+         * @brief Gets the triggers that have turned off and have not yet been
+         *        cleared.
+         * @param[in] maxTriggers  The maximum number of triggers that can be
+         *                         written to triggers.  This must be at least
+         *                         getNumberOfTriggers().
+         * @param[out] triggers    The triggers ordered by onset.  This has
+         *                         dimension [maxTriggers] however only the
+         *                         first getNumberOfTriggers() are defined.
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_trigger
+         */
+        int getTriggers(const int maxTriggers, TriggerRecord triggers[]) const;
+        /*!
+         * @brief Discards the triggers that have turned off.  A trigger that
+         *        is currently on is retained.
+         * @ingroup rtseis_modules_trigger
+         */
+        void clearTriggers(void);
+        /*!
+         * @brief Determines if a trigger is currently on.
+         * @retval True indicates a trigger is on.
+         * @ingroup rtseis_modules_trigger
+         */
+        bool isTriggered(void) const;
+        /*!
+         * @brief Resets the trigger so that the next sample is sample 0 and
+         *        no trigger is on.  The triggers are discarded.
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_trigger
+         */
+        int resetInitialConditions(void);
+        /*!
+         * @brief Clears variables in class and restores defaults.
+         *        This class will have to be re-initialized to use again.
+         * @ingroup rtseis_modules_trigger
+         */
+        void clear(void);
+        /*!
+         * @brief Determines if the class is initialized.
+         * @retval If true then the class is initialized.
+         * @ingroup rtseis_modules_trigger
+         */
+        bool isInitialized(void) const;
+    private:
+        class ThresholdTriggerImpl;
+        std::unique_ptr<ThresholdTriggerImpl> pTrigger_;
+};
+
+};
+};
+
+#endif
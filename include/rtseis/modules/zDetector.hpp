@@ -0,0 +1,342 @@
+#ifndef RTSEIS_MODULES_ZDETECTOR_HPP
+#define RTSEIS_MODULES_ZDETECTOR_HPP 1
+#include <memory>
+#include "rtseis/enums.h"
+
+namespace RTSeis
+{
+namespace Modules
+{
+class ThresholdTrigger;
+
+/*!
+ * @defgroup rtseis_modules_zDetector_parameters Parameters
+ * @brief Defines the parameters for the Z-detector module.
+ * @ingroup rtseis_modules_zDetector
+ * @copyright Ben Baker distributed under the MIT license.
+ */
+class ZDetectorParameters
+{
+    public:
+        /*!
+         * @brief Default constructor.  This module will not yet be usable
+         *        until the parameters are set.
+         * @ingroup rtseis_modules_zDetector_parameters
+         */
+        ZDetectorParameters(void);
+        /*!
+         * @brief Copy constructor.
+         * @param[in] parameters  Class from which to initialize.
+         * @ingroup rtseis_modules_zDetector_parameters
+         */
+        ZDetectorParameters(const ZDetectorParameters &parameters);
+        /*!
+         * @brief Copy operator.
+         * @param[in] parameters  Class to copy.
+         * @result A deep copy of the Z-detector parameter class.
+         * @ingroup rtseis_modules_zDetector_parameters
+         */
+        ZDetectorParameters& operator=(const ZDetectorParameters &parameters);
+        /*!
+         * @brief Initializes the Z-detector parameters.
+         * @param[in] nsta  Number of samples in the short-term average
+         *                  window.  This must be positive.
+         * @param[in] nlta  Number of short-term averages from which the
+         *                  mean and standard deviation are computed.  This
+         *                  must be greater than nsta.
+         * @param[in] mode  Indicates whether or not this is for real-time.
+         *                  By default this is for post-processing.
+         * @param[in] precision  Defines the precision.  By default this
+         *                       is a double precision module.
+         * @ingroup rtseis_modules_zDetector_parameters
+         */
+        ZDetectorParameters(
+            const int nsta, const int nlta,
+            const RTSeis::ProcessingMode mode = RTSeis::ProcessingMode::POST_PROCESSING,
+            const RTSeis::Precision precision = RTSeis::Precision::DOUBLE);
+        /*!
+         * @brief Initializes the Z-detector parameters.
+         * @param[in] staWin  The short-term average window duration in
+         *                    seconds.  This must be non-negative.
+         * @param[in] ltaWin  The duration in seconds of the short-term averages
+         *                    from which the mean and standard deviation are
+         *                    computed.  This must be greater than the STA
+         *                    window length plus half the sampling period
+         *                    i.e., \f$ LTA > STA + \frac{\Delta T}{2} \f$.
+         * @param[in] dt      The sampling period in seconds.  This must be
+         *                    positive.
+         * @param[in] mode    Indicates whether or not this is for real-time.
+         *                    By default this is for post-processing.
+         * @param[in] precision  Defines the precision.  By default this
+         *                       is a double precision module.
+         * @ingroup rtseis_modules_zDetector_parameters
+         */
+        ZDetectorParameters(
+            const double staWin, const double ltaWin,
+            const double dt,
+            const RTSeis::ProcessingMode mode = RTSeis::ProcessingMode::POST_PROCESSING,
+            const RTSeis::Precision precision = RTSeis::Precision::DOUBLE);
+        /*!
+         * @brief Default destructor.
+         * @ingroup rtseis_modules_zDetector_parameters
+         */
+        ~ZDetectorParameters(void);
+        /*!
+         * @brief Clears variables in class and restores defaults.
+         *        This class will have to be re-initialized to use again.
+         * @ingroup rtseis_modules_zDetector_parameters
+         */
+        void clear(void);
+        /*!
+         * @brief Determines if the class parameters are valid and can be
+         *        used to initialize the Z-detector.
+         * @retval True indicates that the parameters are valid.
+         * @retval False indicates that the parameters are invalid.
+         * @ingroup rtseis_modules_zDetector_parameters
+         */
+        bool isValid(void) const;
+        /*!
+         * @brief Sets the short-term and long-term window size in samples.
+         * @param[in] nsta  Number of samples in the short-term average
+         *                  window.  This must be positive.
+         * @param[in] nlta  Number of short-term averages from which the
+         *                  mean and standard deviation are computed.  This
+         *                  must be greater than nsta.
+         * @result 0 indicates success.  On failure the number of samples
+         *         in the short-term and long-term windows will remain
+         *         unchanged.
+         * @ingroup rtseis_modules_zDetector_parameters
+         */
+        int setShortTermAndLongTermWindowSize(const int nsta, const int nlta);
+        /*!
+         * @brief Sets the short-term and long-term window durations.
+         * @param[in] staWin  The short-term average window duration in
+         *                    seconds.  This must be non-negative.
+         * @param[in] ltaWin  The duration in seconds of the short-term averages
+         *                    from which the mean and standard deviation are
+         *                    computed.  This must be greater than the STA
+         *                    window length plus half the sampling period.
+         * @param[in] dt      The sampling period in seconds.  This must be
+         *                    positive.
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_zDetector_parameters
+         */
+        int setShortTermAndLongTermWindowSize(const double staWin,
+                                              const double ltaWin,
+                                              const double dt);
+        /*!
+         * @brief Gets the number of short-term averages from which the mean
+         *        and standard deviation are computed.
+         * @result The number of short-term averages.
+         * @ingroup rtseis_modules_zDetector_parameters
+         */
+        int getLongTermWindowSize(void) const;
+        /*!
+         * @brief Gets the number of samples in the short-term window.
+         * @result The number of samples in the short-term window.
+         * @ingroup rtseis_modules_zDetector_parameters
+         */
+        int getShortTermWindowSize(void) const;
+        /*!
+         * @brief Enables the class as being for real-time application or not.
+         * @param[in] mode  Indicates whether the module is for post-processing
+         *                  or real-time processing.
+         * @ingroup rtseis_modules_zDetector_parameters
+         */
+        void setProcessingMode(const RTSeis::ProcessingMode mode);
+        /*!
+         * @brief Determines if the class is for real-time application.
+         * @result The processing mode.
+         * @ingroup rtseis_modules_zDetector_parameters
+         */
+        RTSeis::ProcessingMode getProcessingMode(void) const;
+        /*!
+         * @brief Determines the precision of the class.
+         * @result The precision of the module.
+         * @ingroup rtseis_modules_zDetector_parameters
+         */
+        RTSeis::Precision getPrecision(void) const;
+    private:
+        /*!< Routine to validate the parameters. */
+        void validate_(void);
+        /*!< Default precision. */
+        const RTSeis::Precision defaultPrecision_ = RTSeis::Precision::DOUBLE;
+        /*!< The number of samples in the short term average window. */
+        int nsta_ = 0;
+        /*!< The number of short-term averages in the background window. */
+        int nlta_ = 0;
+        /*!< The precision of the module. */
+        RTSeis::Precision precision_ = defaultPrecision_;
+        /*!< Flag indicating this module is for real-time or post-processing. */
+        RTSeis::ProcessingMode processingMode_ = RTSeis::ProcessingMode::POST_PROCESSING;
+        /*!< Flag indicating that this is a valid module for processing. */
+        bool isValid_ = false;
+};
+
+/*!
+ * @defgroup rtseis_modules_zDetector Z-Detector
+ * @brief Computes the Z-detector (Swindell and Snell, 1977).  The
+ *        short-term average of the squared signal,
+ *        \f$ STA_i = \frac{1}{n_{sta}} \sum_{j=0}^{n_{sta}-1} x_{i-j}^2 \f$,
+ *        is standardized by the mean, \f$ \mu_i \f$, and standard
+ *        deviation, \f$ \sigma_i \f$, of the last \f$ n_{lta} \f$
+ *        short-term averages
+ *        \f[
+ *           Z_i = \frac{STA_i - \mu_i}{\sigma_i}.
+ *        \f]
+ *        The averages and moments are tabulated with running sums so the
+ *        cost per sample is independent of the window lengths.
+ * @note Unless initial conditions are set the first nsta + nlta - 2
+ *       outputs are 0 while the windows fill.  Where the short-term
+ *       averages are constant the standard deviation is 0 and the output
+ *       is 0.
+ * @ingroup rtseis_modules
+ * @copyright Ben Baker distributed under the MIT license.
+ */
+class ZDetector
+{
+     public:
+        /*!
+         * @brief Default constructor.  This module will not yet be usable
+         *        until the parameters are set.
+         * @ingroup rtseis_modules_zDetector
+         */
+        ZDetector(void);
+        /*!
+         * @brief Initializes the Z-detector from the parameters.
+         * @param[in] parameters  Parameters from which to initialize
+         *                        the Z-detector.
+         * @ingroup rtseis_modules_zDetector
+         */
+        ZDetector(const ZDetectorParameters &parameters);
+        /*!
+         * @brief Copy constructor.
+         * @param[in] zdetector  A Z-detector class from which this
+         *                       class is initialized.
+         * @ingroup rtseis_modules_zDetector
+         */
+        ZDetector(const ZDetector &zdetector);
+        /*!
+         * @brief Copy operator.
+         * @param[in] zdetector  A Z-detector class to copy.
+         * @result A deep copy of the input class.
+         * @ingroup rtseis_modules_zDetector
+         */
+        ZDetector& operator=(const ZDetector &zdetector);
+        /*!
+         * @brief Default destructor.
+         * @ingroup rtseis_modules_zDetector
+         */
+        ~ZDetector(void);
+        /*!
+         * @brief Returns the number of coefficients in the numerator initial
+         *        conditions array.
+         * @result The number of elements in the numerator initial condition
+         *         array which is nsta - 1.  If negative then an error has
+         *         occured.
+         * @ingroup rtseis_modules_zDetector
+         */
+        int getNumeratorInitialConditionLength(void) const;
+        /*!
+         * @brief Returns the number of coefficients in the denominator initial
+         *        conditions array.
+         * @result The number of elements in the denominator initial condition
+         *         array which is nlta - 1.  If negative then an error has
+         *         occured.
+         * @ingroup rtseis_modules_zDetector
+         */
+        int getDenominatorInitialConditionLength(void) const;
+        /*!
+         * @brief Sets the initial conditions on the filter.  The outputs are
+         *        computed from the first sample onward.
+         * @param[in] nzNum  The length of the numerator initial conditions
+         *                   array.
+         * @param[in] zNum   The squared samples immediately preceding the
+         *                   signal ordered from oldest to most recent.  This
+         *                   has dimension [nzNum].
+         * @param[in] nzDen  The length of the denominator initial conditions
+         *                   array.
+         * @param[in] zDen   The short-term averages immediately preceding the
+         *                   signal ordered from oldest to most recent.  This
+         *                   has dimension [nzDen].
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_zDetector
+         */
+        int setInitialConditions(const int nzNum, const double zNum[],
+                                 const int nzDen, const double zDen[]);
+        /*!
+         * @brief Computes the Z-detector of the input signal.
+         * @param[in] nx   Number of points in signal.
+         * @param[in] x    The signal of which to compute the Z-detector.  This
+         *                 has dimension [nx].
+         * @param[in] y    The Z-detector signal.  This has dimension [nx].
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_zDetector
+         */
+        int apply(const int nx, const double x[], double y[]);
+        /*!
+         * @brief Computes the Z-detector of the input signal.
+         * @param[in] nx   Number of points in signal.
+         * @param[in] x    The signal of which to compute the Z-detector.  This
+         *                 has dimension [nx].
+         * @param[in] y    The Z-detector signal.  This has dimension [nx].
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_zDetector
+         */
+        int apply(const int nx, const float x[], float y[]);
+        /*!
+         * @brief Computes the Z-detector of the input signal and scans it for
+         *        triggers.  The Z-detector is computed in small blocks that are
+         *        passed directly to the trigger so the full Z-detector signal
+         *        is never stored.
+         * @param[in] nx   Number of points in signal.
+         * @param[in] x    The signal of which to compute the Z-detector.  This has
+         *                 dimension [nx].
+         * @param[in,out] trigger  On input this is the initialized trigger.
+         *                         On exit its triggers have been updated as
+         *                         if ThresholdTrigger::apply() were called
+         *                         with the Z-detector signal.
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_zDetector
+         */
+        int apply(const int nx, const double x[], ThresholdTrigger *trigger);
+        /*!
+         * @brief Computes the Z-detector of the input signal and scans it for
+         *        triggers.
+         * @param[in] nx   Number of points in signal.
+         * @param[in] x    The signal of which to compute the Z-detector.  This has
+         *                 dimension [nx].
+         * @param[in,out] trigger  On input this is the initialized trigger.
+         *                         On exit its triggers have been updated as
+         *                         if ThresholdTrigger::apply() were called
+         *                         with the Z-detector signal.
+         * @result 0 indicates success.
+         * @ingroup rtseis_modules_zDetector
+         */
+        int apply(const int nx, const float x[], ThresholdTrigger *trigger);
+        /*!
+         * @brief Resets the filter to the initial conditions specified
+         *        by setInitialConditions() or the default initial conditions.
+         * @result 0 indicates success.
+         */
+        int resetInitialConditions(void);
+        /*!
+         * @brief Clears variables in class and restores defaults.
+         *        This class will have to be re-initialized to use again.
+         * @ingroup rtseis_modules_zDetector
+         */
+        void clear(void);
+        /*!
+         * @brief Determines if the class is initialized.
+         * @retval If true then the class is initialized.
+         */
+        bool isInitialized(void) const;
+    private:
+        class ZDetectorImpl;
+        std::unique_ptr<ZDetectorImpl> pZDetector_;
+};
+
+};
+};
+
+#endif
@@ -0,0 +1,325 @@
+#ifndef RTSEIS_PRIVATE_RUNNINGSUM_HPP
+#define RTSEIS_PRIVATE_RUNNINGSUM_HPP 1
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+namespace RTSeis
+{
+namespace Private
+{
+
+/*!
+ * @brief Adds a value to a sum with Neumaier's variant of Kahan summation.
+ * @param[in] value            The value to add.
+ * @param[in,out] sum          The uncompensated sum.
+ * @param[in,out] compensation The running compensation.  The sum is
+ *                             sum + compensation.
+ */
+inline void neumaierAdd(const double value, double *sum, double *compensation)
+{
+    auto t = *sum + value;
+    if (std::abs(*sum) >= std::abs(value))
+    {
+        *compensation = *compensation + ((*sum - t) + value);
+    }
+    else
+    {
+        *compensation = *compensation + ((value - t) + *sum);
+    }
+    *sum = t;
+}
+
+/*!
+ * @brief Tabulates the sum of the last n values in O(1) operations per
+ *        value.  The sum is compensated with Neumaier's variant of Kahan
+ *        summation and is recomputed from the window every n values so
+ *        that round-off, e.g., from evicting very large values, cannot
+ *        accumulate.
+ */
+class RunningSum
+{
+public:
+    /*!
+     * @brief Sets the window length.  The window is filled with zeros.
+     * @param[in] n  The window length.  This must be positive.
+     */
+    void initialize(const int n)
+    {
+        mRing.assign(n, 0);
+        mHead = 0;
+        mSum = 0;
+        mCompensation = 0;
+    }
+    /*!
+     * @brief Gets the window length.
+     */
+    int getLength() const noexcept
+    {
+        return static_cast<int> (mRing.size());
+    }
+    /*!
+     * @brief Sets the values in the window.
+     * @param[in] values  The values ordered from oldest to newest.  This
+     *                    has dimension [getLength()].
+     */
+    void setWindow(const double values[])
+    {
+        std::copy(values, values + mRing.size(), mRing.begin());
+        mHead = 0;
+        recompute();
+    }
+    /*!
+     * @brief Sets the newest values in the window.  The older slots are
+     *        zeroed.
+     * @param[in] nValues  The number of values.  This must be in the range
+     *                     [0, getLength()].
+     * @param[in] values   The values ordered from oldest to newest.  This
+     *                     has dimension [nValues].
+     */
+    void setWindow(const int nValues, const double values[])
+    {
+        auto nZero = mRing.size() - nValues;
+        std::fill(mRing.begin(), mRing.begin() + nZero, 0);
+        std::copy(values, values + nValues, mRing.begin() + nZero);
+        mHead = 0;
+        recompute();
+    }
+    /*!
+     * @brief Sets the newest values in the window to a constant.  The
+     *        older slots are zeroed.
+     * @param[in] nValues  The number of values.  This must be in the range
+     *                     [0, getLength()].
+     * @param[in] value    The value of each of the newest slots.
+     */
+    void fillWindow(const int nValues, const double value)
+    {
+        auto nZero = mRing.size() - nValues;
+        std::fill(mRing.begin(), mRing.begin() + nZero, 0);
+        std::fill(mRing.begin() + nZero, mRing.end(), value);
+        mHead = 0;
+        recompute();
+    }
+    /*!
+     * @brief Appends a value to the window.
+     * @param[in] value  The value to append.
+     * @result The value evicted from the window.
+     */
+    double push(const double value)
+    {
+        auto evicted = mRing[mHead];
+        add(value);
+        add(-evicted);
+        mRing[mHead] = value;
+        mHead = mHead + 1;
+        if (mHead == static_cast<int> (mRing.size()))
+        {
+            mHead = 0;
+            recompute();
+        }
+        return evicted;
+    }
+    /*!
+     * @brief Gets the sum of the values in the window.
+     */
+    double getSum() const noexcept
+    {
+        return mSum + mCompensation;
+    }
+private:
+    void add(const double value)
+    {
+        neumaierAdd(value, &mSum, &mCompensation);
+    }
+    void recompute()
+    {
+        mSum = 0;
+        mCompensation = 0;
+        for (const auto &r : mRing){add(r);}
+    }
+    /// The window.  mHead is the oldest value.
+    std::vector<double> mRing;
+    double mSum = 0;
+    double mCompensation = 0;
+    int mHead = 0;
+};
+
+/*!
+ * @brief Tabulates the average of the last n values with a running sum.
+ *        This is equivalent to a boxcar FIR filter whose initial conditions
+ *        are the n - 1 values preceding the signal.
+ */
+class RunningAverage
+{
+public:
+    /*!
+     * @brief Sets the window length and the initial conditions.
+     * @param[in] n   The window length.  This must be positive.
+     * @param[in] zi  The value of each initial condition.
+     */
+    void initialize(const int n, const double zi)
+    {
+        mSum.initialize(n);
+        mInitialConditions.clear();
+        mInitialValue = zi;
+        mDivisor = 1.0/static_cast<double> (n);
+        reset();
+    }
+    /*!
+     * @brief Gets the length of the initial conditions.
+     */
+    int getInitialConditionLength() const
+    {
+        return mSum.getLength() - 1;
+    }
+    /*!
+     * @brief Sets the initial conditions and resets the window.
+     * @param[in] zi  The values preceding the signal ordered from oldest
+     *                to newest.  This has dimension
+     *                [getInitialConditionLength()].
+     */
+    void setInitialConditions(const double zi[])
+    {
+        mInitialConditions.assign(zi, zi + getInitialConditionLength());
+        reset();
+    }
+    /*!
+     * @brief Fills the window with the initial conditions.  The oldest slot
+     *        is evicted by the first value and does not contribute.
+     */
+    void reset()
+    {
+        auto nz = getInitialConditionLength();
+        if (mInitialConditions.empty())
+        {
+            mSum.fillWindow(nz, mInitialValue);
+        }
+        else
+        {
+            mSum.setWindow(nz, mInitialConditions.data());
+        }
+    }
+    /*!
+     * @brief Appends a value to the window.
+     * @param[in] value  The value to append.
+     * @result The average of the window.
+     */
+    double push(const double value)
+    {
+        mSum.push(value);
+        return mSum.getSum()*mDivisor;
+    }
+private:
+    RunningSum mSum;
+    /// The values preceding the signal.  This is only allocated when they
+    /// are not all mInitialValue.
+    std::vector<double> mInitialConditions;
+    double mInitialValue = 0;
+    double mDivisor = 0;
+};
+
+/*!
+ * @brief Tabulates the mean and mean square of the last n values.  Both
+ *        sums are fed from a single window and are compensated and
+ *        periodically recomputed as in RunningSum.  As with RunningAverage
+ *        the initial conditions are the n - 1 values preceding the signal.
+ */
+class RunningMoments
+{
+public:
+    /*!
+     * @brief Sets the window length.  The initial conditions are zero.
+     * @param[in] n  The window length.  This must be positive.
+     */
+    void initialize(const int n)
+    {
+        mRing.assign(n, 0);
+        mInitialConditions.clear();
+        mDivisor = 1.0/static_cast<double> (n);
+        reset();
+    }
+    /*!
+     * @brief Gets the length of the initial conditions.
+     */
+    int getInitialConditionLength() const
+    {
+        return static_cast<int> (mRing.size()) - 1;
+    }
+    /*!
+     * @brief Sets the initial conditions and resets the window.
+     * @param[in] zi  The values preceding the signal ordered from oldest
+     *                to newest.  This has dimension
+     *                [getInitialConditionLength()].
+     */
+    void setInitialConditions(const double zi[])
+    {
+        mInitialConditions.assign(zi, zi + getInitialConditionLength());
+        reset();
+    }
+    /*!
+     * @brief Fills the window with the initial conditions.  The oldest slot
+     *        is evicted by the first value and does not contribute.
+     */
+    void reset()
+    {
+        std::fill(mRing.begin(), mRing.end(), 0);
+        if (!mInitialConditions.empty())
+        {
+            std::copy(mInitialConditions.begin(), mInitialConditions.end(),
+                      mRing.begin() + 1);
+        }
+        mHead = 0;
+        recompute();
+    }
+    /*!
+     * @brief Appends a value to the window.
+     * @param[in] value        The value to append.
+     * @param[out] mean        The mean of the window.
+     * @param[out] meanSquare  The mean of the squared values in the window.
+     */
+    void push(const double value, double *mean, double *meanSquare)
+    {
+        auto evicted = mRing[mHead];
+        neumaierAdd(value, &mSum, &mCompensation);
+        neumaierAdd(-evicted, &mSum, &mCompensation);
+        neumaierAdd(value*value, &mSumSquares, &mCompensationSquares);
+        neumaierAdd(-evicted*evicted, &mSumSquares, &mCompensationSquares);
+        mRing[mHead] = value;
+        mHead = mHead + 1;
+        if (mHead == static_cast<int> (mRing.size()))
+        {
+            mHead = 0;
+            recompute();
+        }
+        *mean = (mSum + mCompensation)*mDivisor;
+        *meanSquare = (mSumSquares + mCompensationSquares)*mDivisor;
+    }
+private:
+    void recompute()
+    {
+        mSum = 0;
+        mCompensation = 0;
+        mSumSquares = 0;
+        mCompensationSquares = 0;
+        for (const auto &r : mRing)
+        {
+            neumaierAdd(r, &mSum, &mCompensation);
+            neumaierAdd(r*r, &mSumSquares, &mCompensationSquares);
+        }
+    }
+    /// The window.  mHead is the oldest value.
+    std::vector<double> mRing;
+    /// The values preceding the signal.  This is only allocated when they
+    /// are set.
+    std::vector<double> mInitialConditions;
+    double mSum = 0;
+    double mCompensation = 0;
+    double mSumSquares = 0;
+    double mCompensationSquares = 0;
+    double mDivisor = 0;
+    int mHead = 0;
+};
+
+}
+}
+#endif
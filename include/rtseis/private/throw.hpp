@@ -3,6 +3,7 @@
 #include <cstring>
 #include <string>
 #include <exception>
+#include <stdexcept>
 
 #define ANSI_COLOR_RED     "\x1b[31m"
 #define ANSI_COLOR_GREEN   "\x1b[32m"
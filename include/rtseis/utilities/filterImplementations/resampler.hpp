@@ -0,0 +1,175 @@
+#ifndef RTSEIS_UTILITIES_FILTERIMPLEMENTATIONS_RESAMPLER_HPP
+#define RTSEIS_UTILITIES_FILTERIMPLEMENTATIONS_RESAMPLER_HPP 1
+#include <memory>
+#include "rtseis/enums.h"
+#include "rtseis/utilities/interpolation/enums.hpp"
+
+namespace RTSeis::Utilities::FilterImplementations
+{
+/*!
+ * @class Resampler resampler.hpp "include/rtseis/utilities/filterImplementations/resampler.hpp"
+ * @brief Resamples a signal by an arbitrary, possibly time-varying, ratio
+ *        of output to input sampling rates.  The k'th output sample is the
+ *        input signal evaluated at \f$ t_k = t_{k-1} + 1/r \f$ input
+ *        samples, where \f$ r \f$ is the current ratio and \f$ t_0 = 0 \f$
+ *        is the first input sample.  The signal is evaluated with an
+ *        interpolated polyphase windowed-sinc filter so each output sample
+ *        costs a few multiplies per tap regardless of the ratio.
+ * @note When downsampling the cutoff of the kernel is lowered to the output
+ *       Nyquist frequency to prevent aliasing and the kernel is widened by
+ *       the reciprocal of the ratio.  In real-time mode the position of the
+ *       next output sample and the last samples of the previous packet are
+ *       retained so packets can be processed as they arrive.  Since an
+ *       output sample requires the kernel's half-width of input samples
+ *       beyond it, it is emitted after those samples arrive.
+ * @copyright Ben Baker distributed under the MIT license.
+ * @ingroup rtseis_utils_filters
+ */
+template<class T = double>
+class Resampler
+{
+public:
+    /*! @name Constructors
+     * @{
+     */
+    /*!
+     * @brief Default constructor.
+     */
+    Resampler();
+    /*!
+     * @brief Copy constructor.
+     * @param[in] resampler  Resampler class from which to initialize.
+     */
+    Resampler(const Resampler &resampler);
+    /*!
+     * @brief Move constructor.
+     * @param[in,out] resampler  Resampler class to move to this class.
+     *                           On exit resampler's behavior is undefined.
+     */
+    Resampler(Resampler &&resampler) noexcept;
+    /*! @} */
+
+    /*! @name Operators
+     * @{
+     */
+    /*!
+     * @brief Copy assignment operator.
+     * @param[in] resampler  Resampler class to copy.
+     * @result A deep copy of the resampler class.
+     */
+    Resampler& operator=(const Resampler &resampler);
+    /*!
+     * @brief Move assignment operator.
+     * @param[in,out] resampler  On exit this will no longer be usable.
+     * @result A resampler class whose memory was moved from the input class.
+     */
+    Resampler& operator=(Resampler &&resampler) noexcept;
+    /*! @} */
+
+    /*! @name Destructors
+     * @{
+     */
+    /*!
+     * @brief Default destructor.
+     */
+    ~Resampler();
+    /*!
+     * @brief Clears the module and resets all parameters.
+     */
+    void clear() noexcept;
+    /*! @} */
+
+    /*!
+     * @brief Initializes the resampler.
+     * @param[in] ratio      The ratio of the output sampling rate to the
+     *                       input sampling rate.  For example, to resample
+     *                       a digitizer running at 99.998 Hz to 100 Hz this
+     *                       would be 100/99.998.  This must be positive.
+     * @param[in] mode       The processing mode.  By default this is for
+     *                       post-processing.
+     * @param[in] halfWidth  The half-width of the interpolating kernel in
+     *                       sinc lobes.  This must be positive.  When
+     *                       upsampling this is the half-width in input
+     *                       samples.  When downsampling the kernel spans
+     *                       ceil(halfWidth/ratio) input samples on either
+     *                       side so the transition band narrows with the
+     *                       output Nyquist frequency.  Each output sample
+     *                       costs 4 multiply-adds per input sample of
+     *                       half-width so, for example, a half-width of 4
+     *                       is four times cheaper than the default at the
+     *                       expense of a wider transition band and more
+     *                       passband ripple.
+     * @param[in] window     The window that tapers the interpolating kernel.
+     * @throws std::invalid_argument if any arguments are invalid or the
+     *         widened kernel is too long to tabulate.
+     */
+    void initialize(const double ratio,
+                    const RTSeis::ProcessingMode mode = RTSeis::ProcessingMode::POST_PROCESSING,
+                    const int halfWidth = 16,
+                    const RTSeis::Utilities::Interpolation::SincWindowType window = RTSeis::Utilities::Interpolation::SincWindowType::KAISER);
+    /*!
+     * @brief Determines if the module is initialized.
+     * @retval True indicates that the module is initialized.
+     */
+    bool isInitialized() const noexcept;
+    /*!
+     * @brief Changes the resampling ratio.  In real-time mode the new ratio
+     *        takes effect after the next output sample so the output is
+     *        continuous.  This is used to correct for a drifting digitizer
+     *        clock.
+     * @param[in] ratio  The ratio of the output sampling rate to the input
+     *                   sampling rate.  This must be positive.  The
+     *                   kernel's cutoff follows the output Nyquist
+     *                   frequency, min(1, ratio), and the kernel is
+     *                   tabulated again when the cutoff moves by more than
+     *                   0.1 percent.  The kernel's width is fixed by
+     *                   \c initialize() so ratios far below the initial
+     *                   ratio widen the transition band; in that case the
+     *                   module should be initialized again.
+     * @throws std::invalid_argument if ratio is not positive.
+     * @throws std::runtime_error if the module is not initialized.
+     */
+    void setRatio(const double ratio);
+    /*!
+     * @brief Gets the current resampling ratio.
+     * @result The ratio of the output to input sampling rates.
+     * @throws std::runtime_error if the module is not initialized.
+     */
+    double getRatio() const;
+    /*!
+     * @brief Estimates the space required to hold the resampled signal.
+     * @param[in] n  The length of the signal to resample.  This must be
+     *               non-negative.
+     * @result The maximum number of samples that will be output.
+     * @throws std::runtime_error if the module is not initialized.
+     * @throws std::invalid_argument if n is negative.
+     */
+    int estimateSpace(const int n) const;
+    /*!
+     * @brief Resamples the signal.
+     * @param[in] nx       The number of samples in x.
+     * @param[in] x        The signal to resample.  This is an array of
+     *                     dimension [nx].
+     * @param[in] ny       The maximum number of samples in y.  One can
+     *                     estimate ny by using \c estimateSpace().
+     * @param[out] nyOut   The number of defined samples in y.
+     * @param[out] y       The resampled signal.  This has dimension [ny]
+     *                     however only the first [nyOut] samples are
+     *                     defined.
+     * @throws std::invalid_argument if x or y is NULL or ny is too small.
+     * @throws std::runtime_error if the module is not initialized.
+     */
+    void apply(const int nx, const T x[],
+               const int ny, int *nyOut, T *y[]);
+    /*!
+     * @brief Resets the resampler so that the next input sample is the
+     *        first sample of a new signal.  The ratio is not changed.
+     * @throws std::runtime_error if the module is not initialized.
+     */
+    void resetInitialConditions();
+private:
+    class ResamplerImpl;
+    std::unique_ptr<ResamplerImpl> pImpl;
+};
+}
+#endif
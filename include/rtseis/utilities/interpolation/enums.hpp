@@ -0,0 +1,18 @@
+#ifndef RTSEIS_UTILITIES_INTERPOLATION_ENUMS_HPP
+#define RTSEIS_UTILITIES_INTERPOLATION_ENUMS_HPP 1
+
+namespace RTSeis::Utilities::Interpolation
+{
+/*!
+ * @brief Defines the window that tapers the sinc kernel of the windowed-sinc
+ *        interpolator.
+ */
+enum class SincWindowType
+{
+    LANCZOS, /*!< The Lanczos window, \f$ sinc(t/a) \f$, where \f$ a \f$ is
+                  the half-width of the kernel. */
+    KAISER   /*!< A Kaiser window.  This has lower sidelobes than the
+                  Lanczos window for the same half-width. */
+};
+}
+#endif
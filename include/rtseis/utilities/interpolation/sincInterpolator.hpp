@@ -0,0 +1,221 @@
+#ifndef RTSEIS_UTILITIES_INTERPOLATION_SINCINTERPOLATOR_HPP
+#define RTSEIS_UTILITIES_INTERPOLATION_SINCINTERPOLATOR_HPP 1
+#include <memory>
+#include "rtseis/enums.h"
+#include "rtseis/utilities/interpolation/enums.hpp"
+
+namespace RTSeis::Utilities::Interpolation
+{
+/*!
+ * @class SincInterpolator sincInterpolator.hpp "include/rtseis/utilities/interpolation/sincInterpolator.hpp"
+ * @brief Evaluates a regularly sampled signal at arbitrary abscissas with a
+ *        windowed-sinc kernel.  For a half-width \f$ a \f$ the signal at
+ *        \f$ t \f$, measured in samples, is
+ *        \f[
+ *           x(t) = \sum_{k=\lfloor t \rfloor - a + 1}^{\lfloor t \rfloor + a}
+ *                  x_k f_c sinc(f_c (t - k)) w \left( \frac{t-k}{a} \right)
+ *        \f]
+ *        where \f$ f_c \f$ is the cutoff as a fraction of the Nyquist
+ *        frequency and \f$ w \f$ is a Lanczos or Kaiser window.
+ * @note The kernel is tabulated at initialization at an oversampled set of
+ *       fractional sample positions and is linearly interpolated between
+ *       them so each point costs \f$ \mathcal{O}(a) \f$ operations.  Each
+ *       tabulated kernel is normalized to have unit gain at zero frequency.
+ *       Large batches of points are distributed over OpenMP threads.
+ * @copyright Ben Baker distributed under the MIT license.
+ * @ingroup rtseis_utils_math_interpolation
+ */
+template<class T = double>
+class SincInterpolator
+{
+public:
+    /*! @name Constructors
+     * @{
+     */
+    /*!
+     * @brief Default constructor.
+     */
+    SincInterpolator();
+    /*!
+     * @brief Copy constructor.
+     * @param[in] interpolator  Class from which to initialize.
+     */
+    SincInterpolator(const SincInterpolator &interpolator);
+    /*!
+     * @brief Move constructor.
+     * @param[in,out] interpolator  Class from which this class is
+     *                              initialized.  On exit interpolator's
+     *                              behavior is undefined.
+     */
+    SincInterpolator(SincInterpolator &&interpolator) noexcept;
+    /*! @} */
+
+    /*! @name Operators
+     * @{
+     */
+    /*!
+     * @brief Copy assignment operator.
+     * @param[in] interpolator  The interpolator to copy.
+     * @result A deep copy of the input class.
+     */
+    SincInterpolator& operator=(const SincInterpolator &interpolator);
+    /*!
+     * @brief Move assignment operator.
+     * @param[in,out] interpolator  On entry this is the class to move.  On
+     *                              exit interpolator's behavior is undefined.
+     * @result interpolator has been moved to this class.
+     */
+    SincInterpolator& operator=(SincInterpolator &&interpolator) noexcept;
+    /*! @} */
+
+    /*! @name Destructors
+     * @{
+     */
+    /*!
+     * @brief Destructor.
+     */
+    ~SincInterpolator();
+    /*!
+     * @brief Resets the module and releases all memory.
+     */
+    void clear() noexcept;
+    /*! @} */
+
+    /*! @name Initialization
+     * @{
+     */
+    /*!
+     * @brief Initializes the interpolator.
+     * @param[in] halfWidth   The half-width of the kernel, \f$ a \f$, in
+     *                        samples.  Each point is computed from
+     *                        2*halfWidth samples.  This must be positive.
+     * @param[in] window      The window that tapers the sinc.
+     * @param[in] cutoff      The cutoff as a fraction of the Nyquist
+     *                        frequency.  This must be in the range (0,1].
+     *                        Values less than 1 should be used when the
+     *                        signal is evaluated more coarsely than it was
+     *                        sampled.
+     * @param[in] mode        The processing mode.  In real-time mode the
+     *                        last samples of each packet are retained so
+     *                        that points can be evaluated across packets.
+     * @param[in] oversamplingFactor  The number of kernels tabulated per
+     *                                sample.  This must be positive.
+     * @param[in] kaiserBeta  The \f$ \beta \f$ parameter of the Kaiser
+     *                        window.  This must be non-negative and is not
+     *                        used by the Lanczos window.
+     * @throws std::invalid_argument if any arguments are invalid.
+     */
+    void initialize(const int halfWidth = 16,
+                    const SincWindowType window = SincWindowType::KAISER,
+                    const double cutoff = 1,
+                    const RTSeis::ProcessingMode mode = RTSeis::ProcessingMode::POST_PROCESSING,
+                    const int oversamplingFactor = 512,
+                    const double kaiserBeta = 8);
+    /*!
+     * @brief Determines whether or not the class is initialized.
+     * @retval True indicates that the class is initialized.
+     */
+    bool isInitialized() const noexcept;
+    /*! @} */
+
+    /*!
+     * @brief Gets the half-width of the kernel.
+     * @result The half-width of the kernel in samples.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    int getHalfWidth() const;
+    /*!
+     * @brief Changes the cutoff of the kernel.  The kernels are tabulated
+     *        again but the samples retained in real-time mode are kept so
+     *        the signal can be evaluated continuously across the change.
+     * @param[in] cutoff  The cutoff as a fraction of the Nyquist frequency.
+     *                    This must be in the range (0,1].
+     * @throws std::invalid_argument if cutoff is out of range.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void setCutoff(const double cutoff);
+    /*!
+     * @brief Gets the cutoff of the kernel.
+     * @result The cutoff as a fraction of the Nyquist frequency.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    double getCutoff() const;
+
+    /*! @name Initial Conditions
+     * @{
+     */
+    /*!
+     * @brief Gets the number of samples retained between packets in
+     *        real-time mode.
+     * @result The length of the initial conditions which is 2*halfWidth.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    int getInitialConditionLength() const;
+    /*!
+     * @brief Sets the samples that precede the first packet in real-time
+     *        mode.
+     * @param[in] nz  The number of initial conditions.  This must equal
+     *                \c getInitialConditionLength().
+     * @param[in] zi  The samples preceding the first packet in the order
+     *                they were recorded.  This is an array of dimension [nz].
+     * @throws std::invalid_argument if nz is invalid or zi is NULL.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void setInitialConditions(const int nz, const double zi[]);
+    /*!
+     * @brief Resets the retained samples to the initial conditions set by
+     *        \c setInitialConditions().  If no initial conditions were set
+     *        then the retained samples are zeroed.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void resetInitialConditions();
+    /*! @} */
+
+    /*! @name Interpolation
+     * @{
+     */
+    /*!
+     * @brief Evaluates the signal at arbitrary points.
+     * @param[in] nx   The number of samples in x.
+     * @param[in] x    The signal.  This is an array of dimension [nx].
+     * @param[in] nq   The number of points at which to evaluate the signal.
+     *                 If this is not positive then nothing happens though,
+     *                 in real-time mode, x is still retained.
+     * @param[in] xq   The points, measured in samples from x[0], at which to
+     *                 evaluate the signal.  This is an array of dimension
+     *                 [nq].  In post-processing mode the signal is zero
+     *                 outside of [0, nx-1].  In real-time mode the samples
+     *                 from the previous packets precede x[0] so each point
+     *                 must be in the range [-halfWidth, nx - halfWidth).
+     * @param[out] yq  The signal evaluated at xq.  This is an array of
+     *                 dimension [nq].
+     * @throws std::invalid_argument if any arguments are invalid.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void interpolate(const int nx, const T x[],
+                     const int nq, const double xq[], T *yq[]);
+    /*!
+     * @brief Evaluates the signal at regularly spaced points.
+     * @param[in] nx     The number of samples in x.
+     * @param[in] x      The signal.  This is an array of dimension [nx].
+     * @param[in] nq     The number of points at which to evaluate the signal.
+     * @param[in] start  The first point, measured in samples from x[0].
+     * @param[in] step   The spacing of the points in samples.  The i'th
+     *                   point is start + i*step.  This must be positive.
+     *                   The points must satisfy the same range requirements
+     *                   as in the irregularly spaced case.
+     * @param[out] yq    The signal evaluated at the points.  This is an array
+     *                   of dimension [nq].
+     * @throws std::invalid_argument if any arguments are invalid.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void interpolate(const int nx, const T x[],
+                     const int nq, const double start, const double step,
+                     T *yq[]);
+    /*! @} */
+private:
+    class SincInterpolatorImpl;
+    std::unique_ptr<SincInterpolatorImpl> pImpl;
+};
+}
+#endif
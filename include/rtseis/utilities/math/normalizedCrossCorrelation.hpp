@@ -0,0 +1,158 @@
+#ifndef RTSEIS_UTILITIES_MATH_NORMALIZEDCROSSCORRELATION_HPP
+#define RTSEIS_UTILITIES_MATH_NORMALIZEDCROSSCORRELATION_HPP 1
+#include <memory>
+#include "rtseis/enums.h"
+#include "rtseis/utilities/math/convolve.hpp"
+
+namespace RTSeis::Utilities::Math::Convolve
+{
+/*!
+ * @class NormalizedCrossCorrelation normalizedCrossCorrelation.hpp "include/rtseis/utilities/math/normalizedCrossCorrelation.hpp"
+ * @brief Slides a template of length \f$ m \f$ along a signal and computes
+ *        the normalized cross-correlation of the template with the window
+ *        ending at each sample, i.e.,
+ *        \f[
+ *           y[k] = \frac{ \sum_{i=0}^{m-1} t_i x_{k-m+1+i} }
+ *                       { \| t \| \sqrt{ \sum_{i=0}^{m-1} x_{k-m+1+i}^2 } }
+ *        \f]
+ *        which is in [-1,1].  The window preceding the first sample is
+ *        filled with the initial conditions.  Hence, this behaves like an
+ *        FIR filter: in post-processing every call begins from the initial
+ *        conditions whereas in real-time the last \f$ m - 1 \f$ samples of
+ *        a packet become the initial conditions of the next packet.
+ * @note The numerator is computed with \c correlate() with either
+ *       implementation.  The window energies in the denominator are
+ *       maintained with compensated running sums so that each lag costs
+ *       \f$ \mathcal{O}(1) \f$ rather than \f$ \mathcal{O}(m) \f$.  A
+ *       window whose energy is at the round-off level of the energy of the
+ *       preceding \f$ 2m \f$ samples, e.g., a run of zeros, is set to 0.
+ *       The signal is not demeaned so, for a correlation coefficient, the
+ *       template and signal should be demeaned or highpass filtered first.
+ * @ingroup rtseis_utils_math_convolve
+ * @sa correlate
+ */
+class NormalizedCrossCorrelation
+{
+public:
+    /*! @name Constructors
+     * @{
+     */
+    /*!
+     * @brief Default constructor.
+     */
+    NormalizedCrossCorrelation();
+    /*!
+     * @brief Copy constructor.
+     * @param[in] ncc  Class from which to initialize.
+     */
+    NormalizedCrossCorrelation(const NormalizedCrossCorrelation &ncc);
+    /*!
+     * @brief Move constructor.
+     * @param[in,out] ncc  Class from which this class is initialized.
+     *                     On exit ncc's behavior is undefined.
+     */
+    NormalizedCrossCorrelation(NormalizedCrossCorrelation &&ncc) noexcept;
+    /*! @} */
+
+    /*! @name Operators
+     * @{
+     */
+    /*!
+     * @brief Copy assignment operator.
+     * @param[in] ncc  Normalized cross-correlation class to copy.
+     * @result A deep copy of the input class.
+     */
+    NormalizedCrossCorrelation&
+        operator=(const NormalizedCrossCorrelation &ncc);
+    /*!
+     * @brief Move assignment operator.
+     * @param[in,out] ncc  On entry this is the class to move.  On exit
+     *                     ncc's behavior is undefined.
+     * @result ncc has been moved to this class.
+     */
+    NormalizedCrossCorrelation&
+        operator=(NormalizedCrossCorrelation &&ncc) noexcept;
+    /*! @} */
+
+    /*! @name Destructors
+     * @{
+     */
+    /*!
+     * @brief Destructor.
+     */
+    ~NormalizedCrossCorrelation();
+    /*!
+     * @brief Resets the module and releases all memory.
+     */
+    void clear() noexcept;
+    /*! @} */
+
+    /*!
+     * @brief Initializes the normalized cross-correlation.
+     * @param[in] nt    The number of samples in the template.  This must be
+     *                  positive.
+     * @param[in] t     The template.  This is an array of dimension [nt]
+     *                  and cannot be all zeros.
+     * @param[in] mode  The processing mode.  By default this is for
+     *                  post-processing.
+     * @param[in] implementation  Defines the implementation of the
+     *                            correlation.
+     * @throws std::invalid_argument if any of the arguments are invalid.
+     */
+    void initialize(const int nt, const double t[],
+                    const RTSeis::ProcessingMode mode = RTSeis::ProcessingMode::POST_PROCESSING,
+                    const Implementation implementation = Implementation::AUTO);
+    /*!
+     * @brief Determines if the module is initialized.
+     * @retval True indicates that the module is initialized.
+     */
+    bool isInitialized() const noexcept;
+    /*!
+     * @brief Gets the number of samples in the template.
+     * @result The template length.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    int getTemplateLength() const;
+    /*!
+     * @brief Gets the length of the initial conditions.
+     * @result The length of the initial condition array.  This is one less
+     *         than the template length.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    int getInitialConditionLength() const;
+    /*!
+     * @brief Sets the initial conditions.  This should be called prior to
+     *        application as it will reset the running sums.
+     * @param[in] nz  The initial condition length.  This should be equal to
+     *                \c getInitialConditionLength().
+     * @param[in] zi  The samples preceding the signal ordered from oldest to
+     *                newest.  This has dimension [nz].
+     * @throws std::invalid_argument if nz is invalid or nz is positive and
+     *         zi is NULL.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void setInitialConditions(const int nz, const double zi[]);
+    /*!
+     * @brief Resets the initial conditions to the default initial
+     *        conditions, which are zero, or the initial conditions set when
+     *        \c setInitialConditions() was called.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void resetInitialConditions();
+    /*!
+     * @brief Computes the normalized cross-correlation.
+     * @param[in] n   The number of points in the signal.
+     * @param[in] x   The signal.  This has dimension [n].
+     * @param[out] y  The normalized cross-correlation of the template with
+     *                the window ending at each sample of x.  This has
+     *                dimension [n].
+     * @throws std::invalid_argument if n is positive and x or y is NULL.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void apply(const int n, const double x[], double *y[]);
+private:
+    class NormalizedCrossCorrelationImpl;
+    std::unique_ptr<NormalizedCrossCorrelationImpl> pImpl;
+};
+}
+#endif
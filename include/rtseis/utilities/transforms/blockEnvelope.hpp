@@ -0,0 +1,205 @@
+#ifndef RTSEIS_UTILITIES_TRANSFORMS_BLOCKENVELOPE_HPP
+#define RTSEIS_UTILITIES_TRANSFORMS_BLOCKENVELOPE_HPP 1
+#include <memory>
+
+namespace RTSeis::Utilities::Transforms
+{
+/*!
+ * @class BlockEnvelope blockEnvelope.hpp "include/rtseis/utilities/transforms/blockEnvelope.hpp"
+ * @brief Computes the envelope of a long signal from the analytic signal of
+ *        overlapping blocks.  This is an overlap-save variant of
+ *        \c Envelope for records that are too long to transform at once.
+ *        The signal is divided into blocks of a caller-specified size.
+ *        The analytic signal of each block is computed from a window that
+ *        extends the block by at least overlap samples on either side, the
+ *        outer half of each overlap is tapered with a cosine, and only the
+ *        envelope of the central block is retained.  Hence, the workspace
+ *        is proportional to the block size rather than the record length
+ *        and the blocks are processed in parallel when OpenMP is enabled.
+ * @note The mean of the entire signal is removed prior to transforming and
+ *       restored afterwards, as in \c Envelope.  The Hilbert transform's
+ *       impulse response decays like \f$ 1/t \f$ so the truncation error
+ *       decays with the overlap.  For a broadband signal and an overlap of
+ *       a few hundred samples the mean absolute difference from the
+ *       full-length envelope is about 1 percent of the signal's peak
+ *       amplitude and the maximum difference is a few percent.  This holds
+ *       for samples at least overlap samples from either end of the record.
+ *       Near the ends the full-length result is contaminated by the DFT's
+ *       circular wraparound whereas this class zero-pads.  \c transform()
+ *       requires the entire record.  For unbounded streams, \c update()
+ *       accepts the signal in chunks and carries the overlap between calls.
+ * @ingroup rtseis_utils_transforms
+ * @sa Envelope
+ */
+template<class T = double>
+class BlockEnvelope
+{
+public:
+    /*! @name Constructors
+     * @{
+     */
+    /*!
+     * @brief Default constructor.
+     */
+    BlockEnvelope();
+    /*!
+     * @brief Copy constructor.
+     * @param[in] envelope  Class from which to initialize.
+     */
+    BlockEnvelope(const BlockEnvelope &envelope);
+    /*!
+     * @brief Move constructor.
+     * @param[in,out] envelope  Class from which this class is initialized.
+     *                          On exit envelope's behavior is undefined.
+     */
+    BlockEnvelope(BlockEnvelope &&envelope) noexcept;
+    /*! @} */
+
+    /*! @name Operators
+     * @{
+     */
+    /*!
+     * @brief Copy assignment operator.
+     * @param[in] envelope  Block envelope class to copy.
+     * @result A deep copy of the input class.
+     */
+    BlockEnvelope& operator=(const BlockEnvelope &envelope);
+    /*!
+     * @brief Move assignment operator.
+     * @param[in,out] envelope  On entry this is the class to move.  On exit
+     *                          envelope's behavior is undefined.
+     * @result envelope has been moved to this class.
+     */
+    BlockEnvelope& operator=(BlockEnvelope &&envelope) noexcept;
+    /*! @} */
+
+    /*! @name Destructors
+     * @{
+     */
+    /*!
+     * @brief Destructor.
+     */
+    ~BlockEnvelope();
+    /*!
+     * @brief Resets the module and releases all memory.
+     */
+    void clear() noexcept;
+    /*! @} */
+
+    /*!
+     * @brief Initializes the block envelope.
+     * @param[in] blockSize  The number of envelope samples retained from each
+     *                       block.  This must be positive.
+     * @param[in] overlap    The minimum number of samples on either side of
+     *                       a block that are included in the block's
+     *                       transform.  This cannot be negative.
+     * @throws std::invalid_argument if any arguments are invalid.
+     */
+    void initialize(const int blockSize, const int overlap);
+    /*!
+     * @brief Checks if the class is initialized.
+     * @result True indicates that the class is initialized.
+     */
+    bool isInitialized() const noexcept;
+    /*!
+     * @brief Gets the block size.
+     * @result The number of envelope samples retained from each block.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    int getBlockSize() const;
+    /*!
+     * @brief Gets the length of each block's transform.
+     * @result The transform length.  This is the smallest length at least
+     *         blockSize + 2*overlap for which the DFT is efficient.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    int getTransformLength() const;
+
+    /*!
+     * @brief Computes the upper envelope of the signal.
+     * @param[in] n       The number of samples in the signal.
+     * @param[in] x       The signal to transform.  This is an array whose
+     *                    dimension is [n].
+     * @param[out] yupper The upper envelope of x.  This is an array whose
+     *                    dimension is [n].
+     * @throws std::invalid_argument if n is positive and x or yupper is NULL.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void transform(const int n, const T x[], T *yupper[]);
+    /*!
+     * @brief Computes the upper and lower envelopes of the signal.
+     * @param[in] n       The number of samples in the signal.
+     * @param[in] x       The signal to transform.  This is an array whose
+     *                    dimension is [n].
+     * @param[out] yupper The upper envelope of x.  This is an array whose
+     *                    dimension is [n].
+     * @param[out] ylower The lower envelope of x.  This is an array whose
+     *                    dimension is [n].
+     * @throws std::invalid_argument if n is positive and x, yupper, or
+     *         ylower is NULL.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void transform(const int n, const T x[], T *yupper[], T *ylower[]);
+
+    /*! @name Streaming
+     * @{
+     */
+    /*!
+     * @brief Gets the number of samples that must follow a block before
+     *        its envelope can be computed when streaming.
+     * @result The latency in samples.  This is the transform length less
+     *         the block size and the left overlap, i.e., at least overlap.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    int getLatency() const;
+    /*!
+     * @brief Appends a chunk of a stream and computes the upper envelope of
+     *        every block whose transform window is now complete.  Only the
+     *        samples needed by the next block's window are retained between
+     *        calls so the memory is proportional to the transform length.
+     * @param[in] n      The number of samples in the chunk.
+     * @param[in] x      The chunk.  This is an array of dimension [n].
+     * @param[in] maxy   The maximum number of samples that yupper can hold.
+     *                   n + getBlockSize() + getLatency() always suffices.
+     * @param[out] yupper  The upper envelope of the next samples of the
+     *                     stream.  This is an array of dimension [maxy]
+     *                     however only the first (returned) samples are
+     *                     defined.  The envelope lags the stream by up to
+     *                     getBlockSize() + getLatency() samples.
+     * @result The number of envelope samples written to yupper.
+     * @throws std::invalid_argument if n is positive and x or yupper is NULL
+     *         or maxy is too small.
+     * @throws std::runtime_error if the class is not initialized.
+     * @note Each window is demeaned with the mean of the stream samples in
+     *       that window rather than of the entire record.  Hence, where the
+     *       mean drifts the result differs slightly from \c transform().
+     */
+    int update(const int n, const T x[], const int maxy, T *yupper[]);
+    /*!
+     * @brief Ends the stream.  The envelope of the samples that have not
+     *        yet been output is computed by zero-padding the stream, as
+     *        \c transform() does at the end of a record, and the stream is
+     *        reset.
+     * @param[in] maxy     The maximum number of samples that yupper can
+     *                     hold.  getBlockSize() + getLatency() always
+     *                     suffices.
+     * @param[out] yupper  The upper envelope of the remaining samples.  This
+     *                     is an array of dimension [maxy] however only the
+     *                     first (returned) samples are defined.
+     * @result The number of envelope samples written to yupper.
+     * @throws std::invalid_argument if yupper is NULL or maxy is too small.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    int flush(const int maxy, T *yupper[]);
+    /*!
+     * @brief Discards the buffered samples of the stream.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void resetStream();
+    /*! @} */
+private:
+    class BlockEnvelopeImpl;
+    std::unique_ptr<BlockEnvelopeImpl> pImpl;
+};
+}
+#endif
@@ -0,0 +1,200 @@
+#ifndef RTSEIS_UTILITIES_TRANSFORMS_CHIRPZTRANSFORM_HPP
+#define RTSEIS_UTILITIES_TRANSFORMS_CHIRPZTRANSFORM_HPP 1
+#include <memory>
+#include <complex>
+
+namespace RTSeis::Utilities::Transforms
+{
+/*!
+ * @class ChirpZTransform chirpZTransform.hpp "include/rtseis/utilities/transforms/chirpZTransform.hpp"
+ * @brief Computes the chirp-z transform of a signal.  For a signal
+ *        \f$ x \f$ of length \f$ N \f$ this evaluates the z-transform at the
+ *        \f$ M \f$ points \f$ z_k = A W^{-k} \f$ on a spiral arc, i.e.,
+ *        \f[
+ *           X_k = \sum_{n=0}^{N-1} x[n] A^{-n} W^{nk}, \quad k=0,\dots,M-1.
+ *        \f]
+ *        With \f$ A = e^{2 \pi i f_1/f_s} \f$ and
+ *        \f$ W = e^{-2 \pi i (f_2 - f_1)/((M-1) f_s)} \f$ this is a zoom
+ *        transform that evaluates the spectrum at \f$ M \f$ equally spaced
+ *        frequencies in \f$ [f_1, f_2] \f$.  Hence, fine frequency resolution
+ *        in a narrow band does not require zero-padding the signal to an
+ *        enormous length.
+ * @note The transform is computed with Bluestein's algorithm so that the
+ *       cost is that of three DFTs whose length is the next 7-smooth number
+ *       at least \f$ N + M - 1 \f$,
+ *       i.e., \f$ \mathcal{O}((N+M) \log(N+M)) \f$.  The chirps are tabulated
+ *       when the class is initialized.
+ * @ingroup rtseis_utils_transforms
+ */
+template<class T = double>
+class ChirpZTransform
+{
+public:
+    /*! @name Constructors
+     * @{
+     */
+    /*!
+     * @brief Default constructor.
+     */
+    ChirpZTransform();
+    /*!
+     * @brief Copy constructor.
+     * @param[in] czt  Class from which to initialize.
+     */
+    ChirpZTransform(const ChirpZTransform &czt);
+    /*!
+     * @brief Move constructor.
+     * @param[in,out] czt  Class from which this class is initialized.
+     *                     On exit czt's behavior is undefined.
+     */
+    ChirpZTransform(ChirpZTransform &&czt) noexcept;
+    /*! @} */
+
+    /*! @name Operators
+     * @{
+     */
+    /*!
+     * @brief Copy assignment operator.
+     * @param[in] czt  Chirp-z transform class to copy.
+     * @result A deep copy of the input class.
+     */
+    ChirpZTransform& operator=(const ChirpZTransform &czt);
+    /*!
+     * @brief Move assignment operator.
+     * @param[in,out] czt  On entry this is the class to move.  On exit
+     *                     czt's behavior is undefined.
+     * @result czt has been moved to this class.
+     */
+    ChirpZTransform& operator=(ChirpZTransform &&czt) noexcept;
+    /*! @} */
+
+    /*! @name Destructors
+     * @{
+     */
+    /*!
+     * @brief Destructor.
+     */
+    ~ChirpZTransform();
+    /*!
+     * @brief Resets the module and releases all memory.
+     */
+    void clear() noexcept;
+    /*! @} */
+
+    /*! @name Initialization
+     * @{
+     */
+    /*!
+     * @brief Initializes the chirp-z transform for an arbitrary spiral arc.
+     * @param[in] nSamples  The number of samples in the input signal.  This
+     *                      must be positive.
+     * @param[in] nOutput   The number of points, M, at which to evaluate the
+     *                      z-transform.  This must be positive.
+     * @param[in] w         The ratio between consecutive points on the arc.
+     *                      This cannot be zero.
+     * @param[in] a         The starting point on the arc.  This cannot be
+     *                      zero.
+     * @throws std::invalid_argument if any arguments are invalid.
+     */
+    void initialize(const int nSamples,
+                    const int nOutput,
+                    const std::complex<double> &w,
+                    const std::complex<double> &a);
+    /*!
+     * @brief Initializes the chirp-z transform so that it evaluates the
+     *        spectrum at equally spaced frequencies on the unit circle.
+     * @param[in] nSamples      The number of samples in the input signal.
+     *                          This must be positive.
+     * @param[in] nFrequencies  The number of frequencies at which to evaluate
+     *                          the spectrum.  This must be positive.
+     * @param[in] minimumFrequency  The first frequency (Hz).
+     * @param[in] maximumFrequency  The last frequency (Hz).  If nFrequencies
+     *                              exceeds 1 then this must be greater than
+     *                              minimumFrequency.  Otherwise, it is
+     *                              ignored.
+     * @param[in] samplingRate  The sampling rate in Hz.  This must be
+     *                          positive.
+     * @throws std::invalid_argument if any arguments are invalid.
+     */
+    void initialize(const int nSamples,
+                    const int nFrequencies,
+                    const double minimumFrequency,
+                    const double maximumFrequency,
+                    const double samplingRate = 1.0);
+    /*!
+     * @brief Determines whether or not the class is initialized.
+     * @retval True indicates that the class is initialized.
+     */
+    bool isInitialized() const noexcept;
+    /*! @} */
+
+    /*!
+     * @brief Gets the maximum number of samples in the input signal.
+     * @result The input signal length.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    int getInputLength() const;
+    /*!
+     * @brief Gets the number of points at which the z-transform is
+     *        evaluated.
+     * @result The transform length, M.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    int getTransformLength() const;
+    /*!
+     * @brief Gets the frequencies at which the spectrum is evaluated.
+     * @param[in] nFrequencies  The number of frequencies.  This must equal
+     *                          \c getTransformLength().
+     * @param[out] frequencies  The frequencies (Hz).  This is an array of
+     *                          dimension [nFrequencies].
+     * @throws std::invalid_argument if nFrequencies is invalid or frequencies
+     *         is NULL.
+     * @throws std::runtime_error if the class was not initialized with
+     *         the frequency band.
+     */
+    void getFrequencies(const int nFrequencies, double *frequencies[]) const;
+
+    /*! @name Transform
+     * @{
+     */
+    /*!
+     * @brief Computes the chirp-z transform of a real signal.
+     * @param[in] n     The number of samples in x.  This cannot exceed
+     *                  \c getInputLength().  If n is less than the input
+     *                  length then x will be zero-padded.
+     * @param[in] x     The signal to transform.  This is an array of
+     *                  dimension [n].
+     * @param[in] maxy  The maximum number of points allocated to y.  This
+     *                  must be at least \c getTransformLength().
+     * @param[out] y    The chirp-z transform.  This is an array of dimension
+     *                  [maxy] however only the first \c getTransformLength()
+     *                  points are defined.
+     * @throws std::invalid_argument if any arguments are invalid.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void transform(const int n, const T x[],
+                   const int maxy, std::complex<T> *y[]);
+    /*!
+     * @brief Computes the chirp-z transform of a complex signal.
+     * @param[in] n     The number of samples in x.  This cannot exceed
+     *                  \c getInputLength().  If n is less than the input
+     *                  length then x will be zero-padded.
+     * @param[in] x     The signal to transform.  This is an array of
+     *                  dimension [n].
+     * @param[in] maxy  The maximum number of points allocated to y.  This
+     *                  must be at least \c getTransformLength().
+     * @param[out] y    The chirp-z transform.  This is an array of dimension
+     *                  [maxy] however only the first \c getTransformLength()
+     *                  points are defined.
+     * @throws std::invalid_argument if any arguments are invalid.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void transform(const int n, const std::complex<T> x[],
+                   const int maxy, std::complex<T> *y[]);
+    /*! @} */
+private:
+    class ChirpZTransformImpl;
+    std::unique_ptr<ChirpZTransformImpl> pImpl;
+};
+}
+#endif
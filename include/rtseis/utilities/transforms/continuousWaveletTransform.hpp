@@ -0,0 +1,210 @@
+#ifndef RTSEIS_UTILITIES_TRANSFORMS_CONTINUOUSWAVELETTRANSFORM_HPP
+#define RTSEIS_UTILITIES_TRANSFORMS_CONTINUOUSWAVELETTRANSFORM_HPP 1
+#include <memory>
+#include <complex>
+#include "rtseis/utilities/transforms/enums.hpp"
+
+namespace RTSeis::Utilities::Transforms
+{
+/*!
+ * @class ContinuousWaveletTransform continuousWaveletTransform.hpp "include/rtseis/utilities/transforms/continuousWaveletTransform.hpp"
+ * @brief Computes the continuous wavelet transform of a signal following
+ *        Torrence and Compo (1998).  For a scale \f$ s \f$ the transform is
+ *        \f[
+ *           W_n(s) = \sum_{k} \hat{x}_k \hat{\psi}^*(s \omega_k)
+ *                    e^{i \omega_k n \Delta t}
+ *        \f]
+ *        where \f$ \hat{x}_k \f$ is the DFT of the signal and
+ *        \f$ \hat{\psi} \f$ is the Fourier transform of the mother wavelet
+ *        normalized to have unit energy at each scale.
+ * @note The signal is zero-padded to at least twice its length to suppress
+ *       wraparound and is transformed once.  The wavelet spectra for every
+ *       scale are tabulated when the class is initialized and the inverse
+ *       transforms are distributed over OpenMP threads.
+ * @ingroup rtseis_utils_transforms
+ */
+template<class T = double>
+class ContinuousWaveletTransform
+{
+public:
+    /*! @name Constructors
+     * @{
+     */
+    /*!
+     * @brief Default constructor.
+     */
+    ContinuousWaveletTransform();
+    /*!
+     * @brief Copy constructor.
+     * @param[in] cwt  Class from which to initialize.
+     */
+    ContinuousWaveletTransform(const ContinuousWaveletTransform &cwt);
+    /*!
+     * @brief Move constructor.
+     * @param[in,out] cwt  Class from which this class is initialized.
+     *                     On exit cwt's behavior is undefined.
+     */
+    ContinuousWaveletTransform(ContinuousWaveletTransform &&cwt) noexcept;
+    /*! @} */
+
+    /*! @name Operators
+     * @{
+     */
+    /*!
+     * @brief Copy assignment operator.
+     * @param[in] cwt  Continuous wavelet transform class to copy.
+     * @result A deep copy of the input class.
+     */
+    ContinuousWaveletTransform& operator=(const ContinuousWaveletTransform &cwt);
+    /*!
+     * @brief Move assignment operator.
+     * @param[in,out] cwt  On entry this is the class to move.  On exit cwt's
+     *                     behavior is undefined.
+     * @result cwt has been moved to this class.
+     */
+    ContinuousWaveletTransform& operator=(ContinuousWaveletTransform &&cwt) noexcept;
+    /*! @} */
+
+    /*! @name Destructors
+     * @{
+     */
+    /*!
+     * @brief Destructor.
+     */
+    ~ContinuousWaveletTransform();
+    /*!
+     * @brief Resets the module and releases all memory.
+     */
+    void clear() noexcept;
+    /*! @} */
+
+    /*! @name Initialization
+     * @{
+     */
+    /*!
+     * @brief Initializes the continuous wavelet transform.
+     * @param[in] nSamples      The number of samples in the signal.  This
+     *                          must be at least 2.
+     * @param[in] nScales       The number of scales.  This must be positive.
+     * @param[in] scales        The wavelet scales in seconds.  This is an
+     *                          array of dimension [nScales] and each scale
+     *                          must be positive.
+     * @param[in] wavelet       The mother wavelet.
+     * @param[in] samplingRate  The sampling rate in Hz.  This must be
+     *                          positive.
+     * @param[in] waveletParameter  The wavelet's parameter.  For the Morlet
+     *                              wavelet this is the non-dimensional
+     *                              frequency and for the Paul wavelet this is
+     *                              the integer order.  If this is not
+     *                              positive then the default for the wavelet
+     *                              is used.
+     * @throws std::invalid_argument if any arguments are invalid.
+     */
+    void initialize(const int nSamples,
+                    const int nScales,
+                    const double scales[],
+                    const ContinuousWaveletType wavelet = ContinuousWaveletType::MORLET,
+                    const double samplingRate = 1.0,
+                    const double waveletParameter = 0);
+    /*!
+     * @brief Initializes the continuous wavelet transform with
+     *        logarithmically spaced scales.
+     * @param[in] nSamples      The number of samples in the signal.  This
+     *                          must be at least 2.
+     * @param[in] nScales       The number of scales.  This must be positive.
+     * @param[in] minimumScale  The smallest scale in seconds.  This must be
+     *                          positive.
+     * @param[in] maximumScale  The largest scale in seconds.  If nScales
+     *                          exceeds 1 then this must exceed minimumScale.
+     * @param[in] wavelet       The mother wavelet.
+     * @param[in] samplingRate  The sampling rate in Hz.  This must be
+     *                          positive.
+     * @param[in] waveletParameter  The wavelet's parameter.  If this is not
+     *                              positive then the default for the wavelet
+     *                              is used.
+     * @throws std::invalid_argument if any arguments are invalid.
+     */
+    void initialize(const int nSamples,
+                    const int nScales,
+                    const double minimumScale,
+                    const double maximumScale,
+                    const ContinuousWaveletType wavelet = ContinuousWaveletType::MORLET,
+                    const double samplingRate = 1.0,
+                    const double waveletParameter = 0);
+    /*!
+     * @brief Determines whether or not the class is initialized.
+     * @retval True indicates that the class is initialized.
+     */
+    bool isInitialized() const noexcept;
+    /*! @} */
+
+    /*!
+     * @brief Gets the number of samples in the signal.
+     * @result The number of samples.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    int getNumberOfSamples() const;
+    /*!
+     * @brief Gets the number of scales.
+     * @result The number of scales.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    int getNumberOfScales() const;
+    /*!
+     * @brief Gets the scales.
+     * @param[in] nScales  The number of scales.  This must equal
+     *                     \c getNumberOfScales().
+     * @param[out] scales  The scales in seconds.  This is an array of
+     *                     dimension [nScales].
+     * @throws std::invalid_argument if nScales is invalid or scales is NULL.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void getScales(const int nScales, double *scales[]) const;
+    /*!
+     * @brief Gets the Fourier frequency corresponding to each scale.
+     * @param[in] nScales      The number of scales.  This must equal
+     *                         \c getNumberOfScales().
+     * @param[out] frequencies The frequencies in Hz.  This is an array of
+     *                         dimension [nScales].
+     * @throws std::invalid_argument if nScales is invalid or frequencies
+     *         is NULL.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void getFrequencies(const int nScales, double *frequencies[]) const;
+
+    /*! @name Transform
+     * @{
+     */
+    /*!
+     * @brief Computes the continuous wavelet transform.
+     * @param[in] n    The number of samples in x.  This must equal
+     *                 \c getNumberOfSamples().
+     * @param[in] x    The signal to transform.  This is an array of
+     *                 dimension [n].
+     * @param[out] y   The wavelet transform.  This is a row major matrix of
+     *                 dimension [nScales x n].
+     * @throws std::invalid_argument if any arguments are invalid.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void transform(const int n, const T x[], std::complex<T> *y[]);
+    /*!
+     * @brief Computes the amplitude of the continuous wavelet transform.
+     *        This is useful for scalograms since only a single precision
+     *        real value is stored for each scale and sample.
+     * @param[in] n          The number of samples in x.  This must equal
+     *                       \c getNumberOfSamples().
+     * @param[in] x          The signal to transform.  This is an array of
+     *                       dimension [n].
+     * @param[out] amplitude The amplitude of the wavelet transform.  This is
+     *                       a row major matrix of dimension [nScales x n].
+     * @throws std::invalid_argument if any arguments are invalid.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void transformAmplitude(const int n, const T x[], float *amplitude[]);
+    /*! @} */
+private:
+    class ContinuousWaveletTransformImpl;
+    std::unique_ptr<ContinuousWaveletTransformImpl> pImpl;
+};
+}
+#endif
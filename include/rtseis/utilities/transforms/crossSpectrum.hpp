@@ -0,0 +1,244 @@
+#ifndef RTSEIS_UTILITIES_TRANSFORMS_CROSSSPECTRUM_HPP
+#define RTSEIS_UTILITIES_TRANSFORMS_CROSSSPECTRUM_HPP 1
+#include <memory>
+#include <complex>
+
+namespace RTSeis::Utilities::Transforms
+{
+class SlidingWindowRealDFTParameters;
+/*!
+ * @brief Estimates the cross-spectral densities and magnitude-squared
+ *        coherences between pairs of channels with Welch's method.  Every
+ *        channel is divided into the same overlapping, windowed segments
+ *        as in \c Welch.  For each segment the DFT of every channel is
+ *        computed once and is then reused by every pair containing that
+ *        channel.  For a pair \f$ (x, y) \f$ the cross-spectral density is
+ *        the average of \f$ X^* Y \f$ over the segments and the coherence is
+ *        \f[
+ *           C_{xy} = \frac{ |S_{xy}|^2 }{ S_{xx} S_{yy} }.
+ *        \f]
+ *        Samples are appended as they arrive so that the state of the class
+ *        is a partially filled segment per channel and a running sum per
+ *        channel and pair.
+ * @note After the last sample of a signal the power spectral density of
+ *       each channel is identical to the result of \c Welch::transform()
+ *       on that channel.
+ * @author Ben Baker, University of Utah
+ * @copyright Ben Baker distributed under the MIT license.
+ * @sa Welch, StreamingWelch
+ */
+class CrossSpectrum
+{
+public:
+    /*! @name Constructors
+     * @{
+     */
+    /*!
+     * @brief Default constructor.
+     */
+    CrossSpectrum();
+    /*!
+     * @brief Copy constructor.
+     * @param[in] crossSpectrum  The class from which to initialize this class.
+     */
+    CrossSpectrum(const CrossSpectrum &crossSpectrum);
+    /*!
+     * @brief Move constructor.
+     * @param[in,out] crossSpectrum  The class from which to initialize this
+     *                               class.  On exit, crossSpectrum's behavior
+     *                               is undefined.
+     */
+    CrossSpectrum(CrossSpectrum &&crossSpectrum) noexcept;
+    /*! @} */
+
+    /*! @name Operators
+     * @{
+     */
+    /*!
+     * @brief Copy assignment operator.
+     * @param[in] crossSpectrum  The class to copy.
+     * @result A deep copy of the cross spectrum class.
+     */
+    CrossSpectrum& operator=(const CrossSpectrum &crossSpectrum);
+    /*!
+     * @brief Move assignment operator.
+     * @param[in,out] crossSpectrum  The class to move to this.  On exit
+     *                               crossSpectrum's behavior is undefined.
+     * @result The memory that was moved from crossSpectrum to this.
+     */
+    CrossSpectrum& operator=(CrossSpectrum &&crossSpectrum) noexcept;
+    /*! @} */
+
+    /*! @name Destructors
+     * @{
+     */
+    /*!
+     * @brief Default destructor.
+     */
+    ~CrossSpectrum();
+    /*!
+     * @brief Releases memory on the class.
+     */
+    void clear() noexcept;
+    /*! @} */
+
+    /*! @name Initialization
+     * @{
+     */
+    /*!
+     * @brief Initializes the cross spectrum for arbitrary channel pairs.
+     * @param[in] parameters    The segment parameters.  The window, overlap,
+     *                          DFT length, and detrend type are used.  The
+     *                          number of samples is ignored since the
+     *                          signal length is not known in advance.
+     * @param[in] nChannels     The number of channels.  This must be at
+     *                          least 2.
+     * @param[in] nPairs        The number of channel pairs.  This must be
+     *                          positive.
+     * @param[in] pairs         The channel indices of each pair.  This is a
+     *                          row major matrix of dimension [nPairs x 2]
+     *                          whose values must be in the range
+     *                          [0, nChannels-1].  For the pair
+     *                          (pairs[2*i], pairs[2*i+1]) = (x, y) the cross
+     *                          spectrum is \f$ X^* Y \f$.
+     * @param[in] samplingRate  The sampling rate in Hz.  This must be
+     *                          positive.
+     * @throws std::invalid_argument if any parameters are incorrect or the
+     *         parameters output type is not COMPLEX.
+     */
+    void initialize(const SlidingWindowRealDFTParameters &parameters,
+                    const int nChannels,
+                    const int nPairs,
+                    const int pairs[],
+                    const double samplingRate = 1.0);
+    /*!
+     * @brief Initializes the cross spectrum between two channels.  This is
+     *        equivalent to a single pair (0, 1).
+     * @param[in] parameters    The segment parameters.  The number of samples
+     *                          is ignored.
+     * @param[in] samplingRate  The sampling rate in Hz.  This must be
+     *                          positive.
+     * @throws std::invalid_argument if any parameters are incorrect.
+     */
+    void initialize(const SlidingWindowRealDFTParameters &parameters,
+                    const double samplingRate = 1.0);
+    /*!
+     * @brief Flag indicating whether or not the class is initialized.
+     * @result True indicates that the class is inititalized.
+     */
+    bool isInitialized() const noexcept;
+    /*! @} */
+
+    /*!
+     * @brief Returns the number of channels.
+     * @result The number of channels.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    int getNumberOfChannels() const;
+    /*!
+     * @brief Returns the number of channel pairs.
+     * @result The number of channel pairs.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    int getNumberOfPairs() const;
+    /*!
+     * @brief Returns the number of frequencies.
+     * @result The number of frequencies.
+     * @throws std::runtime_error if the class is not intitialized.
+     */
+    int getNumberOfFrequencies() const;
+    /*!
+     * @brief Gets the frequencies at which the spectra are estimated.
+     * @param[in] nFrequencies  The number of frequencies.  This must match the
+     *                          result of \c getNumberOfFrequencies().
+     * @param[out] frequencies  The frequencies (Hz).  This is an array of
+     *                          dimension [nFrequencies].
+     * @throws std::invalid_argument if nFrequencies is invalid or frequencies
+     *         is NULL.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void getFrequencies(const int nFrequencies, double *frequencies[]) const;
+
+    /*!
+     * @brief Appends samples to every channel.  Every segment completed by
+     *        these samples is transformed and folded into the estimates.
+     * @param[in] nChannels  The number of channels.  This must match the
+     *                       result of \c getNumberOfChannels().
+     * @param[in] nSamples   The number of samples to append to each channel.
+     *                       If this is not positive then nothing happens.
+     * @param[in] x          The samples to append.  This is a row major
+     *                       matrix whose dimension is [nChannels x nSamples].
+     * @throws std::invalid_argument if nChannels is invalid or x is NULL.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void update(const int nChannels, const int nSamples, const double x[]);
+    /*!
+     * @brief Discards the buffered samples and the running estimates.  This
+     *        may be useful after a gap is encountered.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void reset();
+    /*!
+     * @brief Returns whether or not an estimate is available.
+     * @retval True indicates that at least one segment has been averaged.
+     */
+    bool haveTransform() const noexcept;
+    /*!
+     * @brief Gets the number of segments contributing to the estimates.
+     * @result The number of averaged segments.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    int getNumberOfAveragedSegments() const;
+
+    /*!
+     * @brief Gets the cross-spectral density of a pair.
+     * @param[in] pair          The pair index.  This must be in the range
+     *                          [0, \c getNumberOfPairs() - 1].
+     * @param[in] nFrequencies  The number of frequencies.  This must match
+     *                          the result of \c getNumberOfFrequencies().
+     * @param[out] csd          The cross-spectral density.  This is an array
+     *                          of dimension [nFrequencies].  If the input
+     *                          signals have units of \f$ Volts \f$ then this
+     *                          has units of \f$ \frac{Volts^2}{Hz} \f$.
+     * @throws std::invalid_argument if any arguments are invalid.
+     * @throws std::runtime_error if the class is not initialized or no
+     *         segment has been averaged.
+     */
+    void getCrossSpectralDensity(const int pair, const int nFrequencies,
+                                 std::complex<double> *csd[]) const;
+    /*!
+     * @brief Gets the power spectral density of a channel.
+     * @param[in] channel       The channel index.  This must be in the range
+     *                          [0, \c getNumberOfChannels() - 1].
+     * @param[in] nFrequencies  The number of frequencies.  This must match
+     *                          the result of \c getNumberOfFrequencies().
+     * @param[out] psd          The power spectral density.  This is an array
+     *                          of dimension [nFrequencies].
+     * @throws std::invalid_argument if any arguments are invalid.
+     * @throws std::runtime_error if the class is not initialized or no
+     *         segment has been averaged.
+     */
+    void getPowerSpectralDensity(const int channel, const int nFrequencies,
+                                 double *psd[]) const;
+    /*!
+     * @brief Gets the magnitude-squared coherence of a pair.
+     * @param[in] pair          The pair index.  This must be in the range
+     *                          [0, \c getNumberOfPairs() - 1].
+     * @param[in] nFrequencies  The number of frequencies.  This must match
+     *                          the result of \c getNumberOfFrequencies().
+     * @param[out] coherence    The magnitude-squared coherence.  This is an
+     *                          array of dimension [nFrequencies] whose values
+     *                          are in the range [0,1].  Where either channel
+     *                          has no power the coherence is 0.
+     * @throws std::invalid_argument if any arguments are invalid.
+     * @throws std::runtime_error if the class is not initialized or no
+     *         segment has been averaged.
+     */
+    void getCoherence(const int pair, const int nFrequencies,
+                      double *coherence[]) const;
+private:
+    class CrossSpectrumImpl;
+    std::unique_ptr<CrossSpectrumImpl> pImpl;
+};
+}
+#endif
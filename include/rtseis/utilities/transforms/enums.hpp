@@ -11,7 +11,10 @@ enum class FourierTransformImplementation
     DFT, /*!< Perform a Discrete Fourier Transform computation. */
     FFT  /*!< Force an Fast Fouerier Transform computation.  The 
               implementation will have to zero-pad the signal so that
-              its length is a power of 2. */
+              its length is a power of 2.  Since the DFT is efficient
+              for lengths whose only prime factors are 2, 3, 5, and 7
+              it is usually better to zero-pad to
+              DFTUtilities::nextFastLength() and use the DFT. */
 };
 /*!
  * @brief Defines the detrending strategy used by the short-time
@@ -36,6 +39,58 @@ enum class SlidingWindowWindowType
     BOXCAR,    /*!< A boxcar (all ones). */ 
     CUSTOM     /*!< A custom window was set. */
 };
- 
+/*!
+ * @brief Defines what the sliding window real DFT retains for each window.
+ */
+enum class SlidingWindowOutputType
+{
+    COMPLEX,   /*!< The complex DFT. */
+    MAGNITUDE, /*!< The magnitude of the DFT, \f$ |X| \f$. */
+    POWER,     /*!< The squared magnitude of the DFT, \f$ |X|^2 \f$. */
+    DECIBEL    /*!< The power in decibels, \f$ 10 \log_{10} |X|^2 \f$. */
+};
+/*!
+ * @brief Defines how the streaming Welch method averages the modified
+ *        periodograms of successive segments.
+ */
+enum class WelchAveragingType
+{
+    CUMULATIVE,   /*!< Every segment since the last reset is given equal
+                       weight.  This reproduces the batch Welch estimate. */
+    EXPONENTIAL,  /*!< Each new segment is given weight \f$ \alpha \f$ and
+                       the prior estimate is given weight
+                       \f$ 1 - \alpha \f$. */
+    MOVING_BLOCK  /*!< The estimate is the average of the segments in the
+                       most recent completed blocks.  Each block holds a
+                       fixed number of segments so the estimate is updated
+                       whenever a block completes. */
+};
+/*!
+ * @brief Defines the mother wavelet used by the continuous wavelet
+ *        transform.
+ */
+enum class ContinuousWaveletType
+{
+    MORLET, /*!< The Morlet wavelet which is a plane wave modulated by a
+                 Gaussian.  The parameter is the non-dimensional frequency,
+                 \f$ \omega_0 \f$, which is 6 by default. */
+    PAUL    /*!< The Paul wavelet.  This has better time resolution but
+                 worse frequency resolution than the Morlet wavelet.  The
+                 parameter is the integer order, \f$ m \f$, which is 4 by
+                 default. */
+};
+/*!
+ * @brief Defines how the multitaper method combines the eigenspectra of the
+ *        individual tapers.
+ */
+enum class MultitaperWeightingType
+{
+    ADAPTIVE,   /*!< The weights are chosen iteratively at each frequency
+                     to minimize broadband leakage as in Thomson (1982). */
+    EIGENVALUE, /*!< Each eigenspectrum is weighted by its taper's
+                     concentration. */
+    UNITY       /*!< The eigenspectra are averaged. */
+};
+
 }
 #endif
@@ -83,9 +83,12 @@ public:
      * @brief Initializes the FIR-based envelope.
      * @param[in] ntaps    The number of filter taps.  This must be positive.
      *                     If ntaps is odd then a Type III FIR filter will be 
-     *                     used.  This can be computationally advantageous
+     *                     used.  This is computationally advantageous
      *                     as the real-part of the FIR filter is simply a 
-     *                     unit delay of ntaps/2 samples.  However, the filter
+     *                     unit delay of ntaps/2 samples and the imaginary
+     *                     part is antisymmetric with every other tap zero
+     *                     so a dedicated kernel requires roughly ntaps/4
+     *                     multiplies per sample.  However, the filter
      *                     response at the Nyquist frequency will be 0.
      *                     If ntaps is even then a Type IV FIR filter will be
      *                     used.  This is less computationally efficient as
@@ -0,0 +1,191 @@
+#ifndef RTSEIS_UTILITIES_TRANSFORMS_MATCHEDFILTER_HPP
+#define RTSEIS_UTILITIES_TRANSFORMS_MATCHEDFILTER_HPP 1
+#include <memory>
+
+namespace RTSeis::Utilities::Transforms
+{
+/*!
+ * @class MatchedFilter matchedFilter.hpp "include/rtseis/utilities/transforms/matchedFilter.hpp"
+ * @brief Computes the normalized cross-correlation of many templates with
+ *        long, continuous records.  For a template \f$ t \f$ of length
+ *        \f$ m \f$ the correlation coefficient at lag \f$ k \f$ is
+ *        \f[
+ *           c[k] = \frac{ \sum_{i=0}^{m-1} (t_i - \bar{t}) x_{k+i} }
+ *                       { \| t - \bar{t} \|
+ *                         \sqrt{ \sum_{i=0}^{m-1} x_{k+i}^2
+ *                              - \frac{1}{m} \left ( \sum_{i=0}^{m-1}
+ *                                x_{k+i} \right )^2 } }
+ *        \f]
+ *        which is in [-1,1].  Only lags at which the template completely
+ *        overlaps the record are computed, i.e., there are
+ *        \f$ n - m + 1 \f$ lags for a record of length \f$ n \f$.
+ * @note The correlations are computed with overlap-save.  The spectra of
+ *       the demeaned, unit-norm templates are computed once, when the
+ *       class is initialized, and each block of a record is transformed
+ *       once and then reused for every template.  The window energies in
+ *       the denominator are maintained with compensated running sums so
+ *       that each lag costs \f$ \mathcal{O}(1) \f$.  Lags whose window
+ *       energy is at the round-off level of the record's energy, e.g.,
+ *       gaps filled with zeros, are set to 0.  Templates, and, for
+ *       multiple records, records and templates, are distributed over
+ *       OpenMP threads.  The cached spectra require about
+ *       nTemplates*(transformLength/2 + 1) complex numbers.
+ * @ingroup rtseis_utils_transforms
+ */
+template<class T = double>
+class MatchedFilter
+{
+public:
+    /*! @name Constructors
+     * @{
+     */
+    /*!
+     * @brief Default constructor.
+     */
+    MatchedFilter();
+    /*!
+     * @brief Copy constructor.
+     * @param[in] filter  Class from which to initialize.
+     */
+    MatchedFilter(const MatchedFilter &filter);
+    /*!
+     * @brief Move constructor.
+     * @param[in,out] filter  Class from which this class is initialized.
+     *                        On exit filter's behavior is undefined.
+     */
+    MatchedFilter(MatchedFilter &&filter) noexcept;
+    /*! @} */
+
+    /*! @name Operators
+     * @{
+     */
+    /*!
+     * @brief Copy assignment operator.
+     * @param[in] filter  Matched filter class to copy.
+     * @result A deep copy of the input class.
+     */
+    MatchedFilter& operator=(const MatchedFilter &filter);
+    /*!
+     * @brief Move assignment operator.
+     * @param[in,out] filter  On entry this is the class to move.  On exit
+     *                        filter's behavior is undefined.
+     * @result filter has been moved to this class.
+     */
+    MatchedFilter& operator=(MatchedFilter &&filter) noexcept;
+    /*! @} */
+
+    /*! @name Destructors
+     * @{
+     */
+    /*!
+     * @brief Destructor.
+     */
+    ~MatchedFilter();
+    /*!
+     * @brief Resets the module and releases all memory.
+     */
+    void clear() noexcept;
+    /*! @} */
+
+    /*! @name Initialization
+     * @{
+     */
+    /*!
+     * @brief Initializes the matched filter and computes the template
+     *        spectra.
+     * @param[in] nTemplates       The number of templates.  This must be
+     *                             positive.
+     * @param[in] templateLength   The number of samples in each template.
+     *                             This must be at least 2.
+     * @param[in] templates        The templates.  This is a row major
+     *                             matrix of dimension
+     *                             [nTemplates x templateLength].  No
+     *                             template can be constant.
+     * @param[in] transformLength  The length of the DFT used to correlate
+     *                             a block of a record.  Each block yields
+     *                             transformLength - templateLength + 1
+     *                             lags.  If this is 0 then a length of
+     *                             about four times the template length is
+     *                             chosen.  Otherwise, this must be at least
+     *                             templateLength and will be rounded up
+     *                             to an efficient length.
+     * @throws std::invalid_argument if any arguments are invalid.
+     */
+    void initialize(const int nTemplates,
+                    const int templateLength,
+                    const T templates[],
+                    const int transformLength = 0);
+    /*!
+     * @brief Determines whether or not the class is initialized.
+     * @retval True indicates that the class is initialized.
+     */
+    bool isInitialized() const noexcept;
+    /*! @} */
+
+    /*!
+     * @brief Gets the number of templates.
+     * @result The number of templates.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    int getNumberOfTemplates() const;
+    /*!
+     * @brief Gets the number of samples in each template.
+     * @result The template length.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    int getTemplateLength() const;
+    /*!
+     * @brief Gets the length of the DFT used to correlate each block.
+     * @result The transform length.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    int getTransformLength() const;
+    /*!
+     * @brief Gets the number of lags computed for each template.
+     * @param[in] n  The number of samples in the record.  This must be at
+     *               least the template length.
+     * @result The number of lags, n - templateLength + 1.
+     * @throws std::invalid_argument if n is too small.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    int getOutputLength(const int n) const;
+
+    /*! @name Correlation
+     * @{
+     */
+    /*!
+     * @brief Correlates every template with a record.
+     * @param[in] n   The number of samples in the record.  This must be at
+     *                least \c getTemplateLength().
+     * @param[in] x   The record.  This is an array of dimension [n].
+     * @param[out] y  The correlation coefficients.  This is a row major
+     *                matrix of dimension [nTemplates x getOutputLength(n)]
+     *                where the i'th row is the correlation with the i'th
+     *                template.
+     * @throws std::invalid_argument if any arguments are invalid.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void correlate(const int n, const T x[], T *y[]);
+    /*!
+     * @brief Correlates every template with each of several records,
+     *        e.g., the same time window recorded at several stations.
+     * @param[in] nRecords  The number of records.  This must be positive.
+     * @param[in] n         The number of samples in each record.  This
+     *                      must be at least \c getTemplateLength().
+     * @param[in] x         The records.  x[i] is an array of dimension [n].
+     * @param[out] y        The correlation coefficients.  y[i] is a row
+     *                      major matrix of dimension
+     *                      [nTemplates x getOutputLength(n)] holding the
+     *                      correlations of every template with x[i].
+     * @throws std::invalid_argument if any arguments are invalid.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void correlate(const int nRecords, const int n,
+                   const T *const x[], T *const y[]);
+    /*! @} */
+private:
+    class MatchedFilterImpl;
+    std::unique_ptr<MatchedFilterImpl> pImpl;
+};
+}
+#endif
@@ -0,0 +1,218 @@
+#ifndef RTSEIS_UTILITIES_TRANSFORMS_MULTITAPER_HPP
+#define RTSEIS_UTILITIES_TRANSFORMS_MULTITAPER_HPP 1
+#include <memory>
+#include "rtseis/utilities/transforms/enums.hpp"
+
+namespace RTSeis::Utilities::Transforms
+{
+/*!
+ * @class Multitaper multitaper.hpp "include/rtseis/utilities/transforms/multitaper.hpp"
+ * @brief Estimates the power spectral density with Thomson's multitaper
+ *        method.  The signal is multiplied by each of \f$ K \f$ discrete
+ *        prolate spheroidal sequences (Slepian tapers), the periodogram of
+ *        each tapered signal is computed, and the resulting eigenspectra
+ *        are combined.  Unlike \c Welch the entire signal contributes to
+ *        every eigenspectrum so this is well suited to short records.
+ * @note The tapers and their concentrations are computed from the
+ *       tridiagonal eigenproblem of Percival and Walden (1993) when the
+ *       class is initialized.  Reinitializing with the same number of
+ *       samples, time-bandwidth product, and number of tapers reuses them.
+ *       The tapered transforms are distributed over OpenMP threads.
+ * @ingroup rtseis_utils_transforms
+ * @sa Welch
+ */
+template<class T = double>
+class Multitaper
+{
+public:
+    /*! @name Constructors
+     * @{
+     */
+    /*!
+     * @brief Default constructor.
+     */
+    Multitaper();
+    /*!
+     * @brief Copy constructor.
+     * @param[in] multitaper  Class from which to initialize.
+     */
+    Multitaper(const Multitaper &multitaper);
+    /*!
+     * @brief Move constructor.
+     * @param[in,out] multitaper  Class from which this class is initialized.
+     *                            On exit multitaper's behavior is undefined.
+     */
+    Multitaper(Multitaper &&multitaper) noexcept;
+    /*! @} */
+
+    /*! @name Operators
+     * @{
+     */
+    /*!
+     * @brief Copy assignment operator.
+     * @param[in] multitaper  Multitaper class to copy.
+     * @result A deep copy of the input class.
+     */
+    Multitaper& operator=(const Multitaper &multitaper);
+    /*!
+     * @brief Move assignment operator.
+     * @param[in,out] multitaper  On entry this is the class to move.  On exit
+     *                            multitaper's behavior is undefined.
+     * @result multitaper has been moved to this class.
+     */
+    Multitaper& operator=(Multitaper &&multitaper) noexcept;
+    /*! @} */
+
+    /*! @name Destructors
+     * @{
+     */
+    /*!
+     * @brief Destructor.
+     */
+    ~Multitaper();
+    /*!
+     * @brief Resets the module and releases all memory.
+     */
+    void clear() noexcept;
+    /*! @} */
+
+    /*! @name Initialization
+     * @{
+     */
+    /*!
+     * @brief Initializes the multitaper spectral estimator.
+     * @param[in] nSamples   The number of samples in the signal.  This must
+     *                       be at least 2.
+     * @param[in] timeBandwidthProduct  The time-halfbandwidth product,
+     *                                  \f$ NW \f$.  This must be in the range
+     *                                  (0, nSamples/2).  Typical values are
+     *                                  2.5 to 4.
+     * @param[in] nTapers    The number of tapers, \f$ K \f$.  If this is not
+     *                       positive then \f$ \lfloor 2NW \rfloor - 1 \f$
+     *                       tapers, or 1 taper if that is smaller, are used.
+     *                       This cannot exceed nSamples.
+     * @param[in] samplingRate  The sampling rate in Hz.  This must be
+     *                          positive.
+     * @param[in] weighting  Defines how the eigenspectra are combined.
+     * @param[in] dftLength  The length of the DFT.  If this is less than
+     *                       nSamples then the DFT length will be nSamples.
+     *                       Otherwise, the tapered signals are zero-padded
+     *                       to this length.
+     * @throws std::invalid_argument if any arguments are invalid.
+     * @throws std::runtime_error if the tapers cannot be computed.
+     */
+    void initialize(const int nSamples,
+                    const double timeBandwidthProduct,
+                    const int nTapers = 0,
+                    const double samplingRate = 1.0,
+                    const MultitaperWeightingType weighting = MultitaperWeightingType::ADAPTIVE,
+                    const int dftLength = 0);
+    /*!
+     * @brief Determines whether or not the class is initialized.
+     * @retval True indicates that the class is initialized.
+     */
+    bool isInitialized() const noexcept;
+    /*! @} */
+
+    /*!
+     * @brief Gets the number of samples in the signal.
+     * @result The number of samples.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    int getNumberOfSamples() const;
+    /*!
+     * @brief Gets the number of tapers.
+     * @result The number of tapers.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    int getNumberOfTapers() const;
+    /*!
+     * @brief Gets the number of frequencies.
+     * @result The number of frequencies.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    int getNumberOfFrequencies() const;
+    /*!
+     * @brief Gets the frequencies at which the spectrum is estimated.
+     * @param[in] nFrequencies  The number of frequencies.  This must equal
+     *                          \c getNumberOfFrequencies().
+     * @param[out] frequencies  The frequencies in Hz.  This is an array of
+     *                          dimension [nFrequencies].
+     * @throws std::invalid_argument if nFrequencies is invalid or
+     *         frequencies is NULL.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void getFrequencies(const int nFrequencies, double *frequencies[]) const;
+    /*!
+     * @brief Gets the Slepian tapers.
+     * @param[in] nTapers   The number of tapers.  This must equal
+     *                      \c getNumberOfTapers().
+     * @param[in] nSamples  The number of samples.  This must equal
+     *                      \c getNumberOfSamples().
+     * @param[out] tapers   The tapers with unit energy.  This is a row major
+     *                      matrix of dimension [nTapers x nSamples].
+     * @throws std::invalid_argument if any arguments are invalid.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void getTapers(const int nTapers, const int nSamples,
+                   double *tapers[]) const;
+    /*!
+     * @brief Gets the fraction of each taper's energy that is concentrated
+     *        in the band \f$ [-W, W] \f$.
+     * @param[in] nTapers          The number of tapers.  This must equal
+     *                             \c getNumberOfTapers().
+     * @param[out] concentrations  The concentrations.  This is an array of
+     *                             dimension [nTapers].
+     * @throws std::invalid_argument if nTapers is invalid or concentrations
+     *         is NULL.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void getConcentrations(const int nTapers, double *concentrations[]) const;
+
+    /*! @name Power Spectral Density
+     * @{
+     */
+    /*!
+     * @brief Estimates the power spectral density of a signal.
+     * @note The mean of the signal is removed prior to tapering.
+     * @param[in] nSamples      The number of samples in x.  This must equal
+     *                          \c getNumberOfSamples().
+     * @param[in] x             The signal.  This is an array of dimension
+     *                          [nSamples].
+     * @param[in] nFrequencies  The number of frequencies.  This must equal
+     *                          \c getNumberOfFrequencies().
+     * @param[out] psd          The one-sided power spectral density.  This
+     *                          is an array of dimension [nFrequencies].  If
+     *                          the signal has units of \f$ Volts \f$ then
+     *                          this has units of \f$ \frac{Volts^2}{Hz} \f$.
+     * @throws std::invalid_argument if any arguments are invalid.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void transform(const int nSamples, const T x[],
+                   const int nFrequencies, T *psd[]);
+    /*!
+     * @brief Estimates the power spectral density of several signals.
+     * @note The mean of each signal is removed prior to tapering.
+     * @param[in] nChannels     The number of signals.  This must be
+     *                          positive.
+     * @param[in] nSamples      The number of samples in each signal.  This
+     *                          must equal \c getNumberOfSamples().
+     * @param[in] x             The signals.  This is a row major matrix of
+     *                          dimension [nChannels x nSamples].
+     * @param[in] nFrequencies  The number of frequencies.  This must equal
+     *                          \c getNumberOfFrequencies().
+     * @param[out] psd          The one-sided power spectral density of each
+     *                          signal.  This is a row major matrix of
+     *                          dimension [nChannels x nFrequencies].
+     * @throws std::invalid_argument if any arguments are invalid.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void transform(const int nChannels, const int nSamples, const T x[],
+                   const int nFrequencies, T *psd[]);
+    /*! @} */
+private:
+    class MultitaperImpl;
+    std::unique_ptr<MultitaperImpl> pImpl;
+};
+}
+#endif
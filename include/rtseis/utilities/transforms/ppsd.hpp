@@ -0,0 +1,259 @@
+#ifndef RTSEIS_UTILITIES_TRANSFORMS_PPSD_HPP
+#define RTSEIS_UTILITIES_TRANSFORMS_PPSD_HPP 1
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+namespace RTSeis::Utilities::Transforms
+{
+class SlidingWindowRealDFTParameters;
+/*!
+ * @brief Computes probabilistic power spectral densities in the manner of
+ *        McNamara and Buland (2004).  A long, contiguous signal is divided
+ *        into overlapping segments (e.g., one hour with 50 percent overlap).
+ *        The power spectral density of each segment is estimated with
+ *        Welch's method, averaged over full-octave bands centered on
+ *        periods spaced at a fraction of an octave, converted to decibels,
+ *        and binned into a two-dimensional period-decibel histogram.
+ *        Only the histogram counts are retained so the memory used per
+ *        channel is fixed regardless of how much data is processed.
+ * @note Partial histograms computed by separate workers can be combined
+ *       with \c merge() or written and read with \c serialize() and
+ *       \c deserialize().  This class is not thread safe; each worker should
+ *       use its own instance.
+ * @author Ben Baker, University of Utah
+ * @copyright Ben Baker distributed under the MIT license.
+ * @sa Welch
+ */
+class PPSD
+{
+public:
+    /*! @name Constructors
+     * @{
+     */
+    /*!
+     * @brief Default constructor.
+     */
+    PPSD();
+    /*!
+     * @brief Copy constructor.
+     * @param[in] ppsd  The PPSD class from which to initialize this class.
+     */
+    PPSD(const PPSD &ppsd);
+    /*!
+     * @brief Move constructor.
+     * @param[in,out] ppsd  The PPSD class from which to initialize this
+     *                      class.  On exit, ppsd's behavior is undefined.
+     */
+    PPSD(PPSD &&ppsd) noexcept;
+    /*! @} */
+
+    /*! @name Operators
+     * @{
+     */
+    /*!
+     * @brief Copy assignment operator.
+     * @param[in] ppsd  The class to copy.
+     * @result A deep copy of the PPSD class.
+     */
+    PPSD& operator=(const PPSD &ppsd);
+    /*!
+     * @brief Move assignment operator.
+     * @param[in,out] ppsd  The class to move to this.
+     *                      On exit ppsd's behavior is undefined.
+     * @result The memory that was moved from ppsd to this.
+     */
+    PPSD& operator=(PPSD &&ppsd) noexcept;
+    /*! @} */
+
+    /*! @name Destructors
+     * @{
+     */
+    /*!
+     * @brief Default destructor.
+     */
+    ~PPSD();
+    /*!
+     * @brief Releases memory on the class.
+     */
+    void clear() noexcept;
+    /*! @} */
+
+    /*!
+     * @brief Initializes the PPSD engine.
+     * @param[in] parameters          The Welch parameters used to estimate
+     *                                the power spectral density of a segment.
+     *                                The number of samples is ignored and
+     *                                instead set to segmentLength.
+     * @param[in] segmentLength       The number of samples in a segment.
+     *                                For example, one hour of data.  This
+     *                                must be at least the window length in
+     *                                the Welch parameters.
+     * @param[in] nSamplesInSegmentOverlap  The number of samples shared by
+     *                                consecutive segments.  This must be in
+     *                                the range [0, segmentLength-1].
+     * @param[in] minimumPeriod       The shortest period center (seconds).
+     * @param[in] maximumPeriod       The longest period center (seconds).
+     *                                This must be at least minimumPeriod.
+     * @param[in] minimumDecibel      The lower edge of the lowest decibel bin.
+     * @param[in] maximumDecibel      The upper edge of the highest decibel
+     *                                bin.  This must exceed minimumDecibel.
+     * @param[in] decibelBinWidth     The width of each decibel bin.  This
+     *                                must be positive.
+     * @param[in] nPeriodsPerOctave   The number of period centers per octave.
+     *                                Each center is averaged over a full
+     *                                octave.  This must be positive.
+     * @param[in] samplingRate        The sampling rate in Hz.  This must be
+     *                                positive.
+     * @throws std::invalid_argument if any parameters are incorrect or if an
+     *         octave band centered on a period extends below the lowest
+     *         non-zero frequency or above the Nyquist frequency, or contains
+     *         no frequencies.  In the latter cases the Welch window should be
+     *         lengthened, the maximum period reduced, or the minimum period
+     *         increased.
+     */
+    void initialize(const SlidingWindowRealDFTParameters &parameters,
+                    const int segmentLength,
+                    const int nSamplesInSegmentOverlap,
+                    const double minimumPeriod,
+                    const double maximumPeriod,
+                    const double minimumDecibel = -200,
+                    const double maximumDecibel = -50,
+                    const double decibelBinWidth = 1,
+                    const int nPeriodsPerOctave = 8,
+                    const double samplingRate = 1.0);
+    /*!
+     * @brief Flag indicating whether or not the class is initialized.
+     * @result True indicates that the class is inititalized.
+     */
+    bool isInitialized() const noexcept;
+
+    /*!
+     * @brief Adds a contiguous signal to the histogram.  Every full segment
+     *        in the signal is processed.  Trailing samples that do not fill
+     *        a segment are discarded so a signal with gaps should be split
+     *        at the gaps and each piece added separately.
+     * @param[in] nSamples  The number of samples in the signal.
+     * @param[in] x         The signal.  This is an array whose dimension is
+     *                      [nSamples].  The units should be physical (e.g.,
+     *                      \f$ m/s^2 \f$ for acceleration) so that the
+     *                      decibels are relative to one physical unit
+     *                      squared per Hz.
+     * @throws std::invalid_argument if nSamples is positive and x is NULL.
+     * @throws std::runtime_error if the class is not initialized.
+     * @result The number of segments that were added to the histogram.
+     */
+    int update(const int nSamples, const double x[]);
+    /*!
+     * @brief Adds the histograms accumulated by another PPSD engine to this
+     *        engine's histogram.
+     * @param[in] ppsd  The PPSD engine to merge.  This must have the same
+     *                  period and decibel bins as this class.
+     * @throws std::invalid_argument if ppsd is not initialized or its bins
+     *         do not match this class's bins.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void merge(const PPSD &ppsd);
+    /*!
+     * @brief Zeros the histogram counts while retaining the configuration.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void resetHistogram();
+    /*!
+     * @brief Gets the number of segments accumulated into the histogram.
+     * @result The number of segments.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    int64_t getNumberOfSegments() const;
+
+    /*!
+     * @brief Gets the number of period centers.
+     * @result The number of period centers.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    int getNumberOfPeriods() const;
+    /*!
+     * @brief Gets the period centers.
+     * @param[in] nPeriods  The number of periods.  This must match the
+     *                      result of \c getNumberOfPeriods().
+     * @param[out] periods  The period centers in seconds in increasing
+     *                      order.  This is an array of dimension [nPeriods].
+     * @throws std::invalid_argument if nPeriods is invalid or periods is NULL.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void getPeriods(const int nPeriods, double *periods[]) const;
+    /*!
+     * @brief Gets the number of decibel bins.
+     * @result The number of decibel bins.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    int getNumberOfDecibelBins() const;
+    /*!
+     * @brief Gets the centers of the decibel bins.
+     * @param[in] nBins    The number of decibel bins.  This must match the
+     *                     result of \c getNumberOfDecibelBins().
+     * @param[out] decibels  The decibel bin centers in increasing order.
+     *                       This is an array of dimension [nBins].
+     * @throws std::invalid_argument if nBins is invalid or decibels is NULL.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void getDecibelBins(const int nBins, double *decibels[]) const;
+    /*!
+     * @brief Gets the histogram counts.
+     * @param[in] nPeriods   The number of periods.  This must match the
+     *                       result of \c getNumberOfPeriods().
+     * @param[in] nBins      The number of decibel bins.  This must match the
+     *                       result of \c getNumberOfDecibelBins().
+     * @param[out] counts    The number of segments whose smoothed power
+     *                       fell in each bin.  This is a row major matrix
+     *                       of dimension [nPeriods x nBins].  Powers outside
+     *                       the decibel range are discarded so a row can
+     *                       sum to fewer than the number of segments.
+     * @throws std::invalid_argument if the dimensions are invalid or counts
+     *         is NULL.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void getHistogram(const int nPeriods, const int nBins,
+                      uint32_t *counts[]) const;
+    /*!
+     * @brief Gets the empirical probability density of the power at each
+     *        period.  This is the histogram normalized so that each row sums
+     *        to one.
+     * @param[in] nPeriods   The number of periods.  This must match the
+     *                       result of \c getNumberOfPeriods().
+     * @param[in] nBins      The number of decibel bins.  This must match the
+     *                       result of \c getNumberOfDecibelBins().
+     * @param[out] pdf       The probability of each decibel bin at each
+     *                       period.  This is a row major matrix of dimension
+     *                       [nPeriods x nBins].  If no segments have been
+     *                       accumulated then this is all zeros.
+     * @throws std::invalid_argument if the dimensions are invalid or pdf
+     *         is NULL.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void getProbabilityDensityFunction(const int nPeriods, const int nBins,
+                                       double *pdf[]) const;
+
+    /*!
+     * @brief Serializes the histogram.
+     * @result A binary representation of the period and decibel bins, the
+     *         number of segments, and the histogram counts.  This uses the
+     *         native byte order.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    std::vector<char> serialize() const;
+    /*!
+     * @brief Replaces this class's histogram with a serialized histogram.
+     * @param[in] data  The output of \c serialize().  The period and decibel
+     *                  bins must match this class's bins.
+     * @throws std::invalid_argument if data is malformed or its bins do not
+     *         match this class's bins.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void deserialize(const std::vector<char> &data);
+private:
+    class PPSDImpl;
+    std::unique_ptr<PPSDImpl> pImpl;
+};
+}
+#endif
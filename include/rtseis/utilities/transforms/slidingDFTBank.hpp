@@ -0,0 +1,204 @@
+#ifndef RTSEIS_UTILITIES_TRANSFORMS_SLIDINGDFTBANK_HPP
+#define RTSEIS_UTILITIES_TRANSFORMS_SLIDINGDFTBANK_HPP 1
+#include <memory>
+#include <complex>
+
+namespace RTSeis::Utilities::Transforms
+{
+/*!
+ * @class SlidingDFTBank slidingDFTBank.hpp "include/rtseis/utilities/transforms/slidingDFTBank.hpp"
+ * @brief Tracks the discrete Fourier transform of a handful of frequencies
+ *        over a sliding window on a sample-by-sample basis.  For a window of
+ *        length \f$ N \f$ and a frequency \f$ \omega_k \f$ (radians/sample)
+ *        the transform at sample \f$ n \f$ is
+ *        \f[
+ *           X_k[n] = \sum_{m=0}^{N-1} x[n-N+1+m] e^{-i \omega_k m}
+ *        \f]
+ *        which is updated with the recursion
+ *        \f[
+ *           X_k[n] = e^{i \omega_k} \left ( X_k[n-1] - x[n-N] \right )
+ *                  + e^{-i \omega_k (N-1)} x[n].
+ *        \f]
+ *        The cost is \f$ \mathcal{O}(k) \f$ per sample for \f$ k \f$
+ *        frequencies.  The recursion has a pole on the unit circle so
+ *        roundoff would otherwise accumulate without bound.  To prevent
+ *        this a non-recursive sum over the next window is accumulated
+ *        alongside the recursion and, once that window is complete, it
+ *        replaces the recursive estimate.  Hence, the error never grows
+ *        beyond that of \f$ N \f$ updates.
+ * @note The frequencies need not fall on DFT bins and the same bank of
+ *       frequencies can be applied to multiple channels.
+ * @ingroup rtseis_utils_transforms
+ */
+template<class T = double>
+class SlidingDFTBank
+{
+public:
+    /*! @name Constructors
+     * @{
+     */
+    /*!
+     * @brief Default constructor.
+     */
+    SlidingDFTBank();
+    /*!
+     * @brief Copy constructor.
+     * @param[in] bank  Class from which to initialize.
+     */
+    SlidingDFTBank(const SlidingDFTBank &bank);
+    /*!
+     * @brief Move constructor.
+     * @param[in,out] bank  Class from which this class is initialized.
+     *                      On exit bank's behavior is undefined.
+     */
+    SlidingDFTBank(SlidingDFTBank &&bank) noexcept;
+    /*! @} */
+
+    /*! @name Operators
+     * @{
+     */
+    /*!
+     * @brief Copy assignment operator.
+     * @param[in] bank  Sliding DFT bank to copy.
+     * @result A deep copy of the input class.
+     */
+    SlidingDFTBank& operator=(const SlidingDFTBank &bank);
+    /*!
+     * @brief Move assignment operator.
+     * @param[in,out] bank  On entry this is the class to move.  On exit
+     *                      bank's behavior is undefined.
+     * @result bank has been moved to this class.
+     */
+    SlidingDFTBank& operator=(SlidingDFTBank &&bank) noexcept;
+    /*! @} */
+
+    /*! @name Destructors
+     * @{
+     */
+    /*!
+     * @brief Destructor.
+     */
+    ~SlidingDFTBank();
+    /*!
+     * @brief Resets the module and releases all memory.
+     */
+    void clear() noexcept;
+    /*! @} */
+
+    /*!
+     * @brief Initializes the sliding DFT bank.
+     * @param[in] windowLength  The number of samples in the sliding window.
+     *                          This must be positive.
+     * @param[in] nFrequencies  The number of frequencies to track.  This must
+     *                          be positive.
+     * @param[in] frequencies   The frequencies (Hz) to track.  This is an
+     *                          array of dimension [nFrequencies] and each
+     *                          frequency must be in the range
+     *                          [0, samplingRate/2].
+     * @param[in] samplingRate  The sampling rate in Hz.  This must be
+     *                          positive.
+     * @param[in] nChannels     The number of channels to which the bank is
+     *                          applied.  This must be positive.
+     * @throws std::invalid_argument if any arguments are invalid.
+     */
+    void initialize(const int windowLength,
+                    const int nFrequencies,
+                    const double frequencies[],
+                    const double samplingRate = 1.0,
+                    const int nChannels = 1);
+    /*!
+     * @brief Determines whether or not the class is initialized.
+     * @retval True indicates that the class is initialized.
+     */
+    bool isInitialized() const noexcept;
+    /*!
+     * @brief Gets the window length.
+     * @result The number of samples in the sliding window.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    int getWindowLength() const;
+    /*!
+     * @brief Gets the number of tracked frequencies.
+     * @result The number of tracked frequencies.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    int getNumberOfFrequencies() const;
+    /*!
+     * @brief Gets the number of channels.
+     * @result The number of channels.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    int getNumberOfChannels() const;
+
+    /*!
+     * @brief Appends samples to each channel and updates the transforms.
+     * @param[in] nSamples  The number of samples per channel.
+     * @param[in] x         The samples to append.  This is a row major matrix
+     *                      of dimension [nChannels x nSamples] so that each
+     *                      channel's samples are contiguous.
+     * @throws std::invalid_argument if nSamples is positive and x is NULL.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void update(const int nSamples, const T x[]);
+    /*!
+     * @brief Appends samples to each channel and returns the transforms
+     *        after every sample.
+     * @param[in] nSamples  The number of samples per channel.
+     * @param[in] x         The samples to append.  This is a row major matrix
+     *                      of dimension [nChannels x nSamples].
+     * @param[out] y        The transform at each sample.  This is a row major
+     *                      array of dimension
+     *                      [nChannels x nSamples x nFrequencies].
+     * @throws std::invalid_argument if nSamples is positive and x or y is
+     *         NULL.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void update(const int nSamples, const T x[], std::complex<T> *y[]);
+    /*!
+     * @brief Gets the transform at the latest sample.
+     * @param[in] nValues  The number of values.  This must equal
+     *                     nChannels*nFrequencies.
+     * @param[out] y       The transforms.  This is a row major matrix of
+     *                     dimension [nChannels x nFrequencies].
+     * @throws std::invalid_argument if nValues is invalid or y is NULL.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void getTransform(const int nValues, std::complex<T> *y[]) const;
+    /*!
+     * @brief Gets the amplitudes at the latest sample.  The amplitudes are
+     *        scaled by \f$ 2/N \f$ so that a sinusoid with amplitude
+     *        \f$ A \f$ at a tracked frequency strictly between 0 and the
+     *        Nyquist frequency and with an integer number of cycles in the
+     *        window has amplitude \f$ A \f$.
+     * @param[in] nValues     The number of values.  This must equal
+     *                        nChannels*nFrequencies.
+     * @param[out] amplitudes The amplitudes.  This is a row major matrix of
+     *                        dimension [nChannels x nFrequencies].
+     * @throws std::invalid_argument if nValues is invalid or amplitudes is
+     *         NULL.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void getAmplitudes(const int nValues, T *amplitudes[]) const;
+    /*!
+     * @brief Gets the phases at the latest sample.  The phase is relative to
+     *        the oldest sample in the window.
+     * @param[in] nValues  The number of values.  This must equal
+     *                     nChannels*nFrequencies.
+     * @param[out] phases  The phases in radians.  This is a row major matrix
+     *                     of dimension [nChannels x nFrequencies].
+     * @throws std::invalid_argument if nValues is invalid or phases is NULL.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void getPhases(const int nValues, T *phases[]) const;
+    /*!
+     * @brief Zeros the transforms and the samples in the window.  This
+     *        may be useful after a gap is encountered.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void reset();
+private:
+    class SlidingDFTBankImpl;
+    std::unique_ptr<SlidingDFTBankImpl> pImpl;
+};
+}
+#endif
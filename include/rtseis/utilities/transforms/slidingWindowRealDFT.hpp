@@ -117,6 +117,13 @@ public:
      * @throws std::runtime_error if the class is not initialized.
      */
     RTSeis::Precision getPrecision() const;
+    /*!
+     * @brief Gets what is retained for each window.
+     * @result The output type.  If this is not complex then the output is
+     *         accessed with \c getSpectrum64f() or \c getSpectrum32f().
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    SlidingWindowOutputType getOutputType() const;
 
     /*!
      * @brief Computes the sliding window DFT of the real signal.
@@ -137,8 +144,9 @@ public:
      *                     be in the range 
      *                     [0, \c getNumberOfTransformWidnwos()-1]. 
      * @throws std::invalid_argument if iWindow is out of bounds.
-     * @throws std::runtime_error if the class precision is FLOAT 
-     *         or the \c transform() has not yet been called. 
+     * @throws std::runtime_error if the class precision is FLOAT,
+     *         the output type is not complex, or the \c transform() has
+     *         not yet been called.
      * @sa \c transform(), \c getNumberOfTransformWindows(), \c getPrecision()
      */
     const std::complex<double> *getTransform64f(const int iWindow) const;
@@ -148,11 +156,42 @@ public:
      *                     be in the range
      *                     [0, \c getNumberOfTransformWindows()-1]. 
      * @throws std::invalid_argument if iWindow is out of bounds.
-     * @throws std::runtime_error if the class precision is DOUBLE
-     *         or the \c transform() has not yet been called. 
+     * @throws std::runtime_error if the class precision is DOUBLE,
+     *         the output type is not complex, or the \c transform() has
+     *         not yet been called.
      * @sa \c transform(), \c getNumberOfTransformWindows(), \c getPrecision()
      */
     const std::complex<float> *getTransform32f(const int iWindow) const;
+    /*!
+     * @brief Gets a pointer to the magnitude, power, or decibels in the
+     *        iWindow'th window.  These are computed as each block of windows
+     *        is transformed so the complex DFTs of all windows are never
+     *        stored.
+     * @param[in] iWindow  The window.  This must be in the range
+     *                     [0, \c getNumberOfTransformWindows()-1].
+     * @result The spectrum in the iWindow'th window.  This is an array of
+     *         dimension [\c getNumberOfFrequencies()].  For decibels, powers
+     *         smaller than the smallest normalized number of the output
+     *         precision are clamped to that number.
+     * @throws std::invalid_argument if iWindow is out of bounds.
+     * @throws std::runtime_error if the output type is complex, the output
+     *         precision is FLOAT, or \c transform() has not yet been called.
+     * @sa \c SlidingWindowRealDFTParameters::setOutputType()
+     */
+    const double *getSpectrum64f(const int iWindow) const;
+    /*!
+     * @brief Gets a pointer to the magnitude, power, or decibels in the
+     *        iWindow'th window.
+     * @param[in] iWindow  The window.  This must be in the range
+     *                     [0, \c getNumberOfTransformWindows()-1].
+     * @result The spectrum in the iWindow'th window.  This is an array of
+     *         dimension [\c getNumberOfFrequencies()].
+     * @throws std::invalid_argument if iWindow is out of bounds.
+     * @throws std::runtime_error if the output type is complex, the output
+     *         precision is DOUBLE, or \c transform() has not yet been called.
+     * @sa \c SlidingWindowRealDFTParameters::setOutputType()
+     */
+    const float *getSpectrum32f(const int iWindow) const;
 private:
     class SlidingWindowRealDFTImpl;
     std::unique_ptr<SlidingWindowRealDFTImpl> pImpl;
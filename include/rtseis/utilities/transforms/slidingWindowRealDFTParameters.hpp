@@ -215,6 +215,32 @@ public:
      *         computation.
      */  
     RTSeis::Precision getPrecision() const noexcept;
+    /*!
+     * @brief Defines what is retained for each window.  Retaining only the
+     *        magnitude, power, or decibels avoids storing the complex DFT
+     *        of every window.
+     * @param[in] outputType       The output type.
+     * @param[in] outputPrecision  The precision of the magnitude, power, or
+     *                             decibels.  Single precision output halves
+     *                             the storage even when the underlying
+     *                             transform is double precision.  This is
+     *                             ignored for complex output since the
+     *                             complex DFT has the precision of the
+     *                             underlying transform.
+     * @note By default the complex DFT is retained.
+     */
+    void setOutputType(const SlidingWindowOutputType outputType,
+                       const RTSeis::Precision outputPrecision = RTSeis::Precision::DOUBLE) noexcept;
+    /*!
+     * @brief Returns what is retained for each window.
+     * @result The output type.
+     */
+    SlidingWindowOutputType getOutputType() const noexcept;
+    /*!
+     * @brief Returns the precision of the magnitude, power, or decibels.
+     * @result The output precision.
+     */
+    RTSeis::Precision getOutputPrecision() const noexcept;
     /*! @} */
 
     /*! @name Valid
@@ -0,0 +1,182 @@
+#ifndef RTSEIS_UTILITIES_TRANSFORMS_STOCKWELLTRANSFORM_HPP
+#define RTSEIS_UTILITIES_TRANSFORMS_STOCKWELLTRANSFORM_HPP 1
+#include <memory>
+#include <complex>
+
+namespace RTSeis::Utilities::Transforms
+{
+/*!
+ * @class StockwellTransform stockwellTransform.hpp "include/rtseis/utilities/transforms/stockwellTransform.hpp"
+ * @brief Computes the discrete S-transform of Stockwell et al. (1996).
+ *        For a signal of length \f$ N \f$ with DFT \f$ H \f$ the voice at
+ *        frequency index \f$ k > 0 \f$ is
+ *        \f[
+ *           S[j, k] = \sum_{m} H[m + k] e^{-2 \pi^2 m^2/k^2}
+ *                     e^{2 \pi i m j/N}
+ *        \f]
+ *        and the zero frequency voice is the mean of the signal.  Each voice
+ *        localizes the signal with a Gaussian window whose width is
+ *        inversely proportional to the frequency.
+ * @note The signal is transformed once.  The Gaussian voices are tabulated
+ *       when the class is initialized and are truncated where they fall
+ *       below machine precision so that low frequency voices are cheap.
+ *       The inverse transforms are distributed over OpenMP threads.
+ * @ingroup rtseis_utils_transforms
+ */
+template<class T = double>
+class StockwellTransform
+{
+public:
+    /*! @name Constructors
+     * @{
+     */
+    /*!
+     * @brief Default constructor.
+     */
+    StockwellTransform();
+    /*!
+     * @brief Copy constructor.
+     * @param[in] stransform  Class from which to initialize.
+     */
+    StockwellTransform(const StockwellTransform &stransform);
+    /*!
+     * @brief Move constructor.
+     * @param[in,out] stransform  Class from which this class is initialized.
+     *                            On exit stransform's behavior is undefined.
+     */
+    StockwellTransform(StockwellTransform &&stransform) noexcept;
+    /*! @} */
+
+    /*! @name Operators
+     * @{
+     */
+    /*!
+     * @brief Copy assignment operator.
+     * @param[in] stransform  S-transform class to copy.
+     * @result A deep copy of the input class.
+     */
+    StockwellTransform& operator=(const StockwellTransform &stransform);
+    /*!
+     * @brief Move assignment operator.
+     * @param[in,out] stransform  On entry this is the class to move.  On exit
+     *                            stransform's behavior is undefined.
+     * @result stransform has been moved to this class.
+     */
+    StockwellTransform& operator=(StockwellTransform &&stransform) noexcept;
+    /*! @} */
+
+    /*! @name Destructors
+     * @{
+     */
+    /*!
+     * @brief Destructor.
+     */
+    ~StockwellTransform();
+    /*!
+     * @brief Resets the module and releases all memory.
+     */
+    void clear() noexcept;
+    /*! @} */
+
+    /*! @name Initialization
+     * @{
+     */
+    /*!
+     * @brief Initializes the S-transform for the given voices.
+     * @param[in] nSamples      The number of samples in the signal.  This
+     *                          must be at least 2.
+     * @param[in] nVoices       The number of voices.  This must be positive.
+     * @param[in] voices        The frequency index of each voice.  This is an
+     *                          array of dimension [nVoices] whose values must
+     *                          be in the range [0, nSamples/2].
+     * @param[in] samplingRate  The sampling rate in Hz.  This must be
+     *                          positive.
+     * @throws std::invalid_argument if any arguments are invalid.
+     */
+    void initialize(const int nSamples,
+                    const int nVoices,
+                    const int voices[],
+                    const double samplingRate = 1.0);
+    /*!
+     * @brief Initializes the S-transform for all voices in a frequency band.
+     * @param[in] nSamples      The number of samples in the signal.  This
+     *                          must be at least 2.
+     * @param[in] minimumFrequency  The minimum frequency (Hz).
+     * @param[in] maximumFrequency  The maximum frequency (Hz).  This must be
+     *                              at least minimumFrequency.
+     * @param[in] samplingRate  The sampling rate in Hz.  This must be
+     *                          positive.
+     * @throws std::invalid_argument if any arguments are invalid or no
+     *         frequency k samplingRate/nSamples, k = 0,...,nSamples/2,
+     *         is in the band.
+     */
+    void initialize(const int nSamples,
+                    const double minimumFrequency,
+                    const double maximumFrequency,
+                    const double samplingRate = 1.0);
+    /*!
+     * @brief Determines whether or not the class is initialized.
+     * @retval True indicates that the class is initialized.
+     */
+    bool isInitialized() const noexcept;
+    /*! @} */
+
+    /*!
+     * @brief Gets the number of samples in the signal.
+     * @result The number of samples.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    int getNumberOfSamples() const;
+    /*!
+     * @brief Gets the number of voices.
+     * @result The number of voices.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    int getNumberOfVoices() const;
+    /*!
+     * @brief Gets the frequency of each voice.
+     * @param[in] nVoices      The number of voices.  This must equal
+     *                         \c getNumberOfVoices().
+     * @param[out] frequencies The frequencies in Hz.  This is an array of
+     *                         dimension [nVoices].
+     * @throws std::invalid_argument if nVoices is invalid or frequencies
+     *         is NULL.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void getFrequencies(const int nVoices, double *frequencies[]) const;
+
+    /*! @name Transform
+     * @{
+     */
+    /*!
+     * @brief Computes the S-transform.
+     * @param[in] n    The number of samples in x.  This must equal
+     *                 \c getNumberOfSamples().
+     * @param[in] x    The signal to transform.  This is an array of
+     *                 dimension [n].
+     * @param[out] y   The S-transform.  This is a row major matrix of
+     *                 dimension [nVoices x n].
+     * @throws std::invalid_argument if any arguments are invalid.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void transform(const int n, const T x[], std::complex<T> *y[]);
+    /*!
+     * @brief Computes the amplitude of the S-transform.  Only a single
+     *        precision real value is stored for each voice and sample.
+     * @param[in] n          The number of samples in x.  This must equal
+     *                       \c getNumberOfSamples().
+     * @param[in] x          The signal to transform.  This is an array of
+     *                       dimension [n].
+     * @param[out] amplitude The amplitude of the S-transform.  This is a row
+     *                       major matrix of dimension [nVoices x n].
+     * @throws std::invalid_argument if any arguments are invalid.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void transformAmplitude(const int n, const T x[], float *amplitude[]);
+    /*! @} */
+private:
+    class StockwellTransformImpl;
+    std::unique_ptr<StockwellTransformImpl> pImpl;
+};
+}
+#endif
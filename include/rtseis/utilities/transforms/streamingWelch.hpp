@@ -0,0 +1,232 @@
+#ifndef RTSEIS_UTILITIES_TRANSFORMS_STREAMINGWELCH_HPP
+#define RTSEIS_UTILITIES_TRANSFORMS_STREAMINGWELCH_HPP 1
+#include <memory>
+#include "rtseis/utilities/transforms/enums.hpp"
+
+namespace RTSeis::Utilities::Transforms
+{
+class SlidingWindowRealDFTParameters;
+/*!
+ * @brief Estimates the power spectral density with Welch's method on a
+ *        stream of data.  Samples are appended as they arrive.  Each time
+ *        a full segment is available its modified periodogram is computed
+ *        and folded into a running average.  The samples in the overlap
+ *        are retained for the next segment.  Hence, the state of the class
+ *        is the partially filled segment and a handful of arrays whose
+ *        length is the number of frequencies.
+ * @note With cumulative averaging the estimate after the last sample of a
+ *       signal is identical to the result of \c Welch::transform() on that
+ *       signal.
+ * @author Ben Baker, University of Utah
+ * @copyright Ben Baker distributed under the MIT license.
+ * @sa Welch
+ */
+class StreamingWelch
+{
+public:
+    /*! @name Constructors
+     * @{
+     */
+    /*!
+     * @brief Default constructor.
+     */
+    StreamingWelch();
+    /*!
+     * @brief Copy constructor.
+     * @param[in] welch  The streaming Welch class from which to initialize
+     *                   this class.
+     */
+    StreamingWelch(const StreamingWelch &welch);
+    /*!
+     * @brief Move constructor.
+     * @param[in,out] welch  The streaming Welch class from which to
+     *                       initialize this class.  On exit, welch's behavior
+     *                       is undefined.
+     */
+    StreamingWelch(StreamingWelch &&welch) noexcept;
+    /*! @} */
+
+    /*! @name Operators
+     * @{
+     */
+    /*!
+     * @brief Copy assignment operator.
+     * @param[in] welch  The class to copy.
+     * @result A deep copy of the streaming Welch class.
+     * @throws std::runtime_error if there is an initialization error.
+     *         This is indicative of an internal error.
+     */
+    StreamingWelch& operator=(const StreamingWelch &welch);
+    /*!
+     * @brief Move assignment operator.
+     * @param[in,out] welch  The class to move to this.
+     *                       On exit welch's behavior is undefined.
+     * @result The memory that was moved from welch to this.
+     */
+    StreamingWelch& operator=(StreamingWelch &&welch) noexcept;
+    /*! @} */
+
+    /*! @name Destructors
+     * @{
+     */
+    /*!
+     * @brief Default destructor.
+     */
+    ~StreamingWelch();
+    /*!
+     * @brief Releases memory on the class.
+     */
+    void clear() noexcept;
+    /*! @} */
+
+    /*! @name Initialization
+     * @{
+     */
+    /*!
+     * @brief Initializes the streaming Welch estimator with cumulative
+     *        averaging.
+     * @param[in] parameters    The segment parameters.  The window, overlap,
+     *                          DFT length, and detrend type are used.  The
+     *                          number of samples is ignored since the
+     *                          signal length is not known in advance.
+     * @param[in] samplingRate  The sampling rate in Hz.  This must be
+     *                          positive.
+     * @throws std::invalid_argument if any parameters are incorrect or the
+     *         parameters output type is not COMPLEX.
+     */
+    void initialize(const SlidingWindowRealDFTParameters &parameters,
+                    const double samplingRate = 1.0);
+    /*!
+     * @brief Initializes the streaming Welch estimator with exponential
+     *        averaging.  After the first segment the estimate is updated as
+     *        \f$ \hat{P} \leftarrow (1 - \alpha) \hat{P} + \alpha P \f$
+     *        where \f$ P \f$ is the newest modified periodogram.
+     * @param[in] parameters    The segment parameters.  The number of samples
+     *                          is ignored.
+     * @param[in] alpha         The weight given to the newest segment.  This
+     *                          must be in the range (0,1].  The effective
+     *                          memory is roughly \f$ 1/\alpha \f$ segments.
+     * @param[in] samplingRate  The sampling rate in Hz.  This must be
+     *                          positive.
+     * @throws std::invalid_argument if any parameters are incorrect.
+     */
+    void initializeExponential(const SlidingWindowRealDFTParameters &parameters,
+                               const double alpha,
+                               const double samplingRate = 1.0);
+    /*!
+     * @brief Initializes the streaming Welch estimator with a moving block
+     *        average.  Segments are summed into blocks of nSegmentsPerBlock
+     *        segments.  The estimate is the average of the last nBlocks
+     *        completed blocks so it spans nSegmentsPerBlock*nBlocks segments
+     *        and is refreshed every nSegmentsPerBlock segments.  For example,
+     *        a one-hour estimate refreshed every five minutes uses 12 blocks.
+     * @param[in] parameters         The segment parameters.  The number of
+     *                               samples is ignored.
+     * @param[in] nSegmentsPerBlock  The number of segments in a block.  This
+     *                               must be positive.
+     * @param[in] nBlocks            The number of blocks in the average.
+     *                               This must be positive.
+     * @param[in] samplingRate       The sampling rate in Hz.  This must be
+     *                               positive.
+     * @throws std::invalid_argument if any parameters are incorrect.
+     */
+    void initializeMovingBlock(const SlidingWindowRealDFTParameters &parameters,
+                               const int nSegmentsPerBlock,
+                               const int nBlocks = 1,
+                               const double samplingRate = 1.0);
+    /*!
+     * @brief Flag indicating whether or not the class is initialized.
+     * @result True indicates that the class is inititalized.
+     */
+    bool isInitialized() const noexcept;
+    /*!
+     * @brief Gets the averaging strategy.
+     * @result The averaging strategy.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    WelchAveragingType getAveragingType() const;
+    /*! @} */
+
+    /*!
+     * @brief Appends samples to the stream.  Every segment completed by these
+     *        samples is transformed and folded into the estimate.
+     * @param[in] nSamples  The number of samples to append.  If this is not
+     *                      positive then nothing happens.
+     * @param[in] x         The samples to append.  This is an array whose
+     *                      dimension is [nSamples].
+     * @throws std::invalid_argument if x is NULL.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void update(const int nSamples, const double x[]);
+    /*!
+     * @brief Discards the buffered samples and the running estimate.  This
+     *        may be useful after a gap is encountered.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void reset();
+    /*!
+     * @brief Returns whether or not an estimate is available.
+     * @retval True indicates that at least one segment has been averaged.
+     */
+    bool haveTransform() const noexcept;
+    /*!
+     * @brief Gets the number of segments contributing to the current
+     *        estimate.  For exponential averaging this is the number of
+     *        segments processed since the last reset.
+     * @result The number of averaged segments.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    int getNumberOfAveragedSegments() const;
+    /*!
+     * @brief Returns the number of frequencies.
+     * @result The number of frequencies.
+     * @throws std::runtime_error if the class is not intitialized.
+     */
+    int getNumberOfFrequencies() const;
+    /*!
+     * @brief Gets the frequencies at which the power spectral density is
+     *        estimated.
+     * @param[in] nFrequencies  The number of frequencies.  This must match the
+     *                          result of \c getNumberOfFrequencies().
+     * @param[out] frequencies  The frequencies (Hz).  This is an array of
+     *                          dimension [nFrequencies].
+     * @throws std::invalid_argument if nFrequencies is invalid or frequencies
+     *         is NULL.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void getFrequencies(const int nFrequencies, double *frequencies[]) const;
+    /*!
+     * @brief Gets the current power spectral density estimate.
+     * @param[in] nFrequencies  The number of frequencies. This must match the
+     *                          result of \c getNumberOfFrequencies().
+     * @param[out] psd          The power spectral density.  This is an array
+     *                          of dimension [nFrequencies].  If the input
+     *                          signal has units of \f$ Volts \f$ then this
+     *                          has units of \f$ \frac{Volts^2}{Hz} \f$.
+     * @throws std::invalid_argument if nFrequencies is invalid or psd is NULL.
+     * @throws std::runtime_error if the class is not initialized or no
+     *         segment has been averaged.
+     * @sa \c haveTransform()
+     */
+    void getPowerSpectralDensity(const int nFrequencies, double *psd[]) const;
+    /*!
+     * @brief Gets the current power spectrum estimate.
+     * @param[in] nFrequencies    The number of frequencies. This must match the
+     *                            result of \c getNumberOfFrequencies().
+     * @param[out] powerSpectrum  The power spectrum.  This is an array of
+     *                            of dimension [nFrequencies].  If the input
+     *                            signal has units of \f$ Volts \f$ then this
+     *                            has units of \f$ Volts^2 \f$.
+     * @throws std::invalid_argument if nFrequencies is invalid or
+     *         powerSpectrum is NULL.
+     * @throws std::runtime_error if the class is not initialized or no
+     *         segment has been averaged.
+     * @sa \c haveTransform()
+     */
+    void getPowerSpectrum(const int nFrequencies, double *powerSpectrum[]) const;
+private:
+    class StreamingWelchImpl;
+    std::unique_ptr<StreamingWelchImpl> pImpl;
+};
+}
+#endif
@@ -0,0 +1,167 @@
+#ifndef RTSEIS_UTILITIES_TRANSFORMS_TIMESHIFT_HPP
+#define RTSEIS_UTILITIES_TRANSFORMS_TIMESHIFT_HPP 1
+#include <memory>
+
+namespace RTSeis::Utilities::Transforms
+{
+/*!
+ * @class TimeShift timeShift.hpp "include/rtseis/utilities/transforms/timeShift.hpp"
+ * @brief Shifts signals by arbitrary, possibly fractional, amounts of time.
+ *        A signal \f$ x(t) \f$ is shifted to \f$ y(t) = x(t - \tau) \f$ by
+ *        applying the linear phase ramp
+ *        \f[
+ *           Y(\omega) = e^{-i \omega \tau} X(\omega)
+ *        \f]
+ *        to its DFT.  This is the band-limited interpolant of the signal so
+ *        integer shifts are exact and fractional shifts are free of the
+ *        amplitude and phase distortions of time domain interpolators.
+ * @note The signals are zero-padded so that samples shifted out of the
+ *       window do not wrap around.  The transforms are planned once, when
+ *       the class is initialized, and the signals are distributed over
+ *       OpenMP threads.  Optionally, the ends of each signal can be cosine
+ *       tapered before shifting to suppress ringing from the truncation.
+ * @ingroup rtseis_utils_transforms
+ */
+template<class T = double>
+class TimeShift
+{
+public:
+    /*! @name Constructors
+     * @{
+     */
+    /*!
+     * @brief Default constructor.
+     */
+    TimeShift();
+    /*!
+     * @brief Copy constructor.
+     * @param[in] timeShift  Class from which to initialize.
+     */
+    TimeShift(const TimeShift &timeShift);
+    /*!
+     * @brief Move constructor.
+     * @param[in,out] timeShift  Class from which this class is initialized.
+     *                           On exit timeShift's behavior is undefined.
+     */
+    TimeShift(TimeShift &&timeShift) noexcept;
+    /*! @} */
+
+    /*! @name Operators
+     * @{
+     */
+    /*!
+     * @brief Copy assignment operator.
+     * @param[in] timeShift  Time shift class to copy.
+     * @result A deep copy of the input class.
+     */
+    TimeShift& operator=(const TimeShift &timeShift);
+    /*!
+     * @brief Move assignment operator.
+     * @param[in,out] timeShift  On entry this is the class to move.  On exit
+     *                           timeShift's behavior is undefined.
+     * @result timeShift has been moved to this class.
+     */
+    TimeShift& operator=(TimeShift &&timeShift) noexcept;
+    /*! @} */
+
+    /*! @name Destructors
+     * @{
+     */
+    /*!
+     * @brief Destructor.
+     */
+    ~TimeShift();
+    /*!
+     * @brief Resets the module and releases all memory.
+     */
+    void clear() noexcept;
+    /*! @} */
+
+    /*! @name Initialization
+     * @{
+     */
+    /*!
+     * @brief Initializes the time shifter.
+     * @param[in] nSamples         The number of samples in each signal.  This
+     *                             must be positive.
+     * @param[in] maximumShift     The largest absolute shift in seconds that
+     *                             will be applied.  This cannot be negative.
+     *                             The signals are zero-padded by at least
+     *                             this many seconds.
+     * @param[in] samplingRate     The sampling rate in Hz.  This must be
+     *                             positive.
+     * @param[in] taperPercentage  The percentage of each signal to taper
+     *                             with a cosine (Hann) window before it is
+     *                             shifted.  Half of this is applied to each
+     *                             end.  This must be in the range [0,100].
+     *                             If this is 0 then no taper is applied.
+     * @throws std::invalid_argument if any arguments are invalid.
+     */
+    void initialize(const int nSamples,
+                    const double maximumShift,
+                    const double samplingRate = 1.0,
+                    const double taperPercentage = 0);
+    /*!
+     * @brief Determines whether or not the class is initialized.
+     * @retval True indicates that the class is initialized.
+     */
+    bool isInitialized() const noexcept;
+    /*! @} */
+
+    /*!
+     * @brief Gets the number of samples in each signal.
+     * @result The number of samples.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    int getNumberOfSamples() const;
+    /*!
+     * @brief Gets the largest absolute shift that can be applied.
+     * @result The maximum shift in seconds.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    double getMaximumShift() const;
+
+    /*! @name Shifting
+     * @{
+     */
+    /*!
+     * @brief Shifts a signal.
+     * @param[in] nSamples  The number of samples in x.  This must equal
+     *                      \c getNumberOfSamples().
+     * @param[in] x         The signal to shift.  This is an array of
+     *                      dimension [nSamples].
+     * @param[in] shift     The shift in seconds.  A positive shift delays
+     *                      the signal.  The absolute value cannot exceed
+     *                      \c getMaximumShift().
+     * @param[out] y        The shifted signal.  This is an array of
+     *                      dimension [nSamples].
+     * @throws std::invalid_argument if any arguments are invalid.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void transform(const int nSamples, const T x[], const double shift,
+                   T *y[]);
+    /*!
+     * @brief Shifts each of several signals by its own amount.
+     * @param[in] nSignals  The number of signals.  This must be positive.
+     * @param[in] nSamples  The number of samples in each signal.  This must
+     *                      equal \c getNumberOfSamples().
+     * @param[in] x         The signals to shift.  This is a row major matrix
+     *                      of dimension [nSignals x nSamples].
+     * @param[in] shifts    The shift in seconds of each signal.  This is an
+     *                      array of dimension [nSignals].  A positive shift
+     *                      delays the signal.  The absolute values cannot
+     *                      exceed \c getMaximumShift().
+     * @param[out] y        The shifted signals.  This is a row major matrix
+     *                      of dimension [nSignals x nSamples].
+     * @throws std::invalid_argument if any arguments are invalid.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void transform(const int nSignals, const int nSamples, const T x[],
+                   const double shifts[], T *y[]);
+    /*! @} */
+private:
+    class TimeShiftImpl;
+    std::unique_ptr<TimeShiftImpl> pImpl;
+};
+}
+#endif
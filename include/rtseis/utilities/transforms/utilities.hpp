@@ -145,6 +145,20 @@ void realToComplexDFTFrequencies(const int nSamples,
  * @ingroup rtseis_utils_transforms_utils
  */
 int nextPowerOfTwo(const int n);
+/*!
+ * @brief Finds the smallest number, n2, such that n2 is greater than or
+ *        equal to n and n2 has no prime factors other than 2, 3, 5, and 7,
+ *        i.e., \f$ n_2 = 2^a 3^b 5^c 7^d \f$.  The mixed-radix DFT is
+ *        efficient at these lengths so zero-padding to n2 rather than to
+ *        the next power of 2 can nearly halve the work and memory.
+ * @param[in] n  Non-negative number of which to find the next fast length.
+ * @result On successful exit this is the smallest 7-smooth number that is
+ *         greater than or equal to n.
+ * @throws std::invalid_argument if n is negative.
+ * @throws std::runtime_error if n is too large and there is an overflow.
+ * @ingroup rtseis_utils_transforms_utils
+ */
+int nextFastLength(const int n);
 
 /*! @name Shuffle
  * @{
@@ -108,7 +108,8 @@ public:
      * @param[in] detrendType         Defines the detrend strategy to be
      *                                applied to each signal prior to windowing.
      * @param[in] precision           The precision of the underlying DFT.
-     * @throws std::invalid_argument if any parameters are incorrect.
+     * @throws std::invalid_argument if any parameters are incorrect or the
+     *         parameters output type is not COMPLEX.
      */
     void initialize(const SlidingWindowRealDFTParameters &parameters,
                     const double samplingRate = 1.0);
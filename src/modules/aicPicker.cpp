@@ -0,0 +1,464 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cfloat>
+#include <cmath>
+#include <algorithm>
+#define RTSEIS_LOGGING 1
+#include "rtseis/log.h"
+#include "rtseis/modules/aicPicker.hpp"
+#include "rtseis/private/runningSum.hpp"
+
+using namespace RTSeis::Modules;
+using RTSeis::Private::neumaierAdd;
+
+namespace
+{
+/// Below this many samples the windows aren't worth distributing
+/// over threads
+constexpr int minParallelSamples = 4096;
+/// Segment variances are at least this fraction of the window's variance
+constexpr double relativeVarianceFloor = 1.e-6;
+}
+
+class AICPicker::AICPickerImpl
+{
+    public:
+        /// Releases memory on the module
+        void clear(void)
+        {
+            nmin_ = 0;
+            linit_ = false;
+            return;
+        }
+        //--------------------------------------------------------------------//
+        int initialize(const int nmin)
+        {
+            clear();
+            nmin_ = nmin;
+            linit_ = true;
+            return 0;
+        }
+        /// Determines if the module is initialized
+        bool isInitialized(void) const
+        {
+            return linit_;
+        }
+        /// Gets the minimum segment length
+        int getMinimumSegmentLength(void) const
+        {
+            return nmin_;
+        }
+        /// Evaluates the AIC at every admissible split point k of x and
+        /// passes k and AIC(k) to consume
+        template<typename T, typename F>
+        void scan(const int nx, const T x[], F consume) const
+        {
+            // Remove the mean so the sums of squares don't cancel
+            double mean = 0;
+            double cMean = 0;
+            for (int i=0; i<nx; ++i)
+            {
+                neumaierAdd(static_cast<double> (x[i]), &mean, &cMean);
+            }
+            mean = (mean + cMean)/static_cast<double> (nx);
+            // Also find the smallest step between distinct samples which,
+            // for digitized data, is the quantization step
+            double s1 = 0, c1 = 0, s2 = 0, c2 = 0;
+            double step = DBL_MAX;
+            for (int i=0; i<nx; ++i)
+            {
+                auto d = static_cast<double> (x[i]) - mean;
+                neumaierAdd(d, &s1, &c1);
+                neumaierAdd(d*d, &s2, &c2);
+                if (i > 0)
+                {
+                    auto dx = std::abs(static_cast<double> (x[i])
+                                     - static_cast<double> (x[i-1]));
+                    if (dx > 0){step = std::min(step, dx);}
+                }
+            }
+            s1 = s1 + c1;
+            s2 = s2 + c2;
+            // A segment's variance can't be resolved below the variance of
+            // the quantization noise, step^2/12, so a run of identical
+            // samples doesn't look infinitely quiet.  The floor is at
+            // least a small fraction of the window's variance so that
+            // runs of identical samples in finely quantized data don't
+            // dominate either.
+            auto varWindow = s2/static_cast<double> (nx);
+            auto varMin = std::max(relativeVarianceFloor*varWindow, DBL_MIN);
+            if (step < DBL_MAX){varMin = std::max(varMin, step*step/12);}
+            // Sweep the split point.  The left segment is x[0:k] and the
+            // right segment's sums are the totals less the left's.
+            double s1L = 0, c1L = 0, s2L = 0, c2L = 0;
+            for (int k=1; k<=nx-nmin_; ++k)
+            {
+                auto d = static_cast<double> (x[k-1]) - mean;
+                neumaierAdd(d, &s1L, &c1L);
+                neumaierAdd(d*d, &s2L, &c2L);
+                if (k < nmin_){continue;}
+                auto nL = static_cast<double> (k);
+                auto nR = static_cast<double> (nx - k);
+                auto sum1L = s1L + c1L;
+                auto sum2L = s2L + c2L;
+                auto sum1R = s1 - sum1L;
+                auto sum2R = s2 - sum2L;
+                auto varL = std::max((sum2L - sum1L*sum1L/nL)/nL, varMin);
+                auto varR = std::max((sum2R - sum1R*sum1R/nR)/nR, varMin);
+                consume(k, nL*std::log(varL) + nR*std::log(varR));
+            }
+        }
+        /// Computes the AIC curve
+        template<typename T>
+        void computeAIC(const int nx, const T x[], T aic[]) const
+        {
+            if (nx < 2*nmin_)
+            {
+                std::fill(aic, aic + nx, 0);
+                return;
+            }
+            double aicMax =-DBL_MAX;
+            scan(nx, x, [&](const int k, const double value)
+                 {
+                     aic[k] = static_cast<T> (value);
+                     aicMax = std::max(aicMax, value);
+                 });
+            std::fill(aic, aic + nmin_, static_cast<T> (aicMax));
+            std::fill(aic + nx - nmin_ + 1, aic + nx, static_cast<T> (aicMax));
+        }
+        /// Picks the onset
+        template<typename T>
+        void pick(const int nx, const T x[], AICPick *pick) const
+        {
+            pick->index =-1;
+            pick->quality = 0;
+            if (nx < 2*nmin_){return;}
+            // Track the minimum and the sum of the Akaike weights
+            // exp(-(AIC - AIC_min)/2) relative to the running minimum
+            double aicMin = DBL_MAX;
+            double weightSum = 0;
+            int kMin =-1;
+            scan(nx, x, [&](const int k, const double value)
+                 {
+                     if (value < aicMin)
+                     {
+                         if (kMin >= 0)
+                         {
+                             weightSum = weightSum
+                                       *std::exp(-0.5*(aicMin - value));
+                         }
+                         aicMin = value;
+                         kMin = k;
+                         weightSum = weightSum + 1;
+                     }
+                     else
+                     {
+                         weightSum = weightSum
+                                   + std::exp(-0.5*(value - aicMin));
+                     }
+                 });
+            pick->index = kMin;
+            pick->quality = 1/weightSum;
+        }
+        /// Picks the onsets in a batch of windows
+        template<typename T>
+        void pick(const int nWindows, const int nx[], const T *const x[],
+                  AICPick picks[]) const
+        {
+            double nTotal = 0;
+            for (int i=0; i<nWindows; ++i){nTotal = nTotal + nx[i];}
+            #pragma omp parallel for schedule(dynamic, 16) \
+                    if (nWindows > 1 && nTotal >= minParallelSamples)
+            for (int i=0; i<nWindows; ++i)
+            {
+                pick(nx[i], x[i], &picks[i]);
+            }
+        }
+    private:
+        /// The minimum number of samples on either side of a split point
+        int nmin_ = 0;
+        /// Flag indicating the class is initialized
+        bool linit_ = false;
+};
+
+//============================================================================//
+
+AICPickerParameters::AICPickerParameters()
+{
+    return;
+}
+
+AICPickerParameters::AICPickerParameters(const AICPickerParameters &parameters)
+{
+    *this = parameters;
+    return;
+}
+
+AICPickerParameters&
+AICPickerParameters::operator=(const AICPickerParameters &parameters)
+{
+    if (&parameters == this){return *this;}
+    clear();
+    nmin_ = parameters.nmin_;
+    precision_ = parameters.precision_;
+    isValid_ = parameters.isValid_;
+    return *this;
+}
+
+AICPickerParameters::AICPickerParameters(const int nmin,
+                                         const RTSeis::Precision prec)
+{
+    int ierr = setMinimumSegmentLength(nmin);
+    if (ierr != 0)
+    {
+        clear();
+        return;
+    }
+    precision_ = prec;
+    // Validate
+    validate_();
+    return;
+}
+
+AICPickerParameters::~AICPickerParameters()
+{
+    clear();
+}
+
+void AICPickerParameters::clear()
+{
+    nmin_ = 0;
+    precision_ = defaultPrecision_;
+    isValid_ = false;
+    return;
+}
+
+int AICPickerParameters::setMinimumSegmentLength(const int nmin)
+{
+    if (nmin < 2)
+    {
+        RTSEIS_ERRMSG("Minimum segment length=%d must be at least 2", nmin);
+        return -1;
+    }
+    nmin_ = nmin;
+    validate_();
+    return 0;
+}
+
+int AICPickerParameters::getMinimumSegmentLength() const
+{
+    return nmin_;
+}
+
+RTSeis::Precision AICPickerParameters::getPrecision(void) const
+{
+    return precision_;
+}
+
+bool AICPickerParameters::isValid() const
+{
+    return isValid_;
+}
+
+void AICPickerParameters::validate_()
+{
+    isValid_ = false;
+    if (nmin_ < 2){return;}
+    if (getPrecision() != RTSeis::Precision::DOUBLE &&
+        getPrecision() != RTSeis::Precision::FLOAT){return;}
+    isValid_ = true;
+    return;
+}
+
+//============================================================================//
+//                                 End Parameters                             //
+//============================================================================//
+
+AICPicker::AICPicker(void) :
+    pPicker_(new AICPickerImpl())
+{
+    clear();
+}
+
+AICPicker::AICPicker(const AICPicker &picker)
+{
+    *this = picker;
+}
+
+AICPicker::~AICPicker()
+{
+    clear();
+    return;
+}
+
+void AICPicker::clear()
+{
+    pPicker_->clear();
+    return;
+}
+
+AICPicker::AICPicker(const AICPickerParameters &parameters) :
+    pPicker_(new AICPickerImpl())
+{
+    clear();
+    if (!parameters.isValid())
+    {
+        RTSEIS_ERRMSG("%s", "Parameters are not valid");
+        return;
+    }
+    int ierr = pPicker_->initialize(parameters.getMinimumSegmentLength());
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to initialize module");
+        return;
+    }
+    return;
+}
+
+AICPicker& AICPicker::operator=(const AICPicker &picker)
+{
+    if (&picker == this){return *this;}
+    if (pPicker_){pPicker_->clear();}
+    pPicker_ = std::unique_ptr<AICPickerImpl>
+              (new AICPickerImpl(*picker.pPicker_));
+    return *this;
+}
+
+bool AICPicker::isInitialized() const
+{
+    return pPicker_->isInitialized();
+}
+
+int AICPicker::computeAIC(const int nx, const double x[], double aic[]) const
+{
+    if (nx <= 0){return 0;} // Nothing to do
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    if (x == nullptr || aic == nullptr)
+    {
+        if (x == nullptr){RTSEIS_ERRMSG("%s", "x is NULL");}
+        if (aic == nullptr){RTSEIS_ERRMSG("%s", "aic is NULL");}
+        return -1;
+    }
+    pPicker_->computeAIC(nx, x, aic);
+    return 0;
+}
+
+int AICPicker::computeAIC(const int nx, const float x[], float aic[]) const
+{
+    if (nx <= 0){return 0;} // Nothing to do
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    if (x == nullptr || aic == nullptr)
+    {
+        if (x == nullptr){RTSEIS_ERRMSG("%s", "x is NULL");}
+        if (aic == nullptr){RTSEIS_ERRMSG("%s", "aic is NULL");}
+        return -1;
+    }
+    pPicker_->computeAIC(nx, x, aic);
+    return 0;
+}
+
+int AICPicker::apply(const int nx, const double x[], AICPick *pick) const
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    if (pick == nullptr)
+    {
+        RTSEIS_ERRMSG("%s", "pick is NULL");
+        return -1;
+    }
+    if (nx > 0 && x == nullptr)
+    {
+        RTSEIS_ERRMSG("%s", "x is NULL");
+        return -1;
+    }
+    pPicker_->pick(nx, x, pick);
+    return 0;
+}
+
+int AICPicker::apply(const int nx, const float x[], AICPick *pick) const
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    if (pick == nullptr)
+    {
+        RTSEIS_ERRMSG("%s", "pick is NULL");
+        return -1;
+    }
+    if (nx > 0 && x == nullptr)
+    {
+        RTSEIS_ERRMSG("%s", "x is NULL");
+        return -1;
+    }
+    pPicker_->pick(nx, x, pick);
+    return 0;
+}
+
+int AICPicker::apply(const int nWindows, const int nx[],
+                     const double *const x[], AICPick picks[]) const
+{
+    if (nWindows <= 0){return 0;} // Nothing to do
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    if (nx == nullptr || x == nullptr || picks == nullptr)
+    {
+        if (nx == nullptr){RTSEIS_ERRMSG("%s", "nx is NULL");}
+        if (x == nullptr){RTSEIS_ERRMSG("%s", "x is NULL");}
+        if (picks == nullptr){RTSEIS_ERRMSG("%s", "picks is NULL");}
+        return -1;
+    }
+    for (int i=0; i<nWindows; i++)
+    {
+        if (nx[i] > 0 && x[i] == nullptr)
+        {
+            RTSEIS_ERRMSG("x[%d] is NULL", i);
+            return -1;
+        }
+    }
+    pPicker_->pick(nWindows, nx, x, picks);
+    return 0;
+}
+
+int AICPicker::apply(const int nWindows, const int nx[],
+                     const float *const x[], AICPick picks[]) const
+{
+    if (nWindows <= 0){return 0;} // Nothing to do
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    if (nx == nullptr || x == nullptr || picks == nullptr)
+    {
+        if (nx == nullptr){RTSEIS_ERRMSG("%s", "nx is NULL");}
+        if (x == nullptr){RTSEIS_ERRMSG("%s", "x is NULL");}
+        if (picks == nullptr){RTSEIS_ERRMSG("%s", "picks is NULL");}
+        return -1;
+    }
+    for (int i=0; i<nWindows; i++)
+    {
+        if (nx[i] > 0 && x[i] == nullptr)
+        {
+            RTSEIS_ERRMSG("x[%d] is NULL", i);
+            return -1;
+        }
+    }
+    pPicker_->pick(nWindows, nx, x, picks);
+    return 0;
+}
@@ -4,90 +4,30 @@
 #include <cfloat>
 #include <vector>
 #include <cmath>
+#include <algorithm>
 #define RTSEIS_LOGGING 1
 #include "rtseis/log.h"
 #include "rtseis/modules/classicSTALTA.hpp"
-#include "rtseis/utilities/filterImplementations/firFilter.hpp"
-#include "rtseis/utilities/filterImplementations/enums.hpp"
-#include <ipps.h>
+#include "rtseis/modules/thresholdTrigger.hpp"
+#include "rtseis/private/runningSum.hpp"
 
 using namespace RTSeis::Modules;
+using RTSeis::Private::RunningAverage;
+
+namespace
+{
+/// The STA/LTA is passed to a trigger in blocks of this many samples
+constexpr int triggerBlockSize = 256;
+}
 
 class ClassicSTALTA::ClassicSTALTAImpl
 {
     public:
-        /// Default constructor
-        ClassicSTALTAImpl(void)
-        {
-            return;
-        }
-        /// Copy constructor
-        ClassicSTALTAImpl(const ClassicSTALTAImpl &stalta)
-        { 
-            *this = stalta;
-            return;
-        }
-        /// Classic destructor
-        ~ClassicSTALTAImpl(void) 
-        {
-            clear();
-            return;
-        }
-        /// Copy assignment operator
-        ClassicSTALTAImpl& operator=(const ClassicSTALTAImpl &stalta)
-        {
-            if (&stalta == this){return *this;} 
-            clear();
-            if (!stalta.linit_){return *this;}
-            firNum_ = stalta.firNum_;
-            firDen_ = stalta.firDen_;
-            nsta_ = stalta.nsta_;
-            nlta_ = stalta.nlta_;
-            chunkSize_ = stalta.chunkSize_;
-            mode_ = stalta.mode_;
-            precision_ = stalta.precision_;
-            linit_ = stalta.linit_;
-            if (chunkSize_ > 0)
-            {
-                if (precision_ == RTSeis::Precision::DOUBLE)
-                {
-                    x264f_   = ippsMalloc_64f(chunkSize_);
-                    ippsCopy_64f(stalta.x264f_, x264f_, chunkSize_);
-                    ynum64f_ = ippsMalloc_64f(chunkSize_);
-                    ippsCopy_64f(stalta.ynum64f_, ynum64f_, chunkSize_);
-                    yden64f_ = ippsMalloc_64f(chunkSize_);
-                    ippsCopy_64f(stalta.yden64f_, yden64f_, chunkSize_);
-                }
-                else
-                {
-                    x232f_   = ippsMalloc_32f(chunkSize_);
-                    ippsCopy_32f(stalta.x232f_, x232f_, chunkSize_);
-                    ynum32f_ = ippsMalloc_32f(chunkSize_);
-                    ippsCopy_32f(stalta.ynum32f_, ynum32f_, chunkSize_);
-                    yden32f_ = ippsMalloc_32f(chunkSize_);
-                    ippsCopy_32f(stalta.yden32f_, yden32f_, chunkSize_);
-                }
-            }
-            return *this;
-        }
         /// Releases memory on the module
         void clear(void)
         {
-            firNum_.clear();
-            firDen_.clear();
-            if (x264f_ != nullptr){ippsFree(x264f_);}
-            if (ynum64f_ != nullptr){ippsFree(ynum64f_);}
-            if (yden64f_ != nullptr){ippsFree(yden64f_);}
-            if (x232f_ != nullptr){ippsFree(x232f_);}
-            if (ynum32f_ != nullptr){ippsFree(ynum32f_);}
-            if (yden32f_ != nullptr){ippsFree(yden32f_);}
-            x264f_ = nullptr;
-            ynum64f_ = nullptr;
-            yden64f_ = nullptr;
-            x232f_ = nullptr;
-            ynum32f_ = nullptr;
-            yden32f_ = nullptr;
-            chunkSize_ = 1024;
+            sta_ = RunningAverage();
+            lta_ = RunningAverage();
             nsta_ = 0;
             nlta_ = 0;
             mode_ = RTSeis::ProcessingMode::POST_PROCESSING;
@@ -97,54 +37,21 @@ class ClassicSTALTA::ClassicSTALTAImpl
         }
         //--------------------------------------------------------------------//
         int initialize(const int nsta, const int nlta,
-                       const int chunkSize,
                        const RTSeis::ProcessingMode mode,
                        const RTSeis::Precision precision)
         {
             clear();
-            // Set constants
-            RTSeis::ProcessingMode modeRT = RTSeis::ProcessingMode::REAL_TIME;
             nsta_ = nsta;
             nlta_ = nlta;
-            chunkSize_ = chunkSize;
-            // Set the short-term averaging filter coefficients
-            Ipp64f *xsta = ippsMalloc_64f(nsta_);
-            double xdiv = 1.0/static_cast<double> (nsta_);
-            ippsSet_64f(xdiv, xsta, nsta_);
-            firNum_.initialize(nsta_, xsta, modeRT,
-              RTSeis::Utilities::FilterImplementations::FIRImplementation::DIRECT);
-            // Set the initial conditions to 0
-            ippsSet_64f(0, xsta, nsta_);
-            firNum_.setInitialConditions(nsta_-1, xsta); 
-            ippsFree(xsta);
-            // Set the long-term averaging filter coefficients
-            Ipp64f *xlta = ippsMalloc_64f(nlta_);
-            xdiv = 1.0/static_cast<double> (nlta_);
-            ippsSet_64f(xdiv, xlta, nlta_);
-            firDen_.initialize(nlta_, xlta, modeRT,
-                 RTSeis::Utilities::FilterImplementations::FIRImplementation::DIRECT);
-            // Set the initial conditions to something large
+            // The short-term average initial conditions are 0
+            sta_.initialize(nsta_, 0);
+            // Set the long-term initial conditions to something large
             double xset = DBL_MAX/static_cast<double> (nlta_)/4.0; 
             if (precision == RTSeis::Precision::FLOAT)
             {
                  xset = FLT_MAX/static_cast<double> (nlta_)/4.0;
             }
-            ippsSet_64f(xset, xlta, nlta_);
-            firDen_.setInitialConditions(nlta_-1, xlta);
-            ippsFree(xlta);
-            // Initialize workspace
-            if (precision == RTSeis::Precision::DOUBLE)
-            {
-                x264f_   = ippsMalloc_64f(chunkSize_);
-                ynum64f_ = ippsMalloc_64f(chunkSize_);
-                yden64f_ = ippsMalloc_64f(chunkSize_);
-            } 
-            else
-            {
-                x232f_   = ippsMalloc_32f(chunkSize_);
-                ynum32f_ = ippsMalloc_32f(chunkSize_);
-                yden32f_ = ippsMalloc_32f(chunkSize_);
-            }
+            lta_.initialize(nlta_, xset);
             mode_ = mode;
             precision_ = precision;
             linit_ = true;
@@ -158,71 +65,38 @@ class ClassicSTALTA::ClassicSTALTAImpl
         /// Gets length of the numerator initial conditons
         int getNumeratorInitialConditionLength(void) const
         {
-            return firNum_.getInitialConditionLength();
+            return sta_.getInitialConditionLength();
         }
         /// Gets length of the denominator initial conditons
         int getDenominatorInitialConditionLength(void) const
         {
-            return firDen_.getInitialConditionLength();
+            return lta_.getInitialConditionLength();
         }
         /// Sets the initial conditions
         int setInitialConditions(const int nzNum, const double zNum[],
                                  const int nzDen, const double zDen[])
         {
-            resetInitialConditions(); 
-            // Set the initial conditions
             int nzNumRef = getNumeratorInitialConditionLength();
             int nzDenRef = getDenominatorInitialConditionLength();
             if (nzNumRef != nzNum){RTSEIS_ERRMSG("%s", "Shouldn't happen");}
             if (nzDenRef != nzDen){RTSEIS_ERRMSG("%s", "Shouldn't happen");}
-            // Set numerator initial conditions
-            firNum_.setInitialConditions(nzNumRef, zNum);
-            firDen_.setInitialConditions(nzDenRef, zDen);
+            sta_.setInitialConditions(zNum);
+            lta_.setInitialConditions(zDen);
             return 0;
         }
         /// Resets the initial conditions
         int resetInitialConditions(void)
         {
-            firNum_.resetInitialConditions();
-            firDen_.resetInitialConditions();
+            sta_.reset();
+            lta_.reset();
             return 0;
         }
         /// Applies the STA/LTA
-        int apply(const int nx, const double x[], double y[])
+        template<typename T>
+        int apply(const int nx, const T x[], T y[])
         {
             if (nx <= 0){return 0;} // Nothing to do
-            for (int i=0; i<nx; i=i+chunkSize_)
-            {
-                int nloc = std::min(chunkSize_, nx - i);
-                // Compute the squared signal
-                ippsSqr_64f(&x[i], x264f_, nloc);
-                // Compute the numerator average 
-                firNum_.apply(nloc, x264f_, &ynum64f_);
-                // Compute the denominator average
-                firDen_.apply(nloc, x264f_, &yden64f_);
-                // Pointwise division
-                IppStatus status = ippsDiv_64f(yden64f_, ynum64f_, &y[i], nloc);
-                if (status != ippStsNoErr)
-                {
-                    // Division by zero error can be handled.  This means the
-                    // the numerator must be 0 as well - so we force the division
-                    // 0/0 = 0.  The head is that a dead signal won't trigger.
-                    if (status == ippStsDivByZero)
-                    {
-                       RTSEIS_WARNMSG("%s", "Division by zero detected");
-                       // if |yden| < DBL_MIN then y = 0
-                       status = ippsThreshold_LTAbsVal_64f(yden64f_, &y[i],
-                                                           nloc,
-                                                           DBL_MIN, 0.0);
-                    }
-                    // Unrecoverable error
-                    if (status != ippStsNoErr)
-                    {
-                        RTSEIS_ERRMSG("%s", "Error computing ynum/yden");
-                        return -1;
-                    }
-                }
-            }
+            compute(nx, x, y);
             // Reset the initial conditions for post-processing
             if (mode_ == RTSeis::ProcessingMode::POST_PROCESSING)
             {
@@ -230,45 +104,16 @@ class ClassicSTALTA::ClassicSTALTAImpl
             }
             return 0;
         }
-/*
-        /// Applies the STA/LTA
-        int apply(const int nx, const float x[], float y[])
+        /// Applies the STA/LTA and passes it to consume in blocks
+        template<typename T, typename F>
+        int apply(const int nx, const T x[], F consume)
         {
-            if (nx <= 0){return 0;} // Nothing to do
-            for (int i=0; i<nx; i=i+chunkSize_)
+            T y[triggerBlockSize];
+            for (int i=0; i<nx; i=i+triggerBlockSize)
             {
-                int nloc = std::min(chunkSize_, nx - i);
-                // Compute the squared signal
-                auto xPtr = reinterpret_cast<float *> (x232f_);
-                ippsSqr_32f(&x[i], xPtr, nloc);
-                // Compute the numerator average 
-                auto yPtr = reinterpret_cast<float *> (ynum32f_);
-                firNum_.apply(nloc, xPtr, &yPtr); //ynum32f_);
-                // Compute the denominator average
-                auto yPtr = reinterpret_cast<float *> (yden32f_);
-                firDen_.apply(nloc, xPtr, &yPtr); //yden32f_);
-                // Pointwise division
-                IppStatus status = ippsDiv_32f(yden32f_, ynum32f_, &y[i], nloc);
-                if (status != ippStsNoErr)
-                {
-                    // Division by zero error can be handled.  This means the
-                    // the numerator must be 0 as well - so we force the division
-                    // 0/0 = 0.  The head is that a dead signal won't trigger.
-                    if (status == ippStsDivByZero)
-                    {
-                        RTSEIS_WARNMSG("%s", "Division by zero detected");
-                        // if |yden| < DBL_MIN then y = 0
-                        status = ippsThreshold_LTAbsVal_32f(yden32f_, &y[i],
-                                                            nloc,
-                                                            FLT_MIN, 0.0f);
-                    }
-                    // Unrecoverable error
-                    if (status != ippStsNoErr)
-                    {
-                        RTSEIS_ERRMSG("%s", "Error computing ynum/yden");
-                        return -1;
-                    }
-                }
+                auto n = std::min(triggerBlockSize, nx - i);
+                compute(n, &x[i], y);
+                consume(n, y);
             }
             // Reset the initial conditions for post-processing
             if (mode_ == RTSeis::ProcessingMode::POST_PROCESSING)
@@ -277,34 +122,33 @@ class ClassicSTALTA::ClassicSTALTAImpl
             }
             return 0;
         }
-*/
     private:
+        /// Computes the STA/LTA
+        template<typename T>
+        void compute(const int nx, const T x[], T y[])
+        {
+            for (int i=0; i<nx; ++i)
+            {
+                auto x2 = static_cast<double> (x[i])*static_cast<double> (x[i]);
+                auto ynum = sta_.push(x2);
+                auto yden = lta_.push(x2);
+                // A dead signal has a zero denominator and numerator so
+                // force 0/0 = 0.  The upshot is that it won't trigger.
+                y[i] = 0;
+                if (std::abs(yden) >= DBL_MIN)
+                {
+                    y[i] = static_cast<T> (ynum/yden);
+                }
+            }
+        }
         /// Tabulates the numerator short-term average
-        RTSeis::Utilities::FilterImplementations::FIRFilter<double> firNum_;
+        RunningAverage sta_;
         /// Tabulates the denominator long-term average
-        RTSeis::Utilities::FilterImplementations::FIRFilter<double> firDen_;
-        /// The characteristic function.  This has dimension [chunkSize_].
-        Ipp64f *x264f_ = nullptr;
-        /// Workspace array for holding numerator.  This has
-        /// dimension [chunkSize_].
-        Ipp64f *ynum64f_ = nullptr;
-        /// Workspace array for hodling denominator.  This has
-        /// dimension [chunkSize_].
-        Ipp64f *yden64f_ = nullptr;
-        /// The characteristic function.  This has dimension [chunkSize_].
-        Ipp32f *x232f_ = nullptr;
-        /// Workspace array for holding numerator.  This has
-        /// dimension [chunkSize_].
-        Ipp32f *ynum32f_ = nullptr;
-        /// Workspace array for hodling denominator.  This has
-        /// dimension [chunkSize_].
-        Ipp32f *yden32f_ = nullptr;
+        RunningAverage lta_;
         /// The number of points in the STA window
         int nsta_ = 0;
         /// The number of points in the LTA window
         int nlta_ = 0;
-        /// Workspace for numerator and denominators 
-        int chunkSize_ = 1024;
         /// The processing mode
         RTSeis::ProcessingMode mode_ = RTSeis::ProcessingMode::POST_PROCESSING;
         /// The precision of th emodule
@@ -602,10 +446,9 @@ ClassicSTALTA::ClassicSTALTA(const ClassicSTALTAParameters &parameters) :
     }
     int nsta = parameters.getShortTermWindowSize();
     int nlta = parameters.getLongTermWindowSize();
-    int chunkSize = static_cast<int> (parameters.getChunkSize());
     RTSeis::Precision precision = parameters.getPrecision();
     RTSeis::ProcessingMode mode = parameters.getProcessingMode();
-    int ierr = pSTALTA_->initialize(nsta, nlta, chunkSize, mode, precision);
+    int ierr = pSTALTA_->initialize(nsta, nlta, mode, precision);
     if (ierr != 0)
     {
         RTSEIS_ERRMSG("%s", "FAiled to initialize module");
@@ -725,7 +568,6 @@ int ClassicSTALTA::apply(const int nx, const double x[], double y[])
     return 0;
 }
 
-/*
 int ClassicSTALTA::apply(const int nx, const float x[], float y[])
 {
     if (nx <= 0){return 0;} // Nothing to do
@@ -748,4 +590,71 @@ int ClassicSTALTA::apply(const int nx, const float x[], float y[])
     }
     return 0;
 }
-*/
+
+int ClassicSTALTA::apply(const int nx, const double x[],
+                         ThresholdTrigger *trigger)
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    if ((nx > 0 && x == nullptr) || trigger == nullptr)
+    {
+        if (x == nullptr){RTSEIS_ERRMSG("%s", "x is NULL");}
+        if (trigger == nullptr){RTSEIS_ERRMSG("%s", "trigger is NULL");}
+        return -1;
+    }
+    if (!trigger->isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Trigger not initialized");
+        return -1;
+    }
+    trigger->begin();
+    int ierr = pSTALTA_->apply(std::max(0, nx), x,
+                               [trigger](const int n, const double y[])
+                               {
+                                   trigger->scan(n, y);
+                               });
+    trigger->end();
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to apply filter");
+        return -1;
+    }
+    return 0;
+}
+
+int ClassicSTALTA::apply(const int nx, const float x[],
+                         ThresholdTrigger *trigger)
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    if ((nx > 0 && x == nullptr) || trigger == nullptr)
+    {
+        if (x == nullptr){RTSEIS_ERRMSG("%s", "x is NULL");}
+        if (trigger == nullptr){RTSEIS_ERRMSG("%s", "trigger is NULL");}
+        return -1;
+    }
+    if (!trigger->isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Trigger not initialized");
+        return -1;
+    }
+    trigger->begin();
+    int ierr = pSTALTA_->apply(std::max(0, nx), x,
+                               [trigger](const int n, const float y[])
+                               {
+                                   trigger->scan(n, y);
+                               });
+    trigger->end();
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to apply filter");
+        return -1;
+    }
+    return 0;
+}
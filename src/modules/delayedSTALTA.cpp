@@ -0,0 +1,634 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cfloat>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#define RTSEIS_LOGGING 1
+#include "rtseis/log.h"
+#include "rtseis/modules/delayedSTALTA.hpp"
+#include "rtseis/modules/thresholdTrigger.hpp"
+#include "rtseis/private/runningSum.hpp"
+
+using namespace RTSeis::Modules;
+
+namespace
+{
+/// The STA/LTA is passed to a trigger in blocks of this many samples
+constexpr int triggerBlockSize = 256;
+/// Tabulates the average of the last nsta squared samples and the average
+/// of the nlta squared samples preceding those.  The samples leaving the
+/// short-term window enter the long-term window.
+class DelayedAverages
+{
+public:
+    /// Initializes the window lengths and the initial conditions
+    void initialize(const int nsta, const int nlta,
+                    const double ziNum, const double ziDen)
+    {
+        mSTA.initialize(nsta);
+        mLTA.initialize(nlta);
+        mSTAWindow.resize(nsta);
+        mLTAWindow.resize(nlta);
+        mNumeratorInitialConditions.assign(nsta - 1, ziNum);
+        mDenominatorInitialConditions.assign(nlta, ziDen);
+        mSTADivisor = 1.0/static_cast<double> (nsta);
+        mLTADivisor = 1.0/static_cast<double> (nlta);
+        reset();
+    }
+    /// Length of the numerator initial conditions
+    int getNumeratorInitialConditionLength() const
+    {
+        return static_cast<int> (mNumeratorInitialConditions.size());
+    }
+    /// Length of the denominator initial conditions
+    int getDenominatorInitialConditionLength() const
+    {
+        return static_cast<int> (mDenominatorInitialConditions.size());
+    }
+    /// Sets the initial conditions
+    void setInitialConditions(const double zNum[], const double zDen[])
+    {
+        std::copy(zNum, zNum + getNumeratorInitialConditionLength(),
+                  mNumeratorInitialConditions.begin());
+        std::copy(zDen, zDen + getDenominatorInitialConditionLength(),
+                  mDenominatorInitialConditions.begin());
+        reset();
+    }
+    /// Fills the windows with the initial conditions.  The first sample
+    /// moves the most recent denominator initial condition from the
+    /// short-term window to the long-term window.
+    void reset()
+    {
+        auto nlta = getDenominatorInitialConditionLength();
+        mSTAWindow[0] = mDenominatorInitialConditions[nlta - 1];
+        std::copy(mNumeratorInitialConditions.begin(),
+                  mNumeratorInitialConditions.end(), mSTAWindow.begin() + 1);
+        mLTAWindow[0] = 0;
+        std::copy(mDenominatorInitialConditions.begin(),
+                  mDenominatorInitialConditions.end() - 1,
+                  mLTAWindow.begin() + 1);
+        mSTA.setWindow(mSTAWindow.data());
+        mLTA.setWindow(mLTAWindow.data());
+    }
+    /// Adds the squared sample x2 and returns the short-term and long-term
+    /// averages
+    void push(const double x2, double *sta, double *lta)
+    {
+        mLTA.push(mSTA.push(x2));
+        *sta = mSTA.getSum()*mSTADivisor;
+        *lta = mLTA.getSum()*mLTADivisor;
+    }
+private:
+    RTSeis::Private::RunningSum mSTA;
+    RTSeis::Private::RunningSum mLTA;
+    /// Workspace for resetting the windows
+    std::vector<double> mSTAWindow;
+    std::vector<double> mLTAWindow;
+    /// The squared samples immediately preceding the signal
+    std::vector<double> mNumeratorInitialConditions;
+    /// The squared samples preceding the numerator initial conditions
+    std::vector<double> mDenominatorInitialConditions;
+    double mSTADivisor = 0;
+    double mLTADivisor = 0;
+};
+
+}
+
+class DelayedSTALTA::DelayedSTALTAImpl
+{
+    public:
+        /// Releases memory on the module
+        void clear(void)
+        {
+            averages_ = DelayedAverages();
+            mode_ = RTSeis::ProcessingMode::POST_PROCESSING;
+            linit_ = false;
+            return;
+        }
+        //--------------------------------------------------------------------//
+        int initialize(const int nsta, const int nlta,
+                       const RTSeis::ProcessingMode mode,
+                       const RTSeis::Precision precision)
+        {
+            clear();
+            // Set the long-term initial conditions to something large
+            double xset = DBL_MAX/static_cast<double> (nlta)/4.0;
+            if (precision == RTSeis::Precision::FLOAT)
+            {
+                 xset = FLT_MAX/static_cast<double> (nlta)/4.0;
+            }
+            averages_.initialize(nsta, nlta, 0, xset);
+            mode_ = mode;
+            linit_ = true;
+            return 0;
+        }
+        /// Determines if the module is initialized
+        bool isInitialized(void) const
+        {
+            return linit_;
+        }
+        /// Gets length of the numerator initial conditons
+        int getNumeratorInitialConditionLength(void) const
+        {
+            return averages_.getNumeratorInitialConditionLength();
+        }
+        /// Gets length of the denominator initial conditons
+        int getDenominatorInitialConditionLength(void) const
+        {
+            return averages_.getDenominatorInitialConditionLength();
+        }
+        /// Sets the initial conditions
+        int setInitialConditions(const double zNum[], const double zDen[])
+        {
+            averages_.setInitialConditions(zNum, zDen);
+            return 0;
+        }
+        /// Resets the initial conditions
+        int resetInitialConditions(void)
+        {
+            averages_.reset();
+            return 0;
+        }
+        /// Applies the STA/LTA
+        template<typename T>
+        int apply(const int nx, const T x[], T y[])
+        {
+            if (nx <= 0){return 0;} // Nothing to do
+            compute(nx, x, y);
+            // Reset the initial conditions for post-processing
+            if (mode_ == RTSeis::ProcessingMode::POST_PROCESSING)
+            {
+                resetInitialConditions();
+            }
+            return 0;
+        }
+        /// Applies the STA/LTA and passes it to consume in blocks
+        template<typename T, typename F>
+        int apply(const int nx, const T x[], F consume)
+        {
+            T y[triggerBlockSize];
+            for (int i=0; i<nx; i=i+triggerBlockSize)
+            {
+                auto n = std::min(triggerBlockSize, nx - i);
+                compute(n, &x[i], y);
+                consume(n, y);
+            }
+            // Reset the initial conditions for post-processing
+            if (mode_ == RTSeis::ProcessingMode::POST_PROCESSING)
+            {
+                resetInitialConditions();
+            }
+            return 0;
+        }
+    private:
+        /// Computes the STA/LTA
+        template<typename T>
+        void compute(const int nx, const T x[], T y[])
+        {
+            double ynum = 0;
+            double yden = 0;
+            for (int i=0; i<nx; ++i)
+            {
+                auto x2 = static_cast<double> (x[i])*static_cast<double> (x[i]);
+                averages_.push(x2, &ynum, &yden);
+                // A dead signal has a zero denominator and numerator so
+                // force 0/0 = 0.  The upshot is that it won't trigger.
+                y[i] = 0;
+                if (std::abs(yden) >= DBL_MIN)
+                {
+                    y[i] = static_cast<T> (ynum/yden);
+                }
+            }
+        }
+        /// Tabulates the short-term and delayed long-term averages
+        DelayedAverages averages_;
+        /// The processing mode
+        RTSeis::ProcessingMode mode_ = RTSeis::ProcessingMode::POST_PROCESSING;
+        /// Flag indicating the class is initialized
+        bool linit_ = false;
+};
+
+//============================================================================//
+
+DelayedSTALTAParameters::DelayedSTALTAParameters()
+{
+    return;
+}
+
+DelayedSTALTAParameters::DelayedSTALTAParameters(
+    const DelayedSTALTAParameters &parameters)
+{
+    *this = parameters;
+    return;
+}
+
+DelayedSTALTAParameters&
+DelayedSTALTAParameters::operator=(const DelayedSTALTAParameters &parameters)
+{
+    if (&parameters == this){return *this;}
+    clear();
+    precision_ = parameters.precision_;
+    processingMode_ = parameters.processingMode_;
+    nsta_ = parameters.nsta_;
+    nlta_ = parameters.nlta_;
+    isValid_ = parameters.isValid_;
+    return *this;
+}
+
+DelayedSTALTAParameters::DelayedSTALTAParameters(
+    const int nsta, const int nlta,
+    const RTSeis::ProcessingMode mode,
+    const RTSeis::Precision prec)
+{
+    // Set the long-term and short-term parameters
+    int ierr = setShortTermAndLongTermWindowSize(nsta, nlta);
+    if (ierr != 0)
+    {
+        clear();
+        return;
+    }
+    setProcessingMode(mode);
+    precision_ = prec;
+    // Validate
+    validate_();
+    return;
+}
+
+DelayedSTALTAParameters::DelayedSTALTAParameters(
+    const double staWin, const double ltaWin, const double dt,
+    const RTSeis::ProcessingMode mode,
+    const RTSeis::Precision prec)
+{
+    // Check parameters
+    int ierr = setShortTermAndLongTermWindowSize(staWin, ltaWin, dt);
+    if (ierr != 0)
+    {
+        clear();
+        return;
+    }
+    setProcessingMode(mode);
+    precision_ = prec;
+    // Validate
+    validate_();
+    return;
+}
+
+DelayedSTALTAParameters::~DelayedSTALTAParameters()
+{
+    clear();
+}
+
+void DelayedSTALTAParameters::clear()
+{
+    nsta_ = 0;
+    nlta_ = 0;
+    precision_ = defaultPrecision_;
+    processingMode_ = RTSeis::ProcessingMode::POST_PROCESSING;
+    isValid_ = false;
+    return;
+}
+
+int DelayedSTALTAParameters::setShortTermAndLongTermWindowSize(
+    const int nsta, const int nlta)
+{
+    if (nsta < 1)
+    {
+        RTSEIS_ERRMSG("STA window=%d samples must be at least 1", nsta);
+        return -1;
+    }
+    if (nlta <= nsta)
+    {
+        RTSEIS_ERRMSG("LTA window=%d samples must be greater than %d",
+                      nlta, nsta);
+        return -1;
+    }
+    nsta_ = nsta;
+    nlta_ = nlta;
+    validate_();
+    return 0;
+}
+
+int DelayedSTALTAParameters::setShortTermAndLongTermWindowSize(
+    const double staWin, const double ltaWin, const double dt)
+{
+    if (dt <= 0)
+    {
+        RTSEIS_ERRMSG("dt=%lf must be postiive", dt);
+        return -1;
+    }
+    if (staWin < 0)
+    {
+        RTSEIS_ERRMSG("STA window length=%lf (s) must be at least %lf (s) ",
+                      staWin, dt);
+        return -1;
+    }
+    if (ltaWin <= staWin + dt/2)
+    {
+        RTSEIS_ERRMSG("LTA window length=%lf (s) must be at least %lf (s) ",
+                      ltaWin, staWin + dt);
+        return -1;
+    }
+    int nsta = static_cast<int> (staWin/dt + 0.5) + 1;
+    int nlta = static_cast<int> (ltaWin/dt + 0.5) + 1;
+    if (nlta <= nsta)
+    {
+        RTSEIS_ERRMSG("%s", "Algorithmic failure");
+        return -1;
+    }
+    nsta_ = nsta;
+    nlta_ = nlta;
+    validate_();
+    return 0;
+}
+
+int DelayedSTALTAParameters::getLongTermWindowSize() const
+{
+    return nlta_;
+}
+
+int DelayedSTALTAParameters::getShortTermWindowSize() const
+{
+    return nsta_;
+}
+
+void DelayedSTALTAParameters::setProcessingMode(
+    const RTSeis::ProcessingMode mode)
+{
+    processingMode_ = mode;
+    validate_();
+    return;
+}
+
+RTSeis::ProcessingMode DelayedSTALTAParameters::getProcessingMode(void) const
+{
+    return processingMode_;
+}
+
+RTSeis::Precision DelayedSTALTAParameters::getPrecision(void) const
+{
+    return precision_;
+}
+
+bool DelayedSTALTAParameters::isValid() const
+{
+    return isValid_;
+}
+
+void DelayedSTALTAParameters::validate_()
+{
+    isValid_ = false;
+    if (nsta_ < 1){return;}
+    if (nlta_ <= nsta_){return;}
+    if (getPrecision() != RTSeis::Precision::DOUBLE &&
+        getPrecision() != RTSeis::Precision::FLOAT){return;}
+    isValid_ = true;
+    return;
+}
+
+//============================================================================//
+//                                 End Parameters                             //
+//============================================================================//
+
+DelayedSTALTA::DelayedSTALTA(void) :
+    pSTALTA_(new DelayedSTALTAImpl())
+{
+    clear();
+}
+
+DelayedSTALTA::DelayedSTALTA(const DelayedSTALTA &dstalta)
+{
+    *this = dstalta;
+}
+
+DelayedSTALTA::~DelayedSTALTA()
+{
+    clear();
+    return;
+}
+
+void DelayedSTALTA::clear()
+{
+    pSTALTA_->clear();
+    return;
+}
+
+DelayedSTALTA::DelayedSTALTA(const DelayedSTALTAParameters &parameters) :
+    pSTALTA_(new DelayedSTALTAImpl())
+{
+    clear();
+    if (!parameters.isValid())
+    {
+        RTSEIS_ERRMSG("%s", "Parameters are not valid");
+        return;
+    }
+    int nsta = parameters.getShortTermWindowSize();
+    int nlta = parameters.getLongTermWindowSize();
+    RTSeis::Precision precision = parameters.getPrecision();
+    RTSeis::ProcessingMode mode = parameters.getProcessingMode();
+    int ierr = pSTALTA_->initialize(nsta, nlta, mode, precision);
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to initialize module");
+        return;
+    }
+    return;
+}
+
+DelayedSTALTA& DelayedSTALTA::operator=(const DelayedSTALTA &dstalta)
+{
+    if (&dstalta == this){return *this;}
+    if (pSTALTA_){pSTALTA_->clear();}
+    pSTALTA_ = std::unique_ptr<DelayedSTALTAImpl>
+              (new DelayedSTALTAImpl(*dstalta.pSTALTA_));
+    return *this;
+}
+
+int DelayedSTALTA::setInitialConditions(const int nzNum, const double zNum[],
+                                          const int nzDen, const double zDen[])
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    int nzNumRef = getNumeratorInitialConditionLength();
+    int nzDenRef = getDenominatorInitialConditionLength();
+    if (nzNumRef != nzNum)
+    {
+        RTSEIS_ERRMSG("nzNum=%d must equal %d", nzNum, nzNumRef);
+        return -1;
+    }
+    if (nzDenRef != nzDen)
+    {
+        RTSEIS_ERRMSG("nzDen=%d must equal %d", nzDen, nzDenRef);
+        return -1;
+    }
+    if (nzNum > 0 && zNum == nullptr)
+    {
+        RTSEIS_ERRMSG("%s", "zNum is NULL");
+        return -1;
+    }
+    if (zDen == nullptr)
+    {
+        RTSEIS_ERRMSG("%s", "zDen is NULL");
+        return -1;
+    }
+    int ierr = pSTALTA_->setInitialConditions(zNum, zDen);
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to set initial conditions");
+        return -1;
+    }
+    return 0;
+}
+
+int DelayedSTALTA::resetInitialConditions()
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    pSTALTA_->resetInitialConditions();
+    return 0;
+}
+
+int DelayedSTALTA::getNumeratorInitialConditionLength() const
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    return pSTALTA_->getNumeratorInitialConditionLength();
+}
+
+int DelayedSTALTA::getDenominatorInitialConditionLength() const
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    return pSTALTA_->getDenominatorInitialConditionLength();
+}
+
+bool DelayedSTALTA::isInitialized() const
+{
+    return pSTALTA_->isInitialized();
+}
+
+int DelayedSTALTA::apply(const int nx, const double x[], double y[])
+{
+    if (nx <= 0){return 0;} // Nothing to do
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    if (x == nullptr || y == nullptr)
+    {
+        if (x == nullptr){RTSEIS_ERRMSG("%s", "x is NULL");}
+        if (y == nullptr){RTSEIS_ERRMSG("%s", "y is NULL");}
+        return -1;
+    }
+    int ierr = pSTALTA_->apply(nx, x, y);
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to apply filter");
+        return -1;
+    }
+    return 0;
+}
+
+int DelayedSTALTA::apply(const int nx, const float x[], float y[])
+{
+    if (nx <= 0){return 0;} // Nothing to do
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    if (x == nullptr || y == nullptr)
+    {
+        if (x == nullptr){RTSEIS_ERRMSG("%s", "x is NULL");}
+        if (y == nullptr){RTSEIS_ERRMSG("%s", "y is NULL");}
+        return -1;
+    }
+    int ierr = pSTALTA_->apply(nx, x, y);
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to apply filter");
+        return -1;
+    }
+    return 0;
+}
+
+int DelayedSTALTA::apply(const int nx, const double x[],
+                         ThresholdTrigger *trigger)
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    if ((nx > 0 && x == nullptr) || trigger == nullptr)
+    {
+        if (x == nullptr){RTSEIS_ERRMSG("%s", "x is NULL");}
+        if (trigger == nullptr){RTSEIS_ERRMSG("%s", "trigger is NULL");}
+        return -1;
+    }
+    if (!trigger->isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Trigger not initialized");
+        return -1;
+    }
+    trigger->begin();
+    int ierr = pSTALTA_->apply(std::max(0, nx), x,
+                               [trigger](const int n, const double y[])
+                               {
+                                   trigger->scan(n, y);
+                               });
+    trigger->end();
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to apply filter");
+        return -1;
+    }
+    return 0;
+}
+
+int DelayedSTALTA::apply(const int nx, const float x[],
+                         ThresholdTrigger *trigger)
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    if ((nx > 0 && x == nullptr) || trigger == nullptr)
+    {
+        if (x == nullptr){RTSEIS_ERRMSG("%s", "x is NULL");}
+        if (trigger == nullptr){RTSEIS_ERRMSG("%s", "trigger is NULL");}
+        return -1;
+    }
+    if (!trigger->isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Trigger not initialized");
+        return -1;
+    }
+    trigger->begin();
+    int ierr = pSTALTA_->apply(std::max(0, nx), x,
+                               [trigger](const int n, const float y[])
+                               {
+                                   trigger->scan(n, y);
+                               });
+    trigger->end();
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to apply filter");
+        return -1;
+    }
+    return 0;
+}
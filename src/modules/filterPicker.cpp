@@ -0,0 +1,724 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cfloat>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#define RTSEIS_LOGGING 1
+#include "rtseis/log.h"
+#include "rtseis/modules/filterPicker.hpp"
+#include "rtseis/utilities/filterImplementations/sosFilter.hpp"
+
+using namespace RTSeis::Modules;
+using RTSeis::Utilities::FilterImplementations::SOSFilter;
+
+namespace
+{
+/// The signal is filtered in blocks of this many samples
+constexpr int blockSize = 256;
+
+/// The trigger states
+enum class State
+{
+    IDLE,      /*!< Waiting for a trigger. */
+    TRIGGERED, /*!< Integrating the characteristic function. */
+    WAITING    /*!< Waiting for the characteristic function to fall below
+                    the trigger threshold. */
+};
+
+/// A band of the filter bank
+struct Band
+{
+    /// The bandpass filter
+    SOSFilter<double> filter;
+    /// The characteristic function of the last nHistory samples
+    std::vector<double> history;
+    /// The long-term mean of the envelope
+    double mean = 0;
+    /// The long-term variance of the envelope
+    double var = 0;
+    /// The band's period in samples.  This bounds the pick refinement.
+    int period = 0;
+};
+
+}
+
+class FilterPicker::FilterPickerImpl
+{
+    public:
+        /// Releases memory on the module
+        void clear(void)
+        {
+            bands_.clear();
+            work_.clear();
+            xWork_.clear();
+            picks_.clear();
+            clt_ = 0;
+            threshold1_ = 0;
+            threshold2_ = 0;
+            cap_ = 0;
+            nUp_ = 0;
+            nHistory_ = 0;
+            nWarmUp_ = 0;
+            mode_ = RTSeis::ProcessingMode::POST_PROCESSING;
+            linit_ = false;
+            resetState();
+            return;
+        }
+        //--------------------------------------------------------------------//
+        int initialize(const double filterWindow,
+                       const double longTermWindow,
+                       const double threshold1,
+                       const double threshold2,
+                       const double tUpEvent,
+                       const double dt,
+                       const RTSeis::ProcessingMode mode)
+        {
+            clear();
+            // Bands have periods 2 dt, 4 dt, ... up to the filter window
+            auto nBands = std::max(1,
+               static_cast<int> (std::log2(filterWindow/dt*(1 + 1.e-10))));
+            bands_.resize(nBands);
+            for (int k=0; k<nBands; ++k)
+            {
+                // A one-pole highpass followed by two one-pole lowpasses
+                // at the band's period.  The highpass and first lowpass
+                // form the first section.
+                auto period = std::pow(2.0, k + 1)*dt;
+                auto w = period/(2*M_PI);
+                auto chp = w/(w + dt);
+                auto clp = dt/(w + dt);
+                double bs[6] = {chp*clp, -chp*clp, 0,
+                                clp,     0,        0};
+                double as[6] = {1, -(chp + 1 - clp), chp*(1 - clp),
+                                1, -(1 - clp),       0};
+                try
+                {
+                    bands_[k].filter.initialize(
+                        2, bs, as, RTSeis::ProcessingMode::REAL_TIME);
+                }
+                catch (const std::exception &e)
+                {
+                    RTSEIS_ERRMSG("Failed to initialize band %d: %s",
+                                  k, e.what());
+                    clear();
+                    return -1;
+                }
+                bands_[k].period = 1 << (k + 1);
+            }
+            nHistory_ = bands_.back().period + 1;
+            for (auto &band : bands_){band.history.resize(nHistory_);}
+            work_.resize(nBands*blockSize);
+            xWork_.resize(blockSize);
+            clt_ = std::min(1.0, dt/longTermWindow);
+            nWarmUp_ = static_cast<int> (longTermWindow/dt + 0.5);
+            threshold1_ = threshold1;
+            threshold2_ = threshold2;
+            cap_ = 2*threshold2;
+            nUp_ = std::max(1, static_cast<int> (tUpEvent/dt + 0.5));
+            mode_ = mode;
+            linit_ = true;
+            resetInitialConditions();
+            return 0;
+        }
+        /// Determines if the module is initialized
+        bool isInitialized(void) const
+        {
+            return linit_;
+        }
+        /// Gets the number of bands
+        int getNumberOfBands(void) const
+        {
+            return static_cast<int> (bands_.size());
+        }
+        /// Resets the initial conditions
+        void resetInitialConditions(void)
+        {
+            for (auto &band : bands_)
+            {
+                band.filter.resetInitialConditions();
+                std::fill(band.history.begin(), band.history.end(), 0);
+                band.mean = 0;
+                band.var = 0;
+            }
+            resetState();
+            picks_.clear();
+        }
+        /// Gets the picks
+        const std::vector<FilterPick> &getPicks(void) const
+        {
+            return picks_;
+        }
+        /// Clears the picks
+        void clearPicks(void)
+        {
+            picks_.clear();
+        }
+        /// Picks x.  cf can be NULL.
+        template<typename T>
+        int apply(const int nx, const T x[], T cf[])
+        {
+            // Every post-processing signal stands alone
+            if (mode_ == RTSeis::ProcessingMode::POST_PROCESSING)
+            {
+                resetInitialConditions();
+            }
+            auto nBands = static_cast<int> (bands_.size());
+            for (int i0=0; i0<nx; i0=i0+blockSize)
+            {
+                auto n = std::min(blockSize, nx - i0);
+                for (int k=0; k<n; ++k)
+                {
+                    xWork_[k] = static_cast<double> (x[i0+k]);
+                }
+                for (int ib=0; ib<nBands; ++ib)
+                {
+                    double *y = &work_[ib*blockSize];
+                    bands_[ib].filter.apply(n, xWork_.data(), &y);
+                }
+                for (int k=0; k<n; ++k)
+                {
+                    auto cfk = update(k);
+                    if (cf != nullptr){cf[i0+k] = static_cast<T> (cfk);}
+                }
+            }
+            return 0;
+        }
+    private:
+        /// Resets the trigger
+        void resetState(void)
+        {
+            state_ = State::IDLE;
+            sample_ = 0;
+            head_ = 0;
+            triggerIndex_ = 0;
+            pickIndex_ = 0;
+            pickBand_ = 0;
+            integral_ = 0;
+            nIntegrated_ = 0;
+            nWarmUpRemaining_ = nWarmUp_;
+        }
+        /// Steps back from the current sample while band's characteristic
+        /// function is rising
+        int64_t refine(const Band &band) const
+        {
+            auto nBack = static_cast<int>
+                         (std::min<int64_t> (band.period, sample_));
+            auto pos = head_;
+            int j = 0;
+            for (j=0; j<nBack; ++j)
+            {
+                auto prev = (pos == 0) ? nHistory_ - 1 : pos - 1;
+                if (band.history[prev] >= band.history[pos]){break;}
+                pos = prev;
+            }
+            return sample_ - j;
+        }
+        /// Processes the k'th filtered sample of the block and returns the
+        /// summary characteristic function
+        double update(const int k)
+        {
+            auto nBands = static_cast<int> (bands_.size());
+            bool lwarm = (nWarmUpRemaining_ > 0);
+            double cfMax = 0;
+            int bandMax = 0;
+            for (int ib=0; ib<nBands; ++ib)
+            {
+                auto &band = bands_[ib];
+                auto y = work_[ib*blockSize + k];
+                auto e = y*y;
+                double cf = 0;
+                auto sigma = std::sqrt(band.var);
+                if (!lwarm && sigma > DBL_MIN){cf = (e - band.mean)/sigma;}
+                band.history[head_] = cf;
+                if (cf > cfMax)
+                {
+                    cfMax = cf;
+                    bandMax = ib;
+                }
+                // Don't let an event normalize itself away before the
+                // pick is decided
+                if (state_ != State::TRIGGERED)
+                {
+                    auto d = e - band.mean;
+                    band.mean = band.mean + clt_*d;
+                    band.var = (1 - clt_)*(band.var + clt_*d*d);
+                }
+            }
+            if (lwarm){nWarmUpRemaining_ = nWarmUpRemaining_ - 1;}
+            // Advance the trigger
+            if (state_ == State::IDLE && cfMax >= threshold1_)
+            {
+                state_ = State::TRIGGERED;
+                triggerIndex_ = sample_;
+                pickBand_ = bandMax;
+                pickIndex_ = refine(bands_[bandMax]);
+                integral_ = 0;
+                nIntegrated_ = 0;
+            }
+            if (state_ == State::TRIGGERED)
+            {
+                integral_ = integral_ + std::min(cfMax, cap_);
+                nIntegrated_ = nIntegrated_ + 1;
+                if (integral_ >= threshold2_*nUp_)
+                {
+                    FilterPick pick;
+                    pick.index = pickIndex_;
+                    pick.triggerIndex = triggerIndex_;
+                    pick.band = pickBand_;
+                    picks_.push_back(pick);
+                    state_ = State::WAITING;
+                }
+                else if (nIntegrated_ >= nUp_)
+                {
+                    state_ = State::WAITING;
+                }
+            }
+            if (state_ == State::WAITING && cfMax < threshold1_)
+            {
+                state_ = State::IDLE;
+            }
+            head_ = head_ + 1;
+            if (head_ == nHistory_){head_ = 0;}
+            sample_ = sample_ + 1;
+            return cfMax;
+        }
+
+        /// The filter bank
+        std::vector<Band> bands_;
+        /// The filtered signals of each band in the current block
+        std::vector<double> work_;
+        /// The current block of the input signal
+        std::vector<double> xWork_;
+        /// The picks
+        std::vector<FilterPick> picks_;
+        /// The long-term averaging weight
+        double clt_ = 0;
+        /// The trigger threshold
+        double threshold1_ = 0;
+        /// The pick threshold
+        double threshold2_ = 0;
+        /// The largest characteristic function integrated
+        double cap_ = 0;
+        /// The integral of the characteristic function since the trigger
+        double integral_ = 0;
+        /// The current sample
+        int64_t sample_ = 0;
+        /// The sample of the pending trigger
+        int64_t triggerIndex_ = 0;
+        /// The refined pick of the pending trigger
+        int64_t pickIndex_ = 0;
+        /// The band of the pending trigger
+        int pickBand_ = 0;
+        /// The number of samples integrated since the trigger
+        int nIntegrated_ = 0;
+        /// The number of samples in the up-event window
+        int nUp_ = 0;
+        /// The length of the characteristic function histories
+        int nHistory_ = 0;
+        /// The position of the current sample in the histories
+        int head_ = 0;
+        /// The number of samples while the averages stabilize
+        int nWarmUp_ = 0;
+        /// The number of samples remaining while the averages stabilize
+        int nWarmUpRemaining_ = 0;
+        /// The trigger state
+        State state_ = State::IDLE;
+        /// The processing mode
+        RTSeis::ProcessingMode mode_ = RTSeis::ProcessingMode::POST_PROCESSING;
+        /// Flag indicating the class is initialized
+        bool linit_ = false;
+};
+
+//============================================================================//
+
+FilterPickerParameters::FilterPickerParameters()
+{
+    return;
+}
+
+FilterPickerParameters::FilterPickerParameters(
+    const FilterPickerParameters &parameters)
+{
+    *this = parameters;
+    return;
+}
+
+FilterPickerParameters&
+FilterPickerParameters::operator=(const FilterPickerParameters &parameters)
+{
+    if (&parameters == this){return *this;}
+    clear();
+    dt_ = parameters.dt_;
+    filterWindow_ = parameters.filterWindow_;
+    longTermWindow_ = parameters.longTermWindow_;
+    threshold1_ = parameters.threshold1_;
+    threshold2_ = parameters.threshold2_;
+    tUpEvent_ = parameters.tUpEvent_;
+    precision_ = parameters.precision_;
+    processingMode_ = parameters.processingMode_;
+    isValid_ = parameters.isValid_;
+    return *this;
+}
+
+FilterPickerParameters::FilterPickerParameters(
+    const double filterWindow,
+    const double longTermWindow,
+    const double threshold1,
+    const double threshold2,
+    const double tUpEvent,
+    const double dt,
+    const RTSeis::ProcessingMode mode,
+    const RTSeis::Precision prec)
+{
+    int ierr = setSamplingPeriod(dt);
+    if (ierr == 0){ierr = setFilterWindow(filterWindow);}
+    if (ierr == 0){ierr = setLongTermWindow(longTermWindow);}
+    if (ierr == 0){ierr = setThresholds(threshold1, threshold2);}
+    if (ierr == 0){ierr = setUpEventWindow(tUpEvent);}
+    if (ierr != 0)
+    {
+        clear();
+        return;
+    }
+    setProcessingMode(mode);
+    precision_ = prec;
+    // Validate
+    validate_();
+    return;
+}
+
+FilterPickerParameters::~FilterPickerParameters()
+{
+    clear();
+}
+
+void FilterPickerParameters::clear()
+{
+    dt_ = 0;
+    filterWindow_ = 0;
+    longTermWindow_ = 0;
+    threshold1_ = 0;
+    threshold2_ = 0;
+    tUpEvent_ = 0;
+    precision_ = defaultPrecision_;
+    processingMode_ = RTSeis::ProcessingMode::POST_PROCESSING;
+    isValid_ = false;
+    return;
+}
+
+int FilterPickerParameters::setSamplingPeriod(const double dt)
+{
+    if (dt <= 0)
+    {
+        RTSEIS_ERRMSG("dt=%lf must be postiive", dt);
+        return -1;
+    }
+    dt_ = dt;
+    validate_();
+    return 0;
+}
+
+double FilterPickerParameters::getSamplingPeriod() const
+{
+    return dt_;
+}
+
+int FilterPickerParameters::setFilterWindow(const double filterWindow)
+{
+    if (filterWindow <= 0)
+    {
+        RTSEIS_ERRMSG("Filter window=%lf (s) must be positive", filterWindow);
+        return -1;
+    }
+    filterWindow_ = filterWindow;
+    validate_();
+    return 0;
+}
+
+double FilterPickerParameters::getFilterWindow() const
+{
+    return filterWindow_;
+}
+
+int FilterPickerParameters::setLongTermWindow(const double longTermWindow)
+{
+    if (longTermWindow <= 0)
+    {
+        RTSEIS_ERRMSG("Long-term window=%lf (s) must be positive",
+                      longTermWindow);
+        return -1;
+    }
+    longTermWindow_ = longTermWindow;
+    validate_();
+    return 0;
+}
+
+double FilterPickerParameters::getLongTermWindow() const
+{
+    return longTermWindow_;
+}
+
+int FilterPickerParameters::setThresholds(const double threshold1,
+                                          const double threshold2)
+{
+    if (threshold1 <= 0 || threshold2 <= 0)
+    {
+        if (threshold1 <= 0)
+        {
+            RTSEIS_ERRMSG("threshold1=%lf must be positive", threshold1);
+        }
+        if (threshold2 <= 0)
+        {
+            RTSEIS_ERRMSG("threshold2=%lf must be positive", threshold2);
+        }
+        return -1;
+    }
+    threshold1_ = threshold1;
+    threshold2_ = threshold2;
+    validate_();
+    return 0;
+}
+
+double FilterPickerParameters::getThreshold1() const
+{
+    return threshold1_;
+}
+
+double FilterPickerParameters::getThreshold2() const
+{
+    return threshold2_;
+}
+
+int FilterPickerParameters::setUpEventWindow(const double tUpEvent)
+{
+    if (tUpEvent <= 0)
+    {
+        RTSEIS_ERRMSG("Up-event window=%lf (s) must be positive", tUpEvent);
+        return -1;
+    }
+    tUpEvent_ = tUpEvent;
+    validate_();
+    return 0;
+}
+
+double FilterPickerParameters::getUpEventWindow() const
+{
+    return tUpEvent_;
+}
+
+void FilterPickerParameters::setProcessingMode(
+    const RTSeis::ProcessingMode mode)
+{
+    processingMode_ = mode;
+    validate_();
+    return;
+}
+
+RTSeis::ProcessingMode FilterPickerParameters::getProcessingMode(void) const
+{
+    return processingMode_;
+}
+
+RTSeis::Precision FilterPickerParameters::getPrecision(void) const
+{
+    return precision_;
+}
+
+bool FilterPickerParameters::isValid() const
+{
+    return isValid_;
+}
+
+void FilterPickerParameters::validate_()
+{
+    isValid_ = false;
+    if (dt_ <= 0){return;}
+    if (filterWindow_ < 2*dt_){return;}
+    if (longTermWindow_ < filterWindow_){return;}
+    if (threshold1_ <= 0 || threshold2_ <= 0){return;}
+    if (tUpEvent_ < dt_){return;}
+    if (getPrecision() != RTSeis::Precision::DOUBLE &&
+        getPrecision() != RTSeis::Precision::FLOAT){return;}
+    isValid_ = true;
+    return;
+}
+
+//============================================================================//
+//                                 End Parameters                             //
+//============================================================================//
+
+FilterPicker::FilterPicker(void) :
+    pPicker_(new FilterPickerImpl())
+{
+    clear();
+}
+
+FilterPicker::FilterPicker(const FilterPicker &picker)
+{
+    *this = picker;
+}
+
+FilterPicker::~FilterPicker()
+{
+    clear();
+    return;
+}
+
+void FilterPicker::clear()
+{
+    pPicker_->clear();
+    return;
+}
+
+FilterPicker::FilterPicker(const FilterPickerParameters &parameters) :
+    pPicker_(new FilterPickerImpl())
+{
+    clear();
+    if (!parameters.isValid())
+    {
+        RTSEIS_ERRMSG("%s", "Parameters are not valid");
+        return;
+    }
+    int ierr = pPicker_->initialize(parameters.getFilterWindow(),
+                                    parameters.getLongTermWindow(),
+                                    parameters.getThreshold1(),
+                                    parameters.getThreshold2(),
+                                    parameters.getUpEventWindow(),
+                                    parameters.getSamplingPeriod(),
+                                    parameters.getProcessingMode());
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to initialize module");
+        return;
+    }
+    return;
+}
+
+FilterPicker& FilterPicker::operator=(const FilterPicker &picker)
+{
+    if (&picker == this){return *this;}
+    if (pPicker_){pPicker_->clear();}
+    pPicker_ = std::unique_ptr<FilterPickerImpl>
+              (new FilterPickerImpl(*picker.pPicker_));
+    return *this;
+}
+
+int FilterPicker::getNumberOfBands() const
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    return pPicker_->getNumberOfBands();
+}
+
+int FilterPicker::getNumberOfPicks() const
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    return static_cast<int> (pPicker_->getPicks().size());
+}
+
+int FilterPicker::getPicks(const int maxPicks, FilterPick picks[]) const
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    const auto &myPicks = pPicker_->getPicks();
+    auto nPicks = static_cast<int> (myPicks.size());
+    if (maxPicks < nPicks)
+    {
+        RTSEIS_ERRMSG("maxPicks=%d must be at least %d", maxPicks, nPicks);
+        return -1;
+    }
+    if (nPicks > 0 && picks == nullptr)
+    {
+        RTSEIS_ERRMSG("%s", "picks is NULL");
+        return -1;
+    }
+    std::copy(myPicks.begin(), myPicks.end(), picks);
+    return 0;
+}
+
+void FilterPicker::clearPicks()
+{
+    pPicker_->clearPicks();
+}
+
+int FilterPicker::resetInitialConditions()
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    pPicker_->resetInitialConditions();
+    return 0;
+}
+
+bool FilterPicker::isInitialized() const
+{
+    return pPicker_->isInitialized();
+}
+
+int FilterPicker::apply(const int nx, const double x[])
+{
+    return apply(nx, x, nullptr);
+}
+
+int FilterPicker::apply(const int nx, const float x[])
+{
+    return apply(nx, x, nullptr);
+}
+
+int FilterPicker::apply(const int nx, const double x[], double cf[])
+{
+    if (nx <= 0){return 0;} // Nothing to do
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    if (x == nullptr)
+    {
+        RTSEIS_ERRMSG("%s", "x is NULL");
+        return -1;
+    }
+    int ierr = pPicker_->apply(nx, x, cf);
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to apply picker");
+        return -1;
+    }
+    return 0;
+}
+
+int FilterPicker::apply(const int nx, const float x[], float cf[])
+{
+    if (nx <= 0){return 0;} // Nothing to do
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    if (x == nullptr)
+    {
+        RTSEIS_ERRMSG("%s", "x is NULL");
+        return -1;
+    }
+    int ierr = pPicker_->apply(nx, x, cf);
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to apply picker");
+        return -1;
+    }
+    return 0;
+}
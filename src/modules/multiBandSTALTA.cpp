@@ -0,0 +1,641 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cfloat>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#define RTSEIS_LOGGING 1
+#include "rtseis/log.h"
+#include "rtseis/modules/multiBandSTALTA.hpp"
+#include "rtseis/modules/thresholdTrigger.hpp"
+#include "rtseis/utilities/filterImplementations/sosFilter.hpp"
+#include "rtseis/private/runningSum.hpp"
+
+using namespace RTSeis::Modules;
+using RTSeis::Private::RunningAverage;
+using RTSeis::Utilities::FilterRepresentations::SOS;
+using RTSeis::Utilities::FilterImplementations::SOSFilter;
+
+namespace
+{
+/// The input is processed in blocks of this many samples so that each
+/// band's intermediate signals stay in cache
+constexpr int blockSize = 256;
+
+/// A band's filter and STA/LTA
+struct Band
+{
+    /// The bandpass filter.  This carries its state between blocks.
+    SOSFilter<double> filter;
+    RunningAverage sta;
+    RunningAverage lta;
+};
+
+}
+
+class MultiBandSTALTA::MultiBandSTALTAImpl
+{
+    public:
+        /// Releases memory on the module
+        void clear(void)
+        {
+            bands_.clear();
+            mode_ = RTSeis::ProcessingMode::POST_PROCESSING;
+            linit_ = false;
+            return;
+        }
+        //--------------------------------------------------------------------//
+        int initialize(const std::vector<SOS> &filters,
+                       const int nsta, const int nlta,
+                       const RTSeis::ProcessingMode mode,
+                       const RTSeis::Precision precision)
+        {
+            clear();
+            // Set the long-term initial conditions to something large
+            double xset = DBL_MAX/static_cast<double> (nlta)/4.0;
+            if (precision == RTSeis::Precision::FLOAT)
+            {
+                 xset = FLT_MAX/static_cast<double> (nlta)/4.0;
+            }
+            bands_.resize(filters.size());
+            for (size_t i=0; i<filters.size(); ++i)
+            {
+                auto bs = filters[i].getNumeratorCoefficients();
+                auto as = filters[i].getDenominatorCoefficients();
+                auto ns = filters[i].getNumberOfSections();
+                try
+                {
+                    bands_[i].filter.initialize(
+                        ns, bs.data(), as.data(),
+                        RTSeis::ProcessingMode::REAL_TIME);
+                }
+                catch (const std::exception &e)
+                {
+                    RTSEIS_ERRMSG("Failed to initialize band %d: %s",
+                                  static_cast<int> (i), e.what());
+                    clear();
+                    return -1;
+                }
+                bands_[i].sta.initialize(nsta, 0);
+                bands_[i].lta.initialize(nlta, xset);
+            }
+            mode_ = mode;
+            linit_ = true;
+            return 0;
+        }
+        /// Determines if the module is initialized
+        bool isInitialized(void) const
+        {
+            return linit_;
+        }
+        /// Gets the number of bands
+        int getNumberOfBands(void) const
+        {
+            return static_cast<int> (bands_.size());
+        }
+        /// Resets the initial conditions
+        int resetInitialConditions(void)
+        {
+            for (auto &band : bands_)
+            {
+                band.filter.resetInitialConditions();
+                band.sta.reset();
+                band.lta.reset();
+            }
+            return 0;
+        }
+        /// Applies the multi-band STA/LTA.  yBands can be NULL.
+        template<typename T>
+        int apply(const int nx, const T x[], T *const yBands[], T y[])
+        {
+            T *yOut = y;
+            return apply(nx, x, yBands,
+                         [&yOut](const int n, const T yBlock[])
+                         {
+                             std::copy(yBlock, yBlock + n, yOut);
+                             yOut = yOut + n;
+                         });
+        }
+        /// Applies the multi-band STA/LTA and passes it to consume in
+        /// blocks.  yBands can be NULL.
+        template<typename T, typename F>
+        int apply(const int nx, const T x[], T *const yBands[], F consume)
+        {
+            T y[blockSize];
+            double xWork[blockSize];
+            double work[blockSize];
+            double ymax[blockSize];
+            double *workPtr = work;
+            auto nBands = static_cast<int> (bands_.size());
+            for (int i0=0; i0<nx; i0=i0+blockSize)
+            {
+                auto n = std::min(blockSize, nx - i0);
+                for (int k=0; k<n; ++k)
+                {
+                    xWork[k] = static_cast<double> (x[i0+k]);
+                }
+                std::fill(ymax, ymax + n, 0);
+                for (int ib=0; ib<nBands; ++ib)
+                {
+                    auto &band = bands_[ib];
+                    band.filter.apply(n, xWork, &workPtr);
+                    for (int k=0; k<n; ++k)
+                    {
+                        auto x2 = work[k]*work[k];
+                        auto ynum = band.sta.push(x2);
+                        auto yden = band.lta.push(x2);
+                        // Force 0/0 = 0 so a dead band won't trigger
+                        work[k] = 0;
+                        if (std::abs(yden) >= DBL_MIN)
+                        {
+                            work[k] = ynum/yden;
+                        }
+                        ymax[k] = std::max(ymax[k], work[k]);
+                    }
+                    if (yBands != nullptr)
+                    {
+                        T *yBand = &yBands[ib][i0];
+                        for (int k=0; k<n; ++k)
+                        {
+                            yBand[k] = static_cast<T> (work[k]);
+                        }
+                    }
+                }
+                for (int k=0; k<n; ++k){y[k] = static_cast<T> (ymax[k]);}
+                consume(n, y);
+            }
+            // Reset the initial conditions for post-processing
+            if (mode_ == RTSeis::ProcessingMode::POST_PROCESSING)
+            {
+                resetInitialConditions();
+            }
+            return 0;
+        }
+    private:
+        /// The bands
+        std::vector<Band> bands_;
+        /// The processing mode
+        RTSeis::ProcessingMode mode_ = RTSeis::ProcessingMode::POST_PROCESSING;
+        /// Flag indicating the class is initialized
+        bool linit_ = false;
+};
+
+//============================================================================//
+
+MultiBandSTALTAParameters::MultiBandSTALTAParameters()
+{
+    return;
+}
+
+MultiBandSTALTAParameters::MultiBandSTALTAParameters(
+    const MultiBandSTALTAParameters &parameters)
+{
+    *this = parameters;
+    return;
+}
+
+MultiBandSTALTAParameters&
+MultiBandSTALTAParameters::operator=(const MultiBandSTALTAParameters &parameters)
+{
+    if (&parameters == this){return *this;}
+    clear();
+    bands_ = parameters.bands_;
+    precision_ = parameters.precision_;
+    processingMode_ = parameters.processingMode_;
+    nsta_ = parameters.nsta_;
+    nlta_ = parameters.nlta_;
+    isValid_ = parameters.isValid_;
+    return *this;
+}
+
+MultiBandSTALTAParameters::MultiBandSTALTAParameters(
+    const int nsta, const int nlta,
+    const RTSeis::ProcessingMode mode,
+    const RTSeis::Precision prec)
+{
+    // Set the long-term and short-term parameters
+    int ierr = setShortTermAndLongTermWindowSize(nsta, nlta);
+    if (ierr != 0)
+    {
+        clear();
+        return;
+    }
+    setProcessingMode(mode);
+    precision_ = prec;
+    // Validate
+    validate_();
+    return;
+}
+
+MultiBandSTALTAParameters::~MultiBandSTALTAParameters()
+{
+    clear();
+}
+
+void MultiBandSTALTAParameters::clear()
+{
+    bands_.clear();
+    nsta_ = 0;
+    nlta_ = 0;
+    precision_ = defaultPrecision_;
+    processingMode_ = RTSeis::ProcessingMode::POST_PROCESSING;
+    isValid_ = false;
+    return;
+}
+
+int MultiBandSTALTAParameters::setShortTermAndLongTermWindowSize(
+    const int nsta, const int nlta)
+{
+    if (nsta < 1)
+    {
+        RTSEIS_ERRMSG("STA window=%d samples must be at least 1", nsta);
+        return -1;
+    }
+    if (nlta <= nsta)
+    {
+        RTSEIS_ERRMSG("LTA window=%d samples must be greater than %d",
+                      nlta, nsta);
+        return -1;
+    }
+    nsta_ = nsta;
+    nlta_ = nlta;
+    validate_();
+    return 0;
+}
+
+int MultiBandSTALTAParameters::getLongTermWindowSize() const
+{
+    return nlta_;
+}
+
+int MultiBandSTALTAParameters::getShortTermWindowSize() const
+{
+    return nsta_;
+}
+
+int MultiBandSTALTAParameters::addBand(const SOS &sos)
+{
+    int ns = sos.getNumberOfSections();
+    if (ns < 1)
+    {
+        RTSEIS_ERRMSG("%s", "The filter has no sections");
+        return -1;
+    }
+    auto as = sos.getDenominatorCoefficients();
+    for (int i=0; i<ns; i++)
+    {
+        if (as[3*i] == 0)
+        {
+            RTSEIS_ERRMSG("Leading coefficient of section %d is zero", i);
+            return -1;
+        }
+    }
+    bands_.push_back(sos);
+    validate_();
+    return 0;
+}
+
+void MultiBandSTALTAParameters::clearBands()
+{
+    bands_.clear();
+    validate_();
+}
+
+int MultiBandSTALTAParameters::getNumberOfBands() const
+{
+    return static_cast<int> (bands_.size());
+}
+
+SOS MultiBandSTALTAParameters::getBand(const int band) const
+{
+    if (band < 0 || band >= getNumberOfBands())
+    {
+        RTSEIS_ERRMSG("band=%d must be in range [0,%d]",
+                      band, getNumberOfBands() - 1);
+        return SOS();
+    }
+    return bands_[band];
+}
+
+void MultiBandSTALTAParameters::setProcessingMode(
+    const RTSeis::ProcessingMode mode)
+{
+    processingMode_ = mode;
+    validate_();
+    return;
+}
+
+RTSeis::ProcessingMode MultiBandSTALTAParameters::getProcessingMode(void) const
+{
+    return processingMode_;
+}
+
+RTSeis::Precision MultiBandSTALTAParameters::getPrecision(void) const
+{
+    return precision_;
+}
+
+bool MultiBandSTALTAParameters::isValid() const
+{
+    return isValid_;
+}
+
+void MultiBandSTALTAParameters::validate_()
+{
+    isValid_ = false;
+    if (nsta_ < 1){return;}
+    if (nlta_ <= nsta_){return;}
+    if (bands_.empty()){return;}
+    if (getPrecision() != RTSeis::Precision::DOUBLE &&
+        getPrecision() != RTSeis::Precision::FLOAT){return;}
+    isValid_ = true;
+    return;
+}
+
+//============================================================================//
+//                                 End Parameters                             //
+//============================================================================//
+
+MultiBandSTALTA::MultiBandSTALTA(void) :
+    pSTALTA_(new MultiBandSTALTAImpl())
+{
+    clear();
+}
+
+MultiBandSTALTA::MultiBandSTALTA(const MultiBandSTALTA &mbstalta)
+{
+    *this = mbstalta;
+}
+
+MultiBandSTALTA::~MultiBandSTALTA()
+{
+    clear();
+    return;
+}
+
+void MultiBandSTALTA::clear()
+{
+    pSTALTA_->clear();
+    return;
+}
+
+MultiBandSTALTA::MultiBandSTALTA(const MultiBandSTALTAParameters &parameters) :
+    pSTALTA_(new MultiBandSTALTAImpl())
+{
+    clear();
+    if (!parameters.isValid())
+    {
+        RTSEIS_ERRMSG("%s", "Parameters are not valid");
+        return;
+    }
+    std::vector<SOS> filters(parameters.getNumberOfBands());
+    for (int i=0; i<parameters.getNumberOfBands(); i++)
+    {
+        filters[i] = parameters.getBand(i);
+    }
+    int nsta = parameters.getShortTermWindowSize();
+    int nlta = parameters.getLongTermWindowSize();
+    RTSeis::Precision precision = parameters.getPrecision();
+    RTSeis::ProcessingMode mode = parameters.getProcessingMode();
+    int ierr = pSTALTA_->initialize(filters, nsta, nlta, mode, precision);
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to initialize module");
+        return;
+    }
+    return;
+}
+
+MultiBandSTALTA& MultiBandSTALTA::operator=(const MultiBandSTALTA &mbstalta)
+{
+    if (&mbstalta == this){return *this;}
+    if (pSTALTA_){pSTALTA_->clear();}
+    pSTALTA_ = std::unique_ptr<MultiBandSTALTAImpl>
+              (new MultiBandSTALTAImpl(*mbstalta.pSTALTA_));
+    return *this;
+}
+
+int MultiBandSTALTA::getNumberOfBands() const
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    return pSTALTA_->getNumberOfBands();
+}
+
+int MultiBandSTALTA::resetInitialConditions()
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    pSTALTA_->resetInitialConditions();
+    return 0;
+}
+
+bool MultiBandSTALTA::isInitialized() const
+{
+    return pSTALTA_->isInitialized();
+}
+
+int MultiBandSTALTA::apply(const int nx, const double x[], double y[])
+{
+    if (nx <= 0){return 0;} // Nothing to do
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    if (x == nullptr || y == nullptr)
+    {
+        if (x == nullptr){RTSEIS_ERRMSG("%s", "x is NULL");}
+        if (y == nullptr){RTSEIS_ERRMSG("%s", "y is NULL");}
+        return -1;
+    }
+    int ierr = pSTALTA_->apply(nx, x, static_cast<double *const *> (nullptr),
+                               y);
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to apply filter");
+        return -1;
+    }
+    return 0;
+}
+
+int MultiBandSTALTA::apply(const int nx, const float x[], float y[])
+{
+    if (nx <= 0){return 0;} // Nothing to do
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    if (x == nullptr || y == nullptr)
+    {
+        if (x == nullptr){RTSEIS_ERRMSG("%s", "x is NULL");}
+        if (y == nullptr){RTSEIS_ERRMSG("%s", "y is NULL");}
+        return -1;
+    }
+    int ierr = pSTALTA_->apply(nx, x, static_cast<float *const *> (nullptr),
+                               y);
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to apply filter");
+        return -1;
+    }
+    return 0;
+}
+
+int MultiBandSTALTA::apply(const int nx, const double x[],
+                           const int nBands, double *const yBands[],
+                           double y[])
+{
+    if (nx <= 0){return 0;} // Nothing to do
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    if (nBands != pSTALTA_->getNumberOfBands())
+    {
+        RTSEIS_ERRMSG("nBands=%d must equal %d",
+                      nBands, pSTALTA_->getNumberOfBands());
+        return -1;
+    }
+    if (x == nullptr || y == nullptr || yBands == nullptr)
+    {
+        if (x == nullptr){RTSEIS_ERRMSG("%s", "x is NULL");}
+        if (y == nullptr){RTSEIS_ERRMSG("%s", "y is NULL");}
+        if (yBands == nullptr){RTSEIS_ERRMSG("%s", "yBands is NULL");}
+        return -1;
+    }
+    for (int i=0; i<nBands; i++)
+    {
+        if (yBands[i] == nullptr)
+        {
+            RTSEIS_ERRMSG("yBands[%d] is NULL", i);
+            return -1;
+        }
+    }
+    int ierr = pSTALTA_->apply(nx, x, yBands, y);
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to apply filter");
+        return -1;
+    }
+    return 0;
+}
+
+int MultiBandSTALTA::apply(const int nx, const float x[],
+                           const int nBands, float *const yBands[],
+                           float y[])
+{
+    if (nx <= 0){return 0;} // Nothing to do
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    if (nBands != pSTALTA_->getNumberOfBands())
+    {
+        RTSEIS_ERRMSG("nBands=%d must equal %d",
+                      nBands, pSTALTA_->getNumberOfBands());
+        return -1;
+    }
+    if (x == nullptr || y == nullptr || yBands == nullptr)
+    {
+        if (x == nullptr){RTSEIS_ERRMSG("%s", "x is NULL");}
+        if (y == nullptr){RTSEIS_ERRMSG("%s", "y is NULL");}
+        if (yBands == nullptr){RTSEIS_ERRMSG("%s", "yBands is NULL");}
+        return -1;
+    }
+    for (int i=0; i<nBands; i++)
+    {
+        if (yBands[i] == nullptr)
+        {
+            RTSEIS_ERRMSG("yBands[%d] is NULL", i);
+            return -1;
+        }
+    }
+    int ierr = pSTALTA_->apply(nx, x, yBands, y);
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to apply filter");
+        return -1;
+    }
+    return 0;
+}
+
+int MultiBandSTALTA::apply(const int nx, const double x[],
+                           ThresholdTrigger *trigger)
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    if ((nx > 0 && x == nullptr) || trigger == nullptr)
+    {
+        if (x == nullptr){RTSEIS_ERRMSG("%s", "x is NULL");}
+        if (trigger == nullptr){RTSEIS_ERRMSG("%s", "trigger is NULL");}
+        return -1;
+    }
+    if (!trigger->isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Trigger not initialized");
+        return -1;
+    }
+    trigger->begin();
+    int ierr = pSTALTA_->apply(std::max(0, nx), x,
+                               static_cast<double *const *> (nullptr),
+                               [trigger](const int n, const double y[])
+                               {
+                                   trigger->scan(n, y);
+                               });
+    trigger->end();
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to apply filter");
+        return -1;
+    }
+    return 0;
+}
+
+int MultiBandSTALTA::apply(const int nx, const float x[],
+                           ThresholdTrigger *trigger)
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    if ((nx > 0 && x == nullptr) || trigger == nullptr)
+    {
+        if (x == nullptr){RTSEIS_ERRMSG("%s", "x is NULL");}
+        if (trigger == nullptr){RTSEIS_ERRMSG("%s", "trigger is NULL");}
+        return -1;
+    }
+    if (!trigger->isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Trigger not initialized");
+        return -1;
+    }
+    trigger->begin();
+    int ierr = pSTALTA_->apply(std::max(0, nx), x,
+                               static_cast<float *const *> (nullptr),
+                               [trigger](const int n, const float y[])
+                               {
+                                   trigger->scan(n, y);
+                               });
+    trigger->end();
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to apply filter");
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,671 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cfloat>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#define RTSEIS_LOGGING 1
+#include "rtseis/log.h"
+#include "rtseis/modules/multiChannelClassicSTALTA.hpp"
+#include "rtseis/private/runningSum.hpp"
+
+using namespace RTSeis::Modules;
+
+namespace
+{
+/// Packets with fewer samples than this in total are not worth threading
+constexpr int minParallelSamples = 4096;
+/// The number of channels whose windows are interleaved and updated
+/// together when the channels receive packets of equal length
+constexpr int nLanes = 8;
+/// The signals are interleaved in blocks of this many samples
+constexpr int blockSize = 256;
+
+/// RTSeis::Private::neumaierAdd written with selects rather than a branch
+/// so that the lockstep loops vectorize.  The arithmetic is identical.
+inline void neumaierAddSelect(const double value, double *sum,
+                              double *compensation)
+{
+    auto t = *sum + value;
+    auto lsum = std::abs(*sum) >= std::abs(value);
+    auto big = lsum ? *sum : value;
+    auto small = lsum ? value : *sum;
+    *compensation = *compensation + ((big - t) + small);
+    *sum = t;
+}
+
+/// The running sums of the last n squared samples of every channel.  The
+/// channels are split into groups of nLanes and the windows of a group are
+/// interleaved, i.e., stored [nGroups x n x nLanes], so that a group can be
+/// updated in lockstep.  The sums, compensations, and heads are stored in
+/// arrays indexed by channel.
+class RunningSums
+{
+public:
+    /// Initializes the window length and each channel's initial conditions
+    void initialize(const int nChannels, const int n, const double zi)
+    {
+        auto nGroups = (nChannels + nLanes - 1)/nLanes;
+        auto nc = static_cast<size_t> (nGroups)*nLanes;
+        mRing.assign(nc*n, 0);
+        mInitialConditions.clear();
+        mInitialConditions.resize(nChannels);
+        mInitialValue = zi;
+        mSum.assign(nc, 0);
+        mCompensation.assign(nc, 0);
+        mHead.assign(nc, 0);
+        mLength = n;
+        mDivisor = 1.0/static_cast<double> (n);
+        for (int c=0; c<nChannels; ++c){reset(c);}
+    }
+    /// Length of each channel's initial conditions
+    int getInitialConditionLength() const
+    {
+        return mLength - 1;
+    }
+    /// Sets the initial conditions on a channel
+    void setInitialConditions(const int c, const double zi[])
+    {
+        mInitialConditions[c].assign(zi, zi + getInitialConditionLength());
+        reset(c);
+    }
+    /// Fills a channel's window with the initial conditions.  The oldest
+    /// slot is evicted by the first sample and does not contribute.
+    void reset(const int c)
+    {
+        auto nz = getInitialConditionLength();
+        double *ring = getRing(c);
+        ring[0] = 0;
+        if (mInitialConditions[c].empty())
+        {
+            for (int i=0; i<nz; ++i){ring[(i + 1)*nLanes] = mInitialValue;}
+        }
+        else
+        {
+            const double *zi = mInitialConditions[c].data();
+            for (int i=0; i<nz; ++i){ring[(i + 1)*nLanes] = zi[i];}
+        }
+        mHead[c] = 0;
+        recompute(ring, &mSum[c], &mCompensation[c]);
+    }
+    /// A channel's state loaded into registers for the duration of a packet
+    struct Channel
+    {
+        double *ring;
+        double sum;
+        double compensation;
+        int head;
+    };
+    /// Loads a channel's state
+    Channel load(const int c)
+    {
+        return Channel{getRing(c), mSum[c], mCompensation[c], mHead[c]};
+    }
+    /// Stores a channel's state
+    void store(const int c, const Channel &channel)
+    {
+        mSum[c] = channel.sum;
+        mCompensation[c] = channel.compensation;
+        mHead[c] = channel.head;
+    }
+    /// Adds the squared sample x2 to a channel and returns the average of
+    /// its window.  This matches RTSeis::Private::RunningSum::push.
+    double push(Channel &channel, const double x2) const
+    {
+        auto slot = channel.head*nLanes;
+        auto evicted = channel.ring[slot];
+        RTSeis::Private::neumaierAdd(x2, &channel.sum, &channel.compensation);
+        RTSeis::Private::neumaierAdd(-evicted,
+                                     &channel.sum, &channel.compensation);
+        channel.ring[slot] = x2;
+        channel.head = channel.head + 1;
+        if (channel.head == mLength)
+        {
+            channel.head = 0;
+            recompute(channel.ring, &channel.sum, &channel.compensation);
+        }
+        return (channel.sum + channel.compensation)*mDivisor;
+    }
+    /// Determines if the first nc channels of the g'th group are at the
+    /// same position in their windows and can be updated in lockstep
+    bool isAligned(const int g, const int nc) const
+    {
+        auto c0 = g*nLanes;
+        for (int l=1; l<nc; ++l)
+        {
+            if (mHead[c0+l] != mHead[c0]){return false;}
+        }
+        return true;
+    }
+    /// Adds n interleaved squared samples, x2, to the aligned channels of
+    /// the g'th group and tabulates the interleaved window averages.  The
+    /// arithmetic is the same as push so the results are identical.
+    void pushGroup(const int g, const int n, const double x2[],
+                   double average[])
+    {
+        auto c0 = g*nLanes;
+        double *ring = &mRing[static_cast<size_t> (c0)*mLength];
+        double sum[nLanes], compensation[nLanes];
+        std::copy(&mSum[c0], &mSum[c0] + nLanes, sum);
+        std::copy(&mCompensation[c0], &mCompensation[c0] + nLanes,
+                  compensation);
+        auto head = mHead[c0];
+        for (int i=0; i<n; ++i)
+        {
+            double *slot = &ring[head*nLanes];
+            const double *v = &x2[i*nLanes];
+            #pragma omp simd
+            for (int l=0; l<nLanes; ++l)
+            {
+                auto evicted = slot[l];
+                neumaierAddSelect(v[l], &sum[l], &compensation[l]);
+                neumaierAddSelect(-evicted, &sum[l], &compensation[l]);
+                slot[l] = v[l];
+            }
+            head = head + 1;
+            if (head == mLength)
+            {
+                head = 0;
+                recomputeGroup(ring, sum, compensation);
+            }
+            double *a = &average[i*nLanes];
+            #pragma omp simd
+            for (int l=0; l<nLanes; ++l)
+            {
+                a[l] = (sum[l] + compensation[l])*mDivisor;
+            }
+        }
+        std::copy(sum, sum + nLanes, &mSum[c0]);
+        std::copy(compensation, compensation + nLanes, &mCompensation[c0]);
+        std::fill(&mHead[c0], &mHead[c0] + nLanes, head);
+    }
+private:
+    /// Gets the first slot of a channel's window
+    double *getRing(const int c)
+    {
+        auto g = c/nLanes;
+        auto l = c - g*nLanes;
+        return &mRing[static_cast<size_t> (g)*mLength*nLanes + l];
+    }
+    /// Recomputes the sum of a window
+    void recompute(const double ring[], double *sum,
+                   double *compensation) const
+    {
+        *sum = 0;
+        *compensation = 0;
+        for (int i=0; i<mLength; ++i)
+        {
+            RTSeis::Private::neumaierAdd(ring[i*nLanes], sum, compensation);
+        }
+    }
+    /// Recomputes the sums of a group's windows
+    void recomputeGroup(const double ring[], double sum[],
+                        double compensation[]) const
+    {
+        std::fill(sum, sum + nLanes, 0);
+        std::fill(compensation, compensation + nLanes, 0);
+        for (int i=0; i<mLength; ++i)
+        {
+            const double *slot = &ring[i*nLanes];
+            #pragma omp simd
+            for (int l=0; l<nLanes; ++l)
+            {
+                neumaierAddSelect(slot[l], &sum[l], &compensation[l]);
+            }
+        }
+    }
+    /// The windows stored [nGroups x mLength x nLanes]
+    std::vector<double> mRing;
+    /// The initial conditions of each channel.  These are only allocated
+    /// for channels whose initial conditions are not all mInitialValue.
+    std::vector<std::vector<double>> mInitialConditions;
+    double mInitialValue = 0;
+    /// The uncompensated sum of each window
+    std::vector<double> mSum;
+    /// The compensation of each sum
+    std::vector<double> mCompensation;
+    /// The oldest slot in each window
+    std::vector<int> mHead;
+    int mLength = 0;
+    double mDivisor = 0;
+};
+
+}
+
+class MultiChannelClassicSTALTA::MultiChannelClassicSTALTAImpl
+{
+    public:
+        /// Releases memory on the module
+        void clear(void)
+        {
+            sta_ = RunningSums();
+            lta_ = RunningSums();
+            nChannels_ = 0;
+            mode_ = RTSeis::ProcessingMode::POST_PROCESSING;
+            linit_ = false;
+            return;
+        }
+        //--------------------------------------------------------------------//
+        int initialize(const int nChannels, const int nsta, const int nlta,
+                       const RTSeis::ProcessingMode mode,
+                       const RTSeis::Precision precision)
+        {
+            clear();
+            nChannels_ = nChannels;
+            // The short-term average initial conditions are 0
+            sta_.initialize(nChannels_, nsta, 0);
+            // Set the long-term initial conditions to something large
+            double xset = DBL_MAX/static_cast<double> (nlta)/4.0;
+            if (precision == RTSeis::Precision::FLOAT)
+            {
+                 xset = FLT_MAX/static_cast<double> (nlta)/4.0;
+            }
+            lta_.initialize(nChannels_, nlta, xset);
+            mode_ = mode;
+            linit_ = true;
+            return 0;
+        }
+        /// Determines if the module is initialized
+        bool isInitialized(void) const
+        {
+            return linit_;
+        }
+        /// Gets the number of channels
+        int getNumberOfChannels(void) const
+        {
+            return nChannels_;
+        }
+        /// Gets length of the numerator initial conditons
+        int getNumeratorInitialConditionLength(void) const
+        {
+            return sta_.getInitialConditionLength();
+        }
+        /// Gets length of the denominator initial conditons
+        int getDenominatorInitialConditionLength(void) const
+        {
+            return lta_.getInitialConditionLength();
+        }
+        /// Sets the initial conditions on a channel
+        int setInitialConditions(const int channel,
+                                 const double zNum[], const double zDen[])
+        {
+            sta_.setInitialConditions(channel, zNum);
+            lta_.setInitialConditions(channel, zDen);
+            return 0;
+        }
+        /// Resets the initial conditions on a channel
+        void resetInitialConditions(const int channel)
+        {
+            sta_.reset(channel);
+            lta_.reset(channel);
+        }
+        /// Resets the initial conditions on all channels
+        int resetInitialConditions(void)
+        {
+            for (int c=0; c<nChannels_; ++c){resetInitialConditions(c);}
+            return 0;
+        }
+        /// Applies the STA/LTA to a channel
+        template<typename T>
+        void apply(const int c, const int nx, const T x[], T y[])
+        {
+            auto sta = sta_.load(c);
+            auto lta = lta_.load(c);
+            for (int i=0; i<nx; ++i)
+            {
+                auto x2 = static_cast<double> (x[i])*static_cast<double> (x[i]);
+                auto ynum = sta_.push(sta, x2);
+                auto yden = lta_.push(lta, x2);
+                // A dead signal has a zero denominator and numerator so
+                // force 0/0 = 0.  The upshot is that it won't trigger.
+                y[i] = 0;
+                if (std::abs(yden) >= DBL_MIN)
+                {
+                    y[i] = static_cast<T> (ynum/yden);
+                }
+            }
+            sta_.store(c, sta);
+            lta_.store(c, lta);
+            // Reset the initial conditions for post-processing
+            if (mode_ == RTSeis::ProcessingMode::POST_PROCESSING)
+            {
+                resetInitialConditions(c);
+            }
+        }
+        /// Applies the STA/LTA to the g'th group of channels.  When the
+        /// group's channels have packets of equal length and are at the
+        /// same position in their windows they are updated in lockstep.
+        /// Otherwise, each channel is updated on its own.
+        template<typename T>
+        void applyGroup(const int g, const int nx[],
+                        const T *const x[], T *const y[])
+        {
+            auto c0 = g*nLanes;
+            auto nc = std::min(nLanes, nChannels_ - c0);
+            bool lockstep = (nc > 1);
+            for (int l=1; l<nc; ++l)
+            {
+                if (nx[c0+l] != nx[c0]){lockstep = false;}
+            }
+            lockstep = lockstep && sta_.isAligned(g, nc)
+                                && lta_.isAligned(g, nc);
+            if (!lockstep)
+            {
+                for (int c=c0; c<c0+nc; ++c)
+                {
+                    if (nx[c] > 0){apply(c, nx[c], x[c], y[c]);}
+                }
+                return;
+            }
+            double work[nLanes*blockSize];
+            double num[nLanes*blockSize];
+            double den[nLanes*blockSize];
+            auto npts = nx[c0];
+            for (int i0=0; i0<npts; i0=i0+blockSize)
+            {
+                auto n = std::min(blockSize, npts - i0);
+                if (nc < nLanes){std::fill(work, work + nLanes*n, 0);}
+                for (int l=0; l<nc; ++l)
+                {
+                    const T *xc = &x[c0+l][i0];
+                    for (int k=0; k<n; ++k)
+                    {
+                        auto xk = static_cast<double> (xc[k]);
+                        work[nLanes*k+l] = xk*xk;
+                    }
+                }
+                sta_.pushGroup(g, n, work, num);
+                lta_.pushGroup(g, n, work, den);
+                // A dead signal has a zero denominator and numerator so
+                // force 0/0 = 0.  The upshot is that it won't trigger.
+                // Dividing first then masking lets both loops vectorize.
+                #pragma omp simd
+                for (int k=0; k<nLanes*n; ++k)
+                {
+                    work[k] = num[k]/den[k];
+                }
+                #pragma omp simd
+                for (int k=0; k<nLanes*n; ++k)
+                {
+                    auto ratio = work[k];
+                    work[k] = (std::abs(den[k]) >= DBL_MIN) ? ratio : 0;
+                }
+                for (int l=0; l<nc; ++l)
+                {
+                    T *yc = &y[c0+l][i0];
+                    for (int k=0; k<n; ++k)
+                    {
+                        yc[k] = static_cast<T> (work[nLanes*k+l]);
+                    }
+                }
+            }
+            // Reset the initial conditions for post-processing
+            if (mode_ == RTSeis::ProcessingMode::POST_PROCESSING)
+            {
+                for (int c=c0; c<c0+nc; ++c){resetInitialConditions(c);}
+            }
+        }
+        /// Applies the STA/LTA to all channels
+        template<typename T>
+        int apply(const int nx[], const T *const x[], T *const y[])
+        {
+            int nTotal = 0;
+            for (int c=0; c<nChannels_; ++c){nTotal = nTotal + nx[c];}
+            auto nGroups = (nChannels_ + nLanes - 1)/nLanes;
+            #pragma omp parallel for schedule(dynamic, 1) \
+                    if (nGroups > 1 && nTotal >= minParallelSamples)
+            for (int g=0; g<nGroups; ++g)
+            {
+                applyGroup(g, nx, x, y);
+            }
+            return 0;
+        }
+    private:
+        /// Tabulates the numerator short-term averages
+        RunningSums sta_;
+        /// Tabulates the denominator long-term averages
+        RunningSums lta_;
+        /// The number of channels
+        int nChannels_ = 0;
+        /// The processing mode
+        RTSeis::ProcessingMode mode_ = RTSeis::ProcessingMode::POST_PROCESSING;
+        /// Flag indicating the class is initialized
+        bool linit_ = false;
+};
+
+//============================================================================//
+
+MultiChannelClassicSTALTA::MultiChannelClassicSTALTA(void) :
+    pSTALTA_(new MultiChannelClassicSTALTAImpl())
+{
+    clear();
+}
+
+MultiChannelClassicSTALTA::MultiChannelClassicSTALTA(
+    const MultiChannelClassicSTALTA &mcstalta)
+{
+    *this = mcstalta;
+}
+
+MultiChannelClassicSTALTA::~MultiChannelClassicSTALTA()
+{
+    clear();
+    return;
+}
+
+void MultiChannelClassicSTALTA::clear()
+{
+    pSTALTA_->clear();
+    return;
+}
+
+MultiChannelClassicSTALTA::MultiChannelClassicSTALTA(
+    const ClassicSTALTAParameters &parameters, const int nChannels) :
+    pSTALTA_(new MultiChannelClassicSTALTAImpl())
+{
+    clear();
+    if (!parameters.isValid())
+    {
+        RTSEIS_ERRMSG("%s", "Parameters are not valid");
+        return;
+    }
+    if (nChannels < 1)
+    {
+        RTSEIS_ERRMSG("nChannels=%d must be positive", nChannels);
+        return;
+    }
+    int nsta = parameters.getShortTermWindowSize();
+    int nlta = parameters.getLongTermWindowSize();
+    RTSeis::Precision precision = parameters.getPrecision();
+    RTSeis::ProcessingMode mode = parameters.getProcessingMode();
+    int ierr = pSTALTA_->initialize(nChannels, nsta, nlta, mode, precision);
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to initialize module");
+        return;
+    }
+    return;
+}
+
+MultiChannelClassicSTALTA&
+MultiChannelClassicSTALTA::operator=(const MultiChannelClassicSTALTA &mcstalta)
+{
+    if (&mcstalta == this){return *this;}
+    if (pSTALTA_){pSTALTA_->clear();}
+    pSTALTA_ = std::unique_ptr<MultiChannelClassicSTALTAImpl>
+              (new MultiChannelClassicSTALTAImpl(*mcstalta.pSTALTA_));
+    return *this;
+}
+
+int MultiChannelClassicSTALTA::getNumberOfChannels() const
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    return pSTALTA_->getNumberOfChannels();
+}
+
+int MultiChannelClassicSTALTA::setInitialConditions(
+    const int channel,
+    const int nzNum, const double zNum[],
+    const int nzDen, const double zDen[])
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    int nChannels = pSTALTA_->getNumberOfChannels();
+    if (channel < 0 || channel >= nChannels)
+    {
+        RTSEIS_ERRMSG("channel=%d must be in range [0,%d]",
+                      channel, nChannels - 1);
+        return -1;
+    }
+    int nzNumRef = pSTALTA_->getNumeratorInitialConditionLength();
+    int nzDenRef = pSTALTA_->getDenominatorInitialConditionLength();
+    if (nzNumRef != nzNum)
+    {
+        RTSEIS_ERRMSG("nzNum=%d must equal %d", nzNum, nzNumRef);
+        return -1;
+    }
+    if (nzDenRef != nzDen)
+    {
+        RTSEIS_ERRMSG("nzDen=%d must equal %d", nzDen, nzDenRef);
+        return -1;
+    }
+    if (nzNum > 0 && zNum == nullptr)
+    {
+        RTSEIS_ERRMSG("%s", "zNum is NULL");
+        return -1;
+    }
+    if (nzDen > 0 && zDen == nullptr)
+    {
+        RTSEIS_ERRMSG("%s", "zDen is NULL");
+        return -1;
+    }
+    int ierr = pSTALTA_->setInitialConditions(channel, zNum, zDen);
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to set initial conditions");
+        return -1;
+    }
+    return 0;
+}
+
+int MultiChannelClassicSTALTA::resetInitialConditions()
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    pSTALTA_->resetInitialConditions();
+    return 0;
+}
+
+int MultiChannelClassicSTALTA::getNumeratorInitialConditionLength() const
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    return pSTALTA_->getNumeratorInitialConditionLength();
+}
+
+int MultiChannelClassicSTALTA::getDenominatorInitialConditionLength() const
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    return pSTALTA_->getDenominatorInitialConditionLength();
+}
+
+bool MultiChannelClassicSTALTA::isInitialized() const
+{
+    return pSTALTA_->isInitialized();
+}
+
+namespace
+{
+/// Checks the multi-channel inputs
+template<typename T>
+int checkInputs(const int nChannels, const int nChannelsRef,
+                const int nx[], const T *const x[], T *const y[])
+{
+    if (nChannels != nChannelsRef)
+    {
+        RTSEIS_ERRMSG("nChannels=%d must equal %d", nChannels, nChannelsRef);
+        return -1;
+    }
+    if (nx == nullptr || x == nullptr || y == nullptr)
+    {
+        if (nx == nullptr){RTSEIS_ERRMSG("%s", "nx is NULL");}
+        if (x == nullptr){RTSEIS_ERRMSG("%s", "x is NULL");}
+        if (y == nullptr){RTSEIS_ERRMSG("%s", "y is NULL");}
+        return -1;
+    }
+    for (int c=0; c<nChannels; ++c)
+    {
+        if (nx[c] < 0)
+        {
+            RTSEIS_ERRMSG("nx[%d]=%d cannot be negative", c, nx[c]);
+            return -1;
+        }
+        if (nx[c] > 0 && (x[c] == nullptr || y[c] == nullptr))
+        {
+            if (x[c] == nullptr){RTSEIS_ERRMSG("x[%d] is NULL", c);}
+            if (y[c] == nullptr){RTSEIS_ERRMSG("y[%d] is NULL", c);}
+            return -1;
+        }
+    }
+    return 0;
+}
+}
+
+int MultiChannelClassicSTALTA::apply(const int nChannels, const int nx[],
+                                     const double *const x[],
+                                     double *const y[])
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    int ierr = checkInputs(nChannels, pSTALTA_->getNumberOfChannels(),
+                           nx, x, y);
+    if (ierr != 0){return -1;}
+    ierr = pSTALTA_->apply(nx, x, y);
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to apply filter");
+        return -1;
+    }
+    return 0;
+}
+
+int MultiChannelClassicSTALTA::apply(const int nChannels, const int nx[],
+                                     const float *const x[],
+                                     float *const y[])
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    int ierr = checkInputs(nChannels, pSTALTA_->getNumberOfChannels(),
+                           nx, x, y);
+    if (ierr != 0){return -1;}
+    ierr = pSTALTA_->apply(nx, x, y);
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to apply filter");
+        return -1;
+    }
+    return 0;
+}
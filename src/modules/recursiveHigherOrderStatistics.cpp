@@ -0,0 +1,659 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cfloat>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#define RTSEIS_LOGGING 1
+#include "rtseis/log.h"
+#include "rtseis/modules/recursiveHigherOrderStatistics.hpp"
+
+using namespace RTSeis::Modules;
+
+namespace
+{
+/// The number of channels whose states are interleaved and updated together
+constexpr int nLanes = 8;
+/// The signals are interleaved in blocks of this many samples
+constexpr int blockSize = 256;
+/// Below this many samples the channels aren't worth distributing
+/// over threads
+constexpr int minParallelSamples = 4096;
+
+/// Updates the mean, variance, and statistic of L interleaved channels.
+/// On input work holds the signals and on output it holds the statistics.
+template<typename U, int L, HigherOrderStatistic S>
+void update(const int n, const U c,
+            U mean[], U var[], U stat[], U work[])
+{
+    const U ic = 1 - c;
+    const U tiny = std::numeric_limits<U>::min();
+    for (int i=0; i<n; ++i)
+    {
+        U *w = &work[L*i];
+        #pragma omp simd
+        for (int l=0; l<L; ++l)
+        {
+            auto m = mean[l] + c*(w[l] - mean[l]);
+            auto d = w[l] - m;
+            auto v = ic*var[l] + c*d*d;
+            // Standardize first so that d^4 can't overflow.  A dead signal
+            // has no variance so let it contribute nothing.
+            U z = d/std::sqrt(std::max(v, tiny));
+            z = (v < tiny) ? 0 : z;
+            auto z2 = z*z;
+            auto p = (S == HigherOrderStatistic::KURTOSIS) ? z2*z2 : z2*z;
+            stat[l] = ic*stat[l] + c*p;
+            mean[l] = m;
+            var[l] = v;
+            w[l] = stat[l];
+        }
+    }
+}
+
+}
+
+class RecursiveHigherOrderStatistics::RecursiveHigherOrderStatisticsImpl
+{
+    public:
+        /// Releases memory on the module
+        void clear(void)
+        {
+            mean_.clear();
+            var_.clear();
+            stat_.clear();
+            mean0_ = 0;
+            var0_ = 0;
+            stat0_ = 0;
+            c_ = 0;
+            nChannels_ = 0;
+            nWarmUp_ = 0;
+            nWarmUpRemaining_ = 0;
+            statistic_ = HigherOrderStatistic::KURTOSIS;
+            precision_ = RTSeis::Precision::DOUBLE;
+            mode_ = RTSeis::ProcessingMode::POST_PROCESSING;
+            linit_ = false;
+            return;
+        }
+        //--------------------------------------------------------------------//
+        int initialize(const int nChannels, const int nwin,
+                       const HigherOrderStatistic statistic,
+                       const RTSeis::ProcessingMode mode,
+                       const RTSeis::Precision precision)
+        {
+            clear();
+            nChannels_ = nChannels;
+            // Pad the states to a whole number of lanes
+            auto nGroups = (nChannels + nLanes - 1)/nLanes;
+            mean_.resize(nGroups*nLanes);
+            var_.resize(nGroups*nLanes);
+            stat_.resize(nGroups*nLanes);
+            c_ = 1.0/static_cast<double> (nwin);
+            // The averages start at 0 so let them stabilize
+            nWarmUp_ = nwin;
+            statistic_ = statistic;
+            precision_ = precision;
+            mode_ = mode;
+            linit_ = true;
+            resetInitialConditions();
+            return 0;
+        }
+        /// Determines if the module is initialized
+        bool isInitialized(void) const
+        {
+            return linit_;
+        }
+        /// Gets the number of channels
+        int getNumberOfChannels(void) const
+        {
+            return nChannels_;
+        }
+        /// Sets the initial conditions
+        int setInitialConditions(const double mean, const double var,
+                                 const double stat)
+        {
+            mean0_ = mean;
+            var0_ = var;
+            stat0_ = stat;
+            // The user has described the signal preceding x
+            nWarmUp_ = 0;
+            resetInitialConditions();
+            return 0;
+        }
+        /// Resets the initial conditions
+        int resetInitialConditions(void)
+        {
+            std::fill(mean_.begin(), mean_.end(), mean0_);
+            std::fill(var_.begin(), var_.end(), var0_);
+            std::fill(stat_.begin(), stat_.end(), stat0_);
+            nWarmUpRemaining_ = nWarmUp_;
+            return 0;
+        }
+        /// Applies the statistic to all channels
+        template<typename T>
+        int apply(const int nx, const T *const x[], T *const y[])
+        {
+            if (precision_ == RTSeis::Precision::FLOAT)
+            {
+                compute<float>(nx, x, y);
+            }
+            else
+            {
+                compute<double>(nx, x, y);
+            }
+            // Zero out the statistic while the averages stabilize
+            auto nZero = std::min(nWarmUpRemaining_, nx);
+            for (int c=0; c<nChannels_; ++c)
+            {
+                std::fill(y[c], y[c] + nZero, 0);
+            }
+            nWarmUpRemaining_ = nWarmUpRemaining_ - nZero;
+            // Reset the initial conditions for post-processing
+            if (mode_ == RTSeis::ProcessingMode::POST_PROCESSING)
+            {
+                resetInitialConditions();
+            }
+            return 0;
+        }
+    private:
+        /// Computes the statistic in precision U
+        template<typename U, typename T>
+        void compute(const int nx, const T *const x[], T *const y[])
+        {
+            if (statistic_ == HigherOrderStatistic::KURTOSIS)
+            {
+                compute<U, HigherOrderStatistic::KURTOSIS>(nx, x, y);
+            }
+            else
+            {
+                compute<U, HigherOrderStatistic::SKEWNESS>(nx, x, y);
+            }
+        }
+        /// Computes statistic S in precision U
+        template<typename U, HigherOrderStatistic S, typename T>
+        void compute(const int nx, const T *const x[], T *const y[])
+        {
+            // A single channel needn't be interleaved
+            if (nChannels_ == 1)
+            {
+                computeGroup<U, S, 1>(0, nx, x, y);
+                return;
+            }
+            auto nGroups = (nChannels_ + nLanes - 1)/nLanes;
+            auto nTotal = static_cast<double> (nx)*nChannels_;
+            #pragma omp parallel for schedule(dynamic, 1) \
+                    if (nGroups > 1 && nTotal >= minParallelSamples)
+            for (int g=0; g<nGroups; ++g)
+            {
+                computeGroup<U, S, nLanes>(g, nx, x, y);
+            }
+        }
+        /// Computes statistic S in precision U for the g'th group of L
+        /// channels
+        template<typename U, HigherOrderStatistic S, int L, typename T>
+        void computeGroup(const int g, const int nx,
+                          const T *const x[], T *const y[])
+        {
+            U work[L*blockSize];
+            U mean[L], var[L], stat[L];
+            auto c0 = g*L;
+            auto nc = std::min(L, nChannels_ - c0);
+            for (int l=0; l<L; ++l)
+            {
+                mean[l] = static_cast<U> (mean_[c0+l]);
+                var[l] = static_cast<U> (var_[c0+l]);
+                stat[l] = static_cast<U> (stat_[c0+l]);
+            }
+            const auto c = static_cast<U> (c_);
+            for (int i0=0; i0<nx; i0=i0+blockSize)
+            {
+                auto n = std::min(blockSize, nx - i0);
+                if (nc < L){std::fill(work, work + L*n, 0);}
+                for (int l=0; l<nc; ++l)
+                {
+                    const T *xc = &x[c0+l][i0];
+                    for (int k=0; k<n; ++k)
+                    {
+                        work[L*k+l] = static_cast<U> (xc[k]);
+                    }
+                }
+                update<U, L, S>(n, c, mean, var, stat, work);
+                for (int l=0; l<nc; ++l)
+                {
+                    T *yc = &y[c0+l][i0];
+                    for (int k=0; k<n; ++k)
+                    {
+                        yc[k] = static_cast<T> (work[L*k+l]);
+                    }
+                }
+            }
+            for (int l=0; l<nc; ++l)
+            {
+                mean_[c0+l] = mean[l];
+                var_[c0+l] = var[l];
+                stat_[c0+l] = stat[l];
+            }
+        }
+
+        /// The mean of each channel
+        std::vector<double> mean_;
+        /// The variance of each channel
+        std::vector<double> var_;
+        /// The statistic of each channel
+        std::vector<double> stat_;
+        /// The mean initial condition
+        double mean0_ = 0;
+        /// The variance initial condition
+        double var0_ = 0;
+        /// The statistic initial condition
+        double stat0_ = 0;
+        /// The averaging weight 1/nwin
+        double c_ = 0;
+        /// The number of channels
+        int nChannels_ = 0;
+        /// The number of values to zero out while the averages stabilize
+        int nWarmUp_ = 0;
+        /// The number of values remaining to zero out
+        int nWarmUpRemaining_ = 0;
+        /// The statistic
+        HigherOrderStatistic statistic_ = HigherOrderStatistic::KURTOSIS;
+        /// The precision of the computations
+        RTSeis::Precision precision_ = RTSeis::Precision::DOUBLE;
+        /// The processing mode
+        RTSeis::ProcessingMode mode_ = RTSeis::ProcessingMode::POST_PROCESSING;
+        /// Flag indicating the class is initialized
+        bool linit_ = false;
+};
+
+//============================================================================//
+
+RecursiveHigherOrderStatisticsParameters::RecursiveHigherOrderStatisticsParameters()
+{
+    return;
+}
+
+RecursiveHigherOrderStatisticsParameters::RecursiveHigherOrderStatisticsParameters(
+    const RecursiveHigherOrderStatisticsParameters &parameters)
+{
+    *this = parameters;
+    return;
+}
+
+RecursiveHigherOrderStatisticsParameters&
+RecursiveHigherOrderStatisticsParameters::operator=(
+    const RecursiveHigherOrderStatisticsParameters &parameters)
+{
+    if (&parameters == this){return *this;}
+    clear();
+    nwin_ = parameters.nwin_;
+    statistic_ = parameters.statistic_;
+    precision_ = parameters.precision_;
+    processingMode_ = parameters.processingMode_;
+    isValid_ = parameters.isValid_;
+    return *this;
+}
+
+RecursiveHigherOrderStatisticsParameters::RecursiveHigherOrderStatisticsParameters(
+    const int nwin,
+    const HigherOrderStatistic statistic,
+    const RTSeis::ProcessingMode mode,
+    const RTSeis::Precision prec)
+{
+    int ierr = setWindowSize(nwin);
+    if (ierr != 0)
+    {
+        clear();
+        return;
+    }
+    setStatistic(statistic);
+    setProcessingMode(mode);
+    precision_ = prec;
+    // Validate
+    validate_();
+    return;
+}
+
+RecursiveHigherOrderStatisticsParameters::~RecursiveHigherOrderStatisticsParameters()
+{
+    clear();
+}
+
+void RecursiveHigherOrderStatisticsParameters::clear()
+{
+    nwin_ = 0;
+    statistic_ = HigherOrderStatistic::KURTOSIS;
+    precision_ = defaultPrecision_;
+    processingMode_ = RTSeis::ProcessingMode::POST_PROCESSING;
+    isValid_ = false;
+    return;
+}
+
+int RecursiveHigherOrderStatisticsParameters::setWindowSize(const int nwin)
+{
+    if (nwin < 2)
+    {
+        RTSEIS_ERRMSG("Window=%d samples must be at least 2", nwin);
+        return -1;
+    }
+    nwin_ = nwin;
+    validate_();
+    return 0;
+}
+
+int RecursiveHigherOrderStatisticsParameters::setWindowSize(
+    const double win, const double dt)
+{
+    if (dt <= 0)
+    {
+        RTSEIS_ERRMSG("dt=%lf must be postiive", dt);
+        return -1;
+    }
+    if (win < dt)
+    {
+        RTSEIS_ERRMSG("Window length=%lf (s) must be at least %lf (s)",
+                      win, dt);
+        return -1;
+    }
+    int nwin = static_cast<int> (win/dt + 0.5) + 1;
+    return setWindowSize(nwin);
+}
+
+int RecursiveHigherOrderStatisticsParameters::getWindowSize() const
+{
+    return nwin_;
+}
+
+void RecursiveHigherOrderStatisticsParameters::setStatistic(
+    const HigherOrderStatistic statistic)
+{
+    statistic_ = statistic;
+    validate_();
+    return;
+}
+
+HigherOrderStatistic
+RecursiveHigherOrderStatisticsParameters::getStatistic() const
+{
+    return statistic_;
+}
+
+void RecursiveHigherOrderStatisticsParameters::setProcessingMode(
+    const RTSeis::ProcessingMode mode)
+{
+    processingMode_ = mode;
+    validate_();
+    return;
+}
+
+RTSeis::ProcessingMode
+RecursiveHigherOrderStatisticsParameters::getProcessingMode(void) const
+{
+    return processingMode_;
+}
+
+RTSeis::Precision
+RecursiveHigherOrderStatisticsParameters::getPrecision(void) const
+{
+    return precision_;
+}
+
+bool RecursiveHigherOrderStatisticsParameters::isValid() const
+{
+    return isValid_;
+}
+
+void RecursiveHigherOrderStatisticsParameters::validate_()
+{
+    isValid_ = false;
+    if (nwin_ < 2){return;}
+    if (getPrecision() != RTSeis::Precision::DOUBLE &&
+        getPrecision() != RTSeis::Precision::FLOAT){return;}
+    isValid_ = true;
+    return;
+}
+
+//============================================================================//
+//                                 End Parameters                             //
+//============================================================================//
+
+RecursiveHigherOrderStatistics::RecursiveHigherOrderStatistics(void) :
+    pHOS_(new RecursiveHigherOrderStatisticsImpl())
+{
+    clear();
+}
+
+RecursiveHigherOrderStatistics::RecursiveHigherOrderStatistics(
+    const RecursiveHigherOrderStatistics &rhos)
+{
+    *this = rhos;
+}
+
+RecursiveHigherOrderStatistics::~RecursiveHigherOrderStatistics()
+{
+    clear();
+    return;
+}
+
+void RecursiveHigherOrderStatistics::clear()
+{
+    pHOS_->clear();
+    return;
+}
+
+RecursiveHigherOrderStatistics::RecursiveHigherOrderStatistics(
+    const RecursiveHigherOrderStatisticsParameters &parameters,
+    const int nChannels) :
+    pHOS_(new RecursiveHigherOrderStatisticsImpl())
+{
+    clear();
+    if (!parameters.isValid())
+    {
+        RTSEIS_ERRMSG("%s", "Parameters are not valid");
+        return;
+    }
+    if (nChannels < 1)
+    {
+        RTSEIS_ERRMSG("nChannels=%d must be positive", nChannels);
+        return;
+    }
+    int nwin = parameters.getWindowSize();
+    HigherOrderStatistic statistic = parameters.getStatistic();
+    RTSeis::Precision precision = parameters.getPrecision();
+    RTSeis::ProcessingMode mode = parameters.getProcessingMode();
+    int ierr = pHOS_->initialize(nChannels, nwin, statistic, mode, precision);
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to initialize module");
+        return;
+    }
+    return;
+}
+
+RecursiveHigherOrderStatistics&
+RecursiveHigherOrderStatistics::operator=(
+    const RecursiveHigherOrderStatistics &rhos)
+{
+    if (&rhos == this){return *this;}
+    if (pHOS_){pHOS_->clear();}
+    pHOS_ = std::unique_ptr<RecursiveHigherOrderStatisticsImpl>
+           (new RecursiveHigherOrderStatisticsImpl(*rhos.pHOS_));
+    return *this;
+}
+
+int RecursiveHigherOrderStatistics::getNumberOfChannels() const
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    return pHOS_->getNumberOfChannels();
+}
+
+int RecursiveHigherOrderStatistics::getInitialConditionLength() const
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    return 3;
+}
+
+int RecursiveHigherOrderStatistics::setInitialConditions(
+    const int nz, const double zi[])
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    if (nz != getInitialConditionLength() || zi == nullptr)
+    {
+        if (nz != getInitialConditionLength())
+        {
+            RTSEIS_ERRMSG("nz=%d should equal %d",
+                          nz, getInitialConditionLength());
+        }
+        if (zi == nullptr){RTSEIS_ERRMSG("%s", "zi is NULL");}
+        return -1;
+    }
+    if (zi[1] < 0)
+    {
+        RTSEIS_ERRMSG("Variance=%e cannot be negative", zi[1]);
+        return -1;
+    }
+    pHOS_->setInitialConditions(zi[0], zi[1], zi[2]);
+    return 0;
+}
+
+int RecursiveHigherOrderStatistics::resetInitialConditions()
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    pHOS_->resetInitialConditions();
+    return 0;
+}
+
+bool RecursiveHigherOrderStatistics::isInitialized() const
+{
+    return pHOS_->isInitialized();
+}
+
+int RecursiveHigherOrderStatistics::apply(const int nx, const double x[],
+                                          double y[])
+{
+    if (nx <= 0){return 0;} // Nothing to do
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    if (pHOS_->getNumberOfChannels() != 1)
+    {
+        RTSEIS_ERRMSG("%s", "Module has multiple channels");
+        return -1;
+    }
+    return apply(1, nx, &x, &y);
+}
+
+int RecursiveHigherOrderStatistics::apply(const int nx, const float x[],
+                                          float y[])
+{
+    if (nx <= 0){return 0;} // Nothing to do
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    if (pHOS_->getNumberOfChannels() != 1)
+    {
+        RTSEIS_ERRMSG("%s", "Module has multiple channels");
+        return -1;
+    }
+    return apply(1, nx, &x, &y);
+}
+
+int RecursiveHigherOrderStatistics::apply(const int nChannels, const int nx,
+                                          const double *const x[],
+                                          double *const y[])
+{
+    if (nx <= 0){return 0;} // Nothing to do
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    if (nChannels != pHOS_->getNumberOfChannels())
+    {
+        RTSEIS_ERRMSG("nChannels=%d must equal %d",
+                      nChannels, pHOS_->getNumberOfChannels());
+        return -1;
+    }
+    if (x == nullptr || y == nullptr)
+    {
+        if (x == nullptr){RTSEIS_ERRMSG("%s", "x is NULL");}
+        if (y == nullptr){RTSEIS_ERRMSG("%s", "y is NULL");}
+        return -1;
+    }
+    for (int c=0; c<nChannels; c++)
+    {
+        if (x[c] == nullptr || y[c] == nullptr)
+        {
+            if (x[c] == nullptr){RTSEIS_ERRMSG("x[%d] is NULL", c);}
+            if (y[c] == nullptr){RTSEIS_ERRMSG("y[%d] is NULL", c);}
+            return -1;
+        }
+    }
+    int ierr = pHOS_->apply(nx, x, y);
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to apply filter");
+        return -1;
+    }
+    return 0;
+}
+
+int RecursiveHigherOrderStatistics::apply(const int nChannels, const int nx,
+                                          const float *const x[],
+                                          float *const y[])
+{
+    if (nx <= 0){return 0;} // Nothing to do
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    if (nChannels != pHOS_->getNumberOfChannels())
+    {
+        RTSEIS_ERRMSG("nChannels=%d must equal %d",
+                      nChannels, pHOS_->getNumberOfChannels());
+        return -1;
+    }
+    if (x == nullptr || y == nullptr)
+    {
+        if (x == nullptr){RTSEIS_ERRMSG("%s", "x is NULL");}
+        if (y == nullptr){RTSEIS_ERRMSG("%s", "y is NULL");}
+        return -1;
+    }
+    for (int c=0; c<nChannels; c++)
+    {
+        if (x[c] == nullptr || y[c] == nullptr)
+        {
+            if (x[c] == nullptr){RTSEIS_ERRMSG("x[%d] is NULL", c);}
+            if (y[c] == nullptr){RTSEIS_ERRMSG("y[%d] is NULL", c);}
+            return -1;
+        }
+    }
+    int ierr = pHOS_->apply(nx, x, y);
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to apply filter");
+        return -1;
+    }
+    return 0;
+}
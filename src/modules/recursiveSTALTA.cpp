@@ -0,0 +1,604 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cfloat>
+#include <cmath>
+#include <algorithm>
+#define RTSEIS_LOGGING 1
+#include "rtseis/log.h"
+#include "rtseis/modules/recursiveSTALTA.hpp"
+#include "rtseis/modules/thresholdTrigger.hpp"
+
+using namespace RTSeis::Modules;
+
+namespace
+{
+/// The STA/LTA is passed to a trigger in blocks of this many samples
+constexpr int triggerBlockSize = 256;
+}
+
+class RecursiveSTALTA::RecursiveSTALTAImpl
+{
+    public:
+        /// Releases memory on the module
+        void clear(void)
+        {
+            sta_ = 0;
+            lta_ = 0;
+            sta0_ = 0;
+            lta0_ = 0;
+            xPrevious_ = 0;
+            csta_ = 0;
+            clta_ = 0;
+            allenWeight_ = 0;
+            nWarmUp_ = 0;
+            nWarmUpRemaining_ = 0;
+            mode_ = RTSeis::ProcessingMode::POST_PROCESSING;
+            linit_ = false;
+            return;
+        }
+        //--------------------------------------------------------------------//
+        int initialize(const int nsta, const int nlta,
+                       const double allenWeight,
+                       const RTSeis::ProcessingMode mode)
+        {
+            clear();
+            csta_ = 1.0/static_cast<double> (nsta);
+            clta_ = 1.0/static_cast<double> (nlta);
+            allenWeight_ = allenWeight;
+            // The averages start at 0 so let the LTA stabilize
+            nWarmUp_ = nlta;
+            mode_ = mode;
+            linit_ = true;
+            resetInitialConditions();
+            return 0;
+        }
+        /// Determines if the module is initialized
+        bool isInitialized(void) const
+        {
+            return linit_;
+        }
+        /// Sets the initial conditions
+        int setInitialConditions(const double zNum, const double zDen)
+        {
+            sta0_ = zNum;
+            lta0_ = zDen;
+            // The user has described the signal preceding x
+            nWarmUp_ = 0;
+            resetInitialConditions();
+            return 0;
+        }
+        /// Resets the initial conditions
+        int resetInitialConditions(void)
+        {
+            sta_ = sta0_;
+            lta_ = lta0_;
+            xPrevious_ = 0;
+            nWarmUpRemaining_ = nWarmUp_;
+            return 0;
+        }
+        /// Applies the STA/LTA
+        template<typename T>
+        int apply(const int nx, const T x[], T y[])
+        {
+            if (nx <= 0){return 0;} // Nothing to do
+            compute(nx, x, y);
+            // Reset the initial conditions for post-processing
+            if (mode_ == RTSeis::ProcessingMode::POST_PROCESSING)
+            {
+                resetInitialConditions();
+            }
+            return 0;
+        }
+        /// Applies the STA/LTA and passes it to consume in blocks
+        template<typename T, typename F>
+        int apply(const int nx, const T x[], F consume)
+        {
+            T y[triggerBlockSize];
+            for (int i=0; i<nx; i=i+triggerBlockSize)
+            {
+                auto n = std::min(triggerBlockSize, nx - i);
+                compute(n, &x[i], y);
+                consume(n, y);
+            }
+            // Reset the initial conditions for post-processing
+            if (mode_ == RTSeis::ProcessingMode::POST_PROCESSING)
+            {
+                resetInitialConditions();
+            }
+            return 0;
+        }
+    private:
+        /// Computes the STA/LTA
+        template<typename T>
+        void compute(const int nx, const T x[], T y[])
+        {
+            const double ista = 1 - csta_;
+            const double ilta = 1 - clta_;
+            for (int i=0; i<nx; ++i)
+            {
+                // Allen's characteristic function
+                auto xi = static_cast<double> (x[i]);
+                auto dx = xi - xPrevious_;
+                auto e = xi*xi + allenWeight_*dx*dx;
+                xPrevious_ = xi;
+                sta_ = csta_*e + ista*sta_;
+                lta_ = clta_*e + ilta*lta_;
+                // A dead signal has a zero denominator and numerator so
+                // force 0/0 = 0.  The upshot is that it won't trigger.
+                y[i] = 0;
+                if (nWarmUpRemaining_ > 0)
+                {
+                    nWarmUpRemaining_ = nWarmUpRemaining_ - 1;
+                    continue;
+                }
+                if (std::abs(lta_) >= DBL_MIN)
+                {
+                    y[i] = static_cast<T> (sta_/lta_);
+                }
+            }
+        }
+        /// The short-term average
+        double sta_ = 0;
+        /// The long-term average
+        double lta_ = 0;
+        /// The short-term average initial condition
+        double sta0_ = 0;
+        /// The long-term average initial condition
+        double lta0_ = 0;
+        /// The previous sample in Allen's characteristic function
+        double xPrevious_ = 0;
+        /// The short-term average weight 1/nsta
+        double csta_ = 0;
+        /// The long-term average weight 1/nlta
+        double clta_ = 0;
+        /// The weight on the derivative in Allen's characteristic function
+        double allenWeight_ = 0;
+        /// The number of ratios to zero out while the LTA stabilizes
+        int nWarmUp_ = 0;
+        /// The number of ratios remaining to zero out
+        int nWarmUpRemaining_ = 0;
+        /// The processing mode
+        RTSeis::ProcessingMode mode_ = RTSeis::ProcessingMode::POST_PROCESSING;
+        /// Flag indicating the class is initialized
+        bool linit_ = false;
+};
+
+//============================================================================//
+
+RecursiveSTALTAParameters::RecursiveSTALTAParameters()
+{
+    return;
+}
+
+RecursiveSTALTAParameters::RecursiveSTALTAParameters(
+    const RecursiveSTALTAParameters &parameters)
+{
+    *this = parameters;
+    return;
+}
+
+RecursiveSTALTAParameters&
+RecursiveSTALTAParameters::operator=(const RecursiveSTALTAParameters &parameters)
+{
+    if (&parameters == this){return *this;}
+    clear();
+    precision_ = parameters.precision_;
+    processingMode_ = parameters.processingMode_;
+    allenWeight_ = parameters.allenWeight_;
+    nsta_ = parameters.nsta_;
+    nlta_ = parameters.nlta_;
+    isValid_ = parameters.isValid_;
+    return *this;
+}
+
+RecursiveSTALTAParameters::RecursiveSTALTAParameters(
+    const int nsta, const int nlta,
+    const RTSeis::ProcessingMode mode,
+    const RTSeis::Precision prec)
+{
+    // Set the long-term and short-term parameters
+    int ierr = setShortTermAndLongTermWindowSize(nsta, nlta);
+    if (ierr != 0)
+    {
+        clear();
+        return;
+    }
+    setProcessingMode(mode);
+    precision_ = prec;
+    // Validate
+    validate_();
+    return;
+}
+
+RecursiveSTALTAParameters::RecursiveSTALTAParameters(
+    const double staWin, const double ltaWin, const double dt,
+    const RTSeis::ProcessingMode mode,
+    const RTSeis::Precision prec)
+{
+    // Check parameters
+    int ierr = setShortTermAndLongTermWindowSize(staWin, ltaWin, dt);
+    if (ierr != 0)
+    {
+        clear();
+        return;
+    }
+    setProcessingMode(mode);
+    precision_ = prec;
+    // Validate
+    validate_();
+    return;
+}
+
+RecursiveSTALTAParameters::~RecursiveSTALTAParameters()
+{
+    clear();
+}
+
+void RecursiveSTALTAParameters::clear()
+{
+    allenWeight_ = 0;
+    nsta_ = 0;
+    nlta_ = 0;
+    precision_ = defaultPrecision_;
+    processingMode_ = RTSeis::ProcessingMode::POST_PROCESSING;
+    isValid_ = false;
+    return;
+}
+
+int RecursiveSTALTAParameters::setShortTermAndLongTermWindowSize(
+    const int nsta, const int nlta)
+{
+    if (nsta < 1)
+    {
+        RTSEIS_ERRMSG("STA window=%d samples must be at least 1", nsta);
+        return -1;
+    }
+    if (nlta <= nsta)
+    {
+        RTSEIS_ERRMSG("LTA window=%d samples must be greater than %d",
+                      nlta, nsta);
+        return -1;
+    }
+    nsta_ = nsta;
+    nlta_ = nlta;
+    validate_();
+    return 0;
+}
+
+int RecursiveSTALTAParameters::setShortTermAndLongTermWindowSize(
+    const double staWin, const double ltaWin, const double dt)
+{
+    if (dt <= 0)
+    {
+        RTSEIS_ERRMSG("dt=%lf must be postiive", dt);
+        return -1;
+    }
+    if (staWin < 0)
+    {
+        RTSEIS_ERRMSG("STA window length=%lf (s) must be at least %lf (s) ",
+                      staWin, dt);
+        return -1;
+    }
+    if (ltaWin <= staWin + dt/2)
+    {
+        RTSEIS_ERRMSG("LTA window length=%lf (s) must be at least %lf (s) ",
+                      ltaWin, staWin + dt);
+        return -1;
+    }
+    int nsta = static_cast<int> (staWin/dt + 0.5) + 1;
+    int nlta = static_cast<int> (ltaWin/dt + 0.5) + 1;
+    if (nlta <= nsta)
+    {
+        RTSEIS_ERRMSG("%s", "Algorithmic failure");
+        return -1;
+    }
+    nsta_ = nsta;
+    nlta_ = nlta;
+    validate_();
+    return 0;
+}
+
+int RecursiveSTALTAParameters::getLongTermWindowSize() const
+{
+    return nlta_;
+}
+
+int RecursiveSTALTAParameters::getShortTermWindowSize() const
+{
+    return nsta_;
+}
+
+int RecursiveSTALTAParameters::setAllenWeight(const double weight)
+{
+    if (weight < 0)
+    {
+        RTSEIS_ERRMSG("Allen weight=%lf cannot be negative", weight);
+        return -1;
+    }
+    allenWeight_ = weight;
+    validate_();
+    return 0;
+}
+
+double RecursiveSTALTAParameters::getAllenWeight() const
+{
+    return allenWeight_;
+}
+
+void RecursiveSTALTAParameters::setProcessingMode(
+    const RTSeis::ProcessingMode mode)
+{
+    processingMode_ = mode;
+    validate_();
+    return;
+}
+
+RTSeis::ProcessingMode RecursiveSTALTAParameters::getProcessingMode(void) const
+{
+    return processingMode_;
+}
+
+RTSeis::Precision RecursiveSTALTAParameters::getPrecision(void) const
+{
+    return precision_;
+}
+
+bool RecursiveSTALTAParameters::isValid() const
+{
+    return isValid_;
+}
+
+void RecursiveSTALTAParameters::validate_()
+{
+    isValid_ = false;
+    if (nsta_ < 1){return;}
+    if (nlta_ <= nsta_){return;}
+    if (allenWeight_ < 0){return;}
+    if (getPrecision() != RTSeis::Precision::DOUBLE &&
+        getPrecision() != RTSeis::Precision::FLOAT){return;}
+    isValid_ = true;
+    return;
+}
+
+//============================================================================//
+//                                 End Parameters                             //
+//============================================================================//
+
+RecursiveSTALTA::RecursiveSTALTA(void) :
+    pSTALTA_(new RecursiveSTALTAImpl())
+{
+    clear();
+}
+
+RecursiveSTALTA::RecursiveSTALTA(const RecursiveSTALTA &rstalta)
+{
+    *this = rstalta;
+}
+
+RecursiveSTALTA::~RecursiveSTALTA()
+{
+    clear();
+    return;
+}
+
+void RecursiveSTALTA::clear()
+{
+    pSTALTA_->clear();
+    return;
+}
+
+RecursiveSTALTA::RecursiveSTALTA(const RecursiveSTALTAParameters &parameters) :
+    pSTALTA_(new RecursiveSTALTAImpl())
+{
+    clear();
+    if (!parameters.isValid())
+    {
+        RTSEIS_ERRMSG("%s", "Parameters are not valid");
+        return;
+    }
+    int nsta = parameters.getShortTermWindowSize();
+    int nlta = parameters.getLongTermWindowSize();
+    double allenWeight = parameters.getAllenWeight();
+    RTSeis::ProcessingMode mode = parameters.getProcessingMode();
+    int ierr = pSTALTA_->initialize(nsta, nlta, allenWeight, mode);
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to initialize module");
+        return;
+    }
+    return;
+}
+
+RecursiveSTALTA& RecursiveSTALTA::operator=(const RecursiveSTALTA &rstalta)
+{
+    if (&rstalta == this){return *this;}
+    if (pSTALTA_){pSTALTA_->clear();}
+    pSTALTA_ = std::unique_ptr<RecursiveSTALTAImpl>
+              (new RecursiveSTALTAImpl(*rstalta.pSTALTA_));
+    return *this;
+}
+
+int RecursiveSTALTA::setInitialConditions(const int nzNum, const double zNum[],
+                                          const int nzDen, const double zDen[])
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    int nzNumRef = getNumeratorInitialConditionLength();
+    int nzDenRef = getDenominatorInitialConditionLength();
+    if (nzNumRef != nzNum)
+    {
+        RTSEIS_ERRMSG("nzNum=%d must equal %d", nzNum, nzNumRef);
+        return -1;
+    }
+    if (nzDenRef != nzDen)
+    {
+        RTSEIS_ERRMSG("nzDen=%d must equal %d", nzDen, nzDenRef);
+        return -1;
+    }
+    if (zNum == nullptr || zDen == nullptr)
+    {
+        if (zNum == nullptr){RTSEIS_ERRMSG("%s", "zNum is NULL");}
+        if (zDen == nullptr){RTSEIS_ERRMSG("%s", "zDen is NULL");}
+        return -1;
+    }
+    if (zNum[0] < 0 || zDen[0] < 0)
+    {
+        RTSEIS_ERRMSG("%s", "Averages of squared signals cannot be negative");
+        return -1;
+    }
+    pSTALTA_->setInitialConditions(zNum[0], zDen[0]);
+    return 0;
+}
+
+int RecursiveSTALTA::resetInitialConditions()
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    pSTALTA_->resetInitialConditions();
+    return 0;
+}
+
+int RecursiveSTALTA::getNumeratorInitialConditionLength() const
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    return 1;
+}
+
+int RecursiveSTALTA::getDenominatorInitialConditionLength() const
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    return 1;
+}
+
+bool RecursiveSTALTA::isInitialized() const
+{
+    return pSTALTA_->isInitialized();
+}
+
+int RecursiveSTALTA::apply(const int nx, const double x[], double y[])
+{
+    if (nx <= 0){return 0;} // Nothing to do
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    if (x == nullptr || y == nullptr)
+    {
+        if (x == nullptr){RTSEIS_ERRMSG("%s", "x is NULL");}
+        if (y == nullptr){RTSEIS_ERRMSG("%s", "y is NULL");}
+        return -1;
+    }
+    int ierr = pSTALTA_->apply(nx, x, y);
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to apply filter");
+        return -1;
+    }
+    return 0;
+}
+
+int RecursiveSTALTA::apply(const int nx, const float x[], float y[])
+{
+    if (nx <= 0){return 0;} // Nothing to do
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    if (x == nullptr || y == nullptr)
+    {
+        if (x == nullptr){RTSEIS_ERRMSG("%s", "x is NULL");}
+        if (y == nullptr){RTSEIS_ERRMSG("%s", "y is NULL");}
+        return -1;
+    }
+    int ierr = pSTALTA_->apply(nx, x, y);
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to apply filter");
+        return -1;
+    }
+    return 0;
+}
+
+int RecursiveSTALTA::apply(const int nx, const double x[],
+                           ThresholdTrigger *trigger)
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    if ((nx > 0 && x == nullptr) || trigger == nullptr)
+    {
+        if (x == nullptr){RTSEIS_ERRMSG("%s", "x is NULL");}
+        if (trigger == nullptr){RTSEIS_ERRMSG("%s", "trigger is NULL");}
+        return -1;
+    }
+    if (!trigger->isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Trigger not initialized");
+        return -1;
+    }
+    trigger->begin();
+    int ierr = pSTALTA_->apply(std::max(0, nx), x,
+                               [trigger](const int n, const double y[])
+                               {
+                                   trigger->scan(n, y);
+                               });
+    trigger->end();
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to apply filter");
+        return -1;
+    }
+    return 0;
+}
+
+int RecursiveSTALTA::apply(const int nx, const float x[],
+                           ThresholdTrigger *trigger)
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    if ((nx > 0 && x == nullptr) || trigger == nullptr)
+    {
+        if (x == nullptr){RTSEIS_ERRMSG("%s", "x is NULL");}
+        if (trigger == nullptr){RTSEIS_ERRMSG("%s", "trigger is NULL");}
+        return -1;
+    }
+    if (!trigger->isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Trigger not initialized");
+        return -1;
+    }
+    trigger->begin();
+    int ierr = pSTALTA_->apply(std::max(0, nx), x,
+                               [trigger](const int n, const float y[])
+                               {
+                                   trigger->scan(n, y);
+                               });
+    trigger->end();
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to apply filter");
+        return -1;
+    }
+    return 0;
+}
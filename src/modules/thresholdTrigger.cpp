@@ -0,0 +1,552 @@
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+#define RTSEIS_LOGGING 1
+#include "rtseis/log.h"
+#include "rtseis/modules/thresholdTrigger.hpp"
+
+using namespace RTSeis::Modules;
+
+class ThresholdTrigger::ThresholdTriggerImpl
+{
+    public:
+        /// Releases memory on the module
+        void clear(void)
+        {
+            triggers_.clear();
+            current_ = TriggerRecord();
+            sample_ = 0;
+            onThreshold_ = 0;
+            offThreshold_ = 0;
+            minimumDuration_ = 0;
+            prePadding_ = 0;
+            postPadding_ = 0;
+            mode_ = RTSeis::ProcessingMode::POST_PROCESSING;
+            lon_ = false;
+            linit_ = false;
+            return;
+        }
+        //--------------------------------------------------------------------//
+        int initialize(const double onThreshold, const double offThreshold,
+                       const int minimumDuration,
+                       const int prePadding, const int postPadding,
+                       const RTSeis::ProcessingMode mode)
+        {
+            clear();
+            onThreshold_ = onThreshold;
+            offThreshold_ = offThreshold;
+            minimumDuration_ = minimumDuration;
+            prePadding_ = prePadding;
+            postPadding_ = postPadding;
+            mode_ = mode;
+            linit_ = true;
+            return 0;
+        }
+        /// Determines if the module is initialized
+        bool isInitialized(void) const
+        {
+            return linit_;
+        }
+        /// Determines if a trigger is on
+        bool isTriggered(void) const
+        {
+            return lon_;
+        }
+        /// Gets the triggers
+        const std::vector<TriggerRecord> &getTriggers(void) const
+        {
+            return triggers_;
+        }
+        /// Discards the triggers that have turned off
+        void clearTriggers(void)
+        {
+            triggers_.clear();
+        }
+        /// Resets the initial conditions
+        int resetInitialConditions(void)
+        {
+            triggers_.clear();
+            current_ = TriggerRecord();
+            sample_ = 0;
+            lon_ = false;
+            return 0;
+        }
+        /// Starts a signal
+        void begin(void)
+        {
+            if (mode_ == RTSeis::ProcessingMode::POST_PROCESSING)
+            {
+                resetInitialConditions();
+            }
+        }
+        /// Scans the next block of the characteristic function for triggers
+        template<typename T>
+        void scan(const int nx, const T cf[])
+        {
+            int i = 0;
+            while (i < nx)
+            {
+                if (!lon_)
+                {
+                    // Most of the time nothing is happening so this is the
+                    // hot loop
+                    for (; i<nx; ++i)
+                    {
+                        if (cf[i] >= onThreshold_){break;}
+                    }
+                    if (i == nx){break;}
+                    lon_ = true;
+                    current_.onset = sample_ + i;
+                    current_.peak = current_.onset;
+                    current_.peakValue = static_cast<double> (cf[i]);
+                    i = i + 1;
+                }
+                else
+                {
+                    for (; i<nx; ++i)
+                    {
+                        if (cf[i] < offThreshold_){break;}
+                        if (cf[i] > current_.peakValue)
+                        {
+                            current_.peak = sample_ + i;
+                            current_.peakValue = static_cast<double> (cf[i]);
+                        }
+                    }
+                    if (i == nx){break;}
+                    turnOff(sample_ + i);
+                }
+            }
+            sample_ = sample_ + nx;
+        }
+        /// Ends a signal
+        void end(void)
+        {
+            // The signal is over so end any active trigger
+            if (mode_ == RTSeis::ProcessingMode::POST_PROCESSING && lon_)
+            {
+                turnOff(sample_);
+            }
+        }
+        /// Scans the characteristic function for triggers
+        template<typename T>
+        int apply(const int nx, const T cf[])
+        {
+            begin();
+            scan(nx, cf);
+            end();
+            return 0;
+        }
+    private:
+        /// Ends the current trigger at the given sample
+        void turnOff(const int64_t off)
+        {
+            lon_ = false;
+            current_.duration = off - current_.onset;
+            if (current_.duration < minimumDuration_){return;}
+            current_.start = std::max(static_cast<int64_t> (0),
+                                      current_.onset - prePadding_);
+            current_.end = off + postPadding_;
+            triggers_.push_back(current_);
+        }
+        /// The triggers that have turned off
+        std::vector<TriggerRecord> triggers_;
+        /// The trigger that is on
+        TriggerRecord current_;
+        /// The index of the next sample
+        int64_t sample_ = 0;
+        /// The on threshold
+        double onThreshold_ = 0;
+        /// The off threshold
+        double offThreshold_ = 0;
+        /// The minimum trigger duration in samples
+        int minimumDuration_ = 0;
+        /// The pre-padding in samples
+        int prePadding_ = 0;
+        /// The post-padding in samples
+        int postPadding_ = 0;
+        /// The processing mode
+        RTSeis::ProcessingMode mode_ = RTSeis::ProcessingMode::POST_PROCESSING;
+        /// Flag indicating a trigger is on
+        bool lon_ = false;
+        /// Flag indicating the class is initialized
+        bool linit_ = false;
+};
+
+//============================================================================//
+
+ThresholdTriggerParameters::ThresholdTriggerParameters()
+{
+    return;
+}
+
+ThresholdTriggerParameters::ThresholdTriggerParameters(
+    const ThresholdTriggerParameters &parameters)
+{
+    *this = parameters;
+    return;
+}
+
+ThresholdTriggerParameters&
+ThresholdTriggerParameters::operator=(
+    const ThresholdTriggerParameters &parameters)
+{
+    if (&parameters == this){return *this;}
+    clear();
+    onThreshold_ = parameters.onThreshold_;
+    offThreshold_ = parameters.offThreshold_;
+    minimumDuration_ = parameters.minimumDuration_;
+    prePadding_ = parameters.prePadding_;
+    postPadding_ = parameters.postPadding_;
+    processingMode_ = parameters.processingMode_;
+    haveThresholds_ = parameters.haveThresholds_;
+    isValid_ = parameters.isValid_;
+    return *this;
+}
+
+ThresholdTriggerParameters::ThresholdTriggerParameters(
+    const double onThreshold, const double offThreshold,
+    const RTSeis::ProcessingMode mode)
+{
+    int ierr = setThresholds(onThreshold, offThreshold);
+    if (ierr != 0)
+    {
+        clear();
+        return;
+    }
+    setProcessingMode(mode);
+    // Validate
+    validate_();
+    return;
+}
+
+ThresholdTriggerParameters::~ThresholdTriggerParameters()
+{
+    clear();
+}
+
+void ThresholdTriggerParameters::clear()
+{
+    onThreshold_ = 0;
+    offThreshold_ = 0;
+    minimumDuration_ = 0;
+    prePadding_ = 0;
+    postPadding_ = 0;
+    processingMode_ = RTSeis::ProcessingMode::POST_PROCESSING;
+    haveThresholds_ = false;
+    isValid_ = false;
+    return;
+}
+
+int ThresholdTriggerParameters::setThresholds(const double onThreshold,
+                                              const double offThreshold)
+{
+    if (offThreshold > onThreshold)
+    {
+        RTSEIS_ERRMSG("Off threshold=%lf cannot exceed on threshold=%lf",
+                      offThreshold, onThreshold);
+        return -1;
+    }
+    onThreshold_ = onThreshold;
+    offThreshold_ = offThreshold;
+    haveThresholds_ = true;
+    validate_();
+    return 0;
+}
+
+double ThresholdTriggerParameters::getOnThreshold() const
+{
+    return onThreshold_;
+}
+
+double ThresholdTriggerParameters::getOffThreshold() const
+{
+    return offThreshold_;
+}
+
+int ThresholdTriggerParameters::setMinimumDuration(const int nSamples)
+{
+    if (nSamples < 0)
+    {
+        RTSEIS_ERRMSG("Minimum duration=%d cannot be negative", nSamples);
+        return -1;
+    }
+    minimumDuration_ = nSamples;
+    validate_();
+    return 0;
+}
+
+int ThresholdTriggerParameters::getMinimumDuration() const
+{
+    return minimumDuration_;
+}
+
+int ThresholdTriggerParameters::setPadding(const int nPre, const int nPost)
+{
+    if (nPre < 0 || nPost < 0)
+    {
+        if (nPre < 0){RTSEIS_ERRMSG("nPre=%d cannot be negative", nPre);}
+        if (nPost < 0){RTSEIS_ERRMSG("nPost=%d cannot be negative", nPost);}
+        return -1;
+    }
+    prePadding_ = nPre;
+    postPadding_ = nPost;
+    validate_();
+    return 0;
+}
+
+int ThresholdTriggerParameters::getPrePadding() const
+{
+    return prePadding_;
+}
+
+int ThresholdTriggerParameters::getPostPadding() const
+{
+    return postPadding_;
+}
+
+void ThresholdTriggerParameters::setProcessingMode(
+    const RTSeis::ProcessingMode mode)
+{
+    processingMode_ = mode;
+    validate_();
+    return;
+}
+
+RTSeis::ProcessingMode ThresholdTriggerParameters::getProcessingMode() const
+{
+    return processingMode_;
+}
+
+bool ThresholdTriggerParameters::isValid() const
+{
+    return isValid_;
+}
+
+void ThresholdTriggerParameters::validate_()
+{
+    isValid_ = false;
+    if (!haveThresholds_){return;}
+    if (offThreshold_ > onThreshold_){return;}
+    if (minimumDuration_ < 0){return;}
+    if (prePadding_ < 0 || postPadding_ < 0){return;}
+    isValid_ = true;
+    return;
+}
+
+//============================================================================//
+//                                 End Parameters                             //
+//============================================================================//
+
+ThresholdTrigger::ThresholdTrigger(void) :
+    pTrigger_(new ThresholdTriggerImpl())
+{
+    clear();
+}
+
+ThresholdTrigger::ThresholdTrigger(const ThresholdTrigger &trigger)
+{
+    *this = trigger;
+}
+
+ThresholdTrigger::~ThresholdTrigger()
+{
+    clear();
+    return;
+}
+
+void ThresholdTrigger::clear()
+{
+    pTrigger_->clear();
+    return;
+}
+
+ThresholdTrigger::ThresholdTrigger(
+    const ThresholdTriggerParameters &parameters) :
+    pTrigger_(new ThresholdTriggerImpl())
+{
+    clear();
+    if (!parameters.isValid())
+    {
+        RTSEIS_ERRMSG("%s", "Parameters are not valid");
+        return;
+    }
+    int ierr = pTrigger_->initialize(parameters.getOnThreshold(),
+                                     parameters.getOffThreshold(),
+                                     parameters.getMinimumDuration(),
+                                     parameters.getPrePadding(),
+                                     parameters.getPostPadding(),
+                                     parameters.getProcessingMode());
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to initialize module");
+        return;
+    }
+    return;
+}
+
+ThresholdTrigger& ThresholdTrigger::operator=(const ThresholdTrigger &trigger)
+{
+    if (&trigger == this){return *this;}
+    if (pTrigger_){pTrigger_->clear();}
+    pTrigger_ = std::unique_ptr<ThresholdTriggerImpl>
+               (new ThresholdTriggerImpl(*trigger.pTrigger_));
+    return *this;
+}
+
+bool ThresholdTrigger::isInitialized() const
+{
+    return pTrigger_->isInitialized();
+}
+
+bool ThresholdTrigger::isTriggered() const
+{
+    return pTrigger_->isTriggered();
+}
+
+int ThresholdTrigger::getNumberOfTriggers() const
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    return static_cast<int> (pTrigger_->getTriggers().size());
+}
+
+int ThresholdTrigger::getTriggers(const int maxTriggers,
+                                  TriggerRecord triggers[]) const
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    const auto &records = pTrigger_->getTriggers();
+    int nTriggers = static_cast<int> (records.size());
+    if (maxTriggers < nTriggers)
+    {
+        RTSEIS_ERRMSG("maxTriggers=%d must be at least %d",
+                      maxTriggers, nTriggers);
+        return -1;
+    }
+    if (nTriggers > 0 && triggers == nullptr)
+    {
+        RTSEIS_ERRMSG("%s", "triggers is NULL");
+        return -1;
+    }
+    std::copy(records.begin(), records.end(), triggers);
+    return 0;
+}
+
+void ThresholdTrigger::clearTriggers()
+{
+    pTrigger_->clearTriggers();
+}
+
+int ThresholdTrigger::resetInitialConditions()
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    pTrigger_->resetInitialConditions();
+    return 0;
+}
+
+int ThresholdTrigger::apply(const int nx, const double cf[])
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    if (nx > 0 && cf == nullptr)
+    {
+        RTSEIS_ERRMSG("%s", "cf is NULL");
+        return -1;
+    }
+    int ierr = pTrigger_->apply(std::max(0, nx), cf);
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to apply trigger");
+        return -1;
+    }
+    return 0;
+}
+
+int ThresholdTrigger::apply(const int nx, const float cf[])
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    if (nx > 0 && cf == nullptr)
+    {
+        RTSEIS_ERRMSG("%s", "cf is NULL");
+        return -1;
+    }
+    int ierr = pTrigger_->apply(std::max(0, nx), cf);
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to apply trigger");
+        return -1;
+    }
+    return 0;
+}
+
+int ThresholdTrigger::begin()
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    pTrigger_->begin();
+    return 0;
+}
+
+int ThresholdTrigger::scan(const int nx, const double cf[])
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    if (nx > 0 && cf == nullptr)
+    {
+        RTSEIS_ERRMSG("%s", "cf is NULL");
+        return -1;
+    }
+    pTrigger_->scan(std::max(0, nx), cf);
+    return 0;
+}
+
+int ThresholdTrigger::scan(const int nx, const float cf[])
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    if (nx > 0 && cf == nullptr)
+    {
+        RTSEIS_ERRMSG("%s", "cf is NULL");
+        return -1;
+    }
+    pTrigger_->scan(std::max(0, nx), cf);
+    return 0;
+}
+
+int ThresholdTrigger::end()
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    pTrigger_->end();
+    return 0;
+}
@@ -0,0 +1,577 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cfloat>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#define RTSEIS_LOGGING 1
+#include "rtseis/log.h"
+#include "rtseis/modules/zDetector.hpp"
+#include "rtseis/modules/thresholdTrigger.hpp"
+#include "rtseis/private/runningSum.hpp"
+
+using namespace RTSeis::Modules;
+using RTSeis::Private::RunningAverage;
+using RTSeis::Private::RunningMoments;
+
+namespace
+{
+/// The Z-detector is passed to a trigger in blocks of this many samples
+constexpr int triggerBlockSize = 256;
+}
+
+class ZDetector::ZDetectorImpl
+{
+    public:
+        /// Releases memory on the module
+        void clear(void)
+        {
+            sta_ = RunningAverage();
+            moments_ = RunningMoments();
+            nWarmUp_ = 0;
+            nWarmUpRemaining_ = 0;
+            mode_ = RTSeis::ProcessingMode::POST_PROCESSING;
+            linit_ = false;
+            return;
+        }
+        //--------------------------------------------------------------------//
+        int initialize(const int nsta, const int nlta,
+                       const RTSeis::ProcessingMode mode)
+        {
+            clear();
+            sta_.initialize(nsta, 0);
+            moments_.initialize(nlta);
+            // The initial conditions are 0 so wait for the windows to fill
+            nWarmUp_ = nsta + nlta - 2;
+            nWarmUpRemaining_ = nWarmUp_;
+            mode_ = mode;
+            linit_ = true;
+            return 0;
+        }
+        /// Determines if the module is initialized
+        bool isInitialized(void) const
+        {
+            return linit_;
+        }
+        /// Gets length of the numerator initial conditons
+        int getNumeratorInitialConditionLength(void) const
+        {
+            return sta_.getInitialConditionLength();
+        }
+        /// Gets length of the denominator initial conditons
+        int getDenominatorInitialConditionLength(void) const
+        {
+            return moments_.getInitialConditionLength();
+        }
+        /// Sets the initial conditions
+        int setInitialConditions(const double zNum[], const double zDen[])
+        {
+            sta_.setInitialConditions(zNum);
+            moments_.setInitialConditions(zDen);
+            // The user has described the signal preceding x
+            nWarmUp_ = 0;
+            nWarmUpRemaining_ = 0;
+            return 0;
+        }
+        /// Resets the initial conditions
+        int resetInitialConditions(void)
+        {
+            sta_.reset();
+            moments_.reset();
+            nWarmUpRemaining_ = nWarmUp_;
+            return 0;
+        }
+        /// Applies the Z-detector
+        template<typename T>
+        int apply(const int nx, const T x[], T y[])
+        {
+            if (nx <= 0){return 0;} // Nothing to do
+            compute(nx, x, y);
+            // Reset the initial conditions for post-processing
+            if (mode_ == RTSeis::ProcessingMode::POST_PROCESSING)
+            {
+                resetInitialConditions();
+            }
+            return 0;
+        }
+        /// Applies the Z-detector and passes it to consume in blocks
+        template<typename T, typename F>
+        int apply(const int nx, const T x[], F consume)
+        {
+            T y[triggerBlockSize];
+            for (int i=0; i<nx; i=i+triggerBlockSize)
+            {
+                auto n = std::min(triggerBlockSize, nx - i);
+                compute(n, &x[i], y);
+                consume(n, y);
+            }
+            // Reset the initial conditions for post-processing
+            if (mode_ == RTSeis::ProcessingMode::POST_PROCESSING)
+            {
+                resetInitialConditions();
+            }
+            return 0;
+        }
+    private:
+        /// Computes the Z-detector
+        template<typename T>
+        void compute(const int nx, const T x[], T y[])
+        {
+            for (int i=0; i<nx; ++i)
+            {
+                auto x2 = static_cast<double> (x[i])*static_cast<double> (x[i]);
+                auto sta = sta_.push(x2);
+                double mean, meanSquare;
+                moments_.push(sta, &mean, &meanSquare);
+                y[i] = 0;
+                if (nWarmUpRemaining_ > 0)
+                {
+                    nWarmUpRemaining_ = nWarmUpRemaining_ - 1;
+                    continue;
+                }
+                // Constant short-term averages have a variance that is
+                // at the level of round-off so force those outputs to 0.
+                auto variance = meanSquare - mean*mean;
+                if (variance > DBL_EPSILON*meanSquare && variance >= DBL_MIN)
+                {
+                    y[i] = static_cast<T> ((sta - mean)/std::sqrt(variance));
+                }
+            }
+        }
+        /// Tabulates the short-term average
+        RunningAverage sta_;
+        /// Tabulates the mean and mean square of the short-term averages
+        /// from one window
+        RunningMoments moments_;
+        /// The number of outputs to zero out while the windows fill
+        int nWarmUp_ = 0;
+        /// The number of outputs remaining to zero out
+        int nWarmUpRemaining_ = 0;
+        /// The processing mode
+        RTSeis::ProcessingMode mode_ = RTSeis::ProcessingMode::POST_PROCESSING;
+        /// Flag indicating the class is initialized
+        bool linit_ = false;
+};
+
+//============================================================================//
+
+ZDetectorParameters::ZDetectorParameters()
+{
+    return;
+}
+
+ZDetectorParameters::ZDetectorParameters(
+    const ZDetectorParameters &parameters)
+{
+    *this = parameters;
+    return;
+}
+
+ZDetectorParameters&
+ZDetectorParameters::operator=(const ZDetectorParameters &parameters)
+{
+    if (&parameters == this){return *this;}
+    clear();
+    precision_ = parameters.precision_;
+    processingMode_ = parameters.processingMode_;
+    nsta_ = parameters.nsta_;
+    nlta_ = parameters.nlta_;
+    isValid_ = parameters.isValid_;
+    return *this;
+}
+
+ZDetectorParameters::ZDetectorParameters(
+    const int nsta, const int nlta,
+    const RTSeis::ProcessingMode mode,
+    const RTSeis::Precision prec)
+{
+    // Set the long-term and short-term parameters
+    int ierr = setShortTermAndLongTermWindowSize(nsta, nlta);
+    if (ierr != 0)
+    {
+        clear();
+        return;
+    }
+    setProcessingMode(mode);
+    precision_ = prec;
+    // Validate
+    validate_();
+    return;
+}
+
+ZDetectorParameters::ZDetectorParameters(
+    const double staWin, const double ltaWin, const double dt,
+    const RTSeis::ProcessingMode mode,
+    const RTSeis::Precision prec)
+{
+    // Check parameters
+    int ierr = setShortTermAndLongTermWindowSize(staWin, ltaWin, dt);
+    if (ierr != 0)
+    {
+        clear();
+        return;
+    }
+    setProcessingMode(mode);
+    precision_ = prec;
+    // Validate
+    validate_();
+    return;
+}
+
+ZDetectorParameters::~ZDetectorParameters()
+{
+    clear();
+}
+
+void ZDetectorParameters::clear()
+{
+    nsta_ = 0;
+    nlta_ = 0;
+    precision_ = defaultPrecision_;
+    processingMode_ = RTSeis::ProcessingMode::POST_PROCESSING;
+    isValid_ = false;
+    return;
+}
+
+int ZDetectorParameters::setShortTermAndLongTermWindowSize(
+    const int nsta, const int nlta)
+{
+    if (nsta < 1)
+    {
+        RTSEIS_ERRMSG("STA window=%d samples must be at least 1", nsta);
+        return -1;
+    }
+    if (nlta <= nsta)
+    {
+        RTSEIS_ERRMSG("LTA window=%d samples must be greater than %d",
+                      nlta, nsta);
+        return -1;
+    }
+    nsta_ = nsta;
+    nlta_ = nlta;
+    validate_();
+    return 0;
+}
+
+int ZDetectorParameters::setShortTermAndLongTermWindowSize(
+    const double staWin, const double ltaWin, const double dt)
+{
+    if (dt <= 0)
+    {
+        RTSEIS_ERRMSG("dt=%lf must be postiive", dt);
+        return -1;
+    }
+    if (staWin < 0)
+    {
+        RTSEIS_ERRMSG("STA window length=%lf (s) must be at least %lf (s) ",
+                      staWin, dt);
+        return -1;
+    }
+    if (ltaWin <= staWin + dt/2)
+    {
+        RTSEIS_ERRMSG("LTA window length=%lf (s) must be at least %lf (s) ",
+                      ltaWin, staWin + dt);
+        return -1;
+    }
+    int nsta = static_cast<int> (staWin/dt + 0.5) + 1;
+    int nlta = static_cast<int> (ltaWin/dt + 0.5) + 1;
+    if (nlta <= nsta)
+    {
+        RTSEIS_ERRMSG("%s", "Algorithmic failure");
+        return -1;
+    }
+    nsta_ = nsta;
+    nlta_ = nlta;
+    validate_();
+    return 0;
+}
+
+int ZDetectorParameters::getLongTermWindowSize() const
+{
+    return nlta_;
+}
+
+int ZDetectorParameters::getShortTermWindowSize() const
+{
+    return nsta_;
+}
+
+void ZDetectorParameters::setProcessingMode(
+    const RTSeis::ProcessingMode mode)
+{
+    processingMode_ = mode;
+    validate_();
+    return;
+}
+
+RTSeis::ProcessingMode ZDetectorParameters::getProcessingMode(void) const
+{
+    return processingMode_;
+}
+
+RTSeis::Precision ZDetectorParameters::getPrecision(void) const
+{
+    return precision_;
+}
+
+bool ZDetectorParameters::isValid() const
+{
+    return isValid_;
+}
+
+void ZDetectorParameters::validate_()
+{
+    isValid_ = false;
+    if (nsta_ < 1){return;}
+    if (nlta_ <= nsta_){return;}
+    if (getPrecision() != RTSeis::Precision::DOUBLE &&
+        getPrecision() != RTSeis::Precision::FLOAT){return;}
+    isValid_ = true;
+    return;
+}
+
+//============================================================================//
+//                                 End Parameters                             //
+//============================================================================//
+
+ZDetector::ZDetector(void) :
+    pZDetector_(new ZDetectorImpl())
+{
+    clear();
+}
+
+ZDetector::ZDetector(const ZDetector &zdetector)
+{
+    *this = zdetector;
+}
+
+ZDetector::~ZDetector()
+{
+    clear();
+    return;
+}
+
+void ZDetector::clear()
+{
+    pZDetector_->clear();
+    return;
+}
+
+ZDetector::ZDetector(const ZDetectorParameters &parameters) :
+    pZDetector_(new ZDetectorImpl())
+{
+    clear();
+    if (!parameters.isValid())
+    {
+        RTSEIS_ERRMSG("%s", "Parameters are not valid");
+        return;
+    }
+    int nsta = parameters.getShortTermWindowSize();
+    int nlta = parameters.getLongTermWindowSize();
+    RTSeis::ProcessingMode mode = parameters.getProcessingMode();
+    int ierr = pZDetector_->initialize(nsta, nlta, mode);
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to initialize module");
+        return;
+    }
+    return;
+}
+
+ZDetector& ZDetector::operator=(const ZDetector &zdetector)
+{
+    if (&zdetector == this){return *this;}
+    if (pZDetector_){pZDetector_->clear();}
+    pZDetector_ = std::unique_ptr<ZDetectorImpl>
+              (new ZDetectorImpl(*zdetector.pZDetector_));
+    return *this;
+}
+
+int ZDetector::setInitialConditions(const int nzNum, const double zNum[],
+                                          const int nzDen, const double zDen[])
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    int nzNumRef = getNumeratorInitialConditionLength();
+    int nzDenRef = getDenominatorInitialConditionLength();
+    if (nzNumRef != nzNum)
+    {
+        RTSEIS_ERRMSG("nzNum=%d must equal %d", nzNum, nzNumRef);
+        return -1;
+    }
+    if (nzDenRef != nzDen)
+    {
+        RTSEIS_ERRMSG("nzDen=%d must equal %d", nzDen, nzDenRef);
+        return -1;
+    }
+    if (nzNum > 0 && zNum == nullptr)
+    {
+        RTSEIS_ERRMSG("%s", "zNum is NULL");
+        return -1;
+    }
+    if (nzDen > 0 && zDen == nullptr)
+    {
+        RTSEIS_ERRMSG("%s", "zDen is NULL");
+        return -1;
+    }
+    int ierr = pZDetector_->setInitialConditions(zNum, zDen);
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to set initial conditions");
+        return -1;
+    }
+    return 0;
+}
+
+int ZDetector::resetInitialConditions()
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    pZDetector_->resetInitialConditions();
+    return 0;
+}
+
+int ZDetector::getNumeratorInitialConditionLength() const
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    return pZDetector_->getNumeratorInitialConditionLength();
+}
+
+int ZDetector::getDenominatorInitialConditionLength() const
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    return pZDetector_->getDenominatorInitialConditionLength();
+}
+
+bool ZDetector::isInitialized() const
+{
+    return pZDetector_->isInitialized();
+}
+
+int ZDetector::apply(const int nx, const double x[], double y[])
+{
+    if (nx <= 0){return 0;} // Nothing to do
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    if (x == nullptr || y == nullptr)
+    {
+        if (x == nullptr){RTSEIS_ERRMSG("%s", "x is NULL");}
+        if (y == nullptr){RTSEIS_ERRMSG("%s", "y is NULL");}
+        return -1;
+    }
+    int ierr = pZDetector_->apply(nx, x, y);
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to apply Z-detector");
+        return -1;
+    }
+    return 0;
+}
+
+int ZDetector::apply(const int nx, const float x[], float y[])
+{
+    if (nx <= 0){return 0;} // Nothing to do
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    if (x == nullptr || y == nullptr)
+    {
+        if (x == nullptr){RTSEIS_ERRMSG("%s", "x is NULL");}
+        if (y == nullptr){RTSEIS_ERRMSG("%s", "y is NULL");}
+        return -1;
+    }
+    int ierr = pZDetector_->apply(nx, x, y);
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to apply Z-detector");
+        return -1;
+    }
+    return 0;
+}
+
+int ZDetector::apply(const int nx, const double x[],
+                     ThresholdTrigger *trigger)
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    if ((nx > 0 && x == nullptr) || trigger == nullptr)
+    {
+        if (x == nullptr){RTSEIS_ERRMSG("%s", "x is NULL");}
+        if (trigger == nullptr){RTSEIS_ERRMSG("%s", "trigger is NULL");}
+        return -1;
+    }
+    if (!trigger->isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Trigger not initialized");
+        return -1;
+    }
+    trigger->begin();
+    int ierr = pZDetector_->apply(std::max(0, nx), x,
+                                  [trigger](const int n, const double y[])
+                                  {
+                                      trigger->scan(n, y);
+                                  });
+    trigger->end();
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to apply filter");
+        return -1;
+    }
+    return 0;
+}
+
+int ZDetector::apply(const int nx, const float x[],
+                     ThresholdTrigger *trigger)
+{
+    if (!isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Module not initialized");
+        return -1;
+    }
+    if ((nx > 0 && x == nullptr) || trigger == nullptr)
+    {
+        if (x == nullptr){RTSEIS_ERRMSG("%s", "x is NULL");}
+        if (trigger == nullptr){RTSEIS_ERRMSG("%s", "trigger is NULL");}
+        return -1;
+    }
+    if (!trigger->isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Trigger not initialized");
+        return -1;
+    }
+    trigger->begin();
+    int ierr = pZDetector_->apply(std::max(0, nx), x,
+                                  [trigger](const int n, const float y[])
+                                  {
+                                      trigger->scan(n, y);
+                                  });
+    trigger->end();
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to apply filter");
+        return -1;
+    }
+    return 0;
+}
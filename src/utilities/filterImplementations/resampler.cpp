@@ -0,0 +1,226 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include "rtseis/enums.h"
+#include "rtseis/private/throw.hpp"
+#include "rtseis/utilities/filterImplementations/resampler.hpp"
+#include "rtseis/utilities/interpolation/sincInterpolator.hpp"
+
+using namespace RTSeis::Utilities::FilterImplementations;
+using namespace RTSeis::Utilities::Interpolation;
+
+namespace
+{
+/// The relative change in the cutoff below which the kernel is not
+/// tabulated again.  This is well inside the kernel's transition band.
+constexpr double cutoffTolerance = 1.e-3;
+}
+
+template<class T>
+class Resampler<T>::ResamplerImpl
+{
+public:
+    /// Counts the output samples start + k*step, k = 0,1,..., that are
+    /// less than end (or no greater than end if inclusive).
+    int countOutputs(const double start, const double end,
+                     const bool inclusive) const
+    {
+        auto inRange = [=](const double t)
+        {
+            return inclusive ? t <= end : t < end;
+        };
+        if (!inRange(start)){return 0;}
+        auto n = static_cast<int> ((end - start)/mStep) + 1;
+        while (n > 0 && !inRange(start + (n - 1)*mStep)){n = n - 1;}
+        while (inRange(start + n*mStep)){n = n + 1;}
+        return n;
+    }
+    /// Counts the output samples that x completes
+    int countOutputs(const int nx) const
+    {
+        if (mMode == RTSeis::ProcessingMode::POST_PROCESSING)
+        {
+            if (nx < 1){return 0;}
+            return countOutputs(0, nx - 1, true);
+        }
+        return countOutputs(mPosition, nx - mHalfWidth, false);
+    }
+//private:
+    SincInterpolator<T> mInterpolator;
+    /// The ratio of the output to input sampling rates
+    double mRatio = 1;
+    /// The spacing of the output samples in input samples
+    double mStep = 1;
+    /// The position of the next output sample relative to the first
+    /// sample of the next packet
+    double mPosition = 0;
+    RTSeis::ProcessingMode mMode = RTSeis::ProcessingMode::POST_PROCESSING;
+    int mHalfWidth = 0;
+    bool mInitialized = false;
+};
+
+/// Constructors
+template<class T>
+Resampler<T>::Resampler() :
+    pImpl(std::make_unique<ResamplerImpl> ())
+{
+}
+
+template<class T>
+Resampler<T>::Resampler(const Resampler &resampler)
+{
+    *this = resampler;
+}
+
+template<class T>
+Resampler<T>::Resampler(Resampler &&resampler) noexcept
+{
+    *this = std::move(resampler);
+}
+
+/// Operators
+template<class T>
+Resampler<T>& Resampler<T>::operator=(const Resampler &resampler)
+{
+    if (&resampler == this){return *this;}
+    pImpl = std::make_unique<ResamplerImpl> (*resampler.pImpl);
+    return *this;
+}
+
+template<class T>
+Resampler<T>& Resampler<T>::operator=(Resampler &&resampler) noexcept
+{
+    if (&resampler == this){return *this;}
+    pImpl = std::move(resampler.pImpl);
+    return *this;
+}
+
+/// Destructors
+template<class T>
+Resampler<T>::~Resampler() = default;
+
+template<class T>
+void Resampler<T>::clear() noexcept
+{
+    pImpl = std::make_unique<ResamplerImpl> ();
+}
+
+/// Initialization
+template<class T>
+void Resampler<T>::initialize(const double ratio,
+                              const RTSeis::ProcessingMode mode,
+                              const int halfWidth,
+                              const SincWindowType window)
+{
+    clear();
+    if (ratio <= 0)
+    {
+        RTSEIS_THROW_IA("ratio = %lf must be positive", ratio);
+    }
+    if (halfWidth < 1)
+    {
+        RTSEIS_THROW_IA("halfWidth = %d must be positive", halfWidth);
+    }
+    // Lower the cutoff to the output Nyquist frequency when downsampling
+    // and widen the kernel so that it spans halfWidth sinc lobes
+    auto cutoff = std::min(1.0, ratio);
+    auto kernelHalfWidth = std::ceil(halfWidth/cutoff);
+    if (kernelHalfWidth > std::numeric_limits<int>::max()/2)
+    {
+        RTSEIS_THROW_IA("ratio = %lf is too small for halfWidth = %d",
+                        ratio, halfWidth);
+    }
+    pImpl->mInterpolator.initialize(static_cast<int> (kernelHalfWidth),
+                                    window, cutoff, mode);
+    pImpl->mRatio = ratio;
+    pImpl->mStep = 1/ratio;
+    pImpl->mPosition = 0;
+    pImpl->mMode = mode;
+    pImpl->mHalfWidth = pImpl->mInterpolator.getHalfWidth();
+    pImpl->mInitialized = true;
+}
+
+template<class T>
+bool Resampler<T>::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+template<class T>
+void Resampler<T>::setRatio(const double ratio)
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    if (ratio <= 0)
+    {
+        RTSEIS_THROW_IA("ratio = %lf must be positive", ratio);
+    }
+    // Track the output Nyquist frequency.  Small drifts do not warrant
+    // tabulating the kernel again.
+    auto cutoff = std::min(1.0, ratio);
+    auto currentCutoff = pImpl->mInterpolator.getCutoff();
+    if (std::abs(cutoff - currentCutoff) > cutoffTolerance*currentCutoff)
+    {
+        pImpl->mInterpolator.setCutoff(cutoff);
+    }
+    pImpl->mRatio = ratio;
+    pImpl->mStep = 1/ratio;
+}
+
+template<class T>
+double Resampler<T>::getRatio() const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    return pImpl->mRatio;
+}
+
+template<class T>
+int Resampler<T>::estimateSpace(const int n) const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    if (n < 0){RTSEIS_THROW_IA("n = %d cannot be negative", n);}
+    return pImpl->countOutputs(n);
+}
+
+template<class T>
+void Resampler<T>::resetInitialConditions()
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    pImpl->mInterpolator.resetInitialConditions();
+    pImpl->mPosition = 0;
+}
+
+/// Resampling
+template<class T>
+void Resampler<T>::apply(const int nx, const T x[],
+                         const int ny, int *nyOut, T *y[])
+{
+    *nyOut = 0;
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    if (nx <= 0){return;} // Nothing to do
+    if (x == nullptr){RTSEIS_THROW_IA("%s", "x is NULL");}
+    auto nq = pImpl->countOutputs(nx);
+    if (ny < nq)
+    {
+        RTSEIS_THROW_IA("ny = %d must be at least %d", ny, nq);
+    }
+    if (nq > 0 && *y == nullptr){RTSEIS_THROW_IA("%s", "y is NULL");}
+    auto start = 0.0;
+    if (pImpl->mMode == RTSeis::ProcessingMode::REAL_TIME)
+    {
+        start = pImpl->mPosition;
+    }
+    // In real-time mode this retains x even when nothing is output
+    pImpl->mInterpolator.interpolate(nx, x, nq, start, pImpl->mStep, y);
+    if (pImpl->mMode == RTSeis::ProcessingMode::REAL_TIME)
+    {
+        pImpl->mPosition = start + nq*pImpl->mStep - nx;
+    }
+    *nyOut = nq;
+}
+
+/// Template instantiation
+template class RTSeis::Utilities::FilterImplementations::Resampler<double>;
+template class RTSeis::Utilities::FilterImplementations::Resampler<float>;
@@ -0,0 +1,373 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include "rtseis/private/throw.hpp"
+#include "rtseis/utilities/interpolation/sincInterpolator.hpp"
+
+using namespace RTSeis::Utilities::Interpolation;
+
+namespace
+{
+/// Batches with fewer points than this are not worth threading
+constexpr int minParallelPoints = 2048;
+
+double sinc(const double x)
+{
+    if (x == 0){return 1;}
+    return std::sin(M_PI*x)/(M_PI*x);
+}
+
+/// Tabulates the 2*halfWidth kernel coefficients for the fractional
+/// positions p/oversamplingFactor, p = 0,...,oversamplingFactor.  The
+/// table is row major [oversamplingFactor + 1 x 2*halfWidth] and the j'th
+/// coefficient multiplies the sample floor(t) - halfWidth + 1 + j.
+template<typename T>
+void tabulateKernel(const int halfWidth, const SincWindowType window,
+                    const double cutoff, const int oversamplingFactor,
+                    const double beta, std::vector<T> *table)
+{
+    auto nTaps = 2*halfWidth;
+    auto i0beta = std::cyl_bessel_i(0.0, beta);
+    table->resize(static_cast<size_t> (oversamplingFactor + 1)*nTaps);
+    std::vector<double> c(nTaps);
+    for (int p=0; p<=oversamplingFactor; ++p)
+    {
+        auto fraction = static_cast<double> (p)/oversamplingFactor;
+        double sum = 0;
+        for (int j=0; j<nTaps; ++j)
+        {
+            auto u = fraction - (j - halfWidth + 1);
+            auto r = u/halfWidth;
+            c[j] = 0;
+            if (std::abs(r) < 1)
+            {
+                double w = 1;
+                if (window == SincWindowType::LANCZOS)
+                {
+                    w = sinc(r);
+                }
+                else
+                {
+                    w = std::cyl_bessel_i(0.0, beta*std::sqrt(1 - r*r))
+                       /i0beta;
+                }
+                c[j] = cutoff*sinc(cutoff*u)*w;
+            }
+            sum = sum + c[j];
+        }
+        // Unit gain at zero frequency
+        T *row = &(*table)[static_cast<size_t> (p)*nTaps];
+        for (int j=0; j<nTaps; ++j){row[j] = static_cast<T> (c[j]/sum);}
+    }
+}
+
+}
+
+template<class T>
+class SincInterpolator<T>::SincInterpolatorImpl
+{
+public:
+    /// Evaluates the signal at t where the samples floor(t) - halfWidth + 1
+    /// through floor(t) + halfWidth are in x.
+    T evaluate(const T x[], const double t) const
+    {
+        auto i0 = static_cast<int> (std::floor(t));
+        auto position = (t - i0)*mOversamplingFactor;
+        auto p = std::min(static_cast<int> (position),
+                          mOversamplingFactor - 1);
+        auto alpha = static_cast<T> (position - p);
+        const T *c0 = &mTable[static_cast<size_t> (p)*mTaps];
+        const T *c1 = c0 + mTaps;
+        const T *xp = &x[i0 - mHalfWidth + 1];
+        T s0 = 0;
+        T s1 = 0;
+        #pragma omp simd reduction(+:s0, s1)
+        for (int j=0; j<mTaps; ++j)
+        {
+            s0 = s0 + c0[j]*xp[j];
+            s1 = s1 + c1[j]*xp[j];
+        }
+        return s0 + alpha*(s1 - s0);
+    }
+    /// Evaluates the signal at t where samples outside of [0, nx-1] are
+    /// zero.
+    T evaluateZeroExtended(const int nx, const T x[], const double t) const
+    {
+        if (!(t >= -mHalfWidth && t < nx + mHalfWidth)){return 0;}
+        auto i0 = static_cast<int> (std::floor(t));
+        auto i1 = i0 - mHalfWidth + 1;
+        if (i1 >= 0 && i0 + mHalfWidth < nx){return evaluate(x, t);}
+        auto position = (t - i0)*mOversamplingFactor;
+        auto p = std::min(static_cast<int> (position),
+                          mOversamplingFactor - 1);
+        auto alpha = static_cast<T> (position - p);
+        const T *c0 = &mTable[static_cast<size_t> (p)*mTaps];
+        const T *c1 = c0 + mTaps;
+        auto jStart = std::max(0, -i1);
+        auto jEnd = std::min(mTaps, nx - i1);
+        T s0 = 0;
+        T s1 = 0;
+        for (int j=jStart; j<jEnd; ++j)
+        {
+            s0 = s0 + c0[j]*x[i1 + j];
+            s1 = s1 + c1[j]*x[i1 + j];
+        }
+        return s0 + alpha*(s1 - s0);
+    }
+    /// Evaluates the signal at the points given by getPoint(i),
+    /// i = 0,...,nq-1.
+    template<typename F>
+    void apply(const int nx, const T x[], const int nq, F getPoint, T yq[])
+    {
+        if (mMode == RTSeis::ProcessingMode::POST_PROCESSING)
+        {
+            if (nq < 1){return;}
+            #pragma omp parallel for if (nq >= minParallelPoints)
+            for (int i=0; i<nq; ++i)
+            {
+                yq[i] = evaluateZeroExtended(nx, x, getPoint(i));
+            }
+            return;
+        }
+        // Points must be supported by the retained samples and x
+        for (int i=0; i<nq; ++i)
+        {
+            auto t = getPoint(i);
+            if (!(t >= -mHalfWidth && t < nx - mHalfWidth))
+            {
+                RTSEIS_THROW_IA("Point %d = %lf must be in range [%d,%d)",
+                                i, t, -mHalfWidth, nx - mHalfWidth);
+            }
+        }
+        auto nHistory = static_cast<int> (mHistory.size());
+        mWork.resize(nHistory + std::max(0, nx));
+        std::copy(mHistory.begin(), mHistory.end(), mWork.begin());
+        if (nx > 0){std::copy(x, x + nx, mWork.begin() + nHistory);}
+        if (nq > 0)
+        {
+            const T *work = mWork.data();
+            #pragma omp parallel for if (nq >= minParallelPoints)
+            for (int i=0; i<nq; ++i)
+            {
+                yq[i] = evaluate(work, getPoint(i) + nHistory);
+            }
+        }
+        std::copy(mWork.end() - nHistory, mWork.end(), mHistory.begin());
+    }
+//private:
+    /// The tabulated kernels stored [mOversamplingFactor + 1 x mTaps]
+    std::vector<T> mTable;
+    /// The samples retained from the previous packets
+    std::vector<T> mHistory;
+    /// The initial conditions
+    std::vector<T> mInitialConditions;
+    /// The retained samples followed by the current packet
+    std::vector<T> mWork;
+    RTSeis::ProcessingMode mMode = RTSeis::ProcessingMode::POST_PROCESSING;
+    SincWindowType mWindow = SincWindowType::KAISER;
+    double mCutoff = 1;
+    double mKaiserBeta = 8;
+    int mHalfWidth = 0;
+    int mTaps = 0;
+    int mOversamplingFactor = 0;
+    bool mInitialized = false;
+};
+
+/// Constructors
+template<class T>
+SincInterpolator<T>::SincInterpolator() :
+    pImpl(std::make_unique<SincInterpolatorImpl> ())
+{
+}
+
+template<class T>
+SincInterpolator<T>::SincInterpolator(const SincInterpolator &interpolator)
+{
+    *this = interpolator;
+}
+
+template<class T>
+SincInterpolator<T>::SincInterpolator(SincInterpolator &&interpolator) noexcept
+{
+    *this = std::move(interpolator);
+}
+
+/// Operators
+template<class T>
+SincInterpolator<T>&
+SincInterpolator<T>::operator=(const SincInterpolator &interpolator)
+{
+    if (&interpolator == this){return *this;}
+    pImpl = std::make_unique<SincInterpolatorImpl> (*interpolator.pImpl);
+    return *this;
+}
+
+template<class T>
+SincInterpolator<T>&
+SincInterpolator<T>::operator=(SincInterpolator &&interpolator) noexcept
+{
+    if (&interpolator == this){return *this;}
+    pImpl = std::move(interpolator.pImpl);
+    return *this;
+}
+
+/// Destructors
+template<class T>
+SincInterpolator<T>::~SincInterpolator() = default;
+
+template<class T>
+void SincInterpolator<T>::clear() noexcept
+{
+    pImpl = std::make_unique<SincInterpolatorImpl> ();
+}
+
+/// Initialization
+template<class T>
+void SincInterpolator<T>::initialize(const int halfWidth,
+                                     const SincWindowType window,
+                                     const double cutoff,
+                                     const RTSeis::ProcessingMode mode,
+                                     const int oversamplingFactor,
+                                     const double kaiserBeta)
+{
+    clear();
+    if (halfWidth < 1)
+    {
+        RTSEIS_THROW_IA("halfWidth = %d must be positive", halfWidth);
+    }
+    if (cutoff <= 0 || cutoff > 1)
+    {
+        RTSEIS_THROW_IA("cutoff = %lf must be in range (0,1]", cutoff);
+    }
+    if (oversamplingFactor < 1)
+    {
+        RTSEIS_THROW_IA("oversamplingFactor = %d must be positive",
+                        oversamplingFactor);
+    }
+    if (kaiserBeta < 0)
+    {
+        RTSEIS_THROW_IA("kaiserBeta = %lf cannot be negative", kaiserBeta);
+    }
+    tabulateKernel(halfWidth, window, cutoff, oversamplingFactor,
+                   kaiserBeta, &pImpl->mTable);
+    pImpl->mWindow = window;
+    pImpl->mCutoff = cutoff;
+    pImpl->mKaiserBeta = kaiserBeta;
+    pImpl->mHalfWidth = halfWidth;
+    pImpl->mTaps = 2*halfWidth;
+    pImpl->mOversamplingFactor = oversamplingFactor;
+    pImpl->mMode = mode;
+    pImpl->mInitialConditions.resize(pImpl->mTaps, 0);
+    pImpl->mHistory.resize(pImpl->mTaps, 0);
+    pImpl->mInitialized = true;
+}
+
+template<class T>
+bool SincInterpolator<T>::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+template<class T>
+int SincInterpolator<T>::getHalfWidth() const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    return pImpl->mHalfWidth;
+}
+
+template<class T>
+void SincInterpolator<T>::setCutoff(const double cutoff)
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    if (cutoff <= 0 || cutoff > 1)
+    {
+        RTSEIS_THROW_IA("cutoff = %lf must be in range (0,1]", cutoff);
+    }
+    if (cutoff == pImpl->mCutoff){return;}
+    tabulateKernel(pImpl->mHalfWidth, pImpl->mWindow, cutoff,
+                   pImpl->mOversamplingFactor, pImpl->mKaiserBeta,
+                   &pImpl->mTable);
+    pImpl->mCutoff = cutoff;
+}
+
+template<class T>
+double SincInterpolator<T>::getCutoff() const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    return pImpl->mCutoff;
+}
+
+/// Initial conditions
+template<class T>
+int SincInterpolator<T>::getInitialConditionLength() const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    return pImpl->mTaps;
+}
+
+template<class T>
+void SincInterpolator<T>::setInitialConditions(const int nz,
+                                               const double zi[])
+{
+    auto nzRef = getInitialConditionLength(); // Throws
+    if (nz != nzRef)
+    {
+        RTSEIS_THROW_IA("nz = %d must equal %d", nz, nzRef);
+    }
+    if (zi == nullptr){RTSEIS_THROW_IA("%s", "zi is NULL");}
+    for (int i=0; i<nz; ++i)
+    {
+        pImpl->mInitialConditions[i] = static_cast<T> (zi[i]);
+    }
+    resetInitialConditions();
+}
+
+template<class T>
+void SincInterpolator<T>::resetInitialConditions()
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    pImpl->mHistory = pImpl->mInitialConditions;
+}
+
+/// Interpolation
+template<class T>
+void SincInterpolator<T>::interpolate(const int nx, const T x[],
+                                      const int nq, const double xq[],
+                                      T *yqIn[])
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    if (nx > 0 && x == nullptr){RTSEIS_THROW_IA("%s", "x is NULL");}
+    T *yq = nullptr;
+    if (nq > 0)
+    {
+        if (xq == nullptr){RTSEIS_THROW_IA("%s", "xq is NULL");}
+        yq = *yqIn;
+        if (yq == nullptr){RTSEIS_THROW_IA("%s", "yq is NULL");}
+    }
+    pImpl->apply(std::max(0, nx), x, nq,
+                 [xq](const int i){return xq[i];}, yq);
+}
+
+template<class T>
+void SincInterpolator<T>::interpolate(const int nx, const T x[],
+                                      const int nq, const double start,
+                                      const double step, T *yqIn[])
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    if (nx > 0 && x == nullptr){RTSEIS_THROW_IA("%s", "x is NULL");}
+    if (step <= 0){RTSEIS_THROW_IA("step = %lf must be positive", step);}
+    T *yq = nullptr;
+    if (nq > 0)
+    {
+        yq = *yqIn;
+        if (yq == nullptr){RTSEIS_THROW_IA("%s", "yq is NULL");}
+    }
+    pImpl->apply(std::max(0, nx), x, nq,
+                 [start, step](const int i){return start + i*step;}, yq);
+}
+
+/// Template instantiation
+template class RTSeis::Utilities::Interpolation::SincInterpolator<double>;
+template class RTSeis::Utilities::Interpolation::SincInterpolator<float>;
@@ -376,17 +376,10 @@ std::pair<int,int> computeTrimIndices(const Convolve::Mode mode,
     // Valid
     else if (mode == Convolve::Mode::VALID)
     {
+        // The first lag at which the shorter signal is fully overlapped
         lc = std::max(n1,n2) - std::min(n1,n2) + 1;
-        if (n2 > n1)
-        {
-            nLeft = n1/2 + 1;
-            nRight = nLeft + lc; 
-        }
-        else
-        {
-            nLeft = n2/2 + 1;
-            nRight = nLeft + lc; 
-        }
+        nLeft = std::min(n1, n2) - 1;
+        nRight = nLeft + lc;
     }
     // Same
     else if (mode == Convolve::Mode::SAME)
@@ -0,0 +1,207 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <cfloat>
+#include <vector>
+#include <algorithm>
+#include "rtseis/private/throw.hpp"
+#include "rtseis/private/runningSum.hpp"
+#include "rtseis/utilities/math/normalizedCrossCorrelation.hpp"
+
+using namespace RTSeis::Utilities::Math::Convolve;
+
+class NormalizedCrossCorrelation::NormalizedCrossCorrelationImpl
+{
+public:
+    /// Fills the delay line with the initial conditions and primes the
+    /// running sums with their squares.  The oldest slot of each window
+    /// is evicted by the first sample and does not contribute.
+    void reset()
+    {
+        auto nz = static_cast<int> (mInitialConditions.size());
+        std::copy(mInitialConditions.begin(), mInitialConditions.end(),
+                  mSignal.begin());
+        mReference.setWindow(nz, mSquaredInitialConditions.data());
+        mEnergy.setWindow(nz, mSquaredInitialConditions.data());
+    }
+    /// Sets the initial conditions and their squares
+    void setInitialConditions(const int nz, const double zi[])
+    {
+        mInitialConditions.assign(zi, zi + nz);
+        mSquaredInitialConditions.resize(nz);
+        for (int i=0; i<nz; ++i){mSquaredInitialConditions[i] = zi[i]*zi[i];}
+    }
+//private:
+    /// The unit-norm template
+    std::vector<double> mTemplate;
+    /// The initial conditions
+    std::vector<double> mInitialConditions;
+    /// The squared initial conditions which prime the running sums
+    std::vector<double> mSquaredInitialConditions;
+    /// The delay line followed by the signal
+    std::vector<double> mSignal;
+    /// The valid correlation of mSignal with the template
+    std::vector<double> mCorrelation;
+    /// The energy in the window ending at the current sample
+    RTSeis::Private::RunningSum mEnergy;
+    /// The energy of the last 2m samples for the near-zero energy guard
+    RTSeis::Private::RunningSum mReference;
+    RTSeis::ProcessingMode mMode = RTSeis::ProcessingMode::POST_PROCESSING;
+    Implementation mImplementation = Implementation::AUTO;
+    int mTemplateLength = 0;
+    bool mInitialized = false;
+};
+
+/// Constructors
+NormalizedCrossCorrelation::NormalizedCrossCorrelation() :
+    pImpl(std::make_unique<NormalizedCrossCorrelationImpl> ())
+{
+}
+
+NormalizedCrossCorrelation::NormalizedCrossCorrelation(
+    const NormalizedCrossCorrelation &ncc)
+{
+    *this = ncc;
+}
+
+NormalizedCrossCorrelation::NormalizedCrossCorrelation(
+    NormalizedCrossCorrelation &&ncc) noexcept
+{
+    *this = std::move(ncc);
+}
+
+/// Operators
+NormalizedCrossCorrelation& NormalizedCrossCorrelation::operator=(
+    const NormalizedCrossCorrelation &ncc)
+{
+    if (&ncc == this){return *this;}
+    pImpl = std::make_unique<NormalizedCrossCorrelationImpl> (*ncc.pImpl);
+    return *this;
+}
+
+NormalizedCrossCorrelation& NormalizedCrossCorrelation::operator=(
+    NormalizedCrossCorrelation &&ncc) noexcept
+{
+    if (&ncc == this){return *this;}
+    pImpl = std::move(ncc.pImpl);
+    return *this;
+}
+
+/// Destructors
+NormalizedCrossCorrelation::~NormalizedCrossCorrelation() = default;
+
+void NormalizedCrossCorrelation::clear() noexcept
+{
+    pImpl = std::make_unique<NormalizedCrossCorrelationImpl> ();
+}
+
+/// Initialization
+void NormalizedCrossCorrelation::initialize(
+    const int nt, const double t[],
+    const RTSeis::ProcessingMode mode,
+    const Implementation implementation)
+{
+    clear();
+    if (nt < 1){RTSEIS_THROW_IA("nt = %d must be positive", nt);}
+    if (t == nullptr){RTSEIS_THROW_IA("%s", "t is NULL");}
+    double norm2 = 0;
+    for (int i=0; i<nt; ++i){norm2 = norm2 + t[i]*t[i];}
+    if (norm2 <= 0){RTSEIS_THROW_IA("%s", "t cannot be all zeros");}
+    auto xnorm = 1.0/std::sqrt(norm2);
+    pImpl->mTemplate.resize(nt);
+    for (int i=0; i<nt; ++i){pImpl->mTemplate[i] = t[i]*xnorm;}
+    pImpl->mInitialConditions.assign(nt - 1, 0);
+    pImpl->mSquaredInitialConditions.assign(nt - 1, 0);
+    pImpl->mSignal.resize(nt - 1);
+    pImpl->mEnergy.initialize(nt);
+    pImpl->mReference.initialize(2*nt);
+    pImpl->mMode = mode;
+    pImpl->mImplementation = implementation;
+    pImpl->mTemplateLength = nt;
+    pImpl->reset();
+    pImpl->mInitialized = true;
+}
+
+bool NormalizedCrossCorrelation::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+int NormalizedCrossCorrelation::getTemplateLength() const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    return pImpl->mTemplateLength;
+}
+
+int NormalizedCrossCorrelation::getInitialConditionLength() const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    return pImpl->mTemplateLength - 1;
+}
+
+void NormalizedCrossCorrelation::setInitialConditions(const int nz,
+                                                      const double zi[])
+{
+    auto nzRef = getInitialConditionLength(); // Throws
+    if (nz != nzRef){RTSEIS_THROW_IA("nz = %d must equal %d", nz, nzRef);}
+    if (nz > 0 && zi == nullptr){RTSEIS_THROW_IA("%s", "zi is NULL");}
+    pImpl->setInitialConditions(nz, zi);
+    pImpl->reset();
+}
+
+void NormalizedCrossCorrelation::resetInitialConditions()
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    pImpl->reset();
+}
+
+/// Application
+void NormalizedCrossCorrelation::apply(const int n, const double x[],
+                                       double *yIn[])
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    if (n <= 0){return;} // Nothing to do
+    double *y = *yIn;
+    if (x == nullptr || y == nullptr)
+    {
+        if (x == nullptr){RTSEIS_THROW_IA("%s", "x is NULL");}
+        RTSEIS_THROW_IA("%s", "y is NULL");
+    }
+    if (pImpl->mMode == RTSeis::ProcessingMode::POST_PROCESSING)
+    {
+        pImpl->reset();
+    }
+    // Correlate the template with the delay line followed by the signal.
+    // The valid correlation's k'th lag is the window ending at x[k].
+    auto m = pImpl->mTemplateLength;
+    auto nz = m - 1;
+    auto ns = nz + n;
+    pImpl->mSignal.resize(ns);
+    std::copy(x, x + n, pImpl->mSignal.begin() + nz);
+    auto nc = computeConvolutionLength(ns, m, Mode::VALID);
+    pImpl->mCorrelation.resize(nc);
+    auto cPtr = pImpl->mCorrelation.data();
+    int ncOut = 0;
+    correlate(ns, pImpl->mSignal.data(), m, pImpl->mTemplate.data(),
+              nc, &ncOut, &cPtr, Mode::VALID, pImpl->mImplementation);
+    // Normalize by the window norms
+    for (int k=0; k<n; ++k)
+    {
+        auto x2 = x[k]*x[k];
+        pImpl->mEnergy.push(x2);
+        pImpl->mReference.push(x2);
+        auto energy = pImpl->mEnergy.getSum();
+        auto tolerance = std::max(DBL_MIN,
+                                  DBL_EPSILON*pImpl->mReference.getSum());
+        y[k] = 0;
+        if (energy > tolerance)
+        {
+            auto ncc = pImpl->mCorrelation[k]/std::sqrt(energy);
+            y[k] = std::min(1.0, std::max(-1.0, ncc));
+        }
+    }
+    // Save the last m - 1 samples for the next packet
+    std::copy(pImpl->mSignal.end() - nz, pImpl->mSignal.end(),
+              pImpl->mSignal.begin());
+    pImpl->mSignal.resize(nz);
+}
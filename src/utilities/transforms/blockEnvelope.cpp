@@ -0,0 +1,378 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <complex>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "rtseis/private/throw.hpp"
+#include "rtseis/utilities/transforms/blockEnvelope.hpp"
+#include "rtseis/utilities/transforms/hilbert.hpp"
+#include "rtseis/utilities/transforms/utilities.hpp"
+
+using namespace RTSeis::Utilities::Transforms;
+
+template<class T>
+class BlockEnvelope<T>::BlockEnvelopeImpl
+{
+public:
+    /// Computes the upper envelope of the demeaned signal for blocks
+    /// [blockStart, blockEnd).  Each thread requires its own Hilbert
+    /// transformer and workspace.
+    void transformBlocks(const int n, const T x[], const T mean,
+                         const int blockStart, const int blockEnd,
+                         Hilbert<T> &hilbert,
+                         std::vector<T> &work,
+                         std::vector<std::complex<T>> &analytic,
+                         T y[]) const
+    {
+        auto workPtr = work.data();
+        auto analyticPtr = analytic.data();
+        for (int block=blockStart; block<blockEnd; ++block)
+        {
+            auto i1 = block*mBlockSize;
+            auto i2 = std::min(n, i1 + mBlockSize);
+            // Gather the window and zero-pad beyond the record
+            auto windowStart = i1 - mOverlap;
+            #pragma omp simd
+            for (int i=0; i<mTransformLength; ++i)
+            {
+                auto j = windowStart + i;
+                workPtr[i] = 0;
+                if (j >= 0 && j < n){workPtr[i] = (x[j] - mean)*mTaper[i];}
+            }
+            hilbert.transform(mTransformLength, workPtr, &analyticPtr);
+            #pragma omp simd
+            for (int i=i1; i<i2; ++i)
+            {
+                y[i] = std::abs(analyticPtr[i - windowStart]) + mean;
+            }
+        }
+    }
+    /// Computes the upper envelope of the nOut stream samples beginning
+    /// at sample i1.  Only stream samples in [mStreamStart, validEnd)
+    /// are known; the rest of the window is zero-padded.
+    void transformStreamBlock(const int64_t i1, const int nOut,
+                              const int64_t validEnd, T y[])
+    {
+        auto windowStart = i1 - mOverlap;
+        auto j1 = std::max(windowStart, mStreamStart);
+        auto j2 = std::min(windowStart + mTransformLength, validEnd);
+        double sum = 0;
+        for (auto j=j1; j<j2; ++j){sum = sum + mStream[j - mStreamStart];}
+        T mean = 0;
+        if (j2 > j1){mean = static_cast<T> (sum/static_cast<double> (j2 - j1));}
+        std::fill(mStreamWork.begin(), mStreamWork.end(), 0);
+        for (auto j=j1; j<j2; ++j)
+        {
+            auto i = j - windowStart;
+            mStreamWork[i] = (mStream[j - mStreamStart] - mean)*mTaper[i];
+        }
+        auto workPtr = mStreamWork.data();
+        auto analyticPtr = mStreamAnalytic.data();
+        mHilbert.transform(mTransformLength, workPtr, &analyticPtr);
+        auto offset = i1 - windowStart;
+        for (int i=0; i<nOut; ++i)
+        {
+            y[i] = std::abs(analyticPtr[offset + i]) + mean;
+        }
+    }
+    /// Advances the stream by one block and discards the samples that no
+    /// later window needs
+    void advanceStream(const int nOut)
+    {
+        mNextBlock = mNextBlock + nOut;
+        auto newStart = std::max(static_cast<int64_t> (0),
+                                 mNextBlock - mOverlap);
+        auto nErase = std::min(static_cast<int64_t> (mStream.size()),
+                               newStart - mStreamStart);
+        if (nErase > 0)
+        {
+            mStream.erase(mStream.begin(), mStream.begin() + nErase);
+            mStreamStart = mStreamStart + nErase;
+        }
+    }
+    void resetStream()
+    {
+        mStream.clear();
+        mStreamStart = 0;
+        mNextBlock = 0;
+        mReceived = 0;
+    }
+//private:
+    Hilbert<T> mHilbert;
+    /// The buffered stream.  mStream[0] is sample mStreamStart.
+    std::vector<T> mStream;
+    /// Workspace for streaming
+    std::vector<T> mStreamWork;
+    std::vector<std::complex<T>> mStreamAnalytic;
+    /// The first stream sample whose envelope has not been output
+    int64_t mNextBlock = 0;
+    int64_t mStreamStart = 0;
+    /// The number of stream samples received
+    int64_t mReceived = 0;
+    /// Taper applied to the window prior to transforming
+    std::vector<T> mTaper;
+    double mMean = 0;
+    int mBlockSize = 0;
+    int mOverlap = 0;
+    int mTransformLength = 0;
+    bool mInitialized = false;
+};
+
+/// Constructors
+template<class T>
+BlockEnvelope<T>::BlockEnvelope() :
+    pImpl(std::make_unique<BlockEnvelopeImpl> ())
+{
+}
+
+template<class T>
+BlockEnvelope<T>::BlockEnvelope(const BlockEnvelope &envelope)
+{
+    *this = envelope;
+}
+
+template<class T>
+BlockEnvelope<T>::BlockEnvelope(BlockEnvelope &&envelope) noexcept
+{
+    *this = std::move(envelope);
+}
+
+/// Operators
+template<class T>
+BlockEnvelope<T>& BlockEnvelope<T>::operator=(const BlockEnvelope &envelope)
+{
+    if (&envelope == this){return *this;}
+    pImpl = std::make_unique<BlockEnvelopeImpl> (*envelope.pImpl);
+    return *this;
+}
+
+template<class T>
+BlockEnvelope<T>&
+BlockEnvelope<T>::operator=(BlockEnvelope &&envelope) noexcept
+{
+    if (&envelope == this){return *this;}
+    pImpl = std::move(envelope.pImpl);
+    return *this;
+}
+
+/// Destructors
+template<class T>
+BlockEnvelope<T>::~BlockEnvelope() = default;
+
+template<class T>
+void BlockEnvelope<T>::clear() noexcept
+{
+    pImpl = std::make_unique<BlockEnvelopeImpl> ();
+}
+
+/// Initialization
+template<class T>
+void BlockEnvelope<T>::initialize(const int blockSize, const int overlap)
+{
+    clear();
+    if (blockSize < 1)
+    {
+        RTSEIS_THROW_IA("blockSize = %d must be positive", blockSize);
+    }
+    if (overlap < 0)
+    {
+        RTSEIS_THROW_IA("overlap = %d cannot be negative", overlap);
+    }
+    auto transformLength
+        = DFTUtilities::nextFastLength(blockSize + 2*overlap);
+    pImpl->mHilbert.initialize(transformLength);
+    // Cosine taper on the outer half of each overlap.  Any extra samples
+    // from rounding up the transform length extend the right overlap.
+    pImpl->mTaper.resize(transformLength, 1);
+    auto nTaper = overlap/2;
+    for (int i=0; i<nTaper; ++i)
+    {
+        auto arg = M_PI*(i + 0.5)/nTaper;
+        auto taper = static_cast<T> (0.5*(1 - std::cos(arg)));
+        pImpl->mTaper[i] = taper;
+        pImpl->mTaper[transformLength - 1 - i] = taper;
+    }
+    pImpl->mBlockSize = blockSize;
+    pImpl->mOverlap = overlap;
+    pImpl->mTransformLength = transformLength;
+    pImpl->mStreamWork.resize(transformLength);
+    pImpl->mStreamAnalytic.resize(transformLength);
+    pImpl->mStream.reserve(2*transformLength);
+    pImpl->mInitialized = true;
+}
+
+template<class T>
+bool BlockEnvelope<T>::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+template<class T>
+int BlockEnvelope<T>::getBlockSize() const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    return pImpl->mBlockSize;
+}
+
+template<class T>
+int BlockEnvelope<T>::getTransformLength() const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    return pImpl->mTransformLength;
+}
+
+/// Transform
+template<class T>
+void BlockEnvelope<T>::transform(const int n, const T x[], T *yIn[])
+{
+    pImpl->mMean = 0;
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    if (n < 1){return;}
+    T *y = *yIn;
+    if (x == nullptr || y == nullptr)
+    {
+        if (x == nullptr){RTSEIS_THROW_IA("%s", "x is NULL");}
+        RTSEIS_THROW_IA("%s", "y is NULL");
+    }
+    // Remove the mean of the entire signal
+    double sum = 0;
+    #pragma omp simd reduction(+:sum)
+    for (int i=0; i<n; ++i)
+    {
+        sum = sum + static_cast<double> (x[i]);
+    }
+    pImpl->mMean = sum/n;
+    auto mean = static_cast<T> (pImpl->mMean);
+    auto nBlocks = (n + pImpl->mBlockSize - 1)/pImpl->mBlockSize;
+    auto transformLength = pImpl->mTransformLength;
+    // Each thread processes a contiguous range of blocks with its own
+    // transformer and workspace so the memory is independent of n
+    #pragma omp parallel shared(n, x, y, mean, nBlocks, transformLength)
+    {
+        int nThreads = 1;
+        int thread = 0;
+#ifdef _OPENMP
+        nThreads = omp_get_num_threads();
+        thread = omp_get_thread_num();
+#endif
+        auto blocksPerThread = (nBlocks + nThreads - 1)/nThreads;
+        auto blockStart = std::min(nBlocks, thread*blocksPerThread);
+        auto blockEnd = std::min(nBlocks, blockStart + blocksPerThread);
+        if (blockStart < blockEnd)
+        {
+            Hilbert<T> hilbert(pImpl->mHilbert);
+            std::vector<T> work(transformLength);
+            std::vector<std::complex<T>> analytic(transformLength);
+            pImpl->transformBlocks(n, x, mean, blockStart, blockEnd,
+                                   hilbert, work, analytic, y);
+        }
+    }
+}
+
+template<class T>
+void BlockEnvelope<T>::transform(const int n, const T x[],
+                                 T *yupperIn[], T *ylowerIn[])
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    if (n < 1){return;}
+    T *ylower = *ylowerIn;
+    if (ylower == nullptr){RTSEIS_THROW_IA("%s", "ylower is NULL");}
+    transform(n, x, yupperIn); // will throw
+    // The lower envelope is the upper envelope reflected about the mean,
+    // i.e., ylower = mean - (yupper - mean) = 2*mean - yupper
+    const T *yupper = *yupperIn;
+    auto twoMean = static_cast<T> (2*pImpl->mMean);
+    #pragma omp simd
+    for (int i=0; i<n; ++i)
+    {
+        ylower[i] = twoMean - yupper[i];
+    }
+}
+
+/// Streaming
+template<class T>
+int BlockEnvelope<T>::getLatency() const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    return pImpl->mTransformLength - pImpl->mBlockSize - pImpl->mOverlap;
+}
+
+template<class T>
+int BlockEnvelope<T>::update(const int n, const T x[], const int maxy,
+                             T *yupperIn[])
+{
+    auto latency = getLatency(); // Throws
+    if (n < 1){return 0;}
+    T *y = *yupperIn;
+    if (x == nullptr || y == nullptr)
+    {
+        if (x == nullptr){RTSEIS_THROW_IA("%s", "x is NULL");}
+        RTSEIS_THROW_IA("%s", "yupper is NULL");
+    }
+    // A block can be output once the samples after it fill its window
+    auto blockSize = pImpl->mBlockSize;
+    auto received = pImpl->mReceived + n;
+    int64_t nOut = 0;
+    if (received >= pImpl->mNextBlock + blockSize + latency)
+    {
+        auto nBlocks = (received - latency - pImpl->mNextBlock)/blockSize;
+        nOut = nBlocks*blockSize;
+    }
+    if (maxy < nOut)
+    {
+        RTSEIS_THROW_IA("maxy = %d must be at least %d",
+                        maxy, static_cast<int> (nOut));
+    }
+    pImpl->mStream.insert(pImpl->mStream.end(), x, x + n);
+    pImpl->mReceived = received;
+    for (int64_t i=0; i<nOut; i=i+blockSize)
+    {
+        pImpl->transformStreamBlock(pImpl->mNextBlock, blockSize,
+                                    received, &y[i]);
+        pImpl->advanceStream(blockSize);
+    }
+    return static_cast<int> (nOut);
+}
+
+template<class T>
+int BlockEnvelope<T>::flush(const int maxy, T *yupperIn[])
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    auto nOut = static_cast<int> (pImpl->mReceived - pImpl->mNextBlock);
+    if (nOut < 1)
+    {
+        pImpl->resetStream();
+        return 0;
+    }
+    T *y = *yupperIn;
+    if (y == nullptr){RTSEIS_THROW_IA("%s", "yupper is NULL");}
+    if (maxy < nOut)
+    {
+        RTSEIS_THROW_IA("maxy = %d must be at least %d", maxy, nOut);
+    }
+    for (int i=0; i<nOut; i=i+pImpl->mBlockSize)
+    {
+        auto nBlock = std::min(pImpl->mBlockSize, nOut - i);
+        pImpl->transformStreamBlock(pImpl->mNextBlock, nBlock,
+                                    pImpl->mReceived, &y[i]);
+        pImpl->advanceStream(nBlock);
+    }
+    pImpl->resetStream();
+    return nOut;
+}
+
+template<class T>
+void BlockEnvelope<T>::resetStream()
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    pImpl->resetStream();
+}
+
+/// Template instantiation
+template class RTSeis::Utilities::Transforms::BlockEnvelope<double>;
+template class RTSeis::Utilities::Transforms::BlockEnvelope<float>;
@@ -0,0 +1,332 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <cstdint>
+#include <complex>
+#include <vector>
+#include <algorithm>
+#include "rtseis/private/throw.hpp"
+#include "rtseis/utilities/transforms/chirpZTransform.hpp"
+#include "rtseis/utilities/transforms/dft.hpp"
+#include "rtseis/utilities/transforms/enums.hpp"
+#include "rtseis/utilities/transforms/utilities.hpp"
+
+using namespace RTSeis::Utilities::Transforms;
+
+namespace
+{
+/// Computes W^{p n^2/2} = exp(p n^2/2 (log|W| + i theta)) where p is +1 or
+/// -1.  For long signals n^2 theta is large so the angle is reduced in
+/// extended precision to retain accuracy.
+std::complex<double> chirp(const int64_t n, const double logMagnitude,
+                           const double theta, const int p)
+{
+    auto n2 = static_cast<long double> (n)*static_cast<long double> (n);
+    auto twopi = 2*static_cast<long double> (M_PI);
+    auto phase = std::fmod(p*n2*theta/2, twopi);
+    auto magnitude = std::exp(p*static_cast<double> (n2)*logMagnitude/2);
+    return std::polar(magnitude, static_cast<double> (phase));
+}
+}
+
+template<class T>
+class ChirpZTransform<T>::ChirpZTransformImpl
+{
+public:
+    /// Computes the transform from the chirped signal in mWork
+    void transform(std::complex<T> y[])
+    {
+        auto work = mWork.data();
+        auto spectrum = mSpectrum.data();
+        mDFT.forwardTransform(mFFTLength, work, mFFTLength, &spectrum);
+        // Convolve with the conjugate chirp
+        #pragma omp simd
+        for (int i=0; i<mFFTLength; ++i)
+        {
+            spectrum[i] = spectrum[i]*mFilterFT[i];
+        }
+        // The inverse transform includes the 1/L scaling
+        mDFT.inverseTransform(mFFTLength, spectrum, mFFTLength, &work);
+        #pragma omp simd
+        for (int k=0; k<mOutputLength; ++k)
+        {
+            y[k] = mOutputChirp[k]*work[k];
+        }
+    }
+//private:
+    DFT<T> mDFT;
+    /// The chirp applied to the input signal, A^{-n} W^{n^2/2}
+    std::vector<std::complex<T>> mInputChirp;
+    /// The DFT of the conjugate chirp, W^{-n^2/2}
+    std::vector<std::complex<T>> mFilterFT;
+    /// The chirp applied to the output, W^{k^2/2}
+    std::vector<std::complex<T>> mOutputChirp;
+    /// Workspace
+    std::vector<std::complex<T>> mWork;
+    std::vector<std::complex<T>> mSpectrum;
+    /// Frequencies at which the zoom transform is evaluated
+    double mMinimumFrequency = 0;
+    double mFrequencySpacing = 0;
+    int mInputLength = 0;
+    int mOutputLength = 0;
+    int mFFTLength = 0;
+    bool mHaveFrequencies = false;
+    bool mInitialized = false;
+};
+
+/// Constructors
+template<class T>
+ChirpZTransform<T>::ChirpZTransform() :
+    pImpl(std::make_unique<ChirpZTransformImpl> ())
+{
+}
+
+template<class T>
+ChirpZTransform<T>::ChirpZTransform(const ChirpZTransform &czt)
+{
+    *this = czt;
+}
+
+template<class T>
+ChirpZTransform<T>::ChirpZTransform(ChirpZTransform &&czt) noexcept
+{
+    *this = std::move(czt);
+}
+
+/// Operators
+template<class T>
+ChirpZTransform<T>&
+ChirpZTransform<T>::operator=(const ChirpZTransform &czt)
+{
+    if (&czt == this){return *this;}
+    pImpl = std::make_unique<ChirpZTransformImpl> (*czt.pImpl);
+    return *this;
+}
+
+template<class T>
+ChirpZTransform<T>&
+ChirpZTransform<T>::operator=(ChirpZTransform &&czt) noexcept
+{
+    if (&czt == this){return *this;}
+    pImpl = std::move(czt.pImpl);
+    return *this;
+}
+
+/// Destructors
+template<class T>
+ChirpZTransform<T>::~ChirpZTransform() = default;
+
+template<class T>
+void ChirpZTransform<T>::clear() noexcept
+{
+    pImpl = std::make_unique<ChirpZTransformImpl> ();
+}
+
+/// Initialization
+template<class T>
+void ChirpZTransform<T>::initialize(const int nSamples,
+                                    const int nOutput,
+                                    const std::complex<double> &w,
+                                    const std::complex<double> &a)
+{
+    clear();
+    if (nSamples < 1)
+    {
+        RTSEIS_THROW_IA("nSamples = %d must be positive", nSamples);
+    }
+    if (nOutput < 1)
+    {
+        RTSEIS_THROW_IA("nOutput = %d must be positive", nOutput);
+    }
+    if (w == std::complex<double> (0, 0))
+    {
+        RTSEIS_THROW_IA("%s", "w cannot be zero");
+    }
+    if (a == std::complex<double> (0, 0))
+    {
+        RTSEIS_THROW_IA("%s", "a cannot be zero");
+    }
+    // Circular convolution of length L >= N + M - 1 avoids wraparound.
+    // The mixed-radix DFT is efficient for 7-smooth lengths so there is no
+    // need to pad to a power of 2.
+    int fftLength = DFTUtilities::nextFastLength(nSamples + nOutput - 1);
+    pImpl->mDFT.initialize(fftLength, FourierTransformImplementation::DFT);
+    // Points on the unit circle are common so avoid the roundoff in |w|
+    // which would otherwise grow like n^2
+    auto logMagnitude = std::log(std::abs(w));
+    if (std::abs(logMagnitude) < 1.e-14){logMagnitude = 0;}
+    auto theta = std::arg(w);
+    auto logA = std::log(a);
+    // Input chirp: A^{-n} W^{n^2/2}
+    pImpl->mInputChirp.resize(nSamples);
+    for (int n=0; n<nSamples; ++n)
+    {
+        auto an = std::exp(-static_cast<double> (n)*logA);
+        auto cn = an*chirp(n, logMagnitude, theta, +1);
+        pImpl->mInputChirp[n] = std::complex<T> (cn);
+    }
+    // Output chirp: W^{k^2/2}
+    pImpl->mOutputChirp.resize(nOutput);
+    for (int k=0; k<nOutput; ++k)
+    {
+        pImpl->mOutputChirp[k]
+            = std::complex<T> (chirp(k, logMagnitude, theta, +1));
+    }
+    // Filter: W^{-m^2/2} for m=-(N-1),...,M-1 stored in wraparound order
+    std::vector<std::complex<T>> v(fftLength, std::complex<T> (0, 0));
+    for (int m=0; m<nOutput; ++m)
+    {
+        v[m] = std::complex<T> (chirp(m, logMagnitude, theta, -1));
+    }
+    for (int m=1; m<nSamples; ++m)
+    {
+        v[fftLength - m]
+            = std::complex<T> (chirp(m, logMagnitude, theta, -1));
+    }
+    pImpl->mFilterFT.resize(fftLength);
+    auto filterPtr = pImpl->mFilterFT.data();
+    pImpl->mDFT.forwardTransform(fftLength, v.data(), fftLength, &filterPtr);
+    pImpl->mWork.resize(fftLength);
+    pImpl->mSpectrum.resize(fftLength);
+    pImpl->mInputLength = nSamples;
+    pImpl->mOutputLength = nOutput;
+    pImpl->mFFTLength = fftLength;
+    pImpl->mInitialized = true;
+}
+
+template<class T>
+void ChirpZTransform<T>::initialize(const int nSamples,
+                                    const int nFrequencies,
+                                    const double minimumFrequency,
+                                    const double maximumFrequency,
+                                    const double samplingRate)
+{
+    clear();
+    if (samplingRate <= 0)
+    {
+        RTSEIS_THROW_IA("samplingRate = %lf must be positive", samplingRate);
+    }
+    if (nFrequencies > 1 && maximumFrequency <= minimumFrequency)
+    {
+        RTSEIS_THROW_IA("maximumFrequency = %lf must exceed %lf",
+                        maximumFrequency, minimumFrequency);
+    }
+    double df = 0;
+    if (nFrequencies > 1)
+    {
+        df = (maximumFrequency - minimumFrequency)/(nFrequencies - 1);
+    }
+    auto w = std::polar(1.0, -2*M_PI*df/samplingRate);
+    auto a = std::polar(1.0, 2*M_PI*minimumFrequency/samplingRate);
+    initialize(nSamples, nFrequencies, w, a);
+    pImpl->mMinimumFrequency = minimumFrequency;
+    pImpl->mFrequencySpacing = df;
+    pImpl->mHaveFrequencies = true;
+}
+
+template<class T>
+bool ChirpZTransform<T>::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+template<class T>
+int ChirpZTransform<T>::getInputLength() const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    return pImpl->mInputLength;
+}
+
+template<class T>
+int ChirpZTransform<T>::getTransformLength() const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    return pImpl->mOutputLength;
+}
+
+template<class T>
+void ChirpZTransform<T>::getFrequencies(const int nFrequencies,
+                                        double *frequenciesIn[]) const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    if (!pImpl->mHaveFrequencies)
+    {
+        RTSEIS_THROW_RTE("%s", "Class not initialized with frequency band");
+    }
+    if (nFrequencies != pImpl->mOutputLength)
+    {
+        RTSEIS_THROW_IA("nFrequencies = %d must equal %d",
+                        nFrequencies, pImpl->mOutputLength);
+    }
+    double *frequencies = *frequenciesIn;
+    if (frequencies == nullptr){RTSEIS_THROW_IA("%s", "frequencies is NULL");}
+    for (int k=0; k<nFrequencies; ++k)
+    {
+        frequencies[k] = pImpl->mMinimumFrequency + k*pImpl->mFrequencySpacing;
+    }
+}
+
+/// Transforms
+template<class T>
+void ChirpZTransform<T>::transform(const int n, const T x[],
+                                   const int maxy, std::complex<T> *yIn[])
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    if (n < 0 || n > pImpl->mInputLength)
+    {
+        RTSEIS_THROW_IA("n = %d must be in range [0,%d]",
+                        n, pImpl->mInputLength);
+    }
+    if (n > 0 && x == nullptr){RTSEIS_THROW_IA("%s", "x is NULL");}
+    if (maxy < pImpl->mOutputLength)
+    {
+        RTSEIS_THROW_IA("maxy = %d must be at least %d",
+                        maxy, pImpl->mOutputLength);
+    }
+    std::complex<T> *y = *yIn;
+    if (y == nullptr){RTSEIS_THROW_IA("%s", "y is NULL");}
+    auto work = pImpl->mWork.data();
+    const auto *chirpPtr = pImpl->mInputChirp.data();
+    #pragma omp simd
+    for (int i=0; i<n; ++i)
+    {
+        work[i] = x[i]*chirpPtr[i];
+    }
+    std::fill(pImpl->mWork.begin() + n, pImpl->mWork.end(),
+              std::complex<T> (0, 0));
+    pImpl->transform(y);
+}
+
+template<class T>
+void ChirpZTransform<T>::transform(const int n, const std::complex<T> x[],
+                                   const int maxy, std::complex<T> *yIn[])
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    if (n < 0 || n > pImpl->mInputLength)
+    {
+        RTSEIS_THROW_IA("n = %d must be in range [0,%d]",
+                        n, pImpl->mInputLength);
+    }
+    if (n > 0 && x == nullptr){RTSEIS_THROW_IA("%s", "x is NULL");}
+    if (maxy < pImpl->mOutputLength)
+    {
+        RTSEIS_THROW_IA("maxy = %d must be at least %d",
+                        maxy, pImpl->mOutputLength);
+    }
+    std::complex<T> *y = *yIn;
+    if (y == nullptr){RTSEIS_THROW_IA("%s", "y is NULL");}
+    auto work = pImpl->mWork.data();
+    const auto *chirpPtr = pImpl->mInputChirp.data();
+    #pragma omp simd
+    for (int i=0; i<n; ++i)
+    {
+        work[i] = x[i]*chirpPtr[i];
+    }
+    std::fill(pImpl->mWork.begin() + n, pImpl->mWork.end(),
+              std::complex<T> (0, 0));
+    pImpl->transform(y);
+}
+
+/// Template instantiation
+template class RTSeis::Utilities::Transforms::ChirpZTransform<double>;
+template class RTSeis::Utilities::Transforms::ChirpZTransform<float>;
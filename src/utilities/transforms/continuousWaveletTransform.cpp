@@ -0,0 +1,350 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <complex>
+#include <vector>
+#include <algorithm>
+#include "rtseis/private/throw.hpp"
+#include "rtseis/utilities/transforms/continuousWaveletTransform.hpp"
+#include "rtseis/utilities/transforms/dftRealToComplex.hpp"
+#include "rtseis/utilities/transforms/dft.hpp"
+#include "rtseis/utilities/transforms/utilities.hpp"
+
+using namespace RTSeis::Utilities::Transforms;
+
+template<class T>
+class ContinuousWaveletTransform<T>::ContinuousWaveletTransformImpl
+{
+public:
+    /// Computes the transform at every scale.  The signal is transformed
+    /// once then each thread inverse transforms a subset of the scales
+    /// and hands the result to the output function.
+    template<typename F>
+    void apply(const T x[], F output)
+    {
+        auto spectrum = mSpectrum.data();
+        mForward.forwardTransform(mSamples, x, mBins, &spectrum);
+        #pragma omp parallel
+        {
+            DFT<T> inverse(mInverse);
+            std::vector<std::complex<T>> work(mLength,
+                                              std::complex<T> (0, 0));
+            std::vector<std::complex<T>> result(mLength);
+            auto workPtr = work.data();
+            auto resultPtr = result.data();
+            #pragma omp for schedule(dynamic)
+            for (int j=0; j<mScalesN; ++j)
+            {
+                // The wavelets are analytic so the negative frequencies
+                // in the tail of the workspace remain zero
+                const T *psi = &mWaveletSpectra[static_cast<size_t> (j)*mBins];
+                #pragma omp simd
+                for (int k=0; k<mBins; ++k)
+                {
+                    workPtr[k] = mSpectrum[k]*psi[k];
+                }
+                inverse.inverseTransform(mLength, workPtr,
+                                         mLength, &resultPtr);
+                output(j, resultPtr);
+            }
+        }
+    }
+//private:
+    DFTRealToComplex<T> mForward;
+    DFT<T> mInverse;
+    /// The wavelet spectra stored [nScales x nBins]
+    std::vector<T> mWaveletSpectra;
+    /// The signal's spectrum
+    std::vector<std::complex<T>> mSpectrum;
+    std::vector<double> mScales;
+    std::vector<double> mFrequencies;
+    int mSamples = 0;
+    int mScalesN = 0;
+    /// The padded transform length
+    int mLength = 0;
+    /// Number of non-negative frequencies
+    int mBins = 0;
+    bool mInitialized = false;
+};
+
+/// Constructors
+template<class T>
+ContinuousWaveletTransform<T>::ContinuousWaveletTransform() :
+    pImpl(std::make_unique<ContinuousWaveletTransformImpl> ())
+{
+}
+
+template<class T>
+ContinuousWaveletTransform<T>::ContinuousWaveletTransform(
+    const ContinuousWaveletTransform &cwt)
+{
+    *this = cwt;
+}
+
+template<class T>
+ContinuousWaveletTransform<T>::ContinuousWaveletTransform(
+    ContinuousWaveletTransform &&cwt) noexcept
+{
+    *this = std::move(cwt);
+}
+
+/// Operators
+template<class T>
+ContinuousWaveletTransform<T>& ContinuousWaveletTransform<T>::operator=(
+    const ContinuousWaveletTransform &cwt)
+{
+    if (&cwt == this){return *this;}
+    pImpl = std::make_unique<ContinuousWaveletTransformImpl> (*cwt.pImpl);
+    return *this;
+}
+
+template<class T>
+ContinuousWaveletTransform<T>& ContinuousWaveletTransform<T>::operator=(
+    ContinuousWaveletTransform &&cwt) noexcept
+{
+    if (&cwt == this){return *this;}
+    pImpl = std::move(cwt.pImpl);
+    return *this;
+}
+
+/// Destructors
+template<class T>
+ContinuousWaveletTransform<T>::~ContinuousWaveletTransform() = default;
+
+template<class T>
+void ContinuousWaveletTransform<T>::clear() noexcept
+{
+    pImpl = std::make_unique<ContinuousWaveletTransformImpl> ();
+}
+
+/// Initialization
+template<class T>
+void ContinuousWaveletTransform<T>::initialize(
+    const int nSamples,
+    const int nScales,
+    const double scales[],
+    const ContinuousWaveletType wavelet,
+    const double samplingRate,
+    const double waveletParameter)
+{
+    clear();
+    if (nSamples < 2)
+    {
+        RTSEIS_THROW_IA("nSamples = %d must be at least 2", nSamples);
+    }
+    if (nScales < 1)
+    {
+        RTSEIS_THROW_IA("nScales = %d must be positive", nScales);
+    }
+    if (scales == nullptr){RTSEIS_THROW_IA("%s", "scales is NULL");}
+    for (int j=0; j<nScales; ++j)
+    {
+        if (scales[j] <= 0)
+        {
+            RTSEIS_THROW_IA("scales[%d] = %lf must be positive",
+                            j, scales[j]);
+        }
+    }
+    if (samplingRate <= 0)
+    {
+        RTSEIS_THROW_IA("samplingRate = %lf must be positive", samplingRate);
+    }
+    double parameter = waveletParameter;
+    if (wavelet == ContinuousWaveletType::MORLET)
+    {
+        if (parameter <= 0){parameter = 6;}
+    }
+    else
+    {
+        if (parameter <= 0){parameter = 4;}
+        if (std::round(parameter) != parameter)
+        {
+            RTSEIS_THROW_IA("Paul order = %lf must be an integer", parameter);
+        }
+    }
+    // Pad to suppress wraparound
+    auto length = DFTUtilities::nextFastLength(2*nSamples);
+    pImpl->mForward.initialize(length, FourierTransformImplementation::DFT);
+    pImpl->mInverse.initialize(length, FourierTransformImplementation::DFT);
+    auto nBins = pImpl->mForward.getTransformLength();
+    // Tabulate the wavelet spectra (Table 1 of Torrence and Compo, 1998)
+    // with the normalization sqrt(2 pi s/dt) so each scale has unit energy
+    pImpl->mWaveletSpectra.resize(static_cast<size_t> (nScales)*nBins, 0);
+    pImpl->mScales.resize(nScales);
+    pImpl->mFrequencies.resize(nScales);
+    auto dOmega = 2*M_PI*samplingRate/length;
+    for (int j=0; j<nScales; ++j)
+    {
+        auto s = scales[j];
+        auto normalization = std::sqrt(2*M_PI*s*samplingRate);
+        T *psi = &pImpl->mWaveletSpectra[static_cast<size_t> (j)*nBins];
+        if (wavelet == ContinuousWaveletType::MORLET)
+        {
+            auto omega0 = parameter;
+            auto c = normalization*std::pow(M_PI, -0.25);
+            for (int k=1; k<nBins; ++k)
+            {
+                auto arg = s*dOmega*k - omega0;
+                psi[k] = static_cast<T> (c*std::exp(-0.5*arg*arg));
+            }
+            auto lambda = 4*M_PI*s/(omega0 + std::sqrt(2 + omega0*omega0));
+            pImpl->mFrequencies[j] = 1/lambda;
+        }
+        else
+        {
+            auto m = parameter;
+            auto logc = m*std::log(2.0)
+                      - 0.5*(std::log(m) + std::lgamma(2*m));
+            for (int k=1; k<nBins; ++k)
+            {
+                auto somega = s*dOmega*k;
+                auto logPsi = logc + m*std::log(somega) - somega;
+                psi[k] = static_cast<T> (normalization*std::exp(logPsi));
+            }
+            auto lambda = 4*M_PI*s/(2*m + 1);
+            pImpl->mFrequencies[j] = 1/lambda;
+        }
+        pImpl->mScales[j] = s;
+    }
+    pImpl->mSpectrum.resize(nBins);
+    pImpl->mSamples = nSamples;
+    pImpl->mScalesN = nScales;
+    pImpl->mLength = length;
+    pImpl->mBins = nBins;
+    pImpl->mInitialized = true;
+}
+
+template<class T>
+void ContinuousWaveletTransform<T>::initialize(
+    const int nSamples,
+    const int nScales,
+    const double minimumScale,
+    const double maximumScale,
+    const ContinuousWaveletType wavelet,
+    const double samplingRate,
+    const double waveletParameter)
+{
+    clear();
+    if (nScales < 1)
+    {
+        RTSEIS_THROW_IA("nScales = %d must be positive", nScales);
+    }
+    if (minimumScale <= 0)
+    {
+        RTSEIS_THROW_IA("minimumScale = %lf must be positive", minimumScale);
+    }
+    if (nScales > 1 && maximumScale <= minimumScale)
+    {
+        RTSEIS_THROW_IA("maximumScale = %lf must exceed %lf",
+                        maximumScale, minimumScale);
+    }
+    std::vector<double> scales(nScales, minimumScale);
+    if (nScales > 1)
+    {
+        auto logRatio = std::log(maximumScale/minimumScale);
+        for (int j=0; j<nScales; ++j)
+        {
+            scales[j] = minimumScale*std::exp(logRatio*j/(nScales - 1));
+        }
+        scales[nScales - 1] = maximumScale;
+    }
+    initialize(nSamples, nScales, scales.data(), wavelet,
+               samplingRate, waveletParameter);
+}
+
+template<class T>
+bool ContinuousWaveletTransform<T>::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+template<class T>
+int ContinuousWaveletTransform<T>::getNumberOfSamples() const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    return pImpl->mSamples;
+}
+
+template<class T>
+int ContinuousWaveletTransform<T>::getNumberOfScales() const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    return pImpl->mScalesN;
+}
+
+template<class T>
+void ContinuousWaveletTransform<T>::getScales(const int nScales,
+                                              double *scalesIn[]) const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    if (nScales != pImpl->mScalesN)
+    {
+        RTSEIS_THROW_IA("nScales = %d must equal %d",
+                        nScales, pImpl->mScalesN);
+    }
+    double *scales = *scalesIn;
+    if (scales == nullptr){RTSEIS_THROW_IA("%s", "scales is NULL");}
+    std::copy(pImpl->mScales.begin(), pImpl->mScales.end(), scales);
+}
+
+template<class T>
+void ContinuousWaveletTransform<T>::getFrequencies(
+    const int nScales, double *frequenciesIn[]) const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    if (nScales != pImpl->mScalesN)
+    {
+        RTSEIS_THROW_IA("nScales = %d must equal %d",
+                        nScales, pImpl->mScalesN);
+    }
+    double *frequencies = *frequenciesIn;
+    if (frequencies == nullptr){RTSEIS_THROW_IA("%s", "frequencies is NULL");}
+    std::copy(pImpl->mFrequencies.begin(), pImpl->mFrequencies.end(),
+              frequencies);
+}
+
+/// Transforms
+template<class T>
+void ContinuousWaveletTransform<T>::transform(const int n, const T x[],
+                                              std::complex<T> *yIn[])
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    if (n != pImpl->mSamples)
+    {
+        RTSEIS_THROW_IA("n = %d must equal %d", n, pImpl->mSamples);
+    }
+    if (x == nullptr){RTSEIS_THROW_IA("%s", "x is NULL");}
+    std::complex<T> *y = *yIn;
+    if (y == nullptr){RTSEIS_THROW_IA("%s", "y is NULL");}
+    pImpl->apply(x, [y, n](const int j, const std::complex<T> w[])
+                 {
+                     std::copy(w, w + n, &y[static_cast<size_t> (j)*n]);
+                 });
+}
+
+template<class T>
+void ContinuousWaveletTransform<T>::transformAmplitude(const int n,
+                                                       const T x[],
+                                                       float *amplitudeIn[])
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    if (n != pImpl->mSamples)
+    {
+        RTSEIS_THROW_IA("n = %d must equal %d", n, pImpl->mSamples);
+    }
+    if (x == nullptr){RTSEIS_THROW_IA("%s", "x is NULL");}
+    float *amplitude = *amplitudeIn;
+    if (amplitude == nullptr){RTSEIS_THROW_IA("%s", "amplitude is NULL");}
+    pImpl->apply(x, [amplitude, n](const int j, const std::complex<T> w[])
+                 {
+                     float *a = &amplitude[static_cast<size_t> (j)*n];
+                     for (int i=0; i<n; ++i)
+                     {
+                         a[i] = static_cast<float> (std::abs(w[i]));
+                     }
+                 });
+}
+
+/// Template instantiation
+template class RTSeis::Utilities::Transforms::ContinuousWaveletTransform<double>;
+template class RTSeis::Utilities::Transforms::ContinuousWaveletTransform<float>;
@@ -0,0 +1,475 @@
+#include <cstdio>
+#include <cstdlib>
+#include <complex>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <ipps.h>
+#include "rtseis/private/throw.hpp"
+#include "rtseis/utilities/transforms/crossSpectrum.hpp"
+#include "rtseis/utilities/transforms/utilities.hpp"
+#include "rtseis/utilities/transforms/slidingWindowRealDFT.hpp"
+#include "rtseis/utilities/transforms/slidingWindowRealDFTParameters.hpp"
+
+using namespace RTSeis::Utilities::Transforms;
+
+namespace
+{
+
+/// The densities are normalized by fs*sum(w^2), as in Welch, so that
+/// they integrate to the (cross) mean square
+double computeDensityScaling(const int npts, const double samplingRate,
+                             const double window[])
+{
+    double wsum2 = 0;
+    ippsDotProd_64f(window, window, npts, &wsum2);
+    wsum2 = samplingRate*wsum2;
+    return wsum2;
+}
+
+}
+
+class CrossSpectrum::CrossSpectrumImpl
+{
+public:
+    /// Discards the buffered data and the estimates
+    void reset()
+    {
+        std::fill(mSegments.begin(), mSegments.end(), 0);
+        std::fill(mSumPower.begin(), mSumPower.end(), 0);
+        std::fill(mSumCross.begin(), mSumCross.end(),
+                  std::complex<double> (0, 0));
+        mSegmentFill = 0;
+        mSegmentsN = 0;
+    }
+    /// Transforms every channel's buffered segment once then folds the
+    /// transforms into the channel and pair sums
+    void processSegment()
+    {
+        #pragma omp parallel for
+        for (int c=0; c<mChannels; ++c)
+        {
+            auto &swdft = mSlidingWindowRealDFTs[c];
+            swdft.transform(mSegmentLength,
+                            &mSegments[static_cast<size_t> (c)*mSegmentLength]);
+            const std::complex<double> *cPtr = swdft.getTransform64f(0);
+            std::complex<double> *spectrum
+                = &mSpectra[static_cast<size_t> (c)*mFrequencies];
+            double *sumPower = &mSumPower[static_cast<size_t> (c)*mFrequencies];
+            for (int k=0; k<mFrequencies; ++k)
+            {
+                spectrum[k] = cPtr[k];
+                sumPower[k] = sumPower[k] + std::norm(cPtr[k]);
+            }
+        }
+        #pragma omp parallel for
+        for (int ip=0; ip<mPairsN; ++ip)
+        {
+            const std::complex<double> *xPtr
+               = &mSpectra[static_cast<size_t> (mPairs[2*ip])*mFrequencies];
+            const std::complex<double> *yPtr
+               = &mSpectra[static_cast<size_t> (mPairs[2*ip+1])*mFrequencies];
+            std::complex<double> *sumCross
+               = &mSumCross[static_cast<size_t> (ip)*mFrequencies];
+            for (int k=0; k<mFrequencies; ++k)
+            {
+                sumCross[k] = sumCross[k] + std::conj(xPtr[k])*yPtr[k];
+            }
+        }
+        mSegmentsN = mSegmentsN + 1;
+    }
+    /// Appends data to the segment buffers
+    void update(const int nSamples, const double x[])
+    {
+        int i = 0;
+        while (i < nSamples)
+        {
+            auto ncopy = std::min(mSegmentLength - mSegmentFill, nSamples - i);
+            for (int c=0; c<mChannels; ++c)
+            {
+                const double *xc = &x[static_cast<size_t> (c)*nSamples];
+                double *segment
+                    = &mSegments[static_cast<size_t> (c)*mSegmentLength];
+                std::copy(xc + i, xc + i + ncopy, segment + mSegmentFill);
+            }
+            mSegmentFill = mSegmentFill + ncopy;
+            i = i + ncopy;
+            if (mSegmentFill == mSegmentLength)
+            {
+                processSegment();
+                // Retain the overlap for the next segment
+                for (int c=0; c<mChannels; ++c)
+                {
+                    double *segment
+                        = &mSegments[static_cast<size_t> (c)*mSegmentLength];
+                    std::copy(segment + mSegmentLength - mSamplesInOverlap,
+                              segment + mSegmentLength, segment);
+                }
+                mSegmentFill = mSamplesInOverlap;
+            }
+        }
+    }
+    /// The scale factor applied to the sums to obtain densities
+    double getDensityScaling() const
+    {
+        return 2.0/(static_cast<double> (mSegmentsN)*mDensityScaling);
+    }
+
+    /// One transform per channel so the channels can be transformed
+    /// in parallel
+    std::vector<class SlidingWindowRealDFT> mSlidingWindowRealDFTs;
+    class SlidingWindowRealDFTParameters mParameters;
+    /// The partially filled segment of each channel.  This has dimension
+    /// [mChannels x mSegmentLength].
+    std::vector<double> mSegments;
+    /// The latest segment's DFT of each channel.  This has dimension
+    /// [mChannels x mFrequencies].
+    std::vector<std::complex<double>> mSpectra;
+    /// The running sum of |X|^2 for each channel.  This has dimension
+    /// [mChannels x mFrequencies].
+    std::vector<double> mSumPower;
+    /// The running sum of X^* Y for each pair.  This has dimension
+    /// [mPairsN x mFrequencies].
+    std::vector<std::complex<double>> mSumCross;
+    /// The channel indices of each pair.  This has dimension [2 x mPairsN].
+    std::vector<int> mPairs;
+    double mDensityScaling = 1;
+    double mSamplingRate = 1;
+    int mChannels = 0;
+    int mPairsN = 0;
+    int mFrequencies = 0;
+    int mSegmentLength = 0;
+    int mSamplesInOverlap = 0;
+    /// Number of samples currently in each segment
+    int mSegmentFill = 0;
+    /// Number of segments processed since the last reset
+    int mSegmentsN = 0;
+    bool mInitialized = false;
+};
+
+/// Constructors
+CrossSpectrum::CrossSpectrum() :
+    pImpl(std::make_unique<CrossSpectrumImpl> ())
+{
+}
+
+CrossSpectrum::CrossSpectrum(const CrossSpectrum &crossSpectrum)
+{
+    *this = crossSpectrum;
+}
+
+CrossSpectrum::CrossSpectrum(CrossSpectrum &&crossSpectrum) noexcept
+{
+    *this = std::move(crossSpectrum);
+}
+
+/// Operators
+CrossSpectrum& CrossSpectrum::operator=(const CrossSpectrum &crossSpectrum)
+{
+    if (&crossSpectrum == this){return *this;}
+    if (pImpl){pImpl.reset();}
+    pImpl = std::make_unique<CrossSpectrumImpl> (*crossSpectrum.pImpl);
+    return *this;
+}
+
+CrossSpectrum& CrossSpectrum::operator=(CrossSpectrum &&crossSpectrum) noexcept
+{
+    if (&crossSpectrum == this){return *this;}
+    pImpl = std::move(crossSpectrum.pImpl);
+    return *this;
+}
+
+/// Destructor
+CrossSpectrum::~CrossSpectrum() = default;
+
+/// Clears memory
+void CrossSpectrum::clear() noexcept
+{
+    pImpl = std::make_unique<CrossSpectrumImpl> ();
+}
+
+/// Initialize
+void CrossSpectrum::initialize(const SlidingWindowRealDFTParameters &parameters,
+                               const int nChannels,
+                               const int nPairs,
+                               const int pairs[],
+                               const double samplingRate)
+{
+    clear();
+    if (nChannels < 2)
+    {
+        RTSEIS_THROW_IA("nChannels = %d must be at least 2", nChannels);
+    }
+    if (nPairs < 1)
+    {
+        RTSEIS_THROW_IA("nPairs = %d must be positive", nPairs);
+    }
+    if (pairs == nullptr){RTSEIS_THROW_IA("%s", "pairs is NULL");}
+    if (parameters.getOutputType() != SlidingWindowOutputType::COMPLEX)
+    {
+        RTSEIS_THROW_IA("%s", "parameters output type must be COMPLEX");
+    }
+    for (int i=0; i<2*nPairs; ++i)
+    {
+        if (pairs[i] < 0 || pairs[i] >= nChannels)
+        {
+            RTSEIS_THROW_IA("pairs[%d] = %d must be in range [0,%d]",
+                            i, pairs[i], nChannels - 1);
+        }
+    }
+    if (samplingRate <= 0)
+    {
+        RTSEIS_THROW_IA("samplingRate = %lf must be posistive", samplingRate);
+    }
+    // The sliding window DFT is told the signal is exactly one segment
+    // long so that each call to transform yields a single segment's DFT
+    try
+    {
+        pImpl->mParameters = parameters;
+        pImpl->mSegmentLength = pImpl->mParameters.getWindowLength();
+        pImpl->mSamplesInOverlap
+            = pImpl->mParameters.getNumberOfSamplesInOverlap();
+        pImpl->mParameters.setNumberOfSamples(pImpl->mSegmentLength);
+    }
+    catch (const std::exception &e)
+    {
+        clear();
+        RTSEIS_THROW_IA("%s; parameters are not valid", e.what());
+    }
+    if (!pImpl->mParameters.isValid())
+    {
+        clear();
+        RTSEIS_THROW_IA("%s", "parameters are not valid");
+    }
+    try
+    {
+        pImpl->mSlidingWindowRealDFTs.resize(nChannels);
+        pImpl->mSlidingWindowRealDFTs[0].initialize(pImpl->mParameters);
+        for (int c=1; c<nChannels; ++c)
+        {
+            pImpl->mSlidingWindowRealDFTs[c]
+                = pImpl->mSlidingWindowRealDFTs[0];
+        }
+    }
+    catch (const std::exception &e)
+    {
+        clear();
+        RTSEIS_THROW_RTE("%s", "Failed to initialize sliding DFT");
+    }
+    std::vector<double> window = pImpl->mParameters.getWindow();
+    pImpl->mDensityScaling = computeDensityScaling(pImpl->mSegmentLength,
+                                                   samplingRate,
+                                                   window.data());
+    auto nFrequencies = pImpl->mSlidingWindowRealDFTs[0].getNumberOfFrequencies();
+    pImpl->mPairs.assign(pairs, pairs + 2*nPairs);
+    pImpl->mSegments.resize(
+        static_cast<size_t> (nChannels)*pImpl->mSegmentLength, 0);
+    pImpl->mSpectra.resize(static_cast<size_t> (nChannels)*nFrequencies);
+    pImpl->mSumPower.resize(static_cast<size_t> (nChannels)*nFrequencies, 0);
+    pImpl->mSumCross.resize(static_cast<size_t> (nPairs)*nFrequencies,
+                            std::complex<double> (0, 0));
+    pImpl->mSamplingRate = samplingRate;
+    pImpl->mChannels = nChannels;
+    pImpl->mPairsN = nPairs;
+    pImpl->mFrequencies = nFrequencies;
+    pImpl->mInitialized = true;
+}
+
+void CrossSpectrum::initialize(const SlidingWindowRealDFTParameters &parameters,
+                               const double samplingRate)
+{
+    const int pairs[2] = {0, 1};
+    initialize(parameters, 2, 1, pairs, samplingRate);
+}
+
+bool CrossSpectrum::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+int CrossSpectrum::getNumberOfChannels() const
+{
+    if (!isInitialized())
+    {
+        RTSEIS_THROW_RTE("%s", "Class is not initialized");
+    }
+    return pImpl->mChannels;
+}
+
+int CrossSpectrum::getNumberOfPairs() const
+{
+    if (!isInitialized())
+    {
+        RTSEIS_THROW_RTE("%s", "Class is not initialized");
+    }
+    return pImpl->mPairsN;
+}
+
+int CrossSpectrum::getNumberOfFrequencies() const
+{
+    if (!isInitialized())
+    {
+        RTSEIS_THROW_RTE("%s", "Class is not initialized");
+    }
+    return pImpl->mFrequencies;
+}
+
+void CrossSpectrum::getFrequencies(const int nFrequencies,
+                                   double *freqsIn[]) const
+{
+    auto nFreqs = getNumberOfFrequencies(); // Will throw initialization error
+    if (nFrequencies != nFreqs)
+    {
+        RTSEIS_THROW_IA("nFrequencies = %d must equal %d",
+                        nFrequencies, nFreqs);
+    }
+    double *freqs = *freqsIn;
+    if (freqs == nullptr)
+    {
+        RTSEIS_THROW_IA("%s", "frequencies is NULL");
+    }
+    int nSamples = pImpl->mParameters.getDFTLength();
+    DFTUtilities::realToComplexDFTFrequencies(nSamples,
+                                              1.0/pImpl->mSamplingRate,
+                                              nFreqs,
+                                              freqsIn);
+}
+
+/// Append data
+void CrossSpectrum::update(const int nChannels, const int nSamples,
+                           const double x[])
+{
+    if (!isInitialized())
+    {
+        RTSEIS_THROW_RTE("%s", "Class is not initialized");
+    }
+    if (nChannels != pImpl->mChannels)
+    {
+        RTSEIS_THROW_IA("nChannels = %d must equal %d",
+                        nChannels, pImpl->mChannels);
+    }
+    if (nSamples < 1){return;} // Nothing to do
+    if (x == nullptr){RTSEIS_THROW_IA("%s", "x is NULL");}
+    pImpl->update(nSamples, x);
+}
+
+/// Reset
+void CrossSpectrum::reset()
+{
+    if (!isInitialized())
+    {
+        RTSEIS_THROW_RTE("%s", "Class is not initialized");
+    }
+    pImpl->reset();
+}
+
+bool CrossSpectrum::haveTransform() const noexcept
+{
+    if (!pImpl->mInitialized){return false;}
+    return (pImpl->mSegmentsN > 0);
+}
+
+int CrossSpectrum::getNumberOfAveragedSegments() const
+{
+    if (!isInitialized())
+    {
+        RTSEIS_THROW_RTE("%s", "Class is not initialized");
+    }
+    return pImpl->mSegmentsN;
+}
+
+/// Estimates
+void CrossSpectrum::getCrossSpectralDensity(const int pair,
+                                            const int nFrequencies,
+                                            std::complex<double> *csdIn[]) const
+{
+    auto nFreqs = getNumberOfFrequencies(); // Will throw initializaiton error
+    if (pair < 0 || pair >= pImpl->mPairsN)
+    {
+        RTSEIS_THROW_IA("pair = %d must be in range [0,%d]",
+                        pair, pImpl->mPairsN - 1);
+    }
+    if (nFrequencies != nFreqs)
+    {
+        RTSEIS_THROW_IA("nFrequencies = %d must equal %d",
+                        nFrequencies, nFreqs);
+    }
+    std::complex<double> *csd = *csdIn;
+    if (csd == nullptr){RTSEIS_THROW_IA("%s", "csd is NULL");}
+    if (!haveTransform())
+    {
+        RTSEIS_THROW_RTE("%s", "no segments have been averaged");
+    }
+    auto xscal = pImpl->getDensityScaling();
+    const std::complex<double> *sumCross
+        = &pImpl->mSumCross[static_cast<size_t> (pair)*nFreqs];
+    for (int k=0; k<nFreqs; ++k)
+    {
+        csd[k] = xscal*sumCross[k];
+    }
+}
+
+void CrossSpectrum::getPowerSpectralDensity(const int channel,
+                                            const int nFrequencies,
+                                            double *psdIn[]) const
+{
+    auto nFreqs = getNumberOfFrequencies(); // Will throw initializaiton error
+    if (channel < 0 || channel >= pImpl->mChannels)
+    {
+        RTSEIS_THROW_IA("channel = %d must be in range [0,%d]",
+                        channel, pImpl->mChannels - 1);
+    }
+    if (nFrequencies != nFreqs)
+    {
+        RTSEIS_THROW_IA("nFrequencies = %d must equal %d",
+                        nFrequencies, nFreqs);
+    }
+    double *psd = *psdIn;
+    if (psd == nullptr){RTSEIS_THROW_IA("%s", "psd is NULL");}
+    if (!haveTransform())
+    {
+        RTSEIS_THROW_RTE("%s", "no segments have been averaged");
+    }
+    auto xscal = pImpl->getDensityScaling();
+    ippsMulC_64f(&pImpl->mSumPower[static_cast<size_t> (channel)*nFreqs],
+                 xscal, psd, nFreqs);
+}
+
+void CrossSpectrum::getCoherence(const int pair,
+                                 const int nFrequencies,
+                                 double *coherenceIn[]) const
+{
+    auto nFreqs = getNumberOfFrequencies(); // Will throw initializaiton error
+    if (pair < 0 || pair >= pImpl->mPairsN)
+    {
+        RTSEIS_THROW_IA("pair = %d must be in range [0,%d]",
+                        pair, pImpl->mPairsN - 1);
+    }
+    if (nFrequencies != nFreqs)
+    {
+        RTSEIS_THROW_IA("nFrequencies = %d must equal %d",
+                        nFrequencies, nFreqs);
+    }
+    double *coherence = *coherenceIn;
+    if (coherence == nullptr){RTSEIS_THROW_IA("%s", "coherence is NULL");}
+    if (!haveTransform())
+    {
+        RTSEIS_THROW_RTE("%s", "no segments have been averaged");
+    }
+    // The scaling cancels in the ratio
+    const double *sxx = &pImpl->mSumPower[
+        static_cast<size_t> (pImpl->mPairs[2*pair])*nFreqs];
+    const double *syy = &pImpl->mSumPower[
+        static_cast<size_t> (pImpl->mPairs[2*pair+1])*nFreqs];
+    const std::complex<double> *sxy
+        = &pImpl->mSumCross[static_cast<size_t> (pair)*nFreqs];
+    for (int k=0; k<nFreqs; ++k)
+    {
+        auto den = sxx[k]*syy[k];
+        coherence[k] = 0;
+        if (den > 0)
+        {
+            coherence[k] = std::min(1.0, std::norm(sxy[k])/den);
+        }
+    }
+}
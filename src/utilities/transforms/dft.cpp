@@ -671,8 +671,6 @@ template<class T>
 DFT<T>& DFT<T>::operator=(const DFT &dft)
 {
     if (&dft == this){return *this;}
-    if (pImpl){pImpl->clear();}
-    clear();
     pImpl = std::make_unique<DFTImpl> (*dft.pImpl);
     return *this;
 }
@@ -722,7 +720,7 @@ void DFT<float>::initialize(
     const int length,
     const FourierTransformImplementation implementation)
 {
-    constexpr RTSeis::Precision precision = RTSeis::Precision::DOUBLE;
+    constexpr RTSeis::Precision precision = RTSeis::Precision::FLOAT;
     clear();
     // Check the inputs
     if (length < 2)
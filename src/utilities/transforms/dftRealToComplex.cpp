@@ -665,8 +665,6 @@ DFTRealToComplex<T>&
 DFTRealToComplex<T>::operator=(const DFTRealToComplex &dftr2c)
 {
     if (&dftr2c == this){return *this;}
-    if (pImpl){pImpl->clear();}
-    clear();
     pImpl = std::make_unique<DFTImpl> (*dftr2c.pImpl);
     return *this;
 }
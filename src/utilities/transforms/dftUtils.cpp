@@ -190,6 +190,33 @@ int DFTUtilities::nextPowerOfTwo(const int n)
     return n2;
 }
 
+int DFTUtilities::nextFastLength(const int n)
+{
+    if (n < 0)
+    {
+        RTSEIS_THROW_IA("n=%d cannot be negative", n);
+    }
+    if (n <= 1){return 1;}
+    // For every product of powers of 7, 5, and 3 that does not exceed the
+    // target find the smallest power of 2 that makes the product at least n
+    auto target = static_cast<int64_t> (n);
+    auto best = static_cast<int64_t> (nextPowerOfTwo(n));
+    for (int64_t p7=1; p7<best; p7=p7*7)
+    {
+        for (int64_t p57=p7; p57<best; p57=p57*5)
+        {
+            for (int64_t p357=p57; p357<best; p357=p357*3)
+            {
+                auto length = p357;
+                while (length < target){length = 2*length;}
+                best = std::min(best, length);
+                if (best == target){return n;}
+            }
+        }
+    }
+    return static_cast<int> (best);
+}
+
 /// fftshift
 template<typename T> std::vector<T> 
 RTSeis::Utilities::Transforms::DFTUtilities::fftShift(const std::vector<T> &x)
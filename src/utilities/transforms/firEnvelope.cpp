@@ -1,6 +1,9 @@
 #include <cstdio>
 #include <cstdlib>
 #include <array>
+#include <vector>
+#include <cmath>
+#include <algorithm>
 #include <ipps.h>
 #include "rtseis/utilities/transforms/firEnvelope.hpp"
 #include "rtseis/utilities/filterDesign/fir.hpp"
@@ -26,6 +29,9 @@ public:
         if (&firEnvelope == this){return *this;}
         mRealFIRFilter = firEnvelope.mRealFIRFilter;
         mImagFIRFilter = firEnvelope.mImagFIRFilter;
+        mFoldedTaps = firEnvelope.mFoldedTaps;
+        mDelayLine = firEnvelope.mDelayLine;
+        mInitialConditions = firEnvelope.mInitialConditions;
         mMean = firEnvelope.mMean;
         mNumberOfTaps = firEnvelope.mNumberOfTaps;
         mZeroPhase = firEnvelope.mZeroPhase;
@@ -35,9 +41,100 @@ public:
         mMode = firEnvelope.mMode;
         return *this; 
     }
+    /// Computes the envelope with the type III Hilbert transformer.  The
+    /// real part is a delay of K = ntaps/2 samples.  The imaginary taps,
+    /// h, are antisymmetric about K and zero at even offsets from K so
+    /// that for a window w centered on sample c
+    ///   imag = sum_{m odd} h[K-m] (w[c+m] - w[c-m]).
+    /// Here, w has dimension [n + ntaps - 1] and y has dimension [n].
+    void type3Envelope(const int n, const T w[], T y[]) const
+    {
+        constexpr int chunkSize = 1024;
+        std::array<T, chunkSize> yi;
+        const auto nFolded = static_cast<int> (mFoldedTaps.size());
+        const int groupDelay = mNumberOfTaps/2;
+        for (int ic=0; ic<n; ic=ic+chunkSize)
+        {
+            auto npts = std::min(n - ic, chunkSize);
+            const T *__restrict__ wc = &w[ic + groupDelay];
+            T *__restrict__ yiPtr = yi.data();
+            std::fill(yi.begin(), yi.begin() + npts, 0);
+            for (int j=0; j<nFolded; ++j)
+            {
+                const int m = 2*j + 1;
+                const T h = mFoldedTaps[j];
+                #pragma omp simd
+                for (int i=0; i<npts; ++i)
+                {
+                    yiPtr[i] = yiPtr[i] + h*(wc[i+m] - wc[i-m]);
+                }
+            }
+            T *__restrict__ yPtr = &y[ic];
+            #pragma omp simd
+            for (int i=0; i<npts; ++i)
+            {
+                yPtr[i] = std::sqrt(wc[i]*wc[i] + yiPtr[i]*yiPtr[i]);
+            }
+        }
+    }
+    /// Post-processing type III envelope.  The signal is demeaned and
+    /// padded with K zeros on either side so that the envelope is not
+    /// delayed.
+    void type3PostProcess(const int n, const T x[], const T mean, T y[]) const
+    {
+        const int groupDelay = mNumberOfTaps/2;
+        std::vector<T> w(n + 2*groupDelay, 0);
+        #pragma omp simd
+        for (int i=0; i<n; ++i)
+        {
+            w[groupDelay + i] = x[i] - mean;
+        }
+        type3Envelope(n, w.data(), y);
+        #pragma omp simd
+        for (int i=0; i<n; ++i)
+        {
+            y[i] = y[i] + mean;
+        }
+    }
+    /// Real-time type III envelope.  The delay line holds the previous
+    /// ntaps - 1 samples followed by the current chunk.
+    void type3RealTime(const int n, const T x[], T y[])
+    {
+        const int nHistory = mNumberOfTaps - 1;
+        const int chunkSize = static_cast<int> (mDelayLine.size()) - nHistory;
+        T *delayLine = mDelayLine.data();
+        for (int ic=0; ic<n; ic=ic+chunkSize)
+        {
+            auto npts = std::min(n - ic, chunkSize);
+            std::copy(&x[ic], &x[ic] + npts, &delayLine[nHistory]);
+            type3Envelope(npts, delayLine, &y[ic]);
+            // Retain the most recent samples for the next chunk
+            std::copy(&delayLine[npts], &delayLine[npts] + nHistory,
+                      delayLine);
+        }
+    }
+    /// Sets the type III delay line to the initial conditions
+    void resetType3DelayLine()
+    {
+        constexpr int chunkSize = 1024;
+        mDelayLine.resize(mNumberOfTaps - 1 + chunkSize);
+        std::fill(mDelayLine.begin(), mDelayLine.end(), 0);
+        if (mHaveInitialCondition)
+        {
+            std::copy(mInitialConditions.begin(), mInitialConditions.end(),
+                      mDelayLine.begin());
+        }
+    }
 
     FilterImplementations::FIRFilter<T> mRealFIRFilter;
     FilterImplementations::FIRFilter<T> mImagFIRFilter;
+    /// Type III imaginary taps h[K-m] for odd m = 1, 3, ..., K
+    std::vector<T> mFoldedTaps;
+    /// Type III delay line holding the previous ntaps - 1 samples
+    /// followed by space for the current chunk
+    std::vector<T> mDelayLine;
+    /// Type III initial conditions
+    std::vector<T> mInitialConditions;
     double mMean = 0;
     int mNumberOfTaps = 0;
     bool mZeroPhase = true;
@@ -96,6 +193,9 @@ void FIREnvelope<T>::clear() noexcept
 {
     pImpl->mRealFIRFilter.clear();
     pImpl->mImagFIRFilter.clear();
+    pImpl->mFoldedTaps.clear();
+    pImpl->mDelayLine.clear();
+    pImpl->mInitialConditions.clear();
     pImpl->mMean = 0;
     pImpl->mNumberOfTaps = 0;
     pImpl->mZeroPhase = true;
@@ -134,11 +234,27 @@ void FIREnvelope<T>::initialize(const int ntaps,
     {
         auto zfir = FilterDesign::FIR::HilbertTransformer(ntaps - 1, beta);
         auto rfir = zfir.first.getFilterTaps();
-        pImpl->mRealFIRFilter.initialize(rfir.size(), rfir.data(),
-                                         mode, direct);
         auto cfir = zfir.second.getFilterTaps();
-        pImpl->mImagFIRFilter.initialize(cfir.size(), cfir.data(),
-                                         mode, direct);
+        // The type III real part is a pure delay and only the odd offsets
+        // from the center of the antisymmetric imaginary part are non-zero
+        // so a dedicated kernel avoids two full convolutions
+        if (pImpl->mType3)
+        {
+            int groupDelay = ntaps/2;
+            for (int m=1; m<=groupDelay; m=m+2)
+            {
+                pImpl->mFoldedTaps.push_back(
+                    static_cast<T> (cfir[groupDelay - m]));
+            }
+            pImpl->resetType3DelayLine();
+        }
+        else
+        {
+            pImpl->mRealFIRFilter.initialize(rfir.size(), rfir.data(),
+                                             mode, direct);
+            pImpl->mImagFIRFilter.initialize(cfir.size(), cfir.data(),
+                                             mode, direct);
+        }
     }
     catch (const std::exception &e) 
     {
@@ -157,6 +273,7 @@ int FIREnvelope<T>::getInitialConditionLength() const
     {
         RTSEIS_THROW_RTE("%s", "Envelope class not initialized");
     }
+    if (pImpl->mType3){return pImpl->mNumberOfTaps - 1;}
     return pImpl->mImagFIRFilter.getInitialConditionLength();
 }
 
@@ -173,6 +290,15 @@ void FIREnvelope<T>::setInitialConditions(const int nz, const double zi[])
     {
         RTSEIS_THROW_IA("nz = %d must equal %d", nz, nzRef);
     }
+    if (pImpl->mType3)
+    {
+        if (nz > 0 && zi == nullptr){RTSEIS_THROW_IA("%s", "zi is NULL");}
+        pImpl->mInitialConditions.resize(nz);
+        std::copy(zi, zi + nz, pImpl->mInitialConditions.begin());
+        pImpl->mHaveInitialCondition = true;
+        pImpl->resetType3DelayLine();
+        return;
+    }
     pImpl->mRealFIRFilter.setInitialConditions(nz, zi);
     pImpl->mImagFIRFilter.setInitialConditions(nz, zi);
     pImpl->mHaveInitialCondition = true;
@@ -186,6 +312,11 @@ void FIREnvelope<T>::resetInitialConditions()
     {
         RTSEIS_THROW_RTE("%s", "Envelope class not initialized");
     }
+    if (pImpl->mType3)
+    {
+        pImpl->resetType3DelayLine();
+        return;
+    }
     pImpl->mRealFIRFilter.resetInitialConditions();
     pImpl->mImagFIRFilter.resetInitialConditions();
 }
@@ -213,6 +344,12 @@ void FIREnvelope<double>::transform(const int n, const double x[], double *yIn[]
         double pMean;
         ippsMean_64f(x, n, &pMean);
         pImpl->mMean = pMean;
+        // Type III uses the dedicated kernel
+        if (pImpl->mType3)
+        {
+            pImpl->type3PostProcess(n, x, pMean, y);
+            return;
+        }
         // Remove the mean and pad out the signal
         // N.B. The group delay is actually + 1 but C wants to shift relative to
         // a base address so we subtract the one.  Hence, n/2 instead of n/2+1.
@@ -221,32 +358,24 @@ void FIREnvelope<double>::transform(const int n, const double x[], double *yIn[]
         double *xPad = ippsMalloc_64f(npad);
         ippsSubC_64f(x, pMean, xPad, n);
         ippsZero_64f(&xPad[n], groupDelay); // Post-pad with zeros
-        // Now apply the filter and compute absolute value - Type III
-        if (pImpl->mType3)
-        {
-            double *yPadr = xPad;
-            double *yPadi = ippsMalloc_64f(npad);
-            pImpl->mImagFIRFilter.apply(npad, xPad, &yPadi); 
-            ippsMagnitude_64f(yPadr, &yPadi[groupDelay], y, n);
-            ippsFree(yPadi);
-        }
-        else
-        {
-            double *yPadr = ippsMalloc_64f(npad);
-            pImpl->mRealFIRFilter.apply(npad, xPad, &yPadr);
-            double *yPadi = ippsMalloc_64f(npad);
-            pImpl->mImagFIRFilter.apply(npad, xPad, &yPadi);
-            ippsMagnitude_64f(&yPadr[groupDelay], &yPadi[groupDelay], y, n);
-            ippsFree(yPadr);
-            ippsFree(yPadi);
-        }
+        // Now apply the filter and compute absolute value - Type IV
+        double *yPadr = ippsMalloc_64f(npad);
+        pImpl->mRealFIRFilter.apply(npad, xPad, &yPadr);
+        double *yPadi = ippsMalloc_64f(npad);
+        pImpl->mImagFIRFilter.apply(npad, xPad, &yPadi);
+        ippsMagnitude_64f(&yPadr[groupDelay], &yPadi[groupDelay], y, n);
+        ippsFree(yPadr);
+        ippsFree(yPadi);
         ippsFree(xPad);
         // Reconstitute the mean
         ippsAddC_64f_I(pMean, y, n);
     }
+    else if (pImpl->mType3)
+    {
+        pImpl->type3RealTime(n, x, y);
+    }
     else
     {
-        // TODO - add a sparse FIR filter for the type III case
         constexpr int chunkSize = 1024;
         std::array<double, chunkSize> yrTemp;
         std::array<double, chunkSize> yiTemp;
@@ -284,6 +413,12 @@ void FIREnvelope<float>::transform(const int n, const float x[], float *yIn[])
         float pMean;
         ippsMean_32f(x, n, &pMean, ippAlgHintAccurate);
         pImpl->mMean = pMean;
+        // Type III uses the dedicated kernel
+        if (pImpl->mType3)
+        {
+            pImpl->type3PostProcess(n, x, pMean, y);
+            return;
+        }
         // Remove the mean and pad out the signal
         // N.B. The group delay is actually + 1 but C wants to shift relative to
         // a base address so we subtract the one.  Hence, n/2 instead of n/2+1.
@@ -292,32 +427,24 @@ void FIREnvelope<float>::transform(const int n, const float x[], float *yIn[])
         float *xPad = ippsMalloc_32f(npad);
         ippsSubC_32f(x, pMean, xPad, n);
         ippsZero_32f(&xPad[n], groupDelay); // Post-pad with zeros
-        // Now apply the filter and compute absolute value - Type III
-        if (pImpl->mType3)
-        {
-            float *yPadr = xPad;
-            float *yPadi = ippsMalloc_32f(npad);
-            pImpl->mImagFIRFilter.apply(npad, xPad, &yPadi);
-            ippsMagnitude_32f(yPadr, &yPadi[groupDelay], y, n);
-            ippsFree(yPadi);
-        }
-        else
-        {
-            float *yPadr = ippsMalloc_32f(npad);
-            pImpl->mRealFIRFilter.apply(npad, xPad, &yPadr);
-            float *yPadi = ippsMalloc_32f(npad);
-            pImpl->mImagFIRFilter.apply(npad, xPad, &yPadi);
-            ippsMagnitude_32f(&yPadr[groupDelay], &yPadi[groupDelay], y, n);
-            ippsFree(yPadr);
-            ippsFree(yPadi);
-        }
+        // Now apply the filter and compute absolute value - Type IV
+        float *yPadr = ippsMalloc_32f(npad);
+        pImpl->mRealFIRFilter.apply(npad, xPad, &yPadr);
+        float *yPadi = ippsMalloc_32f(npad);
+        pImpl->mImagFIRFilter.apply(npad, xPad, &yPadi);
+        ippsMagnitude_32f(&yPadr[groupDelay], &yPadi[groupDelay], y, n);
+        ippsFree(yPadr);
+        ippsFree(yPadi);
         ippsFree(xPad);
         // Reconstitute the mean
         ippsAddC_32f_I(pMean, y, n);
     }
+    else if (pImpl->mType3)
+    {
+        pImpl->type3RealTime(n, x, y);
+    }
     else
     {
-        // TODO - add a sparse FIR filter for the type III case
         constexpr int chunkSize = 1024;
         std::array<float, chunkSize> yrTemp;
         std::array<float, chunkSize> yiTemp;
@@ -0,0 +1,366 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include "rtseis/private/throw.hpp"
+#include "rtseis/private/runningSum.hpp"
+#include "rtseis/utilities/transforms/matchedFilter.hpp"
+#include "rtseis/utilities/transforms/dftRealToComplex.hpp"
+#include "rtseis/utilities/transforms/utilities.hpp"
+
+using namespace RTSeis::Utilities::Transforms;
+
+namespace
+{
+/// The running window sums of a demeaned record.
+struct WindowEnergy
+{
+    RTSeis::Private::RunningSum mSum;
+    RTSeis::Private::RunningSum mSumSquared;
+    double mMean = 0;
+    /// Window energies at or below this are treated as dead
+    double mTolerance = 0;
+};
+}
+
+template<class T>
+class MatchedFilter<T>::MatchedFilterImpl
+{
+public:
+    /// Transforms the block of the demeaned record beginning at lag k0 and
+    /// tabulates the reciprocal window norm of each of its lags.
+    void transformBlock(DFTRealToComplex<T> &dft, const int n, const T x[],
+                        const int k0, const int nLags, WindowEnergy &energy,
+                        T work[], std::complex<T> spectrum[],
+                        T scale[]) const
+    {
+        auto mean = energy.mMean;
+        auto nCopy = std::max(0, std::min(mTransformLength, n - k0));
+        for (int i=0; i<nCopy; ++i)
+        {
+            work[i] = static_cast<T> (x[k0 + i] - mean);
+        }
+        std::fill(work + nCopy, work + mTransformLength, 0);
+        dft.forwardTransform(mTransformLength, work,
+                             mFrequencies, &spectrum);
+        // The window of lag k ends at sample k + m - 1.  The first window
+        // is primed with the m - 1 samples preceding its last sample.
+        if (k0 == 0)
+        {
+            for (int i=0; i<mTemplateLength - 1; ++i)
+            {
+                auto xi = x[i] - mean;
+                energy.mSum.push(xi);
+                energy.mSumSquared.push(xi*xi);
+            }
+        }
+        auto k1 = std::min(nLags, k0 + mHop);
+        auto xnorm = 1.0/static_cast<double> (mTemplateLength);
+        for (int k=k0; k<k1; ++k)
+        {
+            auto xi = x[k + mTemplateLength - 1] - mean;
+            energy.mSum.push(xi);
+            energy.mSumSquared.push(xi*xi);
+            auto sum = energy.mSum.getSum();
+            auto e = energy.mSumSquared.getSum() - sum*sum*xnorm;
+            scale[k - k0] = 0;
+            if (e > energy.mTolerance)
+            {
+                scale[k - k0] = static_cast<T> (1.0/std::sqrt(e));
+            }
+        }
+    }
+    /// Correlates the transformed block beginning at lag k0 with the
+    /// it'th template.
+    void correlateBlock(DFTRealToComplex<T> &dft, const int it,
+                        const int k0, const int nLags,
+                        const std::complex<T> blockSpectrum[],
+                        const T scale[],
+                        std::complex<T> product[], T work[], T y[]) const
+    {
+        auto templateSpectrum = mTemplateSpectra.data()
+                              + static_cast<size_t> (it)*mFrequencies;
+        #pragma omp simd
+        for (int i=0; i<mFrequencies; ++i)
+        {
+            product[i] = blockSpectrum[i]*templateSpectrum[i];
+        }
+        dft.inverseTransform(mFrequencies, product,
+                             mTransformLength, &work);
+        auto nCopy = std::min(mHop, nLags - k0);
+        auto yRow = y + static_cast<size_t> (it)*nLags + k0;
+        for (int i=0; i<nCopy; ++i)
+        {
+            yRow[i] = std::min(static_cast<T> (1),
+                      std::max(static_cast<T> (-1), work[i]*scale[i]));
+        }
+    }
+//private:
+    DFTRealToComplex<T> mDFT;
+    /// The conjugate spectra of the unit-norm templates.  This is a row
+    /// major matrix of dimension [nTemplates x mFrequencies].
+    std::vector<std::complex<T>> mTemplateSpectra;
+    int mTemplates = 0;
+    int mTemplateLength = 0;
+    int mTransformLength = 0;
+    int mFrequencies = 0;
+    /// The number of lags computed from each block
+    int mHop = 0;
+    bool mInitialized = false;
+};
+
+/// Constructors
+template<class T>
+MatchedFilter<T>::MatchedFilter() :
+    pImpl(std::make_unique<MatchedFilterImpl> ())
+{
+}
+
+template<class T>
+MatchedFilter<T>::MatchedFilter(const MatchedFilter &filter)
+{
+    *this = filter;
+}
+
+template<class T>
+MatchedFilter<T>::MatchedFilter(MatchedFilter &&filter) noexcept
+{
+    *this = std::move(filter);
+}
+
+/// Operators
+template<class T>
+MatchedFilter<T>& MatchedFilter<T>::operator=(const MatchedFilter &filter)
+{
+    if (&filter == this){return *this;}
+    pImpl = std::make_unique<MatchedFilterImpl> (*filter.pImpl);
+    return *this;
+}
+
+template<class T>
+MatchedFilter<T>&
+MatchedFilter<T>::operator=(MatchedFilter &&filter) noexcept
+{
+    if (&filter == this){return *this;}
+    pImpl = std::move(filter.pImpl);
+    return *this;
+}
+
+/// Destructors
+template<class T>
+MatchedFilter<T>::~MatchedFilter() = default;
+
+template<class T>
+void MatchedFilter<T>::clear() noexcept
+{
+    pImpl = std::make_unique<MatchedFilterImpl> ();
+}
+
+/// Initialization
+template<class T>
+void MatchedFilter<T>::initialize(const int nTemplates,
+                                  const int templateLength,
+                                  const T templates[],
+                                  const int transformLength)
+{
+    clear();
+    if (nTemplates < 1)
+    {
+        RTSEIS_THROW_IA("nTemplates = %d must be positive", nTemplates);
+    }
+    if (templateLength < 2)
+    {
+        RTSEIS_THROW_IA("templateLength = %d must be at least 2",
+                        templateLength);
+    }
+    if (templates == nullptr){RTSEIS_THROW_IA("%s", "templates is NULL");}
+    if (transformLength != 0 && transformLength < templateLength)
+    {
+        RTSEIS_THROW_IA("transformLength = %d must be 0 or at least %d",
+                        transformLength, templateLength);
+    }
+    auto length = transformLength;
+    if (length == 0){length = 4*templateLength;}
+    length = DFTUtilities::nextFastLength(length);
+    pImpl->mDFT.initialize(length, FourierTransformImplementation::DFT);
+    auto nFrequencies = pImpl->mDFT.getTransformLength();
+    // Demean the templates and scale them to unit norm so the
+    // correlations need only be divided by the window norms
+    pImpl->mTemplateSpectra.resize(static_cast<size_t> (nTemplates)
+                                  *nFrequencies);
+    std::vector<T> work(length, 0);
+    for (int it=0; it<nTemplates; ++it)
+    {
+        auto t = templates + static_cast<size_t> (it)*templateLength;
+        double mean = 0;
+        for (int i=0; i<templateLength; ++i){mean = mean + t[i];}
+        mean = mean/templateLength;
+        double norm2 = 0;
+        for (int i=0; i<templateLength; ++i)
+        {
+            norm2 = norm2 + (t[i] - mean)*(t[i] - mean);
+        }
+        if (norm2 <= 0)
+        {
+            clear();
+            RTSEIS_THROW_IA("Template %d is constant", it);
+        }
+        auto xnorm = 1.0/std::sqrt(norm2);
+        for (int i=0; i<templateLength; ++i)
+        {
+            work[i] = static_cast<T> ((t[i] - mean)*xnorm);
+        }
+        auto spectrum = pImpl->mTemplateSpectra.data()
+                      + static_cast<size_t> (it)*nFrequencies;
+        pImpl->mDFT.forwardTransform(length, work.data(),
+                                     nFrequencies, &spectrum);
+        // Correlation is multiplication by the conjugate spectrum
+        for (int i=0; i<nFrequencies; ++i)
+        {
+            spectrum[i] = std::conj(spectrum[i]);
+        }
+    }
+    pImpl->mTemplates = nTemplates;
+    pImpl->mTemplateLength = templateLength;
+    pImpl->mTransformLength = length;
+    pImpl->mFrequencies = nFrequencies;
+    pImpl->mHop = length - templateLength + 1;
+    pImpl->mInitialized = true;
+}
+
+template<class T>
+bool MatchedFilter<T>::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+template<class T>
+int MatchedFilter<T>::getNumberOfTemplates() const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    return pImpl->mTemplates;
+}
+
+template<class T>
+int MatchedFilter<T>::getTemplateLength() const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    return pImpl->mTemplateLength;
+}
+
+template<class T>
+int MatchedFilter<T>::getTransformLength() const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    return pImpl->mTransformLength;
+}
+
+template<class T>
+int MatchedFilter<T>::getOutputLength(const int n) const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    if (n < pImpl->mTemplateLength)
+    {
+        RTSEIS_THROW_IA("n = %d must be at least %d",
+                        n, pImpl->mTemplateLength);
+    }
+    return n - pImpl->mTemplateLength + 1;
+}
+
+/// Correlation
+template<class T>
+void MatchedFilter<T>::correlate(const int n, const T x[], T *yIn[])
+{
+    T *y = *yIn;
+    correlate(1, n, &x, &y);
+}
+
+template<class T>
+void MatchedFilter<T>::correlate(const int nRecords, const int n,
+                                 const T *const x[], T *const y[])
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    if (nRecords < 1)
+    {
+        RTSEIS_THROW_IA("nRecords = %d must be positive", nRecords);
+    }
+    auto nLags = getOutputLength(n); // Throws
+    if (x == nullptr){RTSEIS_THROW_IA("%s", "x is NULL");}
+    if (y == nullptr){RTSEIS_THROW_IA("%s", "y is NULL");}
+    for (int ir=0; ir<nRecords; ++ir)
+    {
+        if (x[ir] == nullptr){RTSEIS_THROW_IA("x[%d] is NULL", ir);}
+        if (y[ir] == nullptr){RTSEIS_THROW_IA("y[%d] is NULL", ir);}
+    }
+    auto templateLength = pImpl->mTemplateLength;
+    auto nTemplates = pImpl->mTemplates;
+    auto transformLength = pImpl->mTransformLength;
+    auto nFrequencies = pImpl->mFrequencies;
+    auto hop = pImpl->mHop;
+    // Remove each record's mean, which does not change the correlation
+    // with a demeaned template, so that the window energies do not suffer
+    // from cancellation.  Windows with less energy than round-off in the
+    // correlation of the record's typical window are dead.
+    std::vector<WindowEnergy> energies(nRecords);
+    for (int ir=0; ir<nRecords; ++ir)
+    {
+        double sum = 0;
+        double sum2 = 0;
+        for (int i=0; i<n; ++i)
+        {
+            sum = sum + x[ir][i];
+            sum2 = sum2 + static_cast<double> (x[ir][i])*x[ir][i];
+        }
+        auto mean = sum/n;
+        auto variance = std::max(0.0, sum2/n - mean*mean);
+        energies[ir].mMean = mean;
+        energies[ir].mTolerance
+            = std::max(std::numeric_limits<double>::min(),
+                       std::numeric_limits<T>::epsilon()
+                      *templateLength*variance);
+        energies[ir].mSum.initialize(templateLength);
+        energies[ir].mSumSquared.initialize(templateLength);
+    }
+    // Each block of every record is transformed once.  The
+    // record-template pairs then share the block spectra.
+    std::vector<std::complex<T>>
+        blockSpectra(static_cast<size_t> (nRecords)*nFrequencies);
+    std::vector<T> scales(static_cast<size_t> (nRecords)*hop);
+    auto nPairs = nRecords*nTemplates;
+    auto nBlocks = (nLags + hop - 1)/hop;
+    #pragma omp parallel shared(blockSpectra, scales, energies)
+    {
+        DFTRealToComplex<T> dft(pImpl->mDFT);
+        std::vector<T> work(transformLength);
+        std::vector<std::complex<T>> product(nFrequencies);
+        for (int block=0; block<nBlocks; ++block)
+        {
+            auto k0 = block*hop;
+            #pragma omp for
+            for (int ir=0; ir<nRecords; ++ir)
+            {
+                pImpl->transformBlock(dft, n, x[ir], k0, nLags,
+                                      energies[ir], work.data(),
+                                      &blockSpectra[ir*nFrequencies],
+                                      &scales[ir*hop]);
+            }
+            #pragma omp for
+            for (int pair=0; pair<nPairs; ++pair)
+            {
+                auto ir = pair/nTemplates;
+                auto it = pair - ir*nTemplates;
+                pImpl->correlateBlock(dft, it, k0, nLags,
+                                      &blockSpectra[ir*nFrequencies],
+                                      &scales[ir*hop],
+                                      product.data(), work.data(), y[ir]);
+            }
+        }
+    }
+}
+
+/// Template instantiation
+template class RTSeis::Utilities::Transforms::MatchedFilter<double>;
+template class RTSeis::Utilities::Transforms::MatchedFilter<float>;
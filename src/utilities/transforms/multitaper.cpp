@@ -0,0 +1,505 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <complex>
+#include <vector>
+#include <algorithm>
+#include <mkl_lapacke.h>
+#include "rtseis/private/throw.hpp"
+#include "rtseis/utilities/transforms/multitaper.hpp"
+#include "rtseis/utilities/transforms/dftRealToComplex.hpp"
+#include "rtseis/utilities/transforms/utilities.hpp"
+
+using namespace RTSeis::Utilities::Transforms;
+
+namespace
+{
+
+/// Computes the first nTapers Slepian tapers by solving for the largest
+/// eigenvalues of the tridiagonal matrix in Percival and Walden (1993),
+/// Eqn 378.  The tapers are returned row major [nTapers x n] with unit
+/// energy and the sign convention of Percival and Walden.
+void computeSlepianTapers(const int n, const double halfBandwidth,
+                          const int nTapers, std::vector<double> *tapers)
+{
+    std::vector<double> d(n), e(std::max(1, n - 1), 0);
+    auto cosw = std::cos(2*M_PI*halfBandwidth);
+    for (int i=0; i<n; ++i)
+    {
+        auto c = 0.5*(n - 1 - 2*i);
+        d[i] = c*c*cosw;
+    }
+    for (int i=0; i<n-1; ++i)
+    {
+        e[i] = 0.5*(i + 1)*(n - i - 1);
+    }
+    // Eigenvalues are returned in ascending order
+    lapack_int m = 0;
+    lapack_int nsplit = 0;
+    std::vector<double> w(n);
+    std::vector<lapack_int> iblock(n), isplit(n);
+    auto info = LAPACKE_dstebz('I', 'B', n, 0, 0, n - nTapers + 1, n, 0,
+                               d.data(), e.data(), &m, &nsplit, w.data(),
+                               iblock.data(), isplit.data());
+    if (info != 0 || m != nTapers)
+    {
+        RTSEIS_THROW_RTE("dstebz failed with info = %d", info);
+    }
+    std::vector<double> z(static_cast<size_t> (n)*nTapers);
+    std::vector<lapack_int> ifail(nTapers);
+    info = LAPACKE_dstein(LAPACK_COL_MAJOR, n, d.data(), e.data(), m,
+                          w.data(), iblock.data(), isplit.data(),
+                          z.data(), n, ifail.data());
+    if (info != 0)
+    {
+        RTSEIS_THROW_RTE("dstein failed with info = %d", info);
+    }
+    tapers->resize(z.size());
+    auto threshold = std::max(1.e-7, 1.0/n);
+    for (int k=0; k<nTapers; ++k)
+    {
+        // The most concentrated taper has the largest eigenvalue
+        const double *v = &z[static_cast<size_t> (nTapers - 1 - k)*n];
+        double *taper = &(*tapers)[static_cast<size_t> (k)*n];
+        double sign = 1;
+        if (k%2 == 0)
+        {
+            // Symmetric tapers have a positive sum
+            double sum = 0;
+            for (int i=0; i<n; ++i){sum = sum + v[i];}
+            if (sum < 0){sign =-1;}
+        }
+        else
+        {
+            // Antisymmetric tapers start with a positive lobe
+            for (int i=0; i<n; ++i)
+            {
+                if (v[i]*v[i] > threshold)
+                {
+                    if (v[i] < 0){sign =-1;}
+                    break;
+                }
+            }
+        }
+        double energy = 0;
+        for (int i=0; i<n; ++i){energy = energy + v[i]*v[i];}
+        auto scale = sign/std::sqrt(energy);
+        for (int i=0; i<n; ++i){taper[i] = scale*v[i];}
+    }
+}
+
+/// Computes the fraction of each taper's energy in [-W, W] from the
+/// taper's autocorrelation, r, as
+/// \f$ \lambda = 2 W r_0 + 2 \sum_{l>0} r_l \sin(2 \pi W l)/(\pi l) \f$.
+void computeConcentrations(const int n, const double halfBandwidth,
+                           const int nTapers, const double tapers[],
+                           std::vector<double> *concentrations)
+{
+    auto length = DFTUtilities::nextFastLength(2*n);
+    DFTRealToComplex<double> dft;
+    dft.initialize(length, FourierTransformImplementation::DFT);
+    auto nBins = dft.getTransformLength();
+    std::vector<std::complex<double>> spectrum(nBins);
+    std::vector<double> r(length);
+    auto spectrumPtr = spectrum.data();
+    auto rPtr = r.data();
+    concentrations->resize(nTapers);
+    for (int k=0; k<nTapers; ++k)
+    {
+        dft.forwardTransform(n, &tapers[static_cast<size_t> (k)*n],
+                             nBins, &spectrumPtr);
+        for (auto &s : spectrum){s = std::norm(s);}
+        dft.inverseTransform(nBins, spectrumPtr, length, &rPtr);
+        auto lambda = 2*halfBandwidth*r[0];
+        for (int l=1; l<n; ++l)
+        {
+            lambda = lambda + 2*r[l]*std::sin(2*M_PI*halfBandwidth*l)/(M_PI*l);
+        }
+        (*concentrations)[k] = std::min(1.0, std::max(0.0, lambda));
+    }
+}
+
+}
+
+template<class T>
+class Multitaper<T>::MultitaperImpl
+{
+public:
+    /// Combines the eigenspectra, stored [nTapers x nFrequencies], into
+    /// the one-sided power spectral density.  The variance is that of the
+    /// demeaned signal.
+    void combine(const T eigenspectra[], const double variance,
+                 T psd[]) const
+    {
+        auto nTapers = mTapersN;
+        std::vector<double> sk(nTapers);
+        for (int f=0; f<mFrequencies; ++f)
+        {
+            for (int k=0; k<nTapers; ++k)
+            {
+                sk[k] = eigenspectra[static_cast<size_t> (k)*mFrequencies + f];
+            }
+            double s = 0;
+            if (mWeighting == MultitaperWeightingType::UNITY)
+            {
+                for (int k=0; k<nTapers; ++k){s = s + sk[k];}
+                s = s/nTapers;
+            }
+            else if (mWeighting == MultitaperWeightingType::EIGENVALUE ||
+                     nTapers == 1)
+            {
+                double wsum = 0;
+                for (int k=0; k<nTapers; ++k)
+                {
+                    s = s + mConcentrations[k]*sk[k];
+                    wsum = wsum + mConcentrations[k];
+                }
+                s = s/wsum;
+            }
+            else
+            {
+                // Percival and Walden (1993) Eqns 369a and 370a.  The
+                // iteration is seeded with the first two eigenspectra.
+                s = 0.5*(sk[0] + sk[1]);
+                for (int iter=0; iter<mMaxIterations; ++iter)
+                {
+                    double num = 0;
+                    double den = 0;
+                    for (int k=0; k<nTapers; ++k)
+                    {
+                        auto lambda = mConcentrations[k];
+                        auto dk = std::sqrt(lambda)*s
+                                 /(lambda*s + (1 - lambda)*variance);
+                        num = num + dk*dk*sk[k];
+                        den = den + dk*dk;
+                    }
+                    auto sNew = (den > 0) ? num/den : 0;
+                    auto converged = std::abs(sNew - s)
+                                  <= mTolerance*std::abs(sNew);
+                    s = sNew;
+                    if (converged){break;}
+                }
+            }
+            // The zero frequency and Nyquist are not doubled
+            auto scale = 2/mSamplingRate;
+            if (f == 0 || (mDFTLength%2 == 0 && f == mFrequencies - 1))
+            {
+                scale = 1/mSamplingRate;
+            }
+            psd[f] = static_cast<T> (scale*s);
+        }
+    }
+//private:
+    DFTRealToComplex<T> mDFT;
+    /// The tapers with unit energy stored [nTapers x nSamples]
+    std::vector<double> mTapers;
+    /// The tapers in the precision of the transform
+    std::vector<T> mTapersT;
+    /// The fraction of each taper's energy in the band [-W, W]
+    std::vector<double> mConcentrations;
+    double mTimeBandwidthProduct = 0;
+    double mSamplingRate = 1;
+    double mTolerance = 1.e-10;
+    MultitaperWeightingType mWeighting = MultitaperWeightingType::ADAPTIVE;
+    int mMaxIterations = 150;
+    int mSamples = 0;
+    int mTapersN = 0;
+    int mDFTLength = 0;
+    int mFrequencies = 0;
+    bool mInitialized = false;
+};
+
+/// Constructors
+template<class T>
+Multitaper<T>::Multitaper() :
+    pImpl(std::make_unique<MultitaperImpl> ())
+{
+}
+
+template<class T>
+Multitaper<T>::Multitaper(const Multitaper &multitaper)
+{
+    *this = multitaper;
+}
+
+template<class T>
+Multitaper<T>::Multitaper(Multitaper &&multitaper) noexcept
+{
+    *this = std::move(multitaper);
+}
+
+/// Operators
+template<class T>
+Multitaper<T>& Multitaper<T>::operator=(const Multitaper &multitaper)
+{
+    if (&multitaper == this){return *this;}
+    pImpl = std::make_unique<MultitaperImpl> (*multitaper.pImpl);
+    return *this;
+}
+
+template<class T>
+Multitaper<T>& Multitaper<T>::operator=(Multitaper &&multitaper) noexcept
+{
+    if (&multitaper == this){return *this;}
+    pImpl = std::move(multitaper.pImpl);
+    return *this;
+}
+
+/// Destructors
+template<class T>
+Multitaper<T>::~Multitaper() = default;
+
+template<class T>
+void Multitaper<T>::clear() noexcept
+{
+    pImpl = std::make_unique<MultitaperImpl> ();
+}
+
+/// Initialization
+template<class T>
+void Multitaper<T>::initialize(const int nSamples,
+                               const double timeBandwidthProduct,
+                               const int nTapersIn,
+                               const double samplingRate,
+                               const MultitaperWeightingType weighting,
+                               const int dftLengthIn)
+{
+    // Hold onto the tapers in case they can be reused
+    auto previous = std::move(pImpl);
+    clear();
+    if (nSamples < 2)
+    {
+        RTSEIS_THROW_IA("nSamples = %d must be at least 2", nSamples);
+    }
+    if (timeBandwidthProduct <= 0 || timeBandwidthProduct >= 0.5*nSamples)
+    {
+        RTSEIS_THROW_IA("timeBandwidthProduct = %lf must be in range (0,%lf)",
+                        timeBandwidthProduct, 0.5*nSamples);
+    }
+    auto nTapers = nTapersIn;
+    if (nTapers < 1)
+    {
+        nTapers = std::max(1, static_cast<int>
+                              (std::floor(2*timeBandwidthProduct)) - 1);
+    }
+    if (nTapers > nSamples)
+    {
+        RTSEIS_THROW_IA("nTapers = %d cannot exceed %d", nTapers, nSamples);
+    }
+    if (samplingRate <= 0)
+    {
+        RTSEIS_THROW_IA("samplingRate = %lf must be positive", samplingRate);
+    }
+    auto dftLength = std::max(nSamples, dftLengthIn);
+    if (previous->mInitialized &&
+        previous->mSamples == nSamples &&
+        previous->mTapersN == nTapers &&
+        previous->mTimeBandwidthProduct == timeBandwidthProduct)
+    {
+        pImpl->mTapers = std::move(previous->mTapers);
+        pImpl->mConcentrations = std::move(previous->mConcentrations);
+    }
+    else
+    {
+        auto halfBandwidth = timeBandwidthProduct/nSamples;
+        computeSlepianTapers(nSamples, halfBandwidth, nTapers,
+                             &pImpl->mTapers);
+        computeConcentrations(nSamples, halfBandwidth, nTapers,
+                              pImpl->mTapers.data(),
+                              &pImpl->mConcentrations);
+    }
+    previous.reset();
+    pImpl->mTapersT.assign(pImpl->mTapers.begin(), pImpl->mTapers.end());
+    pImpl->mDFT.initialize(dftLength, FourierTransformImplementation::DFT);
+    pImpl->mTimeBandwidthProduct = timeBandwidthProduct;
+    pImpl->mSamplingRate = samplingRate;
+    pImpl->mWeighting = weighting;
+    pImpl->mSamples = nSamples;
+    pImpl->mTapersN = nTapers;
+    pImpl->mDFTLength = dftLength;
+    pImpl->mFrequencies = pImpl->mDFT.getTransformLength();
+    pImpl->mInitialized = true;
+}
+
+template<class T>
+bool Multitaper<T>::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+template<class T>
+int Multitaper<T>::getNumberOfSamples() const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    return pImpl->mSamples;
+}
+
+template<class T>
+int Multitaper<T>::getNumberOfTapers() const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    return pImpl->mTapersN;
+}
+
+template<class T>
+int Multitaper<T>::getNumberOfFrequencies() const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    return pImpl->mFrequencies;
+}
+
+template<class T>
+void Multitaper<T>::getFrequencies(const int nFrequencies,
+                                   double *frequencies[]) const
+{
+    auto nFreqs = getNumberOfFrequencies(); // Throws
+    if (nFrequencies != nFreqs)
+    {
+        RTSEIS_THROW_IA("nFrequencies = %d must equal %d",
+                        nFrequencies, nFreqs);
+    }
+    if (*frequencies == nullptr)
+    {
+        RTSEIS_THROW_IA("%s", "frequencies is NULL");
+    }
+    DFTUtilities::realToComplexDFTFrequencies(pImpl->mDFTLength,
+                                              1.0/pImpl->mSamplingRate,
+                                              nFreqs, frequencies);
+}
+
+template<class T>
+void Multitaper<T>::getTapers(const int nTapers, const int nSamples,
+                              double *tapersIn[]) const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    if (nTapers != pImpl->mTapersN)
+    {
+        RTSEIS_THROW_IA("nTapers = %d must equal %d",
+                        nTapers, pImpl->mTapersN);
+    }
+    if (nSamples != pImpl->mSamples)
+    {
+        RTSEIS_THROW_IA("nSamples = %d must equal %d",
+                        nSamples, pImpl->mSamples);
+    }
+    double *tapers = *tapersIn;
+    if (tapers == nullptr){RTSEIS_THROW_IA("%s", "tapers is NULL");}
+    std::copy(pImpl->mTapers.begin(), pImpl->mTapers.end(), tapers);
+}
+
+template<class T>
+void Multitaper<T>::getConcentrations(const int nTapers,
+                                      double *concentrationsIn[]) const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    if (nTapers != pImpl->mTapersN)
+    {
+        RTSEIS_THROW_IA("nTapers = %d must equal %d",
+                        nTapers, pImpl->mTapersN);
+    }
+    double *concentrations = *concentrationsIn;
+    if (concentrations == nullptr)
+    {
+        RTSEIS_THROW_IA("%s", "concentrations is NULL");
+    }
+    std::copy(pImpl->mConcentrations.begin(), pImpl->mConcentrations.end(),
+              concentrations);
+}
+
+/// Power spectral density
+template<class T>
+void Multitaper<T>::transform(const int nSamples, const T x[],
+                              const int nFrequencies, T *psd[])
+{
+    transform(1, nSamples, x, nFrequencies, psd);
+}
+
+template<class T>
+void Multitaper<T>::transform(const int nChannels, const int nSamples,
+                              const T x[], const int nFrequencies,
+                              T *psdIn[])
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    if (nChannels < 1)
+    {
+        RTSEIS_THROW_IA("nChannels = %d must be positive", nChannels);
+    }
+    if (nSamples != pImpl->mSamples)
+    {
+        RTSEIS_THROW_IA("nSamples = %d must equal %d",
+                        nSamples, pImpl->mSamples);
+    }
+    if (nFrequencies != pImpl->mFrequencies)
+    {
+        RTSEIS_THROW_IA("nFrequencies = %d must equal %d",
+                        nFrequencies, pImpl->mFrequencies);
+    }
+    if (x == nullptr){RTSEIS_THROW_IA("%s", "x is NULL");}
+    T *psd = *psdIn;
+    if (psd == nullptr){RTSEIS_THROW_IA("%s", "psd is NULL");}
+    auto nTapers = pImpl->mTapersN;
+    auto nSpectra = nChannels*nTapers;
+    std::vector<T> eigenspectra(static_cast<size_t> (nSpectra)*nFrequencies);
+    // Remove each channel's mean so that a DC offset does not leak into the
+    // low frequencies or bias the adaptive weights
+    std::vector<double> means(nChannels);
+    for (int channel=0; channel<nChannels; ++channel)
+    {
+        const T *xc = &x[static_cast<size_t> (channel)*nSamples];
+        double sum = 0;
+        for (int i=0; i<nSamples; ++i){sum = sum + xc[i];}
+        means[channel] = sum/nSamples;
+    }
+    // Every (channel, taper) pair is an independent tapered transform
+    #pragma omp parallel shared(eigenspectra, means)
+    {
+        DFTRealToComplex<T> dft(pImpl->mDFT);
+        std::vector<T> work(nSamples);
+        std::vector<std::complex<T>> spectrum(nFrequencies);
+        auto workPtr = work.data();
+        auto spectrumPtr = spectrum.data();
+        #pragma omp for
+        for (int ik=0; ik<nSpectra; ++ik)
+        {
+            auto channel = ik/nTapers;
+            auto k = ik - channel*nTapers;
+            const T *xc = &x[static_cast<size_t> (channel)*nSamples];
+            const T *taper = &pImpl->mTapersT[static_cast<size_t> (k)*nSamples];
+            auto mean = static_cast<T> (means[channel]);
+            #pragma omp simd
+            for (int i=0; i<nSamples; ++i)
+            {
+                workPtr[i] = taper[i]*(xc[i] - mean);
+            }
+            dft.forwardTransform(nSamples, workPtr,
+                                 nFrequencies, &spectrumPtr);
+            T *sk = &eigenspectra[static_cast<size_t> (ik)*nFrequencies];
+            #pragma omp simd
+            for (int f=0; f<nFrequencies; ++f)
+            {
+                sk[f] = std::norm(spectrumPtr[f]);
+            }
+        }
+        #pragma omp for
+        for (int channel=0; channel<nChannels; ++channel)
+        {
+            const T *xc = &x[static_cast<size_t> (channel)*nSamples];
+            auto mean = means[channel];
+            double variance = 0;
+            for (int i=0; i<nSamples; ++i)
+            {
+                auto dx = xc[i] - mean;
+                variance = variance + dx*dx;
+            }
+            variance = variance/nSamples;
+            pImpl->combine(&eigenspectra[static_cast<size_t> (channel)
+                                        *nTapers*nFrequencies],
+                           variance,
+                           &psd[static_cast<size_t> (channel)*nFrequencies]);
+        }
+    }
+}
+
+/// Template instantiation
+template class RTSeis::Utilities::Transforms::Multitaper<double>;
+template class RTSeis::Utilities::Transforms::Multitaper<float>;
@@ -0,0 +1,463 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <ipps.h>
+#include "rtseis/private/throw.hpp"
+#include "rtseis/utilities/transforms/ppsd.hpp"
+#include "rtseis/utilities/transforms/welch.hpp"
+#include "rtseis/utilities/transforms/slidingWindowRealDFTParameters.hpp"
+
+using namespace RTSeis::Utilities::Transforms;
+
+namespace
+{
+
+const char SERIALIZATION_MAGIC[4] = {'P', 'P', 'S', 'D'};
+const int32_t SERIALIZATION_VERSION = 1;
+
+template<typename T>
+void pack(const T &value, std::vector<char> &data)
+{
+    auto p = reinterpret_cast<const char *> (&value);
+    data.insert(data.end(), p, p + sizeof(T));
+}
+
+template<typename T>
+T unpack(const std::vector<char> &data, size_t &offset)
+{
+    if (offset + sizeof(T) > data.size())
+    {
+        RTSEIS_THROW_IA("%s", "Serialized data is truncated");
+    }
+    T value;
+    std::memcpy(&value, data.data() + offset, sizeof(T));
+    offset = offset + sizeof(T);
+    return value;
+}
+
+bool isClose(const double a, const double b)
+{
+    return std::abs(a - b) <= 1.e-10*std::max(1.0, std::abs(a));
+}
+
+}
+
+class PPSD::PPSDImpl
+{
+public:
+    /// Checks that another histogram's bins match this histogram's bins
+    bool binsMatch(const std::vector<double> &periods,
+                   const int nBins, const double minimumDecibel,
+                   const double decibelBinWidth) const
+    {
+        if (periods.size() != mPeriods.size()){return false;}
+        if (nBins != mDecibelBins){return false;}
+        if (!isClose(minimumDecibel, mMinimumDecibel)){return false;}
+        if (!isClose(decibelBinWidth, mDecibelBinWidth)){return false;}
+        for (size_t i=0; i<periods.size(); ++i)
+        {
+            if (!isClose(periods[i], mPeriods[i])){return false;}
+        }
+        return true;
+    }
+    /// Smooths the current Welch estimate into octave bands and bins it
+    void binSegment()
+    {
+        auto nFrequencies = static_cast<int> (mPSD.size());
+        double *psdPtr = mPSD.data();
+        mWelch.getPowerSpectralDensity(nFrequencies, &psdPtr);
+        auto nPeriods = static_cast<int> (mPeriods.size());
+        for (int i=0; i<nPeriods; ++i)
+        {
+            auto i1 = mBandStart[i];
+            auto nAvg = mBandEnd[i] - i1;
+            double sum;
+            ippsSum_64f(&psdPtr[i1], nAvg, &sum);
+            auto average = sum/static_cast<double> (nAvg);
+            // Powers outside of the decibel range are discarded rather than
+            // piled into the edge bins
+            if (average <= 0){continue;}
+            auto dB = 10*std::log10(average);
+            auto fBin = std::floor((dB - mMinimumDecibel)/mDecibelBinWidth);
+            if (fBin < 0 || fBin >= mDecibelBins){continue;}
+            auto bin = static_cast<int> (fBin);
+            mCounts[static_cast<size_t> (i)*mDecibelBins + bin] += 1;
+        }
+        mSegments = mSegments + 1;
+    }
+//private:
+    class Welch mWelch;
+    /// The period centers
+    std::vector<double> mPeriods;
+    /// The band corresponding to the i'th period is
+    /// [mBandStart[i], mBandEnd[i]) in the Welch frequencies
+    std::vector<int> mBandStart;
+    std::vector<int> mBandEnd;
+    /// Holds the current segment's PSD
+    std::vector<double> mPSD;
+    /// The histogram stored row major [nPeriods x mDecibelBins]
+    std::vector<uint32_t> mCounts;
+    int64_t mSegments = 0;
+    double mMinimumDecibel = 0;
+    double mDecibelBinWidth = 1;
+    int mDecibelBins = 0;
+    int mSegmentLength = 0;
+    int mSegmentOverlap = 0;
+    bool mInitialized = false;
+};
+
+/// Constructors
+PPSD::PPSD() :
+    pImpl(std::make_unique<PPSDImpl> ())
+{
+}
+
+PPSD::PPSD(const PPSD &ppsd)
+{
+    *this = ppsd;
+}
+
+PPSD::PPSD(PPSD &&ppsd) noexcept
+{
+    *this = std::move(ppsd);
+}
+
+/// Operators
+PPSD& PPSD::operator=(const PPSD &ppsd)
+{
+    if (&ppsd == this){return *this;}
+    if (pImpl){pImpl.reset();}
+    pImpl = std::make_unique<PPSDImpl> (*ppsd.pImpl);
+    return *this;
+}
+
+PPSD& PPSD::operator=(PPSD &&ppsd) noexcept
+{
+    if (&ppsd == this){return *this;}
+    pImpl = std::move(ppsd.pImpl);
+    return *this;
+}
+
+/// Destructor
+PPSD::~PPSD() = default;
+
+/// Clears memory
+void PPSD::clear() noexcept
+{
+    pImpl = std::make_unique<PPSDImpl> ();
+}
+
+/// Initialize
+void PPSD::initialize(const SlidingWindowRealDFTParameters &parameters,
+                      const int segmentLength,
+                      const int nSamplesInSegmentOverlap,
+                      const double minimumPeriod,
+                      const double maximumPeriod,
+                      const double minimumDecibel,
+                      const double maximumDecibel,
+                      const double decibelBinWidth,
+                      const int nPeriodsPerOctave,
+                      const double samplingRate)
+{
+    clear();
+    // The segment length is the number of samples given to Welch
+    SlidingWindowRealDFTParameters welchParameters(parameters);
+    if (segmentLength > 0){welchParameters.setNumberOfSamples(segmentLength);}
+    if (!welchParameters.isValid())
+    {
+        RTSEIS_THROW_IA("%s", "parameters are not valid");
+    }
+    if (segmentLength < welchParameters.getWindowLength())
+    {
+        RTSEIS_THROW_IA("segmentLength = %d must be at least %d",
+                        segmentLength, welchParameters.getWindowLength());
+    }
+    if (nSamplesInSegmentOverlap < 0 ||
+        nSamplesInSegmentOverlap >= segmentLength)
+    {
+        RTSEIS_THROW_IA("nSamplesInSegmentOverlap = %d must be in [0,%d]",
+                        nSamplesInSegmentOverlap, segmentLength - 1);
+    }
+    if (minimumPeriod <= 0)
+    {
+        RTSEIS_THROW_IA("minimumPeriod = %lf must be positive", minimumPeriod);
+    }
+    if (maximumPeriod < minimumPeriod)
+    {
+        RTSEIS_THROW_IA("maximumPeriod = %lf must be at least %lf",
+                        maximumPeriod, minimumPeriod);
+    }
+    if (decibelBinWidth <= 0)
+    {
+        RTSEIS_THROW_IA("decibelBinWidth = %lf must be positive",
+                        decibelBinWidth);
+    }
+    if (maximumDecibel <= minimumDecibel)
+    {
+        RTSEIS_THROW_IA("maximumDecibel = %lf must exceed %lf",
+                        maximumDecibel, minimumDecibel);
+    }
+    if (nPeriodsPerOctave < 1)
+    {
+        RTSEIS_THROW_IA("nPeriodsPerOctave = %d must be positive",
+                        nPeriodsPerOctave);
+    }
+    if (samplingRate <= 0)
+    {
+        RTSEIS_THROW_IA("samplingRate = %lf must be positive", samplingRate);
+    }
+    // Initialize Welch on a segment
+    pImpl->mWelch.initialize(welchParameters, samplingRate);
+    auto nFrequencies = pImpl->mWelch.getNumberOfFrequencies();
+    std::vector<double> frequencies(nFrequencies);
+    double *fPtr = frequencies.data();
+    pImpl->mWelch.getFrequencies(nFrequencies, &fPtr);
+    // Tabulate the period centers and their full-octave bands
+    const double sqrt2 = std::sqrt(2.0);
+    for (int i=0; ; ++i)
+    {
+        auto exponent = static_cast<double> (i)/nPeriodsPerOctave;
+        auto period = minimumPeriod*std::pow(2.0, exponent);
+        if (period > maximumPeriod*(1 + 1.e-12)){break;}
+        auto fLow = 1.0/(period*sqrt2);
+        auto fHigh = sqrt2/period;
+        auto i1 = static_cast<int> (std::lower_bound(frequencies.begin(),
+                                                     frequencies.end(), fLow)
+                                  - frequencies.begin());
+        auto i2 = static_cast<int> (std::upper_bound(frequencies.begin(),
+                                                     frequencies.end(), fHigh)
+                                  - frequencies.begin());
+        // The band must lie within the resolvable, non-zero frequencies
+        // so that it is not silently truncated at DC or Nyquist
+        if (fLow < frequencies[1]*(1 - 1.e-12) ||
+            fHigh > frequencies[nFrequencies - 1]*(1 + 1.e-12))
+        {
+            clear();
+            RTSEIS_THROW_IA("Octave band [%lf,%lf] Hz at period %lf "
+                            "exceeds the frequencies [%lf,%lf] Hz",
+                            fLow, fHigh, period,
+                            frequencies[1], frequencies[nFrequencies - 1]);
+        }
+        if (i2 <= i1)
+        {
+            clear();
+            RTSEIS_THROW_IA("No frequencies in octave band at period %lf",
+                            period);
+        }
+        pImpl->mPeriods.push_back(period);
+        pImpl->mBandStart.push_back(i1);
+        pImpl->mBandEnd.push_back(i2);
+    }
+    // Set space for the histogram
+    pImpl->mDecibelBins = static_cast<int>
+        (std::ceil((maximumDecibel - minimumDecibel)/decibelBinWidth - 1.e-10));
+    pImpl->mDecibelBins = std::max(1, pImpl->mDecibelBins);
+    pImpl->mMinimumDecibel = minimumDecibel;
+    pImpl->mDecibelBinWidth = decibelBinWidth;
+    pImpl->mCounts.resize(pImpl->mPeriods.size()*pImpl->mDecibelBins, 0);
+    pImpl->mPSD.resize(nFrequencies);
+    pImpl->mSegmentLength = segmentLength;
+    pImpl->mSegmentOverlap = nSamplesInSegmentOverlap;
+    pImpl->mSegments = 0;
+    pImpl->mInitialized = true;
+}
+
+bool PPSD::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+/// Process data
+int PPSD::update(const int nSamples, const double x[])
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    if (nSamples < pImpl->mSegmentLength){return 0;}
+    if (x == nullptr){RTSEIS_THROW_IA("%s", "x is NULL");}
+    auto segmentLength = pImpl->mSegmentLength;
+    auto nHop = segmentLength - pImpl->mSegmentOverlap;
+    int nSegments = 0;
+    for (int i1=0; i1 + segmentLength <= nSamples; i1 = i1 + nHop)
+    {
+        pImpl->mWelch.transform(segmentLength, &x[i1]);
+        pImpl->binSegment();
+        nSegments = nSegments + 1;
+    }
+    return nSegments;
+}
+
+/// Merge histograms
+void PPSD::merge(const PPSD &ppsd)
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    if (!ppsd.isInitialized())
+    {
+        RTSEIS_THROW_IA("%s", "ppsd is not initialized");
+    }
+    if (!pImpl->binsMatch(ppsd.pImpl->mPeriods, ppsd.pImpl->mDecibelBins,
+                          ppsd.pImpl->mMinimumDecibel,
+                          ppsd.pImpl->mDecibelBinWidth))
+    {
+        RTSEIS_THROW_IA("%s", "ppsd bins do not match");
+    }
+    auto nCounts = pImpl->mCounts.size();
+    uint32_t *counts = pImpl->mCounts.data();
+    const uint32_t *countsMerge = ppsd.pImpl->mCounts.data();
+    #pragma omp simd
+    for (size_t i=0; i<nCounts; ++i)
+    {
+        counts[i] = counts[i] + countsMerge[i];
+    }
+    pImpl->mSegments = pImpl->mSegments + ppsd.pImpl->mSegments;
+}
+
+void PPSD::resetHistogram()
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    std::fill(pImpl->mCounts.begin(), pImpl->mCounts.end(), 0);
+    pImpl->mSegments = 0;
+}
+
+int64_t PPSD::getNumberOfSegments() const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    return pImpl->mSegments;
+}
+
+/// Bins
+int PPSD::getNumberOfPeriods() const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    return static_cast<int> (pImpl->mPeriods.size());
+}
+
+void PPSD::getPeriods(const int nPeriods, double *periodsIn[]) const
+{
+    auto nPeriodsRef = getNumberOfPeriods(); // Throws
+    if (nPeriods != nPeriodsRef)
+    {
+        RTSEIS_THROW_IA("nPeriods = %d must equal %d", nPeriods, nPeriodsRef);
+    }
+    double *periods = *periodsIn;
+    if (periods == nullptr){RTSEIS_THROW_IA("%s", "periods is NULL");}
+    ippsCopy_64f(pImpl->mPeriods.data(), periods, nPeriods);
+}
+
+int PPSD::getNumberOfDecibelBins() const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    return pImpl->mDecibelBins;
+}
+
+void PPSD::getDecibelBins(const int nBins, double *decibelsIn[]) const
+{
+    auto nBinsRef = getNumberOfDecibelBins(); // Throws
+    if (nBins != nBinsRef)
+    {
+        RTSEIS_THROW_IA("nBins = %d must equal %d", nBins, nBinsRef);
+    }
+    double *decibels = *decibelsIn;
+    if (decibels == nullptr){RTSEIS_THROW_IA("%s", "decibels is NULL");}
+    for (int i=0; i<nBins; ++i)
+    {
+        decibels[i] = pImpl->mMinimumDecibel
+                    + (i + 0.5)*pImpl->mDecibelBinWidth;
+    }
+}
+
+/// Histograms
+void PPSD::getHistogram(const int nPeriods, const int nBins,
+                        uint32_t *countsIn[]) const
+{
+    auto nPeriodsRef = getNumberOfPeriods(); // Throws
+    if (nPeriods != nPeriodsRef || nBins != pImpl->mDecibelBins)
+    {
+        RTSEIS_THROW_IA("Histogram must be %d x %d",
+                        nPeriodsRef, pImpl->mDecibelBins);
+    }
+    uint32_t *counts = *countsIn;
+    if (counts == nullptr){RTSEIS_THROW_IA("%s", "counts is NULL");}
+    std::copy(pImpl->mCounts.begin(), pImpl->mCounts.end(), counts);
+}
+
+void PPSD::getProbabilityDensityFunction(const int nPeriods, const int nBins,
+                                         double *pdfIn[]) const
+{
+    auto nPeriodsRef = getNumberOfPeriods(); // Throws
+    if (nPeriods != nPeriodsRef || nBins != pImpl->mDecibelBins)
+    {
+        RTSEIS_THROW_IA("pdf must be %d x %d",
+                        nPeriodsRef, pImpl->mDecibelBins);
+    }
+    double *pdf = *pdfIn;
+    if (pdf == nullptr){RTSEIS_THROW_IA("%s", "pdf is NULL");}
+    for (int i=0; i<nPeriods; ++i)
+    {
+        const uint32_t *counts = &pImpl->mCounts[static_cast<size_t> (i)*nBins];
+        double *pdfRow = &pdf[static_cast<size_t> (i)*nBins];
+        double total = 0;
+        for (int j=0; j<nBins; ++j){total = total + counts[j];}
+        auto xnorm = (total > 0) ? 1.0/total : 0.0;
+        for (int j=0; j<nBins; ++j){pdfRow[j] = counts[j]*xnorm;}
+    }
+}
+
+/// Serialization
+std::vector<char> PPSD::serialize() const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    std::vector<char> data;
+    data.reserve(64 + 8*pImpl->mPeriods.size() + 4*pImpl->mCounts.size());
+    data.insert(data.end(), SERIALIZATION_MAGIC, SERIALIZATION_MAGIC + 4);
+    pack(SERIALIZATION_VERSION, data);
+    pack(static_cast<int32_t> (pImpl->mPeriods.size()), data);
+    pack(static_cast<int32_t> (pImpl->mDecibelBins), data);
+    pack(pImpl->mMinimumDecibel, data);
+    pack(pImpl->mDecibelBinWidth, data);
+    pack(pImpl->mSegments, data);
+    for (const auto &period : pImpl->mPeriods){pack(period, data);}
+    for (const auto &count : pImpl->mCounts){pack(count, data);}
+    return data;
+}
+
+void PPSD::deserialize(const std::vector<char> &data)
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    if (data.size() < 4 ||
+        !std::equal(SERIALIZATION_MAGIC, SERIALIZATION_MAGIC + 4, data.begin()))
+    {
+        RTSEIS_THROW_IA("%s", "data is not a serialized PPSD");
+    }
+    size_t offset = 4;
+    auto version = unpack<int32_t> (data, offset);
+    if (version != SERIALIZATION_VERSION)
+    {
+        RTSEIS_THROW_IA("Unsupported serialization version %d", version);
+    }
+    auto nPeriods = unpack<int32_t> (data, offset);
+    auto nBins = unpack<int32_t> (data, offset);
+    auto minimumDecibel = unpack<double> (data, offset);
+    auto decibelBinWidth = unpack<double> (data, offset);
+    auto nSegments = unpack<int64_t> (data, offset);
+    if (nPeriods < 0 || nBins < 0)
+    {
+        RTSEIS_THROW_IA("%s", "Invalid histogram dimensions");
+    }
+    std::vector<double> periods(nPeriods);
+    for (auto &period : periods){period = unpack<double> (data, offset);}
+    if (!pImpl->binsMatch(periods, nBins, minimumDecibel, decibelBinWidth))
+    {
+        RTSEIS_THROW_IA("%s", "Serialized bins do not match");
+    }
+    auto nCounts = pImpl->mCounts.size();
+    if (offset + nCounts*sizeof(uint32_t) != data.size())
+    {
+        RTSEIS_THROW_IA("%s", "Serialized histogram has wrong size");
+    }
+    std::memcpy(pImpl->mCounts.data(), data.data() + offset,
+                nCounts*sizeof(uint32_t));
+    pImpl->mSegments = nSegments;
+}
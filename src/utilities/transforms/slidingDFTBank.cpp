@@ -0,0 +1,369 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <complex>
+#include <algorithm>
+#include "rtseis/private/throw.hpp"
+#include "rtseis/utilities/transforms/slidingDFTBank.hpp"
+
+using namespace RTSeis::Utilities::Transforms;
+
+template<class T>
+class SlidingDFTBank<T>::SlidingDFTBankImpl
+{
+public:
+    /// Zeros the state
+    void reset()
+    {
+        std::fill(mXRe.begin(), mXRe.end(), 0);
+        std::fill(mXIm.begin(), mXIm.end(), 0);
+        std::fill(mZRe.begin(), mZRe.end(), 0);
+        std::fill(mZIm.begin(), mZIm.end(), 0);
+        std::fill(mQRe.begin(), mQRe.end(), 1);
+        std::fill(mQIm.begin(), mQIm.end(), 0);
+        std::fill(mBuffer.begin(), mBuffer.end(), 0);
+        mPosition = 0;
+    }
+    /// Updates the transforms.  If y is not NULL then the transforms are
+    /// written after every sample.
+    void update(const int nSamples, const T x[], std::complex<T> y[])
+    {
+        const int nf = mFrequencies;
+        const T *__restrict__ aRe = mARe.data();
+        const T *__restrict__ aIm = mAIm.data();
+        const T *__restrict__ bRe = mBRe.data();
+        const T *__restrict__ bIm = mBIm.data();
+        const T *__restrict__ wRe = mWRe.data();
+        const T *__restrict__ wIm = mWIm.data();
+        T *__restrict__ qRe = mQRe.data();
+        T *__restrict__ qIm = mQIm.data();
+        for (int i=0; i<nSamples; ++i)
+        {
+            for (int c=0; c<mChannels; ++c)
+            {
+                const T xNew = x[static_cast<size_t> (c)*nSamples + i];
+                T *buffer = &mBuffer[static_cast<size_t> (c)*mWindowLength];
+                const T xOld = buffer[mPosition];
+                buffer[mPosition] = xNew;
+                auto offset = static_cast<size_t> (c)*nf;
+                T *__restrict__ xRe = &mXRe[offset];
+                T *__restrict__ xIm = &mXIm[offset];
+                T *__restrict__ zRe = &mZRe[offset];
+                T *__restrict__ zIm = &mZIm[offset];
+                #pragma omp simd
+                for (int k=0; k<nf; ++k)
+                {
+                    // X = e^{i w} (X - x[n-N]) + e^{-i w (N-1)} x[n]
+                    auto dRe = xRe[k] - xOld;
+                    auto re = aRe[k]*dRe - aIm[k]*xIm[k] + bRe[k]*xNew;
+                    auto im = aRe[k]*xIm[k] + aIm[k]*dRe + bIm[k]*xNew;
+                    xRe[k] = re;
+                    xIm[k] = im;
+                    // Non-recursive sum over the current window
+                    zRe[k] = zRe[k] + qRe[k]*xNew;
+                    zIm[k] = zIm[k] + qIm[k]*xNew;
+                }
+            }
+            // Advance the phasor for the non-recursive sum
+            #pragma omp simd
+            for (int k=0; k<nf; ++k)
+            {
+                auto re = qRe[k]*wRe[k] - qIm[k]*wIm[k];
+                auto im = qRe[k]*wIm[k] + qIm[k]*wRe[k];
+                qRe[k] = re;
+                qIm[k] = im;
+            }
+            mPosition = mPosition + 1;
+            // The non-recursive sum now spans the window so replace the
+            // recursive estimate and start the next window
+            if (mPosition == mWindowLength)
+            {
+                std::copy(mZRe.begin(), mZRe.end(), mXRe.begin());
+                std::copy(mZIm.begin(), mZIm.end(), mXIm.begin());
+                std::fill(mZRe.begin(), mZRe.end(), 0);
+                std::fill(mZIm.begin(), mZIm.end(), 0);
+                std::fill(mQRe.begin(), mQRe.end(), 1);
+                std::fill(mQIm.begin(), mQIm.end(), 0);
+                mPosition = 0;
+            }
+            if (y)
+            {
+                for (int c=0; c<mChannels; ++c)
+                {
+                    auto offset = static_cast<size_t> (c)*nf;
+                    std::complex<T> *yPtr
+                        = &y[(static_cast<size_t> (c)*nSamples + i)*nf];
+                    for (int k=0; k<nf; ++k)
+                    {
+                        yPtr[k] = std::complex<T> (mXRe[offset + k],
+                                                   mXIm[offset + k]);
+                    }
+                }
+            }
+        }
+    }
+//private:
+    /// The transforms stored [nChannels x nFrequencies]
+    std::vector<T> mXRe;
+    std::vector<T> mXIm;
+    /// The non-recursive sums over the current window
+    std::vector<T> mZRe;
+    std::vector<T> mZIm;
+    /// The phasor e^{-i w m} for the non-recursive sum at the current
+    /// position m in the window
+    std::vector<T> mQRe;
+    std::vector<T> mQIm;
+    /// e^{i w}
+    std::vector<T> mARe;
+    std::vector<T> mAIm;
+    /// e^{-i w (N-1)}
+    std::vector<T> mBRe;
+    std::vector<T> mBIm;
+    /// e^{-i w}
+    std::vector<T> mWRe;
+    std::vector<T> mWIm;
+    /// The samples in the window stored [nChannels x windowLength]
+    std::vector<T> mBuffer;
+    int mWindowLength = 0;
+    int mFrequencies = 0;
+    int mChannels = 0;
+    /// Position in the circular buffer.  Since the samples are written in
+    /// order this is also the position in the non-recursive sum's window.
+    int mPosition = 0;
+    bool mInitialized = false;
+};
+
+/// Constructors
+template<class T>
+SlidingDFTBank<T>::SlidingDFTBank() :
+    pImpl(std::make_unique<SlidingDFTBankImpl> ())
+{
+}
+
+template<class T>
+SlidingDFTBank<T>::SlidingDFTBank(const SlidingDFTBank &bank)
+{
+    *this = bank;
+}
+
+template<class T>
+SlidingDFTBank<T>::SlidingDFTBank(SlidingDFTBank &&bank) noexcept
+{
+    *this = std::move(bank);
+}
+
+/// Operators
+template<class T>
+SlidingDFTBank<T>& SlidingDFTBank<T>::operator=(const SlidingDFTBank &bank)
+{
+    if (&bank == this){return *this;}
+    pImpl = std::make_unique<SlidingDFTBankImpl> (*bank.pImpl);
+    return *this;
+}
+
+template<class T>
+SlidingDFTBank<T>& SlidingDFTBank<T>::operator=(SlidingDFTBank &&bank) noexcept
+{
+    if (&bank == this){return *this;}
+    pImpl = std::move(bank.pImpl);
+    return *this;
+}
+
+/// Destructors
+template<class T>
+SlidingDFTBank<T>::~SlidingDFTBank() = default;
+
+template<class T>
+void SlidingDFTBank<T>::clear() noexcept
+{
+    pImpl = std::make_unique<SlidingDFTBankImpl> ();
+}
+
+/// Initialization
+template<class T>
+void SlidingDFTBank<T>::initialize(const int windowLength,
+                                   const int nFrequencies,
+                                   const double frequencies[],
+                                   const double samplingRate,
+                                   const int nChannels)
+{
+    clear();
+    if (windowLength < 1)
+    {
+        RTSEIS_THROW_IA("windowLength = %d must be positive", windowLength);
+    }
+    if (nFrequencies < 1)
+    {
+        RTSEIS_THROW_IA("nFrequencies = %d must be positive", nFrequencies);
+    }
+    if (frequencies == nullptr)
+    {
+        RTSEIS_THROW_IA("%s", "frequencies is NULL");
+    }
+    if (samplingRate <= 0)
+    {
+        RTSEIS_THROW_IA("samplingRate = %lf must be positive", samplingRate);
+    }
+    if (nChannels < 1)
+    {
+        RTSEIS_THROW_IA("nChannels = %d must be positive", nChannels);
+    }
+    auto nyquist = samplingRate/2;
+    for (int k=0; k<nFrequencies; ++k)
+    {
+        if (frequencies[k] < 0 || frequencies[k] > nyquist)
+        {
+            RTSEIS_THROW_IA("frequencies[%d] = %lf must be in range [0,%lf]",
+                            k, frequencies[k], nyquist);
+        }
+    }
+    pImpl->mARe.resize(nFrequencies);
+    pImpl->mAIm.resize(nFrequencies);
+    pImpl->mBRe.resize(nFrequencies);
+    pImpl->mBIm.resize(nFrequencies);
+    pImpl->mWRe.resize(nFrequencies);
+    pImpl->mWIm.resize(nFrequencies);
+    for (int k=0; k<nFrequencies; ++k)
+    {
+        auto omega = 2*M_PI*frequencies[k]/samplingRate;
+        auto phiN = omega*(windowLength - 1);
+        pImpl->mARe[k] = static_cast<T> (std::cos(omega));
+        pImpl->mAIm[k] = static_cast<T> (std::sin(omega));
+        pImpl->mBRe[k] = static_cast<T> (std::cos(phiN));
+        pImpl->mBIm[k] = static_cast<T> (-std::sin(phiN));
+        pImpl->mWRe[k] = static_cast<T> (std::cos(omega));
+        pImpl->mWIm[k] = static_cast<T> (-std::sin(omega));
+    }
+    auto nValues = static_cast<size_t> (nChannels)*nFrequencies;
+    pImpl->mXRe.resize(nValues);
+    pImpl->mXIm.resize(nValues);
+    pImpl->mZRe.resize(nValues);
+    pImpl->mZIm.resize(nValues);
+    pImpl->mQRe.resize(nFrequencies);
+    pImpl->mQIm.resize(nFrequencies);
+    pImpl->mBuffer.resize(static_cast<size_t> (nChannels)*windowLength);
+    pImpl->mWindowLength = windowLength;
+    pImpl->mFrequencies = nFrequencies;
+    pImpl->mChannels = nChannels;
+    pImpl->reset();
+    pImpl->mInitialized = true;
+}
+
+template<class T>
+bool SlidingDFTBank<T>::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+template<class T>
+int SlidingDFTBank<T>::getWindowLength() const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    return pImpl->mWindowLength;
+}
+
+template<class T>
+int SlidingDFTBank<T>::getNumberOfFrequencies() const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    return pImpl->mFrequencies;
+}
+
+template<class T>
+int SlidingDFTBank<T>::getNumberOfChannels() const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    return pImpl->mChannels;
+}
+
+/// Updates
+template<class T>
+void SlidingDFTBank<T>::update(const int nSamples, const T x[])
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    if (nSamples < 1){return;}
+    if (x == nullptr){RTSEIS_THROW_IA("%s", "x is NULL");}
+    pImpl->update(nSamples, x, nullptr);
+}
+
+template<class T>
+void SlidingDFTBank<T>::update(const int nSamples, const T x[],
+                               std::complex<T> *yIn[])
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    if (nSamples < 1){return;}
+    if (x == nullptr){RTSEIS_THROW_IA("%s", "x is NULL");}
+    std::complex<T> *y = *yIn;
+    if (y == nullptr){RTSEIS_THROW_IA("%s", "y is NULL");}
+    pImpl->update(nSamples, x, y);
+}
+
+/// Results
+template<class T>
+void SlidingDFTBank<T>::getTransform(const int nValues,
+                                     std::complex<T> *yIn[]) const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    auto nValuesRef = pImpl->mChannels*pImpl->mFrequencies;
+    if (nValues != nValuesRef)
+    {
+        RTSEIS_THROW_IA("nValues = %d must equal %d", nValues, nValuesRef);
+    }
+    std::complex<T> *y = *yIn;
+    if (y == nullptr){RTSEIS_THROW_IA("%s", "y is NULL");}
+    for (int i=0; i<nValues; ++i)
+    {
+        y[i] = std::complex<T> (pImpl->mXRe[i], pImpl->mXIm[i]);
+    }
+}
+
+template<class T>
+void SlidingDFTBank<T>::getAmplitudes(const int nValues,
+                                      T *amplitudesIn[]) const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    auto nValuesRef = pImpl->mChannels*pImpl->mFrequencies;
+    if (nValues != nValuesRef)
+    {
+        RTSEIS_THROW_IA("nValues = %d must equal %d", nValues, nValuesRef);
+    }
+    T *amplitudes = *amplitudesIn;
+    if (amplitudes == nullptr){RTSEIS_THROW_IA("%s", "amplitudes is NULL");}
+    auto scale = static_cast<T> (2.0/pImpl->mWindowLength);
+    const T *xRe = pImpl->mXRe.data();
+    const T *xIm = pImpl->mXIm.data();
+    #pragma omp simd
+    for (int i=0; i<nValues; ++i)
+    {
+        amplitudes[i] = scale*std::sqrt(xRe[i]*xRe[i] + xIm[i]*xIm[i]);
+    }
+}
+
+template<class T>
+void SlidingDFTBank<T>::getPhases(const int nValues, T *phasesIn[]) const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    auto nValuesRef = pImpl->mChannels*pImpl->mFrequencies;
+    if (nValues != nValuesRef)
+    {
+        RTSEIS_THROW_IA("nValues = %d must equal %d", nValues, nValuesRef);
+    }
+    T *phases = *phasesIn;
+    if (phases == nullptr){RTSEIS_THROW_IA("%s", "phases is NULL");}
+    for (int i=0; i<nValues; ++i)
+    {
+        phases[i] = std::atan2(pImpl->mXIm[i], pImpl->mXRe[i]);
+    }
+}
+
+template<class T>
+void SlidingDFTBank<T>::reset()
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    pImpl->reset();
+}
+
+/// Template instantiation
+template class RTSeis::Utilities::Transforms::SlidingDFTBank<double>;
+template class RTSeis::Utilities::Transforms::SlidingDFTBank<float>;
@@ -2,6 +2,9 @@
 #include <cstdlib>
 #include <cstring>
 #include <cassert>
+#include <cmath>
+#include <limits>
+#include <vector>
 #include <complex> // Put this before fftw
 #include <fftw/fftw3.h>
 #include <ipps.h>
@@ -16,6 +19,11 @@ using namespace RTSeis::Utilities::Transforms;
 namespace
 {
 
+/// When only the magnitude, power, or decibels are retained the windows
+/// are transformed in blocks of this many columns so that the complex
+/// workspace does not grow with the signal length.
+constexpr int maxBlockColumns = 64;
+
 inline int padLength64f(const int n, const int alignment=64)
 {
     auto size = static_cast<int> (sizeof(double));
@@ -73,17 +81,103 @@ public:
         mSamplesInOverlap = 0;
         mDFTLength = 0;
         mNumberOfFrequencies = 0;
+        mSpectrum64f.clear();
+        mSpectrum32f.clear();
         mNumberOfColumns = 0;
+        mBlockColumns = 0;
         mDataOffset = 0;
         mFTOffset = 0;
         mPrecision = RTSeis::Precision::DOUBLE;
         mDetrendType = SlidingWindowDetrendType::REMOVE_NONE;
+        mOutputType = SlidingWindowOutputType::COMPLEX;
+        mOutputPrecision = RTSeis::Precision::DOUBLE;
         mHaveDoublePlan = false;
         mHaveFloatPlan = false;
         mApplyWindow = false;
         mHaveTransform = false;
         mInitialized = false;
     }
+    /// Detrends and windows the columns [firstColumn, firstColumn+nColumns)
+    /// of the signal into the first nColumns columns of mInData64f
+    void fillColumns(const int nSamples, const double x[],
+                     const int firstColumn, const int nColumns)
+    {
+        auto *window = mWindow64f;
+        auto *inData = mInData64f;
+        int nDataOffset = mDataOffset;
+        int nPtsPerSeg = mSamplesPerSegment;
+        int shift = nPtsPerSeg - mSamplesInOverlap;
+        auto lwindow = mApplyWindow;
+        SlidingWindowDetrendType detrendType = mDetrendType;
+        for (auto jcol=0; jcol<nColumns; ++jcol)
+        {
+            auto xIndex = (firstColumn + jcol)*shift; // Extract x
+            auto dataIndex = jcol*nDataOffset;
+            auto xptr = &x[xIndex];
+            auto dptr = &inData[dataIndex];
+#ifdef DEBUG
+            assert(xIndex < nSamples);
+#endif
+            auto ncopy = std::min(nPtsPerSeg, nSamples - xIndex);
+            // Zero and copy
+            std::memset(dptr, 0,
+                        static_cast<size_t> (nDataOffset)*sizeof(double));
+            std::copy(xptr, xptr + ncopy, dptr);
+            // Demean?
+            if (detrendType == SlidingWindowDetrendType::REMOVE_MEAN)
+            {
+                double mean;
+                FilterImplementations::removeMean(ncopy, xptr, &dptr, &mean);
+            }
+            else if (detrendType == SlidingWindowDetrendType::REMOVE_TREND)
+            {
+                double intercept;
+                double slope;
+                FilterImplementations::removeTrend(ncopy, xptr, &dptr,
+                                                   &intercept, &slope);
+            }
+            // Window
+            if (lwindow){ippsMul_64f_I(window, dptr, nPtsPerSeg);}
+        }
+    }
+    /// Reduces the first nColumns transformed columns of mOutData64f to
+    /// the magnitude, power, or decibels and stores them starting at
+    /// firstColumn in the output
+    template<typename U>
+    void reduceColumns(const int firstColumn, const int nColumns, U output[])
+    {
+        constexpr double minimumPower = std::numeric_limits<U>::min();
+        auto nFrequencies = mNumberOfFrequencies;
+        for (auto jcol=0; jcol<nColumns; ++jcol)
+        {
+            auto ft = reinterpret_cast<const std::complex<double> *>
+                      (mOutData64f + static_cast<size_t> (jcol)*mFTOffset);
+            U *y = &output[static_cast<size_t> (firstColumn + jcol)
+                          *nFrequencies];
+            if (mOutputType == SlidingWindowOutputType::MAGNITUDE)
+            {
+                for (auto k=0; k<nFrequencies; ++k)
+                {
+                    y[k] = static_cast<U> (std::abs(ft[k]));
+                }
+            }
+            else if (mOutputType == SlidingWindowOutputType::POWER)
+            {
+                for (auto k=0; k<nFrequencies; ++k)
+                {
+                    y[k] = static_cast<U> (std::norm(ft[k]));
+                }
+            }
+            else
+            {
+                for (auto k=0; k<nFrequencies; ++k)
+                {
+                    auto power = std::max(minimumPower, std::norm(ft[k]));
+                    y[k] = static_cast<U> (10*std::log10(power));
+                }
+            }
+        }
+    }
 
 //private:
     /// The parameters that went into initialization
@@ -110,6 +204,11 @@ public:
     /// Holds the window function.  This is an array of dimension
     /// [mSamples].  This is used with mApplyWindow.
     float *mWindow32f = nullptr;
+    /// Holds the magnitude, power, or decibels when the output is not
+    /// complex.  This is an array of dimension
+    /// [mNumberOfColumns x mNumberOfFrequencies].
+    std::vector<double> mSpectrum64f;
+    std::vector<float> mSpectrum32f;
     /// The number of samples in the input signal
     int mSamples = 0;
     /// The number of samples in an overlap
@@ -124,6 +223,9 @@ public:
     int mNumberOfFrequencies = 0;
     /// The number of time domain samples where the sliding DFT is tabulated.
     int mNumberOfColumns = 0;
+    /// The number of columns in the transform workspace.  For complex
+    /// output this is mNumberOfColumns.
+    int mBlockColumns = 0;
     /// This is a padded variant of mDFTLength.  The padding ensures 64 bit
     /// cache alignment for each row of the input data to transform.
     int mDataOffset = 0;
@@ -137,6 +239,10 @@ public:
     /// The detrend strategy
     SlidingWindowDetrendType mDetrendType
        = SlidingWindowDetrendType::REMOVE_NONE;
+    /// Defines what is retained for each window
+    SlidingWindowOutputType mOutputType = SlidingWindowOutputType::COMPLEX;
+    /// The precision of the magnitude, power, or decibels
+    RTSeis::Precision mOutputPrecision = RTSeis::Precision::DOUBLE;
     /// Flag indicating that I have a plan (for double precision)
     bool mHaveDoublePlan = false;
     /// Flag indicating that I have a plan (for single precision)
@@ -214,6 +320,8 @@ SlidingWindowRealDFT::operator=(const SlidingWindowRealDFT &swdft)
                 *sizeof(fftwf_complex);
         std::memcpy(pImpl->mOutData32f, swdft.pImpl->mOutData32f, nbytes);
     }
+    pImpl->mSpectrum64f = swdft.pImpl->mSpectrum64f;
+    pImpl->mSpectrum32f = swdft.pImpl->mSpectrum32f;
     return *this;
 }
 
@@ -257,6 +365,25 @@ void SlidingWindowRealDFT::initialize(
     pImpl->mNumberOfColumns = ncols;
     pImpl->mPrecision = parameters.getPrecision();
     pImpl->mDetrendType = parameters.getDetrendType();
+    pImpl->mOutputType = parameters.getOutputType();
+    pImpl->mOutputPrecision = parameters.getOutputPrecision();
+    // Only a block of columns need be transformed at a time when the
+    // complex DFT is not retained
+    pImpl->mBlockColumns = ncols;
+    if (pImpl->mOutputType != SlidingWindowOutputType::COMPLEX)
+    {
+        pImpl->mBlockColumns = std::min(ncols, maxBlockColumns);
+        auto nOutput = static_cast<size_t> (ncols)
+                      *pImpl->mNumberOfFrequencies;
+        if (pImpl->mOutputPrecision == RTSeis::Precision::DOUBLE)
+        {
+            pImpl->mSpectrum64f.resize(nOutput, 0);
+        }
+        else
+        {
+            pImpl->mSpectrum32f.resize(nOutput, 0);
+        }
+    }
     if (luseWindow)
     {
         auto window = parameters.getWindow();
@@ -273,7 +400,7 @@ void SlidingWindowRealDFT::initialize(
     // Initialize the Fourier transform
     constexpr int rank = 1;
     int nForward[1] = {pImpl->mDFTLength};
-    int howMany = pImpl->mNumberOfColumns;
+    int howMany = pImpl->mBlockColumns;
     constexpr int istride = 1;
     constexpr int ostride = 1;
     constexpr int inembed[1] = {0}; //NULL;
@@ -290,8 +417,8 @@ void SlidingWindowRealDFT::initialize(
         pImpl->mFTOffset = padLength32f(pImpl->mNumberOfFrequencies, 64);
     }
     // Make the real-to-complex Fourier transform plans
-    pImpl->mInDataLength  = pImpl->mDataOffset*pImpl->mNumberOfColumns;
-    pImpl->mOutDataLength = pImpl->mFTOffset*pImpl->mNumberOfColumns;
+    pImpl->mInDataLength  = pImpl->mDataOffset*pImpl->mBlockColumns;
+    pImpl->mOutDataLength = pImpl->mFTOffset*pImpl->mBlockColumns;
     if (pImpl->mPrecision == RTSeis::Precision::DOUBLE)
     {
         auto nbytes = static_cast<size_t> (pImpl->mInDataLength)
@@ -330,6 +457,8 @@ void SlidingWindowRealDFT::initialize(
                                                     FFTW_PATIENT);
         pImpl->mHaveFloatPlan = true;
     }
+    // Save the parameters for the copy constructor
+    pImpl->mParameters = parameters;
     pImpl->mHaveTransform = false;
     pImpl->mInitialized = true;
 }
@@ -516,50 +645,32 @@ void SlidingWindowRealDFT::transform(const int nSamples, const double x[])
     {
         RTSEIS_THROW_RTE("%s", "Float precision not yet implemented");
     }
-    // Loop over the windows
-    //#pragma omp parallel shared(inData, window) default(None)
-    {
-    auto *window = pImpl->mWindow64f;
-    auto *inData = pImpl->mInData64f;
-    int nDataOffset = pImpl->mDataOffset;
-    int nPtsPerSeg = pImpl->mSamplesPerSegment;
-    int nOverlap   = pImpl->mSamplesInOverlap;
-    int shift = nPtsPerSeg - nOverlap;
-    auto lwindow = pImpl->mApplyWindow;
-    SlidingWindowDetrendType detrendType = pImpl->mDetrendType;
-    //#pragma omp for
-    for (auto icol=0; icol<pImpl->mNumberOfColumns; ++icol)
-    {
-        auto xIndex = icol*shift; // Extract x
-        auto dataIndex = icol*nDataOffset;
-        auto xptr = &x[xIndex];
-        auto dptr = &inData[dataIndex];
-#ifdef DEBUG
-        assert(xIndex < nSamples);
-#endif
-        auto ncopy = std::min(nPtsPerSeg, nSamples - xIndex);
-        // Zero and copy
-        std::memset(dptr, 0, static_cast<size_t> (nDataOffset)*sizeof(double));
-        std::copy(xptr, xptr + ncopy, dptr); //dptr, xptr, static_cast<size_t> (ncopy)*sizeof(double));
-        // Demean?
-        if (detrendType == SlidingWindowDetrendType::REMOVE_MEAN)
-        {
-            double mean;
-            FilterImplementations::removeMean(ncopy, xptr, &dptr, &mean);
-        }
-        else if (detrendType == SlidingWindowDetrendType::REMOVE_TREND)
+    if (pImpl->mOutputType == SlidingWindowOutputType::COMPLEX)
+    {
+        pImpl->fillColumns(nSamples, x, 0, pImpl->mNumberOfColumns);
+        fftw_execute(pImpl->mDoublePlan);
+    }
+    else
+    {
+        // Transform a block of windows then immediately reduce it.  If the
+        // final block is partial then the stale trailing columns are
+        // transformed but ignored.
+        auto nColumns = pImpl->mNumberOfColumns;
+        for (auto icol=0; icol<nColumns; icol=icol+pImpl->mBlockColumns)
         {
-            double intercept;
-            double slope;
-            FilterImplementations::removeTrend(ncopy, xptr, &dptr,
-                                               &intercept, &slope);
+            auto nBlock = std::min(pImpl->mBlockColumns, nColumns - icol);
+            pImpl->fillColumns(nSamples, x, icol, nBlock);
+            fftw_execute(pImpl->mDoublePlan);
+            if (pImpl->mOutputPrecision == RTSeis::Precision::DOUBLE)
+            {
+                pImpl->reduceColumns(icol, nBlock, pImpl->mSpectrum64f.data());
+            }
+            else
+            {
+                pImpl->reduceColumns(icol, nBlock, pImpl->mSpectrum32f.data());
+            }
         }
-        // Window
-        if (lwindow){ippsMul_64f_I(window, dptr, nPtsPerSeg);}
     }
-    } // End parallel
-    // Transform
-    fftw_execute(pImpl->mDoublePlan);
     pImpl->mHaveTransform = true;
 }
 
@@ -572,6 +683,10 @@ SlidingWindowRealDFT::getTransform64f(const int iWindow) const
     {
         RTSEIS_THROW_RTE("%s", "Transform not yet applied");
     }
+    if (pImpl->mOutputType != SlidingWindowOutputType::COMPLEX)
+    {
+        RTSEIS_THROW_RTE("%s", "Output is not complex - call getSpectrum");
+    }
     if (pImpl->mPrecision != RTSeis::Precision::DOUBLE)
     {
         RTSEIS_THROW_RTE("%s", "Precision is FLOAT - call getTransform32f");
@@ -595,6 +710,10 @@ SlidingWindowRealDFT::getTransform32f(const int iWindow) const
     {
         RTSEIS_THROW_RTE("%s", "Transform not yet applied");
     }
+    if (pImpl->mOutputType != SlidingWindowOutputType::COMPLEX)
+    {
+        RTSEIS_THROW_RTE("%s", "Output is not complex - call getSpectrum");
+    }
     if (pImpl->mPrecision != RTSeis::Precision::FLOAT)
     {
         RTSEIS_THROW_RTE("%s", "Precision is DOUBLE - call getTransform64f");
@@ -609,3 +728,59 @@ SlidingWindowRealDFT::getTransform32f(const int iWindow) const
                (pImpl->mOutData32f + indx);
     return ptr;
 }
+
+/// Returns a pointer to the magnitude, power, or decibels in the i'th window
+const double *SlidingWindowRealDFT::getSpectrum64f(const int iWindow) const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    if (!pImpl->mHaveTransform)
+    {
+        RTSEIS_THROW_RTE("%s", "Transform not yet applied");
+    }
+    if (pImpl->mOutputType == SlidingWindowOutputType::COMPLEX)
+    {
+        RTSEIS_THROW_RTE("%s", "Output is complex - call getTransform64f");
+    }
+    if (pImpl->mOutputPrecision != RTSeis::Precision::DOUBLE)
+    {
+        RTSEIS_THROW_RTE("%s", "Output precision is FLOAT - call getSpectrum32f");
+    }
+    if (iWindow < 0 || iWindow >= pImpl->mNumberOfColumns)
+    {
+        RTSEIS_THROW_IA("iWindow = %d must be in range [0,%d]",
+                        iWindow, pImpl->mNumberOfColumns);
+    }
+    auto indx = static_cast<size_t> (iWindow)*pImpl->mNumberOfFrequencies;
+    return pImpl->mSpectrum64f.data() + indx;
+}
+
+const float *SlidingWindowRealDFT::getSpectrum32f(const int iWindow) const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    if (!pImpl->mHaveTransform)
+    {
+        RTSEIS_THROW_RTE("%s", "Transform not yet applied");
+    }
+    if (pImpl->mOutputType == SlidingWindowOutputType::COMPLEX)
+    {
+        RTSEIS_THROW_RTE("%s", "Output is complex - call getTransform32f");
+    }
+    if (pImpl->mOutputPrecision != RTSeis::Precision::FLOAT)
+    {
+        RTSEIS_THROW_RTE("%s", "Output precision is DOUBLE - call getSpectrum64f");
+    }
+    if (iWindow < 0 || iWindow >= pImpl->mNumberOfColumns)
+    {
+        RTSEIS_THROW_IA("iWindow = %d must be in range [0,%d]",
+                        iWindow, pImpl->mNumberOfColumns);
+    }
+    auto indx = static_cast<size_t> (iWindow)*pImpl->mNumberOfFrequencies;
+    return pImpl->mSpectrum32f.data() + indx;
+}
+
+/// Gets the output type
+SlidingWindowOutputType SlidingWindowRealDFT::getOutputType() const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    return pImpl->mOutputType;
+}
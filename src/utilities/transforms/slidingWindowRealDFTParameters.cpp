@@ -26,6 +26,10 @@ public:
     SlidingWindowDetrendType mDetrendType = SlidingWindowDetrendType::REMOVE_NONE;
     /// Defines the precision
     RTSeis::Precision mPrecision = RTSeis::Precision::DOUBLE;
+    /// Defines what is retained for each window
+    SlidingWindowOutputType mOutputType = SlidingWindowOutputType::COMPLEX;
+    /// Defines the precision of the magnitude, power, or decibels
+    RTSeis::Precision mOutputPrecision = RTSeis::Precision::DOUBLE;
 };
 
 /// Constructor
@@ -81,6 +85,8 @@ void SlidingWindowRealDFTParameters::clear() noexcept
     pImpl->mWindowType = SlidingWindowWindowType::BOXCAR;
     pImpl->mDetrendType = SlidingWindowDetrendType::REMOVE_NONE;
     pImpl->mPrecision = RTSeis::Precision::DOUBLE;
+    pImpl->mOutputType = SlidingWindowOutputType::COMPLEX;
+    pImpl->mOutputPrecision = RTSeis::Precision::DOUBLE;
 }
 
 /// Set number of samples
@@ -268,6 +274,27 @@ RTSeis::Precision SlidingWindowRealDFTParameters::getPrecision() const noexcept
     return pImpl->mPrecision;
 }
 
+/// Gets/sets the output type
+void SlidingWindowRealDFTParameters::setOutputType(
+    const SlidingWindowOutputType outputType,
+    const RTSeis::Precision outputPrecision) noexcept
+{
+    pImpl->mOutputType = outputType;
+    pImpl->mOutputPrecision = outputPrecision;
+}
+
+SlidingWindowOutputType
+SlidingWindowRealDFTParameters::getOutputType() const noexcept
+{
+    return pImpl->mOutputType;
+}
+
+RTSeis::Precision
+SlidingWindowRealDFTParameters::getOutputPrecision() const noexcept
+{
+    return pImpl->mOutputPrecision;
+}
+
 /// Check if class is usable
 bool SlidingWindowRealDFTParameters::isValid() const noexcept
 {
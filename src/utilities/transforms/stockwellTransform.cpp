@@ -0,0 +1,343 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <complex>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include "rtseis/private/throw.hpp"
+#include "rtseis/utilities/transforms/stockwellTransform.hpp"
+#include "rtseis/utilities/transforms/dftRealToComplex.hpp"
+#include "rtseis/utilities/transforms/dft.hpp"
+
+using namespace RTSeis::Utilities::Transforms;
+
+template<class T>
+class StockwellTransform<T>::StockwellTransformImpl
+{
+public:
+    /// Computes every voice.  The signal is transformed once then each
+    /// thread inverse transforms a subset of the voices and hands the
+    /// result to the output function.
+    template<typename F>
+    void apply(const T x[], F output)
+    {
+        auto spectrum = mSpectrum.data();
+        mForward.forwardTransform(mSamples, x, mBins, &spectrum);
+        // Negative frequencies follow from conjugate symmetry
+        for (int k=mBins; k<mSamples; ++k)
+        {
+            spectrum[k] = std::conj(spectrum[mSamples - k]);
+        }
+        #pragma omp parallel
+        {
+            DFT<T> inverse(mInverse);
+            std::vector<std::complex<T>> work(mSamples,
+                                              std::complex<T> (0, 0));
+            std::vector<std::complex<T>> result(mSamples);
+            auto workPtr = work.data();
+            auto resultPtr = result.data();
+            #pragma omp for schedule(dynamic)
+            for (int j=0; j<mVoicesN; ++j)
+            {
+                auto k = mVoices[j];
+                auto m0 = mFirstLag[j];
+                auto nLags = static_cast<int> (mOffsets[j+1] - mOffsets[j]);
+                const T *gaussian = &mGaussians[mOffsets[j]];
+                for (int i=0; i<nLags; ++i)
+                {
+                    auto m = m0 + i;
+                    auto iw = (m < 0) ? m + mSamples : m;
+                    auto is = m + k;
+                    if (is < 0){is = is + mSamples;}
+                    if (is >= mSamples){is = is - mSamples;}
+                    workPtr[iw] = spectrum[is]*gaussian[i];
+                }
+                inverse.inverseTransform(mSamples, workPtr,
+                                         mSamples, &resultPtr);
+                output(j, resultPtr);
+                // Only the window's support was written
+                for (int i=0; i<nLags; ++i)
+                {
+                    auto m = m0 + i;
+                    auto iw = (m < 0) ? m + mSamples : m;
+                    workPtr[iw] = 0;
+                }
+            }
+        }
+    }
+//private:
+    DFTRealToComplex<T> mForward;
+    DFT<T> mInverse;
+    /// The truncated Gaussian windows for all voices stored contiguously
+    std::vector<T> mGaussians;
+    /// The start index of voice j's window is mOffsets[j]
+    std::vector<size_t> mOffsets;
+    /// The lag, m, of the first sample in voice j's window
+    std::vector<int> mFirstLag;
+    /// The frequency index of each voice
+    std::vector<int> mVoices;
+    /// The signal's full spectrum
+    std::vector<std::complex<T>> mSpectrum;
+    double mSamplingRate = 1;
+    int mSamples = 0;
+    int mVoicesN = 0;
+    /// Number of non-negative frequencies
+    int mBins = 0;
+    bool mInitialized = false;
+};
+
+/// Constructors
+template<class T>
+StockwellTransform<T>::StockwellTransform() :
+    pImpl(std::make_unique<StockwellTransformImpl> ())
+{
+}
+
+template<class T>
+StockwellTransform<T>::StockwellTransform(
+    const StockwellTransform &stransform)
+{
+    *this = stransform;
+}
+
+template<class T>
+StockwellTransform<T>::StockwellTransform(
+    StockwellTransform &&stransform) noexcept
+{
+    *this = std::move(stransform);
+}
+
+/// Operators
+template<class T>
+StockwellTransform<T>& StockwellTransform<T>::operator=(
+    const StockwellTransform &stransform)
+{
+    if (&stransform == this){return *this;}
+    pImpl = std::make_unique<StockwellTransformImpl> (*stransform.pImpl);
+    return *this;
+}
+
+template<class T>
+StockwellTransform<T>& StockwellTransform<T>::operator=(
+    StockwellTransform &&stransform) noexcept
+{
+    if (&stransform == this){return *this;}
+    pImpl = std::move(stransform.pImpl);
+    return *this;
+}
+
+/// Destructors
+template<class T>
+StockwellTransform<T>::~StockwellTransform() = default;
+
+template<class T>
+void StockwellTransform<T>::clear() noexcept
+{
+    pImpl = std::make_unique<StockwellTransformImpl> ();
+}
+
+/// Initialization
+template<class T>
+void StockwellTransform<T>::initialize(const int nSamples,
+                                       const int nVoices,
+                                       const int voices[],
+                                       const double samplingRate)
+{
+    clear();
+    if (nSamples < 2)
+    {
+        RTSEIS_THROW_IA("nSamples = %d must be at least 2", nSamples);
+    }
+    if (nVoices < 1)
+    {
+        RTSEIS_THROW_IA("nVoices = %d must be positive", nVoices);
+    }
+    if (voices == nullptr){RTSEIS_THROW_IA("%s", "voices is NULL");}
+    auto nyquist = nSamples/2;
+    for (int j=0; j<nVoices; ++j)
+    {
+        if (voices[j] < 0 || voices[j] > nyquist)
+        {
+            RTSEIS_THROW_IA("voices[%d] = %d must be in range [0,%d]",
+                            j, voices[j], nyquist);
+        }
+    }
+    if (samplingRate <= 0)
+    {
+        RTSEIS_THROW_IA("samplingRate = %lf must be positive", samplingRate);
+    }
+    pImpl->mForward.initialize(nSamples, FourierTransformImplementation::DFT);
+    pImpl->mInverse.initialize(nSamples, FourierTransformImplementation::DFT);
+    // Tabulate the Gaussian windows exp(-2 pi^2 m^2/k^2).  The window is
+    // truncated once it falls below machine epsilon, i.e., for
+    // |m| > k sqrt(-log(eps)/(2 pi^2)), and wraps at most once around the
+    // circle.
+    auto logEpsilon = std::log(std::numeric_limits<T>::epsilon());
+    auto halfWidth = std::sqrt(-logEpsilon/(2*M_PI*M_PI));
+    pImpl->mOffsets.resize(nVoices + 1, 0);
+    pImpl->mFirstLag.resize(nVoices, 0);
+    pImpl->mVoices.assign(voices, voices + nVoices);
+    size_t nTable = 0;
+    for (int j=0; j<nVoices; ++j)
+    {
+        auto k = voices[j];
+        int m0 = 0;
+        int m1 = 0;
+        if (k > 0)
+        {
+            auto mMax = static_cast<int> (std::ceil(k*halfWidth));
+            m0 = std::max(-mMax, -nyquist);
+            m1 = std::min(mMax, nSamples - 1 - nyquist);
+        }
+        pImpl->mFirstLag[j] = m0;
+        nTable = nTable + static_cast<size_t> (m1 - m0 + 1);
+        pImpl->mOffsets[j+1] = nTable;
+    }
+    pImpl->mGaussians.resize(nTable);
+    for (int j=0; j<nVoices; ++j)
+    {
+        auto k = voices[j];
+        auto m0 = pImpl->mFirstLag[j];
+        auto nLags = static_cast<int> (pImpl->mOffsets[j+1]
+                                     - pImpl->mOffsets[j]);
+        T *gaussian = &pImpl->mGaussians[pImpl->mOffsets[j]];
+        // The zero frequency voice is the signal's mean
+        if (k == 0)
+        {
+            gaussian[0] = 1;
+            continue;
+        }
+        auto c = -2*M_PI*M_PI/(static_cast<double> (k)*k);
+        for (int i=0; i<nLags; ++i)
+        {
+            auto m = static_cast<double> (m0 + i);
+            gaussian[i] = static_cast<T> (std::exp(c*m*m));
+        }
+    }
+    pImpl->mSpectrum.resize(nSamples);
+    pImpl->mSamplingRate = samplingRate;
+    pImpl->mSamples = nSamples;
+    pImpl->mVoicesN = nVoices;
+    pImpl->mBins = pImpl->mForward.getTransformLength();
+    pImpl->mInitialized = true;
+}
+
+template<class T>
+void StockwellTransform<T>::initialize(const int nSamples,
+                                       const double minimumFrequency,
+                                       const double maximumFrequency,
+                                       const double samplingRate)
+{
+    clear();
+    if (nSamples < 2)
+    {
+        RTSEIS_THROW_IA("nSamples = %d must be at least 2", nSamples);
+    }
+    if (samplingRate <= 0)
+    {
+        RTSEIS_THROW_IA("samplingRate = %lf must be positive", samplingRate);
+    }
+    if (maximumFrequency < minimumFrequency)
+    {
+        RTSEIS_THROW_IA("maximumFrequency = %lf must be at least %lf",
+                        maximumFrequency, minimumFrequency);
+    }
+    auto df = samplingRate/nSamples;
+    auto k0 = static_cast<int> (std::ceil(std::max(0.0, minimumFrequency)/df));
+    auto k1 = static_cast<int> (std::floor(maximumFrequency/df));
+    k1 = std::min(k1, nSamples/2);
+    if (k1 < k0)
+    {
+        RTSEIS_THROW_IA("No frequencies in band [%lf,%lf]",
+                        minimumFrequency, maximumFrequency);
+    }
+    std::vector<int> voices(k1 - k0 + 1);
+    for (int k=k0; k<=k1; ++k){voices[k - k0] = k;}
+    initialize(nSamples, static_cast<int> (voices.size()), voices.data(),
+               samplingRate);
+}
+
+template<class T>
+bool StockwellTransform<T>::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+template<class T>
+int StockwellTransform<T>::getNumberOfSamples() const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    return pImpl->mSamples;
+}
+
+template<class T>
+int StockwellTransform<T>::getNumberOfVoices() const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    return pImpl->mVoicesN;
+}
+
+template<class T>
+void StockwellTransform<T>::getFrequencies(const int nVoices,
+                                           double *frequenciesIn[]) const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    if (nVoices != pImpl->mVoicesN)
+    {
+        RTSEIS_THROW_IA("nVoices = %d must equal %d",
+                        nVoices, pImpl->mVoicesN);
+    }
+    double *frequencies = *frequenciesIn;
+    if (frequencies == nullptr){RTSEIS_THROW_IA("%s", "frequencies is NULL");}
+    auto df = pImpl->mSamplingRate/pImpl->mSamples;
+    for (int j=0; j<nVoices; ++j)
+    {
+        frequencies[j] = pImpl->mVoices[j]*df;
+    }
+}
+
+/// Transforms
+template<class T>
+void StockwellTransform<T>::transform(const int n, const T x[],
+                                      std::complex<T> *yIn[])
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    if (n != pImpl->mSamples)
+    {
+        RTSEIS_THROW_IA("n = %d must equal %d", n, pImpl->mSamples);
+    }
+    if (x == nullptr){RTSEIS_THROW_IA("%s", "x is NULL");}
+    std::complex<T> *y = *yIn;
+    if (y == nullptr){RTSEIS_THROW_IA("%s", "y is NULL");}
+    pImpl->apply(x, [y, n](const int j, const std::complex<T> s[])
+                 {
+                     std::copy(s, s + n, &y[static_cast<size_t> (j)*n]);
+                 });
+}
+
+template<class T>
+void StockwellTransform<T>::transformAmplitude(const int n, const T x[],
+                                               float *amplitudeIn[])
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    if (n != pImpl->mSamples)
+    {
+        RTSEIS_THROW_IA("n = %d must equal %d", n, pImpl->mSamples);
+    }
+    if (x == nullptr){RTSEIS_THROW_IA("%s", "x is NULL");}
+    float *amplitude = *amplitudeIn;
+    if (amplitude == nullptr){RTSEIS_THROW_IA("%s", "amplitude is NULL");}
+    pImpl->apply(x, [amplitude, n](const int j, const std::complex<T> s[])
+                 {
+                     float *a = &amplitude[static_cast<size_t> (j)*n];
+                     for (int i=0; i<n; ++i)
+                     {
+                         a[i] = static_cast<float> (std::abs(s[i]));
+                     }
+                 });
+}
+
+/// Template instantiation
+template class RTSeis::Utilities::Transforms::StockwellTransform<double>;
+template class RTSeis::Utilities::Transforms::StockwellTransform<float>;
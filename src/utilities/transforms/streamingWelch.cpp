@@ -0,0 +1,479 @@
+#include <cstdio>
+#include <cstdlib>
+#include <complex>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <ipps.h>
+#include "rtseis/private/throw.hpp"
+#include "rtseis/utilities/transforms/streamingWelch.hpp"
+#include "rtseis/utilities/transforms/utilities.hpp"
+#include "rtseis/utilities/transforms/slidingWindowRealDFT.hpp"
+#include "rtseis/utilities/transforms/slidingWindowRealDFTParameters.hpp"
+
+using namespace RTSeis::Utilities::Transforms;
+
+namespace
+{
+
+/// The power spectrum is normalized by (sum w)^2 so that a sinusoid's
+/// peak is its mean square
+double computeSpectrumScaling(const int npts, const double window[])
+{
+    double wsum;
+    ippsSum_64f(window, npts, &wsum);
+    wsum = wsum*wsum;
+    return wsum;
+}
+
+/// The power spectral density is normalized by fs*sum(w^2) so that it
+/// integrates to the mean square
+double computeDensityScaling(const int npts, const double samplingRate,
+                             const double window[])
+{
+    double wsum2 = 0;
+    ippsDotProd_64f(window, window, npts, &wsum2);
+    wsum2 = samplingRate*wsum2;
+    return wsum2;
+}
+
+}
+
+class StreamingWelch::StreamingWelchImpl
+{
+public:
+    /// Sets the segment transform and the workspace.  The sliding window
+    /// DFT is told the signal is exactly one segment long so that each
+    /// call to transform yields a single modified periodogram.
+    void initialize(const SlidingWindowRealDFTParameters &parameters,
+                    const double samplingRate)
+    {
+        if (samplingRate <= 0)
+        {
+            RTSEIS_THROW_IA("samplingRate = %lf must be posistive",
+                            samplingRate);
+        }
+        if (parameters.getOutputType() != SlidingWindowOutputType::COMPLEX)
+        {
+            RTSEIS_THROW_IA("%s", "parameters output type must be COMPLEX");
+        }
+        mSamplingRate = samplingRate;
+        try
+        {
+            mParameters = parameters;
+            mSegmentLength = mParameters.getWindowLength();
+            mSamplesInOverlap = mParameters.getNumberOfSamplesInOverlap();
+            mParameters.setNumberOfSamples(mSegmentLength);
+        }
+        catch (const std::exception &e)
+        {
+            RTSEIS_THROW_IA("%s; parameters are not valid", e.what());
+        }
+        if (!mParameters.isValid())
+        {
+            RTSEIS_THROW_IA("%s", "parameters are not valid");
+        }
+        try
+        {
+            mSlidingWindowRealDFT.initialize(mParameters);
+        }
+        catch (const std::exception &e)
+        {
+            RTSEIS_THROW_RTE("%s", "Failed to initialize sliding DFT");
+        }
+        // Compute the scaling
+        std::vector<double> window = mParameters.getWindow();
+        mSpectrumScaling = computeSpectrumScaling(mSegmentLength,
+                                                  window.data());
+        mDensityScaling = computeDensityScaling(mSegmentLength,
+                                                mSamplingRate,
+                                                window.data());
+        // Set space for the segment and intermediate spectra
+        mFrequencies = mSlidingWindowRealDFT.getNumberOfFrequencies();
+        mSegment.resize(mSegmentLength, 0);
+        mPower.resize(mFrequencies, 0);
+        mAverage.resize(mFrequencies, 0);
+    }
+    /// Discards the buffered data and the estimate
+    void reset()
+    {
+        std::fill(mSegment.begin(), mSegment.end(), 0);
+        std::fill(mAverage.begin(), mAverage.end(), 0);
+        std::fill(mCurrentBlock.begin(), mCurrentBlock.end(), 0);
+        std::fill(mBlocks.begin(), mBlocks.end(), 0);
+        mSegmentFill = 0;
+        mSegments = 0;
+        mSegmentsInCurrentBlock = 0;
+        mCompletedBlocks = 0;
+        mBlockIndex = 0;
+    }
+    /// Transforms the buffered segment and folds it into the estimate
+    void processSegment()
+    {
+        mSlidingWindowRealDFT.transform(mSegmentLength, mSegment.data());
+        auto cPtr = mSlidingWindowRealDFT.getTransform64f(0);
+        auto pDFT = reinterpret_cast<const Ipp64fc *> (cPtr);
+        double *pPower = mPower.data();
+        #pragma omp simd
+        for (auto k=0; k<mFrequencies; ++k)
+        {
+            pPower[k] = pDFT[k].re*pDFT[k].re + pDFT[k].im*pDFT[k].im;
+        }
+        double *pAverage = mAverage.data();
+        if (mAveragingType == WelchAveragingType::CUMULATIVE)
+        {
+            ippsAdd_64f_I(pPower, pAverage, mFrequencies);
+        }
+        else if (mAveragingType == WelchAveragingType::EXPONENTIAL)
+        {
+            if (mSegments == 0)
+            {
+                ippsCopy_64f(pPower, pAverage, mFrequencies);
+            }
+            else
+            {
+                double alpha = mAlpha;
+                #pragma omp simd
+                for (auto k=0; k<mFrequencies; ++k)
+                {
+                    pAverage[k] = pAverage[k] + alpha*(pPower[k] - pAverage[k]);
+                }
+            }
+        }
+        else
+        {
+            ippsAdd_64f_I(pPower, mCurrentBlock.data(), mFrequencies);
+            mSegmentsInCurrentBlock = mSegmentsInCurrentBlock + 1;
+            if (mSegmentsInCurrentBlock == mSegmentsPerBlock)
+            {
+                // Retire the block into the ring and re-sum the ring.
+                // Re-summing costs nBlocks*nFrequencies once per block
+                // and avoids the drift of adding and subtracting blocks.
+                double *pBlock = &mBlocks[mBlockIndex*mFrequencies];
+                ippsCopy_64f(mCurrentBlock.data(), pBlock, mFrequencies);
+                ippsZero_64f(mCurrentBlock.data(), mFrequencies);
+                mSegmentsInCurrentBlock = 0;
+                mBlockIndex = (mBlockIndex + 1)%mNumberOfBlocks;
+                mCompletedBlocks = std::min(mCompletedBlocks + 1,
+                                            mNumberOfBlocks);
+                ippsCopy_64f(mBlocks.data(), pAverage, mFrequencies);
+                for (auto ib=1; ib<mCompletedBlocks; ++ib)
+                {
+                    ippsAdd_64f_I(&mBlocks[ib*mFrequencies], pAverage,
+                                  mFrequencies);
+                }
+            }
+        }
+        mSegments = mSegments + 1;
+    }
+    /// Appends data to the segment buffer
+    void update(const int nSamples, const double x[])
+    {
+        int i = 0;
+        while (i < nSamples)
+        {
+            auto ncopy = std::min(mSegmentLength - mSegmentFill, nSamples - i);
+            std::copy(x + i, x + i + ncopy, mSegment.data() + mSegmentFill);
+            mSegmentFill = mSegmentFill + ncopy;
+            i = i + ncopy;
+            if (mSegmentFill == mSegmentLength)
+            {
+                processSegment();
+                // Retain the overlap for the next segment
+                std::copy(mSegment.end() - mSamplesInOverlap, mSegment.end(),
+                          mSegment.begin());
+                mSegmentFill = mSamplesInOverlap;
+            }
+        }
+    }
+    /// Number of segments in the current estimate
+    int getNumberOfAveragedSegments() const
+    {
+        if (mAveragingType == WelchAveragingType::MOVING_BLOCK)
+        {
+            if (mCompletedBlocks > 0)
+            {
+                return mCompletedBlocks*mSegmentsPerBlock;
+            }
+            return mSegmentsInCurrentBlock;
+        }
+        return mSegments;
+    }
+    /// Computes the scaled estimate
+    void getEstimate(const double scaling, double y[]) const
+    {
+        const double *pAverage = mAverage.data();
+        double xscal = 2.0/scaling;
+        if (mAveragingType == WelchAveragingType::CUMULATIVE)
+        {
+            xscal = xscal/static_cast<double> (mSegments);
+        }
+        else if (mAveragingType == WelchAveragingType::MOVING_BLOCK)
+        {
+            // Until a block completes report the partial block
+            if (mCompletedBlocks == 0){pAverage = mCurrentBlock.data();}
+            xscal = xscal/static_cast<double> (getNumberOfAveragedSegments());
+        }
+        ippsMulC_64f(pAverage, xscal, y, mFrequencies);
+    }
+
+    class SlidingWindowRealDFT mSlidingWindowRealDFT;
+    class SlidingWindowRealDFTParameters mParameters;
+    /// Holds the partially filled segment.  This has dimension
+    /// [mSegmentLength].
+    std::vector<double> mSegment;
+    /// The squared magnitude of the latest segment's DFT.  This has
+    /// dimension [mFrequencies].
+    std::vector<double> mPower;
+    /// The running sum (cumulative), running average (exponential), or sum
+    /// of the completed blocks (moving block).  This has dimension
+    /// [mFrequencies].
+    std::vector<double> mAverage;
+    /// The sum of the segments in the current block.  This has dimension
+    /// [mFrequencies].
+    std::vector<double> mCurrentBlock;
+    /// A ring of block sums.  This has dimension
+    /// [mNumberOfBlocks x mFrequencies].
+    std::vector<double> mBlocks;
+    double mSpectrumScaling = 1;
+    double mDensityScaling = 1;
+    double mSamplingRate = 1;
+    /// Exponential averaging weight
+    double mAlpha = 1;
+    int mFrequencies = 0;
+    int mSegmentLength = 0;
+    int mSamplesInOverlap = 0;
+    /// Number of samples currently in mSegment
+    int mSegmentFill = 0;
+    /// Number of segments processed since the last reset
+    int mSegments = 0;
+    int mSegmentsPerBlock = 1;
+    int mNumberOfBlocks = 1;
+    int mSegmentsInCurrentBlock = 0;
+    int mCompletedBlocks = 0;
+    int mBlockIndex = 0;
+    WelchAveragingType mAveragingType = WelchAveragingType::CUMULATIVE;
+    bool mInitialized = false;
+};
+
+/// Constructors
+StreamingWelch::StreamingWelch() :
+    pImpl(std::make_unique<StreamingWelchImpl> ())
+{
+}
+
+StreamingWelch::StreamingWelch(const StreamingWelch &welch)
+{
+    *this = welch;
+}
+
+StreamingWelch::StreamingWelch(StreamingWelch &&welch) noexcept
+{
+    *this = std::move(welch);
+}
+
+/// Operators
+StreamingWelch& StreamingWelch::operator=(const StreamingWelch &welch)
+{
+    if (&welch == this){return *this;}
+    if (pImpl){pImpl.reset();}
+    pImpl = std::make_unique<StreamingWelchImpl> (*welch.pImpl);
+    return *this;
+}
+
+StreamingWelch& StreamingWelch::operator=(StreamingWelch &&welch) noexcept
+{
+    if (&welch == this){return *this;}
+    pImpl = std::move(welch.pImpl);
+    return *this;
+}
+
+/// Destructor
+StreamingWelch::~StreamingWelch() = default;
+
+/// Clears memory
+void StreamingWelch::clear() noexcept
+{
+    pImpl = std::make_unique<StreamingWelchImpl> ();
+}
+
+/// Initialize
+void StreamingWelch::initialize(
+    const SlidingWindowRealDFTParameters &parameters,
+    const double samplingRate)
+{
+    clear();
+    try
+    {
+        pImpl->initialize(parameters, samplingRate);
+    }
+    catch (const std::invalid_argument &e)
+    {
+        clear();
+        throw;
+    }
+    catch (const std::exception &e)
+    {
+        clear();
+        RTSEIS_THROW_RTE("%s", e.what());
+    }
+    pImpl->mAveragingType = WelchAveragingType::CUMULATIVE;
+    pImpl->mInitialized = true;
+}
+
+void StreamingWelch::initializeExponential(
+    const SlidingWindowRealDFTParameters &parameters,
+    const double alpha,
+    const double samplingRate)
+{
+    clear();
+    if (alpha <= 0 || alpha > 1)
+    {
+        RTSEIS_THROW_IA("alpha = %lf must be in range (0,1]", alpha);
+    }
+    initialize(parameters, samplingRate);
+    pImpl->mAlpha = alpha;
+    pImpl->mAveragingType = WelchAveragingType::EXPONENTIAL;
+}
+
+void StreamingWelch::initializeMovingBlock(
+    const SlidingWindowRealDFTParameters &parameters,
+    const int nSegmentsPerBlock,
+    const int nBlocks,
+    const double samplingRate)
+{
+    clear();
+    if (nSegmentsPerBlock < 1)
+    {
+        RTSEIS_THROW_IA("nSegmentsPerBlock = %d must be positive",
+                        nSegmentsPerBlock);
+    }
+    if (nBlocks < 1)
+    {
+        RTSEIS_THROW_IA("nBlocks = %d must be positive", nBlocks);
+    }
+    initialize(parameters, samplingRate);
+    auto nFrequencies = pImpl->mFrequencies;
+    pImpl->mSegmentsPerBlock = nSegmentsPerBlock;
+    pImpl->mNumberOfBlocks = nBlocks;
+    pImpl->mCurrentBlock.resize(nFrequencies, 0);
+    pImpl->mBlocks.resize(static_cast<size_t> (nBlocks)*nFrequencies, 0);
+    pImpl->mAveragingType = WelchAveragingType::MOVING_BLOCK;
+}
+
+bool StreamingWelch::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+WelchAveragingType StreamingWelch::getAveragingType() const
+{
+    if (!isInitialized())
+    {
+        RTSEIS_THROW_RTE("%s", "Class is not initialized");
+    }
+    return pImpl->mAveragingType;
+}
+
+bool StreamingWelch::haveTransform() const noexcept
+{
+    if (!pImpl->mInitialized){return false;}
+    return (pImpl->getNumberOfAveragedSegments() > 0);
+}
+
+int StreamingWelch::getNumberOfAveragedSegments() const
+{
+    if (!isInitialized())
+    {
+        RTSEIS_THROW_RTE("%s", "Class is not initialized");
+    }
+    return pImpl->getNumberOfAveragedSegments();
+}
+
+int StreamingWelch::getNumberOfFrequencies() const
+{
+    if (!isInitialized())
+    {
+        RTSEIS_THROW_RTE("%s", "Class is not initialized");
+    }
+    return pImpl->mFrequencies;
+}
+
+/// Append data
+void StreamingWelch::update(const int nSamples, const double x[])
+{
+    if (!isInitialized())
+    {
+        RTSEIS_THROW_RTE("%s", "Class is not initialized");
+    }
+    if (nSamples < 1){return;} // Nothing to do
+    if (x == nullptr){RTSEIS_THROW_IA("%s", "x is NULL");}
+    pImpl->update(nSamples, x);
+}
+
+/// Reset
+void StreamingWelch::reset()
+{
+    if (!isInitialized())
+    {
+        RTSEIS_THROW_RTE("%s", "Class is not initialized");
+    }
+    pImpl->reset();
+}
+
+void StreamingWelch::getPowerSpectrum(const int nFrequencies,
+                                      double *powerSpectrum[]) const
+{
+    auto nFreqs = getNumberOfFrequencies(); // Will throw initializaiton error
+    if (nFrequencies != nFreqs)
+    {
+        RTSEIS_THROW_IA("nFrequencies = %d must equal %d",
+                        nFrequencies, nFreqs);
+    }
+    double *ptr = *powerSpectrum;
+    if (ptr == nullptr){RTSEIS_THROW_IA("%s", "powerSpectrum is NULL");}
+    if (!haveTransform())
+    {
+        RTSEIS_THROW_RTE("%s", "no segments have been averaged");
+    }
+    pImpl->getEstimate(pImpl->mSpectrumScaling, ptr);
+}
+
+void StreamingWelch::getPowerSpectralDensity(const int nFrequencies,
+                                             double *psd[]) const
+{
+    auto nFreqs = getNumberOfFrequencies(); // Will throw initializaiton error
+    if (nFrequencies != nFreqs)
+    {
+        RTSEIS_THROW_IA("nFrequencies = %d must equal %d",
+                        nFrequencies, nFreqs);
+    }
+    double *ptr = *psd;
+    if (ptr == nullptr){RTSEIS_THROW_IA("%s", "psd is NULL");}
+    if (!haveTransform())
+    {
+        RTSEIS_THROW_RTE("%s", "no segments have been averaged");
+    }
+    pImpl->getEstimate(pImpl->mDensityScaling, ptr);
+}
+
+void StreamingWelch::getFrequencies(const int nFrequencies,
+                                    double *freqsIn[]) const
+{
+    auto nFreqs = getNumberOfFrequencies(); // Will throw initialization error
+    if (nFrequencies != nFreqs)
+    {
+        RTSEIS_THROW_IA("nFrequencies = %d must equal %d",
+                        nFrequencies, nFreqs);
+    }
+    double *freqs = *freqsIn;
+    if (freqs == nullptr)
+    {
+        RTSEIS_THROW_IA("%s", "frequencies is NULL");
+    }
+    int nSamples = pImpl->mParameters.getDFTLength();
+    DFTUtilities::realToComplexDFTFrequencies(nSamples,
+                                              1.0/pImpl->mSamplingRate,
+                                              nFreqs,
+                                              freqsIn);
+}
@@ -0,0 +1,235 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <complex>
+#include <vector>
+#include <algorithm>
+#include "rtseis/private/throw.hpp"
+#include "rtseis/utilities/transforms/timeShift.hpp"
+#include "rtseis/utilities/transforms/dftRealToComplex.hpp"
+#include "rtseis/utilities/transforms/utilities.hpp"
+
+using namespace RTSeis::Utilities::Transforms;
+
+template<class T>
+class TimeShift<T>::TimeShiftImpl
+{
+public:
+    /// Shifts x by shift samples.  The work arrays are the padded signal
+    /// of length mDFTLength and its spectrum of length mFrequencies.
+    void shift(DFTRealToComplex<T> &dft, const T x[], const double shift,
+               T work[], std::complex<T> spectrum[], T y[]) const
+    {
+        if (mTaper.empty())
+        {
+            std::copy(x, x + mSamples, work);
+        }
+        else
+        {
+            #pragma omp simd
+            for (int i=0; i<mSamples; ++i){work[i] = mTaper[i]*x[i];}
+        }
+        dft.forwardTransform(mSamples, work, mFrequencies, &spectrum);
+        // Reduce the argument modulo the DFT length so the phase is
+        // accurate for long signals
+        auto length = static_cast<double> (mDFTLength);
+        auto dphi =-2*M_PI/length;
+        for (int k=1; k<mFrequencies; ++k)
+        {
+            auto phi = dphi*std::fmod(k*shift, length);
+            spectrum[k] = spectrum[k]*std::complex<T> (std::cos(phi),
+                                                       std::sin(phi));
+        }
+        // The Nyquist of the shifted signal must remain real
+        if (mDFTLength%2 == 0)
+        {
+            spectrum[mFrequencies-1]
+                = std::complex<T> (std::real(spectrum[mFrequencies-1]), 0);
+        }
+        dft.inverseTransform(mFrequencies, spectrum, mDFTLength, &work);
+        std::copy(work, work + mSamples, y);
+    }
+//private:
+    DFTRealToComplex<T> mDFT;
+    /// The cosine taper.  This is empty when no taper is applied.
+    std::vector<T> mTaper;
+    double mMaximumShift = 0;
+    double mSamplingRate = 1;
+    int mSamples = 0;
+    int mDFTLength = 0;
+    int mFrequencies = 0;
+    bool mInitialized = false;
+};
+
+/// Constructors
+template<class T>
+TimeShift<T>::TimeShift() :
+    pImpl(std::make_unique<TimeShiftImpl> ())
+{
+}
+
+template<class T>
+TimeShift<T>::TimeShift(const TimeShift &timeShift)
+{
+    *this = timeShift;
+}
+
+template<class T>
+TimeShift<T>::TimeShift(TimeShift &&timeShift) noexcept
+{
+    *this = std::move(timeShift);
+}
+
+/// Operators
+template<class T>
+TimeShift<T>& TimeShift<T>::operator=(const TimeShift &timeShift)
+{
+    if (&timeShift == this){return *this;}
+    pImpl = std::make_unique<TimeShiftImpl> (*timeShift.pImpl);
+    return *this;
+}
+
+template<class T>
+TimeShift<T>& TimeShift<T>::operator=(TimeShift &&timeShift) noexcept
+{
+    if (&timeShift == this){return *this;}
+    pImpl = std::move(timeShift.pImpl);
+    return *this;
+}
+
+/// Destructors
+template<class T>
+TimeShift<T>::~TimeShift() = default;
+
+template<class T>
+void TimeShift<T>::clear() noexcept
+{
+    pImpl = std::make_unique<TimeShiftImpl> ();
+}
+
+/// Initialization
+template<class T>
+void TimeShift<T>::initialize(const int nSamples,
+                              const double maximumShift,
+                              const double samplingRate,
+                              const double taperPercentage)
+{
+    clear();
+    if (nSamples < 1)
+    {
+        RTSEIS_THROW_IA("nSamples = %d must be positive", nSamples);
+    }
+    if (maximumShift < 0)
+    {
+        RTSEIS_THROW_IA("maximumShift = %lf cannot be negative",
+                        maximumShift);
+    }
+    if (samplingRate <= 0)
+    {
+        RTSEIS_THROW_IA("samplingRate = %lf must be positive", samplingRate);
+    }
+    if (taperPercentage < 0 || taperPercentage > 100)
+    {
+        RTSEIS_THROW_IA("taperPercentage = %lf must be in range [0,100]",
+                        taperPercentage);
+    }
+    // Pad so that the largest shift does not wrap around
+    auto nPad = static_cast<int> (std::ceil(maximumShift*samplingRate));
+    auto dftLength = DFTUtilities::nextFastLength(nSamples + nPad);
+    // Hann taper applied to taperPercentage/2 of each end
+    auto nTaper = static_cast<int> (0.5*taperPercentage/100*nSamples);
+    if (nTaper > 0)
+    {
+        pImpl->mTaper.resize(nSamples, 1);
+        for (int i=0; i<nTaper; ++i)
+        {
+            auto w = 0.5 - 0.5*std::cos(M_PI*(i + 0.5)/nTaper);
+            pImpl->mTaper[i] = static_cast<T> (w);
+            pImpl->mTaper[nSamples - 1 - i] = static_cast<T> (w);
+        }
+    }
+    pImpl->mDFT.initialize(dftLength, FourierTransformImplementation::DFT);
+    pImpl->mMaximumShift = maximumShift;
+    pImpl->mSamplingRate = samplingRate;
+    pImpl->mSamples = nSamples;
+    pImpl->mDFTLength = dftLength;
+    pImpl->mFrequencies = pImpl->mDFT.getTransformLength();
+    pImpl->mInitialized = true;
+}
+
+template<class T>
+bool TimeShift<T>::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+template<class T>
+int TimeShift<T>::getNumberOfSamples() const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    return pImpl->mSamples;
+}
+
+template<class T>
+double TimeShift<T>::getMaximumShift() const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    return pImpl->mMaximumShift;
+}
+
+/// Shifting
+template<class T>
+void TimeShift<T>::transform(const int nSamples, const T x[],
+                             const double shift, T *y[])
+{
+    transform(1, nSamples, x, &shift, y);
+}
+
+template<class T>
+void TimeShift<T>::transform(const int nSignals, const int nSamples,
+                             const T x[], const double shifts[],
+                             T *yIn[])
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    if (nSignals < 1)
+    {
+        RTSEIS_THROW_IA("nSignals = %d must be positive", nSignals);
+    }
+    if (nSamples != pImpl->mSamples)
+    {
+        RTSEIS_THROW_IA("nSamples = %d must equal %d",
+                        nSamples, pImpl->mSamples);
+    }
+    if (x == nullptr){RTSEIS_THROW_IA("%s", "x is NULL");}
+    if (shifts == nullptr){RTSEIS_THROW_IA("%s", "shifts is NULL");}
+    T *y = *yIn;
+    if (y == nullptr){RTSEIS_THROW_IA("%s", "y is NULL");}
+    for (int i=0; i<nSignals; ++i)
+    {
+        if (std::abs(shifts[i]) > pImpl->mMaximumShift)
+        {
+            RTSEIS_THROW_IA("|shifts[%d]| = %lf cannot exceed %lf",
+                            i, std::abs(shifts[i]), pImpl->mMaximumShift);
+        }
+    }
+    auto dftLength = pImpl->mDFTLength;
+    auto nFrequencies = pImpl->mFrequencies;
+    auto samplingRate = pImpl->mSamplingRate;
+    #pragma omp parallel
+    {
+        DFTRealToComplex<T> dft(pImpl->mDFT);
+        std::vector<T> work(dftLength);
+        std::vector<std::complex<T>> spectrum(nFrequencies);
+        #pragma omp for
+        for (int i=0; i<nSignals; ++i)
+        {
+            auto offset = static_cast<size_t> (i)*nSamples;
+            pImpl->shift(dft, &x[offset], shifts[i]*samplingRate,
+                         work.data(), spectrum.data(), &y[offset]);
+        }
+    }
+}
+
+/// Template instantiation
+template class RTSeis::Utilities::Transforms::TimeShift<double>;
+template class RTSeis::Utilities::Transforms::TimeShift<float>;
@@ -13,16 +13,9 @@ using namespace RTSeis::Utilities::Transforms;
 namespace
 {
 
-double computeSpectrumScaling(const int npts, const double samplingRate,
-                              const double window[])
-{
-    double wsum2 = 0;
-    ippsDotProd_64f(window, window, npts, &wsum2); 
-    wsum2 = samplingRate*wsum2; 
-    return wsum2;
-}
-
-double computeDensityScaling(const int npts, const double window[])
+/// The power spectrum is normalized by (sum w)^2 so that a sinusoid's
+/// peak is its mean square
+double computeSpectrumScaling(const int npts, const double window[])
 {
     double wsum;
     ippsSum_64f(window, npts, &wsum);
@@ -30,6 +23,17 @@ double computeDensityScaling(const int npts, const double window[])
     return wsum;
 }
 
+/// The power spectral density is normalized by fs*sum(w^2) so that it
+/// integrates to the mean square
+double computeDensityScaling(const int npts, const double samplingRate,
+                             const double window[])
+{
+    double wsum2 = 0;
+    ippsDotProd_64f(window, window, npts, &wsum2);
+    wsum2 = samplingRate*wsum2;
+    return wsum2;
+}
+
 }
 
 class Welch::WelchImpl
@@ -106,6 +110,10 @@ void Welch::initialize(const SlidingWindowRealDFTParameters &parameters,
     {
         RTSEIS_THROW_IA("%s", "parameters are not valid");
     }
+    if (parameters.getOutputType() != SlidingWindowOutputType::COMPLEX)
+    {
+        RTSEIS_THROW_IA("%s", "parameters output type must be COMPLEX");
+    }
     // Initialize the sliding window DFT
     pImpl->mSamplingRate = samplingRate;
     try
@@ -121,10 +129,10 @@ void Welch::initialize(const SlidingWindowRealDFTParameters &parameters,
     // Compute the scaling
     int nWindow = pImpl->mParameters.getWindowLength();
     std::vector<double> window  = pImpl->mParameters.getWindow();
-    pImpl->mSpectrumScaling = computeSpectrumScaling(nWindow,
-                                                     pImpl->mSamplingRate,
-                                                     window.data());
-    pImpl->mDensityScaling = computeDensityScaling(nWindow, window.data()); 
+    pImpl->mSpectrumScaling = computeSpectrumScaling(nWindow, window.data());
+    pImpl->mDensityScaling = computeDensityScaling(nWindow,
+                                                   pImpl->mSamplingRate,
+                                                   window.data());
     // Set space for the intermediate output
     int nfreqs = pImpl->mSlidingWindowRealDFT.getNumberOfFrequencies();
     pImpl->mSumSpectrum.resize(nfreqs);
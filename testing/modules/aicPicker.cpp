@@ -0,0 +1,178 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#define RTSEIS_LOGGING 1
+#include "rtseis/modules/aicPicker.hpp"
+#include "rtseis/log.h"
+#include "modules.hpp"
+
+using namespace RTSeis::Modules;
+
+namespace
+{
+/// Reference implementation that computes each segment's variance directly
+std::vector<double> aicReference(const int n, const double x[], const int nmin)
+{
+    std::vector<double> aic(n, 0);
+    for (int k=nmin; k<=n-nmin; k++)
+    {
+        double var[2];
+        int i0[2] = {0, k};
+        int i1[2] = {k, n};
+        for (int j=0; j<2; j++)
+        {
+            double mean = 0;
+            for (int i=i0[j]; i<i1[j]; i++){mean = mean + x[i];}
+            mean = mean/(i1[j] - i0[j]);
+            var[j] = 0;
+            for (int i=i0[j]; i<i1[j]; i++)
+            {
+                var[j] = var[j] + (x[i] - mean)*(x[i] - mean);
+            }
+            var[j] = var[j]/(i1[j] - i0[j]);
+        }
+        aic[k] = k*std::log(var[0]) + (n - k)*std::log(var[1]);
+    }
+    return aic;
+}
+
+double gaussian()
+{
+    double u1 = (rand() + 1.0)/(static_cast<double> (RAND_MAX) + 2.0);
+    double u2 = (rand() + 1.0)/(static_cast<double> (RAND_MAX) + 2.0);
+    return std::sqrt(-2*std::log(u1))*std::cos(2*M_PI*u2);
+}
+}
+
+int rtseis_test_modules_aicPicker(const int npts, const double x[])
+{
+    fprintf(stdout, "Testing AIC picker...\n");
+    srand(83402);
+    int nmin = 5;
+    AICPickerParameters parms(nmin);
+    AICPicker picker(parms);
+    if (!picker.isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Failed to initialize picker");
+        return EXIT_FAILURE;
+    }
+    // Compare the AIC curves with the direct computation on windows of the
+    // data.  A large offset makes the variances harder to compute.  The data
+    // are dithered since the segments of constant samples at the ends of
+    // some windows make their minima ill-conditioned.
+    int nwin = 1000;
+    std::vector<const double *> windows;
+    std::vector<int> nx;
+    std::vector<std::vector<double>> offsetWindows;
+    for (int i0=0; i0+nwin<=npts; i0=i0+nwin/2)
+    {
+        std::vector<double> xw(x + i0, x + i0 + nwin);
+        for (auto &xi : xw){xi = xi + 1.e4 + 0.1*gaussian();}
+        offsetWindows.push_back(xw);
+    }
+    double emax = 0;
+    std::vector<double> aic(nwin);
+    for (const auto &xw : offsetWindows)
+    {
+        auto aicRef = aicReference(nwin, xw.data(), nmin);
+        picker.computeAIC(nwin, xw.data(), aic.data());
+        for (int k=nmin; k<=nwin-nmin; k++)
+        {
+            emax = std::max(emax,
+                            std::abs(aic[k] - aicRef[k])/std::abs(aicRef[k]));
+        }
+        auto kRef = std::distance(aicRef.begin() + nmin,
+                                  std::min_element(aicRef.begin() + nmin,
+                                                   aicRef.begin() + nwin - nmin + 1))
+                  + nmin;
+        AICPick pick;
+        picker.apply(nwin, xw.data(), &pick);
+        if (pick.index != kRef)
+        {
+            RTSEIS_ERRMSG("Pick=%d should be %d", pick.index,
+                          static_cast<int> (kRef));
+            return EXIT_FAILURE;
+        }
+        windows.push_back(xw.data());
+        nx.push_back(nwin);
+    }
+    if (emax > 1.e-8)
+    {
+        RTSEIS_ERRMSG("AIC failed; relative error=%e", emax);
+        return EXIT_FAILURE;
+    }
+    // The batch must match the individual picks
+    int nWindows = static_cast<int> (windows.size());
+    std::vector<AICPick> picks(nWindows);
+    picker.apply(nWindows, nx.data(), windows.data(), picks.data());
+    for (int i=0; i<nWindows; i++)
+    {
+        AICPick pick;
+        picker.apply(nx[i], windows[i], &pick);
+        if (picks[i].index != pick.index || picks[i].quality != pick.quality)
+        {
+            RTSEIS_ERRMSG("Batch pick %d is incorrect", i);
+            return EXIT_FAILURE;
+        }
+    }
+    // A sharp onset in noise
+    int n = 600;
+    int onset = 350;
+    std::vector<double> xs(n);
+    for (int i=0; i<n; i++)
+    {
+        xs[i] = gaussian();
+        if (i >= onset){xs[i] = 20*xs[i];}
+    }
+    AICPick pick;
+    picker.apply(n, xs.data(), &pick);
+    if (std::abs(pick.index - onset) > 2 || pick.quality < 0.5)
+    {
+        RTSEIS_ERRMSG("Onset pick=%d (quality=%lf) should be near %d",
+                      pick.index, pick.quality, onset);
+        return EXIT_FAILURE;
+    }
+    std::vector<float> x4(xs.begin(), xs.end());
+    AICPick pick4;
+    picker.apply(n, x4.data(), &pick4);
+    if (pick4.index != pick.index)
+    {
+        RTSEIS_ERRMSG("%s", "Float pick is incorrect");
+        return EXIT_FAILURE;
+    }
+    // A weak onset in integer counts ending in a run of identical samples.
+    // The flat run must not look infinitely quiet and attract the pick.
+    std::vector<double> xq(n);
+    int nFlat = 20;
+    for (int i=0; i<n; i++)
+    {
+        xq[i] = std::round(2*gaussian());
+        if (i >= onset){xq[i] = std::round(10*gaussian());}
+    }
+    std::fill(xq.end() - nFlat, xq.end(), xq[n - nFlat - 1]);
+    picker.apply(n, xq.data(), &pick);
+    if (std::abs(pick.index - onset) > 5)
+    {
+        RTSEIS_ERRMSG("Quantized onset pick=%d (quality=%lf) should be near %d",
+                      pick.index, pick.quality, onset);
+        return EXIT_FAILURE;
+    }
+    // Pure noise has no clear pick
+    for (int i=0; i<n; i++){xs[i] = gaussian();}
+    picker.apply(n, xs.data(), &pick);
+    if (pick.quality > 0.5)
+    {
+        RTSEIS_ERRMSG("Noise pick quality=%lf is too high", pick.quality);
+        return EXIT_FAILURE;
+    }
+    // Window too short
+    picker.apply(2*nmin - 1, xs.data(), &pick);
+    if (pick.index !=-1)
+    {
+        RTSEIS_ERRMSG("%s", "Short window should not be picked");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -64,6 +64,29 @@ int rtseis_test_modules_classicSTALTA(const int npts, const double x[],
     }
     std::chrono::duration<double> tdif = timeEnd - timeStart;
     fprintf(stdout, "Passed post-processing test in %.8e (s)\n", tdif.count());
+    // Single precision post-processing
+    ClassicSTALTAParameters ppParms32(nsta, nlta,
+                                      RTSeis::ProcessingMode::POST_PROCESSING,
+                                      RTSeis::Precision::FLOAT);
+    ClassicSTALTA stalta32(ppParms32);
+    std::vector<float> x32(x, x + npts);
+    std::vector<float> y32(npts);
+    ierr = stalta32.apply(npts, x32.data(), y32.data());
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to compute float STA/LTA");
+        return EXIT_FAILURE;
+    }
+    error = 0;
+    for (int i=0; i<npts; i++)
+    {
+        error = std::max(error, std::abs(y32[i] - yref[i]));
+    }
+    if (error > 1.e-5)
+    {
+        RTSEIS_ERRMSG("Failed float post-processing test w/ error %lf", error);
+        return EXIT_FAILURE;
+    }
     // Do real-time test
     stalta = ClassicSTALTA(rtParms);
     std::vector<int> packetSize({1, 2, 3, 16, 64, 100, 200, 512,
@@ -0,0 +1,154 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#define RTSEIS_LOGGING 1
+#include "rtseis/modules/filterPicker.hpp"
+#include "rtseis/log.h"
+#include "modules.hpp"
+
+using namespace RTSeis::Modules;
+
+namespace
+{
+std::vector<FilterPick> getPicks(const FilterPicker &picker)
+{
+    std::vector<FilterPick> picks(picker.getNumberOfPicks());
+    picker.getPicks(static_cast<int> (picks.size()), picks.data());
+    return picks;
+}
+
+bool equal(const std::vector<FilterPick> &a, const std::vector<FilterPick> &b)
+{
+    if (a.size() != b.size()){return false;}
+    for (size_t i=0; i<a.size(); i++)
+    {
+        if (a[i].index != b[i].index ||
+            a[i].triggerIndex != b[i].triggerIndex ||
+            a[i].band != b[i].band)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+double gaussian()
+{
+    double u1 = (rand() + 1.0)/(static_cast<double> (RAND_MAX) + 2.0);
+    double u2 = (rand() + 1.0)/(static_cast<double> (RAND_MAX) + 2.0);
+    return std::sqrt(-2*std::log(u1))*std::cos(2*M_PI*u2);
+}
+}
+
+int rtseis_test_modules_filterPicker(const int npts, const double x[])
+{
+    fprintf(stdout, "Testing filter picker...\n");
+    srand(10394);
+    double dt = 1.0/100;
+    // Noise with a 5 Hz arrival at 30 s
+    int n = 6000;
+    int onset = 3000;
+    std::vector<double> xs(n);
+    for (int i=0; i<n; i++)
+    {
+        xs[i] = gaussian();
+        if (i >= onset)
+        {
+            double t = (i - onset)*dt;
+            xs[i] = xs[i] + 50*std::exp(-t)*std::sin(2*M_PI*5*t);
+        }
+    }
+    FilterPickerParameters parms(1.6, 10, 10, 10, 0.5, dt);
+    if (!parms.isValid())
+    {
+        RTSEIS_ERRMSG("%s", "Parameters should be valid");
+        return EXIT_FAILURE;
+    }
+    FilterPicker picker(parms);
+    if (picker.getNumberOfBands() != 7)
+    {
+        RTSEIS_ERRMSG("Number of bands=%d should be 7",
+                      picker.getNumberOfBands());
+        return EXIT_FAILURE;
+    }
+    std::vector<double> cf(n);
+    int ierr = picker.apply(n, xs.data(), cf.data());
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to apply picker");
+        return EXIT_FAILURE;
+    }
+    auto picks = getPicks(picker);
+    if (picks.size() != 1)
+    {
+        RTSEIS_ERRMSG("Expected 1 pick but got %d",
+                      static_cast<int> (picks.size()));
+        return EXIT_FAILURE;
+    }
+    if (std::abs(picks[0].index - onset) > 5 ||
+        picks[0].index > picks[0].triggerIndex)
+    {
+        RTSEIS_ERRMSG("Pick=%d (trigger=%d) should be near %d",
+                      static_cast<int> (picks[0].index),
+                      static_cast<int> (picks[0].triggerIndex), onset);
+        return EXIT_FAILURE;
+    }
+    fprintf(stdout, "Pick error: %d samples\n",
+            static_cast<int> (picks[0].index - onset));
+    for (int i=0; i<1000; i++)
+    {
+        if (cf[i] != 0)
+        {
+            RTSEIS_ERRMSG("%s", "Characteristic function should warm up");
+            return EXIT_FAILURE;
+        }
+    }
+    // Float
+    std::vector<float> x4(xs.begin(), xs.end());
+    picker.apply(n, x4.data());
+    if (!equal(getPicks(picker), picks))
+    {
+        RTSEIS_ERRMSG("%s", "Float picks are incorrect");
+        return EXIT_FAILURE;
+    }
+    // Post-processing repeats and real-time picks carry over packets
+    std::vector<double> y(npts);
+    picker = FilterPicker(FilterPickerParameters(1.0, 5, 8, 8, 0.5, 1.0/200));
+    picker.apply(npts, x, y.data());
+    auto picksRef = getPicks(picker);
+    picker.apply(npts, x, y.data());
+    if (picksRef.empty() || !equal(getPicks(picker), picksRef))
+    {
+        RTSEIS_ERRMSG("%s", "Post-processing picks are incorrect");
+        return EXIT_FAILURE;
+    }
+    FilterPickerParameters rtParms(1.0, 5, 8, 8, 0.5, 1.0/200,
+                                   RTSeis::ProcessingMode::REAL_TIME);
+    picker = FilterPicker(rtParms);
+    std::vector<FilterPick> rtPicks;
+    std::vector<double> yrt(npts);
+    int nxloc = 0;
+    while (nxloc < npts)
+    {
+        int nptsPass = std::min(npts - nxloc, 1 + rand()%1000);
+        ierr = picker.apply(nptsPass, &x[nxloc], &yrt[nxloc]);
+        if (ierr != 0)
+        {
+            RTSEIS_ERRMSG("%s", "Failed to apply real-time picker");
+            return EXIT_FAILURE;
+        }
+        auto newPicks = getPicks(picker);
+        rtPicks.insert(rtPicks.end(), newPicks.begin(), newPicks.end());
+        picker.clearPicks();
+        nxloc = nxloc + nptsPass;
+    }
+    if (!equal(rtPicks, picksRef) || !std::equal(y.begin(), y.end(), yrt.begin()))
+    {
+        RTSEIS_ERRMSG("%s", "Real-time picks are incorrect");
+        return EXIT_FAILURE;
+    }
+    fprintf(stdout, "Found %d picks\n", static_cast<int> (rtPicks.size()));
+    return EXIT_SUCCESS;
+}
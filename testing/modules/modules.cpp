@@ -48,6 +48,78 @@ int main()
     }
     RTSEIS_INFOMSG("%s", "Passed classic STA/LTA");
 
+    ierr = rtseis_test_modules_recursiveSTALTA(npts, x);
+    if (ierr != EXIT_SUCCESS)
+    {
+        RTSEIS_ERRMSG("%s", "Failed recursive STA/LTA module");
+        return EXIT_FAILURE;
+    }
+    RTSEIS_INFOMSG("%s", "Passed recursive STA/LTA");
+
+    ierr = rtseis_test_modules_delayedSTALTA(npts, x);
+    if (ierr != EXIT_SUCCESS)
+    {
+        RTSEIS_ERRMSG("%s", "Failed delayed STA/LTA module");
+        return EXIT_FAILURE;
+    }
+    RTSEIS_INFOMSG("%s", "Passed delayed STA/LTA");
+
+    ierr = rtseis_test_modules_zDetector(npts, x);
+    if (ierr != EXIT_SUCCESS)
+    {
+        RTSEIS_ERRMSG("%s", "Failed Z-detector module");
+        return EXIT_FAILURE;
+    }
+    RTSEIS_INFOMSG("%s", "Passed Z-detector");
+
+    ierr = rtseis_test_modules_multiChannelClassicSTALTA(npts, x);
+    if (ierr != EXIT_SUCCESS)
+    {
+        RTSEIS_ERRMSG("%s", "Failed multi-channel classic STA/LTA module");
+        return EXIT_FAILURE;
+    }
+    RTSEIS_INFOMSG("%s", "Passed multi-channel classic STA/LTA");
+
+    ierr = rtseis_test_modules_thresholdTrigger(npts, x);
+    if (ierr != EXIT_SUCCESS)
+    {
+        RTSEIS_ERRMSG("%s", "Failed threshold trigger module");
+        return EXIT_FAILURE;
+    }
+    RTSEIS_INFOMSG("%s", "Passed threshold trigger");
+
+    ierr = rtseis_test_modules_multiBandSTALTA(npts, x);
+    if (ierr != EXIT_SUCCESS)
+    {
+        RTSEIS_ERRMSG("%s", "Failed multi-band STA/LTA module");
+        return EXIT_FAILURE;
+    }
+    RTSEIS_INFOMSG("%s", "Passed multi-band STA/LTA");
+
+    ierr = rtseis_test_modules_recursiveHigherOrderStatistics(npts, x);
+    if (ierr != EXIT_SUCCESS)
+    {
+        RTSEIS_ERRMSG("%s", "Failed recursive higher order statistics module");
+        return EXIT_FAILURE;
+    }
+    RTSEIS_INFOMSG("%s", "Passed recursive higher order statistics");
+
+    ierr = rtseis_test_modules_aicPicker(npts, x);
+    if (ierr != EXIT_SUCCESS)
+    {
+        RTSEIS_ERRMSG("%s", "Failed AIC picker module");
+        return EXIT_FAILURE;
+    }
+    RTSEIS_INFOMSG("%s", "Passed AIC picker");
+
+    ierr = rtseis_test_modules_filterPicker(npts, x);
+    if (ierr != EXIT_SUCCESS)
+    {
+        RTSEIS_ERRMSG("%s", "Failed filter picker module");
+        return EXIT_FAILURE;
+    }
+    RTSEIS_INFOMSG("%s", "Passed filter picker");
+
     RTSEIS_INFOMSG("%s", "Passed all tets");
     free(x);
     return EXIT_SUCCESS;
@@ -8,5 +8,16 @@ int rtseis_test_modules_demean(void);
 int rtseis_test_modules_detrend(void);
 int rtseis_test_modules_classicSTALTA(const int npts, const double x[],
                                       const std::string fileName);
+int rtseis_test_modules_recursiveSTALTA(const int npts, const double x[]);
+int rtseis_test_modules_delayedSTALTA(const int npts, const double x[]);
+int rtseis_test_modules_zDetector(const int npts, const double x[]);
+int rtseis_test_modules_multiChannelClassicSTALTA(const int npts,
+                                                  const double x[]);
+int rtseis_test_modules_thresholdTrigger(const int npts, const double x[]);
+int rtseis_test_modules_multiBandSTALTA(const int npts, const double x[]);
+int rtseis_test_modules_recursiveHigherOrderStatistics(const int npts,
+                                                      const double x[]);
+int rtseis_test_modules_aicPicker(const int npts, const double x[]);
+int rtseis_test_modules_filterPicker(const int npts, const double x[]);
 
 #endif
@@ -0,0 +1,180 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#define RTSEIS_LOGGING 1
+#include "rtseis/modules/classicSTALTA.hpp"
+#include "rtseis/modules/multiBandSTALTA.hpp"
+#include "rtseis/modules/thresholdTrigger.hpp"
+#include "rtseis/utilities/filterDesign/enums.hpp"
+#include "rtseis/utilities/filterDesign/iir.hpp"
+#include "rtseis/utilities/filterRepresentations/sos.hpp"
+#include "rtseis/log.h"
+#include "modules.hpp"
+
+using namespace RTSeis::Modules;
+using namespace RTSeis::Utilities;
+
+namespace
+{
+/// Reference implementation of a cascade of biquads in direct form I
+std::vector<double> sosfilt(const FilterRepresentations::SOS &sos,
+                            const int npts, const double x[])
+{
+    auto bs = sos.getNumeratorCoefficients();
+    auto as = sos.getDenominatorCoefficients();
+    std::vector<double> y(x, x + npts);
+    for (int is=0; is<sos.getNumberOfSections(); is++)
+    {
+        std::vector<double> xs = y;
+        const double *b = &bs[3*is];
+        const double *a = &as[3*is];
+        for (int i=0; i<npts; i++)
+        {
+            double yi = b[0]*xs[i];
+            if (i > 0){yi = yi + b[1]*xs[i-1] - a[1]*y[i-1];}
+            if (i > 1){yi = yi + b[2]*xs[i-2] - a[2]*y[i-2];}
+            y[i] = yi/a[0];
+        }
+    }
+    return y;
+}
+}
+
+int rtseis_test_modules_multiBandSTALTA(const int npts, const double x[])
+{
+    fprintf(stdout, "Testing multi-band STA/LTA...\n");
+    srand(50943);
+    double dt = 1.0/200;
+    int nsta = static_cast<int> (1/dt);
+    int nlta = static_cast<int> (10/dt);
+    // Design the bandpass filters
+    std::vector<std::pair<double, double>> corners{{1, 3}, {2, 8}, {5, 15}};
+    MultiBandSTALTAParameters parms(nsta, nlta);
+    std::vector<FilterRepresentations::SOS> filters;
+    for (const auto &c : corners)
+    {
+        double fnyq = 1/(2*dt);
+        double W[2] = {c.first/fnyq, c.second/fnyq};
+        auto sos = FilterDesign::IIR::designSOSIIRFilter(
+                       4, W, 0, 0,
+                       FilterDesign::Bandtype::BANDPASS,
+                       FilterDesign::IIRPrototype::BUTTERWORTH);
+        filters.push_back(sos);
+        parms.addBand(sos);
+    }
+    if (!parms.isValid())
+    {
+        RTSEIS_ERRMSG("%s", "Parameters should be valid");
+        return EXIT_FAILURE;
+    }
+    // Compute the reference
+    int nBands = static_cast<int> (filters.size());
+    ClassicSTALTAParameters staltaParms(nsta, nlta);
+    ClassicSTALTA stalta(staltaParms);
+    std::vector<std::vector<double>> yBandsRef(nBands);
+    std::vector<double> yRef(npts, 0);
+    for (int ib=0; ib<nBands; ib++)
+    {
+        auto xf = sosfilt(filters[ib], npts, x);
+        yBandsRef[ib].resize(npts);
+        stalta.apply(npts, xf.data(), yBandsRef[ib].data());
+        for (int i=0; i<npts; i++)
+        {
+            yRef[i] = std::max(yRef[i], yBandsRef[ib][i]);
+        }
+    }
+    // Post-processing
+    MultiBandSTALTA mbstalta(parms);
+    if (mbstalta.getNumberOfBands() != nBands)
+    {
+        RTSEIS_ERRMSG("%s", "Wrong number of bands");
+        return EXIT_FAILURE;
+    }
+    std::vector<double> y(npts);
+    std::vector<std::vector<double>> yBands(nBands, std::vector<double> (npts));
+    std::vector<double *> yBandsPtr(nBands);
+    for (int ib=0; ib<nBands; ib++){yBandsPtr[ib] = yBands[ib].data();}
+    int ierr = mbstalta.apply(npts, x, nBands, yBandsPtr.data(), y.data());
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to apply multi-band STA/LTA");
+        return EXIT_FAILURE;
+    }
+    double emax = 0;
+    for (int i=0; i<npts; i++)
+    {
+        emax = std::max(emax, std::abs(y[i] - yRef[i]));
+        for (int ib=0; ib<nBands; ib++)
+        {
+            emax = std::max(emax, std::abs(yBands[ib][i] - yBandsRef[ib][i]));
+        }
+    }
+    if (emax > 1.e-8)
+    {
+        RTSEIS_ERRMSG("Multi-band STA/LTA failed; error=%e", emax);
+        return EXIT_FAILURE;
+    }
+    // The combined statistic alone must be the same
+    std::vector<double> y2(npts);
+    mbstalta.apply(npts, x, y2.data());
+    if (!std::equal(y.begin(), y.end(), y2.begin()))
+    {
+        RTSEIS_ERRMSG("%s", "Combined statistic differs");
+        return EXIT_FAILURE;
+    }
+    // Passing the combined statistic directly to a trigger finds the same
+    // triggers as triggering the stored statistic
+    ThresholdTriggerParameters triggerParms(1.5, 1.2);
+    ThresholdTrigger triggerRef(triggerParms);
+    triggerRef.apply(npts, y.data());
+    ThresholdTrigger fusedTrigger(triggerParms);
+    ierr = mbstalta.apply(npts, x, &fusedTrigger);
+    int nTriggers = triggerRef.getNumberOfTriggers();
+    std::vector<TriggerRecord> triggersRef(nTriggers), triggers(nTriggers);
+    triggerRef.getTriggers(nTriggers, triggersRef.data());
+    if (ierr != 0 || nTriggers < 1 ||
+        fusedTrigger.getTriggers(nTriggers, triggers.data()) != 0 ||
+        fusedTrigger.getNumberOfTriggers() != nTriggers)
+    {
+        RTSEIS_ERRMSG("%s", "Fused multi-band trigger failed");
+        return EXIT_FAILURE;
+    }
+    for (int i=0; i<nTriggers; i++)
+    {
+        if (triggers[i].onset != triggersRef[i].onset ||
+            triggers[i].peak != triggersRef[i].peak ||
+            triggers[i].duration != triggersRef[i].duration)
+        {
+            RTSEIS_ERRMSG("Fused multi-band trigger %d differs", i);
+            return EXIT_FAILURE;
+        }
+    }
+    // Real-time
+    MultiBandSTALTAParameters rtParms = parms;
+    rtParms.setProcessingMode(RTSeis::ProcessingMode::REAL_TIME);
+    mbstalta = MultiBandSTALTA(rtParms);
+    std::fill(y2.begin(), y2.end(), 0);
+    int nxloc = 0;
+    while (nxloc < npts)
+    {
+        int nptsPass = std::min(npts - nxloc, 1 + rand()%1000);
+        ierr = mbstalta.apply(nptsPass, &x[nxloc], &y2[nxloc]);
+        if (ierr != 0)
+        {
+            RTSEIS_ERRMSG("%s", "Failed to apply real-time multi-band STA/LTA");
+            return EXIT_FAILURE;
+        }
+        nxloc = nxloc + nptsPass;
+    }
+    emax = 0;
+    for (int i=0; i<npts; i++){emax = std::max(emax, std::abs(y2[i] - y[i]));}
+    if (emax > 1.e-8)
+    {
+        RTSEIS_ERRMSG("Real-time multi-band STA/LTA failed; error=%e", emax);
+        return EXIT_FAILURE;
+    }
+    fprintf(stdout, "Max error: %e\n", emax);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,227 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <cmath>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#define RTSEIS_LOGGING 1
+#include "rtseis/modules/classicSTALTA.hpp"
+#include "rtseis/modules/multiChannelClassicSTALTA.hpp"
+#include "rtseis/log.h"
+#include "modules.hpp"
+
+using namespace RTSeis::Modules;
+
+int rtseis_test_modules_multiChannelClassicSTALTA(const int npts,
+                                                  const double x[])
+{
+    fprintf(stdout, "Testing multi-channel classic STA/LTA...\n");
+    srand(40238);
+    double dt = 1.0/200;
+    int nlta = static_cast<int> (10/dt);
+    int nsta = static_cast<int> (5/dt);
+    const int nChannels = 64;
+    // Make each channel a scaled and circularly shifted copy of the data
+    std::vector<std::vector<double>> xs(nChannels);
+    for (int c=0; c<nChannels; c++)
+    {
+        xs[c].resize(npts);
+        int shift = (c*997)%npts;
+        for (int i=0; i<npts; i++)
+        {
+            xs[c][i] = (1 + 0.1*c)*x[(i + shift)%npts];
+        }
+    }
+    ClassicSTALTAParameters rtParms(nsta, nlta,
+                                    RTSeis::ProcessingMode::REAL_TIME,
+                                    RTSeis::Precision::DOUBLE);
+    // Compute the reference with one module per channel
+    std::vector<std::vector<double>> yref(nChannels);
+    auto timeStart = std::chrono::high_resolution_clock::now();
+    for (int c=0; c<nChannels; c++)
+    {
+        ClassicSTALTA stalta(rtParms);
+        yref[c].resize(npts);
+        stalta.apply(npts, xs[c].data(), yref[c].data());
+    }
+    auto timeEnd = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> tdif = timeEnd - timeStart;
+    fprintf(stdout, "Single-channel modules took %.8e (s)\n", tdif.count());
+    // Apply the multi-channel module in packets of differing lengths
+    MultiChannelClassicSTALTA stalta(rtParms, nChannels);
+    if (!stalta.isInitialized() || stalta.getNumberOfChannels() != nChannels)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to initialize multi-channel STA/LTA");
+        return EXIT_FAILURE;
+    }
+    std::vector<std::vector<double>> y(nChannels);
+    for (int c=0; c<nChannels; c++){y[c].resize(npts);}
+    std::vector<int> nxloc(nChannels, 0);
+    std::vector<int> nx(nChannels);
+    std::vector<const double *> xPtr(nChannels);
+    std::vector<double *> yPtr(nChannels);
+    timeStart = std::chrono::high_resolution_clock::now();
+    while (true)
+    {
+        bool lfinished = true;
+        for (int c=0; c<nChannels; c++)
+        {
+            nx[c] = std::min(npts - nxloc[c], rand()%300);
+            xPtr[c] = xs[c].data() + nxloc[c];
+            yPtr[c] = y[c].data() + nxloc[c];
+            nxloc[c] = nxloc[c] + nx[c];
+            if (nxloc[c] < npts){lfinished = false;}
+        }
+        int ierr = stalta.apply(nChannels, nx.data(), xPtr.data(),
+                                yPtr.data());
+        if (ierr != 0)
+        {
+            RTSEIS_ERRMSG("%s", "Failed to apply multi-channel STA/LTA");
+            return EXIT_FAILURE;
+        }
+        if (lfinished){break;}
+    }
+    timeEnd = std::chrono::high_resolution_clock::now();
+    tdif = timeEnd - timeStart;
+    fprintf(stdout, "Multi-channel module took %.8e (s)\n", tdif.count());
+    for (int c=0; c<nChannels; c++)
+    {
+        for (int i=0; i<npts; i++)
+        {
+            if (y[c][i] != yref[c][i])
+            {
+                RTSEIS_ERRMSG("Channel %d differs at %d %lf %lf",
+                              c, i, y[c][i], yref[c][i]);
+                return EXIT_FAILURE;
+            }
+        }
+    }
+    // Equal-length packets update groups of channels in lockstep.  Use a
+    // channel count that leaves a partial group and interrupt the stream
+    // with one ragged packet which forces the per-channel path.
+    const int nChannelsLockstep = 13;
+    MultiChannelClassicSTALTA lockstep(rtParms, nChannelsLockstep);
+    std::fill(nxloc.begin(), nxloc.end(), 0);
+    int ipacket = 0;
+    while (nxloc[0] < npts)
+    {
+        auto packetSize = std::min(npts - nxloc[0], 1 + rand()%700);
+        for (int c=0; c<nChannelsLockstep; c++)
+        {
+            nx[c] = std::min(npts - nxloc[c], packetSize);
+            if (ipacket == 3){nx[c] = std::min(npts - nxloc[c], c);}
+            xPtr[c] = xs[c].data() + nxloc[c];
+            yPtr[c] = y[c].data() + nxloc[c];
+        }
+        // Realign the channels after the ragged packet
+        if (ipacket == 4)
+        {
+            for (int c=0; c<nChannelsLockstep; c++)
+            {
+                nx[c] = std::min(npts - nxloc[c],
+                                 nxloc[nChannelsLockstep-1] + packetSize
+                               - nxloc[c]);
+            }
+        }
+        if (lockstep.apply(nChannelsLockstep, nx.data(), xPtr.data(),
+                           yPtr.data()) != 0)
+        {
+            RTSEIS_ERRMSG("%s", "Failed to apply lockstep STA/LTA");
+            return EXIT_FAILURE;
+        }
+        for (int c=0; c<nChannelsLockstep; c++){nxloc[c] += nx[c];}
+        ipacket = ipacket + 1;
+    }
+    for (int c=0; c<nChannelsLockstep; c++)
+    {
+        if (nxloc[c] != npts)
+        {
+            RTSEIS_ERRMSG("Channel %d only processed %d samples",
+                          c, nxloc[c]);
+            return EXIT_FAILURE;
+        }
+        for (int i=0; i<npts; i++)
+        {
+            if (y[c][i] != yref[c][i])
+            {
+                RTSEIS_ERRMSG("Lockstep channel %d differs at %d", c, i);
+                return EXIT_FAILURE;
+            }
+        }
+    }
+    // Initial conditions set on one channel leave the defaults on the others
+    int nzNum = lockstep.getNumeratorInitialConditionLength();
+    int nzDen = lockstep.getDenominatorInitialConditionLength();
+    std::vector<double> zNum(nzNum), zDen(nzDen);
+    for (int i=0; i<nzNum; i++){zNum[i] = std::pow(xs[2][npts-nzNum+i], 2);}
+    for (int i=0; i<nzDen; i++){zDen[i] = std::pow(xs[2][npts-nzDen+i], 2);}
+    ClassicSTALTA staltaIC(rtParms);
+    staltaIC.setInitialConditions(nzNum, zNum.data(), nzDen, zDen.data());
+    std::vector<double> yIC(npts);
+    staltaIC.apply(npts, xs[2].data(), yIC.data());
+    if (lockstep.setInitialConditions(2, nzNum, zNum.data(),
+                                      nzDen, zDen.data()) != 0 ||
+        lockstep.resetInitialConditions() != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to set initial conditions");
+        return EXIT_FAILURE;
+    }
+    for (int c=0; c<nChannelsLockstep; c++)
+    {
+        nx[c] = npts;
+        xPtr[c] = xs[c].data();
+        yPtr[c] = y[c].data();
+    }
+    lockstep.apply(nChannelsLockstep, nx.data(), xPtr.data(), yPtr.data());
+    for (int c=0; c<nChannelsLockstep; c++)
+    {
+        const double *yc = (c == 2) ? yIC.data() : yref[c].data();
+        for (int i=0; i<npts; i++)
+        {
+            if (y[c][i] != yc[i])
+            {
+                RTSEIS_ERRMSG("Initial conditions channel %d differs at %d",
+                              c, i);
+                return EXIT_FAILURE;
+            }
+        }
+    }
+    // Post-processing in single precision resets after each application
+    ClassicSTALTAParameters ppParms(nsta, nlta,
+                                    RTSeis::ProcessingMode::POST_PROCESSING,
+                                    RTSeis::Precision::FLOAT);
+    MultiChannelClassicSTALTA stalta32(ppParms, nChannels);
+    std::vector<std::vector<float>> x32(nChannels), y32(nChannels);
+    std::vector<const float *> x32Ptr(nChannels);
+    std::vector<float *> y32Ptr(nChannels);
+    for (int c=0; c<nChannels; c++)
+    {
+        x32[c].assign(xs[c].begin(), xs[c].end());
+        y32[c].resize(npts);
+        nx[c] = npts;
+        x32Ptr[c] = x32[c].data();
+        y32Ptr[c] = y32[c].data();
+    }
+    for (int k=0; k<2; k++)
+    {
+        int ierr = stalta32.apply(nChannels, nx.data(), x32Ptr.data(),
+                                  y32Ptr.data());
+        if (ierr != 0)
+        {
+            RTSEIS_ERRMSG("%s", "Failed to apply float STA/LTA");
+            return EXIT_FAILURE;
+        }
+        for (int c=0; c<nChannels; c++)
+        {
+            for (int i=0; i<npts; i++)
+            {
+                if (std::abs(y32[c][i] - yref[c][i]) > 1.e-5)
+                {
+                    RTSEIS_ERRMSG("Float channel %d differs at %d", c, i);
+                    return EXIT_FAILURE;
+                }
+            }
+        }
+    }
+    return EXIT_SUCCESS;
+}
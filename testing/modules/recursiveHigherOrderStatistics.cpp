@@ -0,0 +1,180 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#define RTSEIS_LOGGING 1
+#include "rtseis/modules/recursiveHigherOrderStatistics.hpp"
+#include "rtseis/log.h"
+#include "modules.hpp"
+
+using namespace RTSeis::Modules;
+
+namespace
+{
+/// Reference implementation of the recursive statistic
+std::vector<double> reference(const int npts, const double x[],
+                              const int nwin, const int p)
+{
+    std::vector<double> y(npts, 0);
+    double c = 1.0/static_cast<double> (nwin);
+    double mean = 0;
+    double var = 0;
+    double stat = 0;
+    for (int i=0; i<npts; i++)
+    {
+        mean = (1 - c)*mean + c*x[i];
+        double d = x[i] - mean;
+        var = (1 - c)*var + c*d*d;
+        double z = 0;
+        if (var > 0){z = d/std::sqrt(var);}
+        stat = (1 - c)*stat + c*std::pow(z, p);
+        if (i >= nwin){y[i] = stat;}
+    }
+    return y;
+}
+
+double maxError(const int n, const double y[], const double yref[])
+{
+    double emax = 0;
+    for (int i=0; i<n; i++)
+    {
+        emax = std::max(emax, std::abs(y[i] - yref[i]));
+    }
+    return emax;
+}
+}
+
+int rtseis_test_modules_recursiveHigherOrderStatistics(const int npts,
+                                                      const double x[])
+{
+    fprintf(stdout, "Testing recursive higher order statistics...\n");
+    srand(20384);
+    int nwin = 200;
+    for (auto statistic : {HigherOrderStatistic::SKEWNESS,
+                           HigherOrderStatistic::KURTOSIS})
+    {
+        int p = 4;
+        if (statistic == HigherOrderStatistic::SKEWNESS){p = 3;}
+        auto yref = reference(npts, x, nwin, p);
+        // Post-processing
+        RecursiveHigherOrderStatisticsParameters parms(nwin, statistic);
+        RecursiveHigherOrderStatistics hos(parms);
+        std::vector<double> y(npts);
+        int ierr = hos.apply(npts, x, y.data());
+        if (ierr != 0)
+        {
+            RTSEIS_ERRMSG("%s", "Failed to apply module");
+            return EXIT_FAILURE;
+        }
+        double emax = maxError(npts, y.data(), yref.data());
+        if (emax > 1.e-8)
+        {
+            RTSEIS_ERRMSG("Post-processing failed; error=%e", emax);
+            return EXIT_FAILURE;
+        }
+        // Real-time
+        parms.setProcessingMode(RTSeis::ProcessingMode::REAL_TIME);
+        hos = RecursiveHigherOrderStatistics(parms);
+        int nxloc = 0;
+        while (nxloc < npts)
+        {
+            int nptsPass = std::min(npts - nxloc, 1 + rand()%1000);
+            hos.apply(nptsPass, &x[nxloc], &y[nxloc]);
+            nxloc = nxloc + nptsPass;
+        }
+        emax = maxError(npts, y.data(), yref.data());
+        if (emax > 1.e-8)
+        {
+            RTSEIS_ERRMSG("Real-time failed; error=%e", emax);
+            return EXIT_FAILURE;
+        }
+        // Many channels - each is a scaled and shifted signal so the
+        // standardized statistic is unchanged
+        int nChannels = 11;
+        parms.setProcessingMode(RTSeis::ProcessingMode::POST_PROCESSING);
+        hos = RecursiveHigherOrderStatistics(parms, nChannels);
+        std::vector<std::vector<double>> xs(nChannels);
+        std::vector<std::vector<double>> ys(nChannels);
+        std::vector<const double *> xPtr(nChannels);
+        std::vector<double *> yPtr(nChannels);
+        for (int c=0; c<nChannels; c++)
+        {
+            xs[c].resize(npts);
+            ys[c].resize(npts);
+            for (int i=0; i<npts; i++){xs[c][i] = (c + 1)*x[i];}
+            xPtr[c] = xs[c].data();
+            yPtr[c] = ys[c].data();
+        }
+        ierr = hos.apply(nChannels, npts, xPtr.data(), yPtr.data());
+        if (ierr != 0)
+        {
+            RTSEIS_ERRMSG("%s", "Failed to apply multi-channel module");
+            return EXIT_FAILURE;
+        }
+        for (int c=0; c<nChannels; c++)
+        {
+            emax = maxError(npts, ys[c].data(), yref.data());
+            if (emax > 1.e-8)
+            {
+                RTSEIS_ERRMSG("Channel %d failed; error=%e", c, emax);
+                return EXIT_FAILURE;
+            }
+        }
+        // Float precision
+        RecursiveHigherOrderStatisticsParameters parmsFloat(
+            nwin, statistic,
+            RTSeis::ProcessingMode::POST_PROCESSING,
+            RTSeis::Precision::FLOAT);
+        RecursiveHigherOrderStatistics hosFloat(parmsFloat);
+        std::vector<float> x4(x, x + npts);
+        std::vector<float> y4(npts);
+        hosFloat.apply(npts, x4.data(), y4.data());
+        emax = 0;
+        double ymax = 0;
+        for (int i=0; i<npts; i++)
+        {
+            emax = std::max(emax, std::abs(y4[i] - yref[i]));
+            ymax = std::max(ymax, std::abs(yref[i]));
+        }
+        if (emax > 1.e-3*ymax)
+        {
+            RTSEIS_ERRMSG("Float failed; error=%e", emax);
+            return EXIT_FAILURE;
+        }
+    }
+    // Gaussian noise has 0 skewness and a kurtosis of 3
+    int n = 200000;
+    std::vector<double> noise(n);
+    for (int i=0; i<n; i++)
+    {
+        double u1 = (rand() + 1.0)/(static_cast<double> (RAND_MAX) + 2.0);
+        double u2 = (rand() + 1.0)/(static_cast<double> (RAND_MAX) + 2.0);
+        noise[i] = std::sqrt(-2*std::log(u1))*std::cos(2*M_PI*u2);
+    }
+    RecursiveHigherOrderStatisticsParameters kparms(
+        1000, HigherOrderStatistic::KURTOSIS);
+    RecursiveHigherOrderStatistics kurtosis(kparms);
+    std::vector<double> y(n);
+    kurtosis.apply(n, noise.data(), y.data());
+    double kavg = 0;
+    for (int i=n/2; i<n; i++){kavg = kavg + y[i];}
+    kavg = kavg/static_cast<double> (n - n/2);
+    if (std::abs(kavg - 3) > 0.1)
+    {
+        RTSEIS_ERRMSG("Kurtosis of noise=%lf should be near 3", kavg);
+        return EXIT_FAILURE;
+    }
+    // A dead signal yields 0
+    std::vector<double> zeros(1000, 0);
+    kurtosis.apply(static_cast<int> (zeros.size()), zeros.data(), y.data());
+    for (size_t i=0; i<zeros.size(); i++)
+    {
+        if (y[i] != 0)
+        {
+            RTSEIS_ERRMSG("%s", "Dead signal should have 0 kurtosis");
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,239 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#define RTSEIS_LOGGING 1
+#include "rtseis/modules/recursiveSTALTA.hpp"
+#include "rtseis/modules/delayedSTALTA.hpp"
+#include "rtseis/modules/zDetector.hpp"
+#include "rtseis/log.h"
+#include "modules.hpp"
+
+using namespace RTSeis::Modules;
+
+namespace
+{
+/// Applies the module to x in randomly sized packets and compares to yref
+template<typename T>
+int checkRealTime(T &module, const int npts, const double x[],
+                  const std::vector<double> &yref, const double tol)
+{
+    std::vector<double> y(npts);
+    int nxloc = 0;
+    while (nxloc < npts)
+    {
+        int nptsPass = std::min(npts - nxloc, 1 + rand()%600);
+        int ierr = module.apply(nptsPass, &x[nxloc], &y[nxloc]);
+        if (ierr != 0)
+        {
+            RTSEIS_ERRMSG("%s", "Failed to apply module");
+            return EXIT_FAILURE;
+        }
+        nxloc = nxloc + nptsPass;
+    }
+    module.resetInitialConditions();
+    for (int i=0; i<npts; i++)
+    {
+        if (std::abs(yref[i] - y[i]) > tol)
+        {
+            RTSEIS_ERRMSG("Failed real-time test %d %lf %lf",
+                          i, y[i], yref[i]);
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+/// Applies the module to x in one pass and compares to yref
+template<typename T>
+int checkPostProcessing(T &module, const int npts, const double x[],
+                        const std::vector<double> &yref, const double tol)
+{
+    std::vector<double> y(npts);
+    int ierr = module.apply(npts, x, y.data());
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to apply module");
+        return EXIT_FAILURE;
+    }
+    double error = 0;
+    for (int i=0; i<npts; i++)
+    {
+        error = std::max(error, std::abs(y[i] - yref[i]));
+    }
+    if (error > tol)
+    {
+        RTSEIS_ERRMSG("Failed post-processing test w/ error %e", error);
+        return EXIT_FAILURE;
+    }
+    // Single precision
+    std::vector<float> x32(x, x + npts);
+    std::vector<float> y32(npts);
+    ierr = module.apply(npts, x32.data(), y32.data());
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to apply float module");
+        return EXIT_FAILURE;
+    }
+    error = 0;
+    for (int i=0; i<npts; i++)
+    {
+        error = std::max(error, std::abs(y32[i] - yref[i])
+                               /std::max(1.0, std::abs(yref[i])));
+    }
+    if (error > 1.e-5)
+    {
+        RTSEIS_ERRMSG("Failed float post-processing test w/ error %e", error);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+}
+
+int rtseis_test_modules_recursiveSTALTA(const int npts, const double x[])
+{
+    fprintf(stdout, "Testing recursive STA/LTA...\n");
+    srand(40235);
+    double dt = 1.0/200;
+    int nsta = static_cast<int> (1/dt);
+    int nlta = static_cast<int> (10/dt);
+    double weight = 3;
+    // Reference with Allen's characteristic function
+    std::vector<double> yref(npts);
+    double sta = 0;
+    double lta = 0;
+    double xPrevious = 0;
+    for (int i=0; i<npts; i++)
+    {
+        double e = x[i]*x[i] + weight*std::pow(x[i] - xPrevious, 2);
+        xPrevious = x[i];
+        sta = e/nsta + (1 - 1.0/nsta)*sta;
+        lta = e/nlta + (1 - 1.0/nlta)*lta;
+        yref[i] = 0;
+        if (i >= nlta){yref[i] = sta/lta;}
+    }
+    RecursiveSTALTAParameters ppParms(nsta, nlta);
+    ppParms.setAllenWeight(weight);
+    RecursiveSTALTA stalta(ppParms);
+    if (!stalta.isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Failed to initialize recursive STA/LTA");
+        return EXIT_FAILURE;
+    }
+    if (checkPostProcessing(stalta, npts, x, yref, 1.e-10) != EXIT_SUCCESS)
+    {
+        return EXIT_FAILURE;
+    }
+    RecursiveSTALTAParameters rtParms = ppParms;
+    rtParms.setProcessingMode(RTSeis::ProcessingMode::REAL_TIME);
+    stalta = RecursiveSTALTA(rtParms);
+    if (checkRealTime(stalta, npts, x, yref, 1.e-10) != EXIT_SUCCESS)
+    {
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+int rtseis_test_modules_delayedSTALTA(const int npts, const double x[])
+{
+    fprintf(stdout, "Testing delayed STA/LTA...\n");
+    srand(40236);
+    double dt = 1.0/200;
+    int nsta = static_cast<int> (1/dt);
+    int nlta = static_cast<int> (10/dt);
+    // The signal preceding x is 0 in the short-term window and 1 in the
+    // long-term window
+    std::vector<double> zNum(nsta - 1, 0);
+    std::vector<double> zDen(nlta, 1);
+    std::vector<double> yref(npts);
+    for (int i=0; i<npts; i++)
+    {
+        double sta = 0;
+        double lta = 0;
+        for (int j=0; j<nsta; j++)
+        {
+            if (i - j >= 0){sta = sta + x[i-j]*x[i-j];}
+        }
+        for (int j=nsta; j<nsta+nlta; j++)
+        {
+            if (i - j >= 0){lta = lta + x[i-j]*x[i-j];}
+            else if (i - j < -(nsta - 1)){lta = lta + 1;}
+        }
+        yref[i] = (sta/nsta)/(lta/nlta);
+    }
+    DelayedSTALTAParameters ppParms(nsta, nlta);
+    DelayedSTALTA stalta(ppParms);
+    int ierr = stalta.setInitialConditions(nsta - 1, zNum.data(),
+                                           nlta, zDen.data());
+    if (ierr != 0)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to set initial conditions");
+        return EXIT_FAILURE;
+    }
+    if (checkPostProcessing(stalta, npts, x, yref, 1.e-10) != EXIT_SUCCESS)
+    {
+        return EXIT_FAILURE;
+    }
+    DelayedSTALTAParameters rtParms = ppParms;
+    rtParms.setProcessingMode(RTSeis::ProcessingMode::REAL_TIME);
+    stalta = DelayedSTALTA(rtParms);
+    stalta.setInitialConditions(nsta - 1, zNum.data(), nlta, zDen.data());
+    if (checkRealTime(stalta, npts, x, yref, 1.e-10) != EXIT_SUCCESS)
+    {
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+int rtseis_test_modules_zDetector(const int npts, const double x[])
+{
+    fprintf(stdout, "Testing Z-detector...\n");
+    srand(40237);
+    double dt = 1.0/200;
+    int nsta = static_cast<int> (1/dt);
+    int nlta = static_cast<int> (10/dt);
+    std::vector<double> sta(npts);
+    for (int i=0; i<npts; i++)
+    {
+        sta[i] = 0;
+        for (int j=0; j<nsta; j++)
+        {
+            if (i - j >= 0){sta[i] = sta[i] + x[i-j]*x[i-j]/nsta;}
+        }
+    }
+    std::vector<double> yref(npts, 0);
+    for (int i=nsta+nlta-2; i<npts; i++)
+    {
+        double mean = 0;
+        double meanSquare = 0;
+        for (int j=0; j<nlta; j++)
+        {
+            double s = 0;
+            if (i - j >= 0){s = sta[i-j];}
+            mean = mean + s/nlta;
+            meanSquare = meanSquare + s*s/nlta;
+        }
+        yref[i] = (sta[i] - mean)/std::sqrt(meanSquare - mean*mean);
+    }
+    ZDetectorParameters ppParms(nsta, nlta);
+    ZDetector zdetector(ppParms);
+    if (!zdetector.isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Failed to initialize Z-detector");
+        return EXIT_FAILURE;
+    }
+    if (checkPostProcessing(zdetector, npts, x, yref, 1.e-8) != EXIT_SUCCESS)
+    {
+        return EXIT_FAILURE;
+    }
+    ZDetectorParameters rtParms = ppParms;
+    rtParms.setProcessingMode(RTSeis::ProcessingMode::REAL_TIME);
+    zdetector = ZDetector(rtParms);
+    if (checkRealTime(zdetector, npts, x, yref, 1.e-8) != EXIT_SUCCESS)
+    {
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
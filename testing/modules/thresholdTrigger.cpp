@@ -0,0 +1,216 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#define RTSEIS_LOGGING 1
+#include "rtseis/modules/classicSTALTA.hpp"
+#include "rtseis/modules/delayedSTALTA.hpp"
+#include "rtseis/modules/recursiveSTALTA.hpp"
+#include "rtseis/modules/zDetector.hpp"
+#include "rtseis/modules/thresholdTrigger.hpp"
+#include "rtseis/log.h"
+#include "modules.hpp"
+
+using namespace RTSeis::Modules;
+
+namespace
+{
+std::vector<TriggerRecord> getTriggers(const ThresholdTrigger &trigger)
+{
+    std::vector<TriggerRecord> triggers(trigger.getNumberOfTriggers());
+    trigger.getTriggers(static_cast<int> (triggers.size()), triggers.data());
+    return triggers;
+}
+
+bool equal(const std::vector<TriggerRecord> &a,
+           const std::vector<TriggerRecord> &b)
+{
+    if (a.size() != b.size()){return false;}
+    for (size_t i=0; i<a.size(); i++)
+    {
+        if (a[i].onset != b[i].onset || a[i].peak != b[i].peak ||
+            a[i].peakValue != b[i].peakValue ||
+            a[i].duration != b[i].duration ||
+            a[i].start != b[i].start || a[i].end != b[i].end)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Checks that a module passing its characteristic function directly to
+/// the trigger finds the same triggers as triggering the stored function
+template<typename M>
+int checkFused(M &module, const int npts, const double x[],
+               const ThresholdTriggerParameters &parms, const char *name)
+{
+    std::vector<double> y(npts);
+    module.apply(npts, x, y.data());
+    ThresholdTrigger triggerRef(parms);
+    triggerRef.apply(npts, y.data());
+    auto triggersRef = getTriggers(triggerRef);
+    if (triggersRef.empty())
+    {
+        RTSEIS_ERRMSG("No %s triggers on data", name);
+        return EXIT_FAILURE;
+    }
+    ThresholdTrigger fusedTrigger(parms);
+    int ierr = module.apply(npts, x, &fusedTrigger);
+    if (ierr != 0 || !equal(getTriggers(fusedTrigger), triggersRef))
+    {
+        RTSEIS_ERRMSG("Fused %s triggers are incorrect", name);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+}
+
+int rtseis_test_modules_thresholdTrigger(const int npts, const double x[])
+{
+    fprintf(stdout, "Testing threshold trigger...\n");
+    srand(40239);
+    // Characteristic function with a short trigger, a long trigger, and
+    // a trigger that is on at the end of the signal
+    std::vector<double> cf(400, 1);
+    for (int i=50; i<53; i++){cf[i] = 4;}
+    for (int i=100; i<160; i++){cf[i] = 3;}
+    cf[120] = 6;
+    for (int i=160; i<170; i++){cf[i] = 2;} // Between on and off thresholds
+    for (int i=390; i<400; i++){cf[i] = 5;}
+    ThresholdTriggerParameters ppParms(2.5, 1.5);
+    ppParms.setMinimumDuration(5);
+    ppParms.setPadding(20, 30);
+    ThresholdTrigger trigger(ppParms);
+    if (!trigger.isInitialized())
+    {
+        RTSEIS_ERRMSG("%s", "Failed to initialize trigger");
+        return EXIT_FAILURE;
+    }
+    trigger.apply(static_cast<int> (cf.size()), cf.data());
+    auto triggers = getTriggers(trigger);
+    if (triggers.size() != 2)
+    {
+        RTSEIS_ERRMSG("Expected 2 triggers but got %d",
+                      static_cast<int> (triggers.size()));
+        return EXIT_FAILURE;
+    }
+    if (triggers[0].onset != 100 || triggers[0].peak != 120 ||
+        triggers[0].peakValue != 6 || triggers[0].duration != 70 ||
+        triggers[0].start != 80 || triggers[0].end != 200)
+    {
+        RTSEIS_ERRMSG("%s", "First trigger is incorrect");
+        return EXIT_FAILURE;
+    }
+    if (triggers[1].onset != 390 || triggers[1].duration != 10 ||
+        triggers[1].end != 430)
+    {
+        RTSEIS_ERRMSG("%s", "Trigger at end of signal is incorrect");
+        return EXIT_FAILURE;
+    }
+    // Real-time triggers carry over packets
+    ThresholdTriggerParameters rtParms = ppParms;
+    rtParms.setProcessingMode(RTSeis::ProcessingMode::REAL_TIME);
+    trigger = ThresholdTrigger(rtParms);
+    std::vector<TriggerRecord> rtTriggers;
+    for (int i=0; i<static_cast<int> (cf.size()); i=i+7)
+    {
+        int n = std::min(7, static_cast<int> (cf.size()) - i);
+        trigger.apply(n, &cf[i]);
+        auto newTriggers = getTriggers(trigger);
+        rtTriggers.insert(rtTriggers.end(),
+                          newTriggers.begin(), newTriggers.end());
+        trigger.clearTriggers();
+    }
+    if (rtTriggers.size() != 1 || !equal({rtTriggers[0]}, {triggers[0]}) ||
+        !trigger.isTriggered())
+    {
+        RTSEIS_ERRMSG("%s", "Real-time triggers are incorrect");
+        return EXIT_FAILURE;
+    }
+    // Scanning in blocks between begin and end matches one application
+    ThresholdTrigger blockTrigger(ppParms);
+    blockTrigger.begin();
+    for (int i=0; i<static_cast<int> (cf.size()); i=i+7)
+    {
+        int n = std::min(7, static_cast<int> (cf.size()) - i);
+        blockTrigger.scan(n, &cf[i]);
+    }
+    blockTrigger.end();
+    if (!equal(getTriggers(blockTrigger), triggers) ||
+        blockTrigger.isTriggered())
+    {
+        RTSEIS_ERRMSG("%s", "Block triggers are incorrect");
+        return EXIT_FAILURE;
+    }
+    // The fused STA/LTA and trigger must match triggering the STA/LTA
+    double dt = 1.0/200;
+    int nsta = static_cast<int> (1/dt);
+    int nlta = static_cast<int> (10/dt);
+    ClassicSTALTAParameters staltaParms(nsta, nlta);
+    ClassicSTALTA stalta(staltaParms);
+    std::vector<double> y(npts);
+    stalta.apply(npts, x, y.data());
+    ThresholdTriggerParameters parms(1.5, 1.2);
+    parms.setPadding(100, 100);
+    ThresholdTrigger triggerRef(parms);
+    triggerRef.apply(npts, y.data());
+    auto triggersRef = getTriggers(triggerRef);
+    if (triggersRef.empty())
+    {
+        RTSEIS_ERRMSG("%s", "No triggers on data");
+        return EXIT_FAILURE;
+    }
+    ThresholdTrigger fusedTrigger(parms);
+    int ierr = stalta.apply(npts, x, &fusedTrigger);
+    if (ierr != 0 || !equal(getTriggers(fusedTrigger), triggersRef))
+    {
+        RTSEIS_ERRMSG("%s", "Fused post-processing triggers are incorrect");
+        return EXIT_FAILURE;
+    }
+    // Real-time fused
+    staltaParms.setProcessingMode(RTSeis::ProcessingMode::REAL_TIME);
+    parms.setProcessingMode(RTSeis::ProcessingMode::REAL_TIME);
+    stalta = ClassicSTALTA(staltaParms);
+    fusedTrigger = ThresholdTrigger(parms);
+    int nxloc = 0;
+    while (nxloc < npts)
+    {
+        int nptsPass = std::min(npts - nxloc, 1 + rand()%1000);
+        ierr = stalta.apply(nptsPass, &x[nxloc], &fusedTrigger);
+        if (ierr != 0)
+        {
+            RTSEIS_ERRMSG("%s", "Failed to apply fused trigger");
+            return EXIT_FAILURE;
+        }
+        nxloc = nxloc + nptsPass;
+    }
+    auto rtFused = getTriggers(fusedTrigger);
+    // A trigger that is on at the end is not yet closed in real-time
+    if (fusedTrigger.isTriggered()){triggersRef.pop_back();}
+    if (!equal(rtFused, triggersRef))
+    {
+        RTSEIS_ERRMSG("%s", "Fused real-time triggers are incorrect");
+        return EXIT_FAILURE;
+    }
+    fprintf(stdout, "Found %d triggers\n", static_cast<int> (rtFused.size()));
+    // The other characteristic functions can be fused with the trigger
+    RecursiveSTALTA rstalta(RecursiveSTALTAParameters(nsta, nlta));
+    if (checkFused(rstalta, npts, x, parms, "recursive STA/LTA") != 0)
+    {
+        return EXIT_FAILURE;
+    }
+    DelayedSTALTA dstalta(DelayedSTALTAParameters(nsta, nlta));
+    if (checkFused(dstalta, npts, x, parms, "delayed STA/LTA") != 0)
+    {
+        return EXIT_FAILURE;
+    }
+    ZDetector zdetector(ZDetectorParameters(nsta, nlta));
+    ThresholdTriggerParameters zParms(2, 1);
+    if (checkFused(zdetector, npts, x, zParms, "Z-detector") != 0)
+    {
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -1,9 +1,13 @@
 #include <cstdio>
 #include <cstdlib>
 #include <string>
+#include <cmath>
+#include <vector>
+#include <algorithm>
 #include <stdexcept>
 #include <ipps.h>
 #include "rtseis/utilities/math/convolve.hpp"
+#include "rtseis/utilities/math/normalizedCrossCorrelation.hpp"
 #include <gtest/gtest.h>
 
 namespace
@@ -297,6 +301,22 @@ TEST(UtilitiesConvolve, correlate)
             }
         }
         EXPECT_LE(emax, 1.e-10);
+        // Test 13 - the valid lags of a longer second signal are the lags
+        // of the full correlation at which it is fully overlapped
+        std::vector<double> a3({3, -1, 4, 1, -5, 9, 2, -6, 5, 3, 5, -8});
+        std::vector<double> b3({2, 7, -1, 8, 2, 8});
+        auto cfull = Convolve::correlate(a3, b3, Convolve::Mode::FULL,
+                                         implementation);
+        EXPECT_NO_THROW(
+            c = Convolve::correlate(a3, b3,
+                                    Convolve::Mode::VALID, implementation));
+        EXPECT_EQ(c.size(), a3.size() - b3.size() + 1);
+        emax = 0;
+        for (size_t i=0; i<c.size(); i++)
+        {
+            emax = std::max(emax, std::abs(cfull[b3.size() - 1 + i] - c[i]));
+        }
+        EXPECT_LE(emax, 1.e-10);
     }
 }
 
@@ -384,6 +404,103 @@ TEST(UtilitiesConvolve, autoCorrelate)
         ippsNormDiff_Inf_64f(c.data(), cref.data(), c.size(), &emax);
         EXPECT_LE(emax, 1.e-10);
     }
-} 
+}
+
+TEST(UtilitiesConvolve, normalizedCrossCorrelation)
+{
+    const int nt = 25;
+    const int n = 700;
+    srand(5013);
+    std::vector<double> t(nt), x(n), zi(nt - 1);
+    for (auto &ti : t){ti = static_cast<double> (rand())/RAND_MAX - 0.5;}
+    for (auto &xi : x){xi = static_cast<double> (rand())/RAND_MAX - 0.5;}
+    for (auto &z : zi){z = static_cast<double> (rand())/RAND_MAX - 0.5;}
+    // Bury the template, scaled, and a run of zeros
+    const int lag = 411;
+    for (int i=0; i<nt; ++i){x[lag + i] = 5*t[i];}
+    const int deadStart = 200;
+    const int deadEnd = 300;
+    std::fill(x.begin() + deadStart, x.begin() + deadEnd, 0);
+    // Reference with the initial conditions preceding the signal
+    auto reference = [&](const std::vector<double> &z0)
+    {
+        std::vector<double> signal(z0);
+        signal.insert(signal.end(), x.begin(), x.end());
+        double tnorm = 0;
+        for (const auto &ti : t){tnorm = tnorm + ti*ti;}
+        std::vector<double> yRef(n, 0);
+        for (int k=0; k<n; ++k)
+        {
+            double xy = 0;
+            double x2 = 0;
+            for (int i=0; i<nt; ++i)
+            {
+                xy = xy + t[i]*signal[k + i];
+                x2 = x2 + signal[k + i]*signal[k + i];
+            }
+            if (x2 > 0){yRef[k] = xy/std::sqrt(tnorm*x2);}
+        }
+        return yRef;
+    };
+    auto yRef = reference(std::vector<double> (nt - 1, 0));
+    auto yRefZi = reference(zi);
+    for (auto implementation : {Convolve::Implementation::DIRECT,
+                                Convolve::Implementation::FFT})
+    {
+        // Post-processing
+        Convolve::NormalizedCrossCorrelation ncc;
+        EXPECT_NO_THROW(ncc.initialize(nt, t.data(),
+                                       RTSeis::ProcessingMode::POST_PROCESSING,
+                                       implementation));
+        EXPECT_EQ(ncc.getTemplateLength(), nt);
+        EXPECT_EQ(ncc.getInitialConditionLength(), nt - 1);
+        std::vector<double> y(n);
+        auto yPtr = y.data();
+        for (int pass=0; pass<2; ++pass)
+        {
+            EXPECT_NO_THROW(ncc.apply(n, x.data(), &yPtr));
+            for (int k=0; k<n; ++k){EXPECT_NEAR(y[k], yRef[k], 1.e-10);}
+        }
+        EXPECT_NEAR(y[lag + nt - 1], 1, 1.e-12);
+        for (int k=deadStart + nt - 1; k<deadEnd; ++k){EXPECT_EQ(y[k], 0);}
+        EXPECT_NO_THROW(ncc.setInitialConditions(nt - 1, zi.data()));
+        ncc.apply(n, x.data(), &yPtr);
+        for (int k=0; k<n; ++k){EXPECT_NEAR(y[k], yRefZi[k], 1.e-10);}
+        // Real-time with packets of varying size
+        Convolve::NormalizedCrossCorrelation nccRT;
+        nccRT.initialize(nt, t.data(), RTSeis::ProcessingMode::REAL_TIME,
+                         implementation);
+        nccRT.setInitialConditions(nt - 1, zi.data());
+        for (int pass=0; pass<2; ++pass)
+        {
+            std::fill(y.begin(), y.end(), 0);
+            int i1 = 0;
+            int packetSize = 1;
+            while (i1 < n)
+            {
+                auto i2 = std::min(n, i1 + packetSize);
+                auto yp = &y[i1];
+                EXPECT_NO_THROW(nccRT.apply(i2 - i1, &x[i1], &yp));
+                i1 = i2;
+                packetSize = (packetSize*7)%53 + 1;
+            }
+            for (int k=0; k<n; ++k)
+            {
+                EXPECT_NEAR(y[k], yRefZi[k], 1.e-10);
+            }
+            nccRT.resetInitialConditions();
+        }
+        Convolve::NormalizedCrossCorrelation copy(nccRT);
+        EXPECT_TRUE(copy.isInitialized());
+    }
+    // Errors
+    Convolve::NormalizedCrossCorrelation ncc;
+    std::vector<double> zeros(nt, 0);
+    EXPECT_THROW(ncc.initialize(nt, zeros.data()), std::invalid_argument);
+    EXPECT_FALSE(ncc.isInitialized());
+    ncc.initialize(nt, t.data());
+    EXPECT_THROW(ncc.setInitialConditions(nt, zi.data()),
+                 std::invalid_argument);
+}
 
 }
@@ -19,7 +19,9 @@
 #include "rtseis/utilities/filterImplementations/multiRateFIRFilter.hpp"
 #include "rtseis/utilities/filterImplementations/medianFilter.hpp"
 #include "rtseis/utilities/filterImplementations/sosFilter.hpp"
+#include "rtseis/utilities/filterImplementations/resampler.hpp"
 #include "rtseis/utilities/filterImplementations/enums.hpp"
+#include "rtseis/utilities/interpolation/sincInterpolator.hpp"
 #include <gtest/gtest.h>
 
 namespace
@@ -1106,6 +1108,178 @@ TEST(UtilitiesFilterImplementations, decimate)
     free(x);
 }
 //============================================================================//
+TEST(UtilitiesFilterImplementations, resampler)
+{
+    // A digitizer that is nominally 100 Hz but really 99.998 Hz
+    const int npts = 4000;
+    const double samplingRate = 99.998;
+    const double ratio = 100/samplingRate;
+    auto signal = [](const double t)
+    {
+        return std::sin(2*M_PI*1.3*t) + 0.5*std::cos(2*M_PI*17.1*t + 1);
+    };
+    std::vector<double> x(npts);
+    for (int i=0; i<npts; ++i){x[i] = signal(i/samplingRate);}
+    Resampler<double> resampler;
+    EXPECT_NO_THROW(resampler.initialize(ratio));
+    EXPECT_NEAR(resampler.getRatio(), ratio, 1.e-14);
+    auto nyRef = resampler.estimateSpace(npts);
+    EXPECT_EQ(nyRef, static_cast<int> ((npts - 1)*ratio) + 1);
+    std::vector<double> yRef(nyRef);
+    auto yRefPtr = yRef.data();
+    int ny;
+    EXPECT_NO_THROW(resampler.apply(npts, x.data(), nyRef, &ny, &yRefPtr));
+    EXPECT_EQ(ny, nyRef);
+    double emax = 0;
+    for (int i=100; i<ny-100; ++i)
+    {
+        emax = std::max(emax, std::abs(yRef[i] - signal(i/100.0)));
+    }
+    EXPECT_LE(emax, 1.e-4);
+    // Real-time resampling across packets matches post-processing up to
+    // the samples that have not yet been emitted
+    Resampler<double> realTime;
+    realTime.initialize(ratio, RTSeis::ProcessingMode::REAL_TIME);
+    std::vector<double> y(nyRef + 1);
+    srand(3040);
+    int nxloc = 0;
+    int nyloc = 0;
+    int packetLen = 100;
+    while (nxloc < npts)
+    {
+        auto nptsPass = std::min(packetLen, npts - nxloc);
+        auto nyEst = realTime.estimateSpace(nptsPass);
+        int nyOut = 0;
+        auto yPtr = &y[nyloc];
+        EXPECT_NO_THROW(realTime.apply(nptsPass, &x[nxloc],
+                                       nyRef + 1 - nyloc, &nyOut, &yPtr));
+        EXPECT_EQ(nyOut, nyEst);
+        nxloc = nxloc + nptsPass;
+        nyloc = nyloc + nyOut;
+        packetLen = std::max(1, packetLen + rand()%50 - 25);
+    }
+    EXPECT_LE(nyloc, nyRef);
+    EXPECT_GE(nyloc, nyRef - static_cast<int> (16*ratio) - 1);
+    for (int i=0; i<nyloc; ++i){EXPECT_NEAR(y[i], yRef[i], 1.e-12);}
+    // Downsampling a 50 Hz channel to 40 Hz attenuates energy above the
+    // new Nyquist frequency
+    Resampler<double> downsampler;
+    downsampler.initialize(0.8);
+    std::vector<double> tone(npts);
+    for (int i=0; i<npts; ++i){tone[i] = std::sin(2*M_PI*24.0*i/50.0);}
+    auto nDown = downsampler.estimateSpace(npts);
+    std::vector<double> yDown(nDown);
+    auto yDownPtr = yDown.data();
+    downsampler.apply(npts, tone.data(), nDown, &ny, &yDownPtr);
+    EXPECT_EQ(ny, nDown);
+    double amax = 0;
+    for (int i=100; i<ny-100; ++i){amax = std::max(amax, std::abs(yDown[i]));}
+    EXPECT_LE(amax, 0.01);
+    // Lowering the ratio after initialization lowers the cutoff as well
+    Resampler<double> retuned;
+    retuned.initialize(1);
+    retuned.setRatio(0.8);
+    EXPECT_EQ(retuned.estimateSpace(npts), nDown);
+    std::vector<double> yRetuned(nDown);
+    auto yRetunedPtr = yRetuned.data();
+    retuned.apply(npts, tone.data(), nDown, &ny, &yRetunedPtr);
+    EXPECT_EQ(ny, nDown);
+    amax = 0;
+    for (int i=100; i<ny-100; ++i)
+    {
+        amax = std::max(amax, std::abs(yRetuned[i]));
+    }
+    EXPECT_LE(amax, 0.01);
+    // Raising the ratio again restores the band above the old cutoff
+    Resampler<double> restored;
+    restored.initialize(1, RTSeis::ProcessingMode::REAL_TIME);
+    std::vector<double> highTone(npts);
+    for (int i=0; i<npts; ++i){highTone[i] = std::sin(2*M_PI*0.3*i);}
+    std::vector<double> yRestored(2*npts);
+    auto yRestoredPtr = yRestored.data();
+    restored.setRatio(0.5);
+    restored.apply(npts/2, highTone.data(), 2*npts, &ny, &yRestoredPtr);
+    restored.setRatio(1);
+    EXPECT_NEAR(restored.getRatio(), 1, 1.e-14);
+    restored.apply(npts/2, highTone.data() + npts/2, 2*npts,
+                   &ny, &yRestoredPtr);
+    EXPECT_GT(ny, 1000);
+    double power = 0;
+    for (int i=ny-1000; i<ny; ++i){power = power + yRestored[i]*yRestored[i];}
+    EXPECT_NEAR(std::sqrt(2*power/1000), 1, 0.01);
+    // Strong decimation still rejects energy just above the new Nyquist
+    // frequency
+    Resampler<double> decimator;
+    decimator.initialize(0.25);
+    std::vector<double> stopTone(npts), passTone(npts);
+    for (int i=0; i<npts; ++i)
+    {
+        stopTone[i] = std::sin(2*M_PI*0.16*i);
+        passTone[i] = std::sin(2*M_PI*0.02*i);
+    }
+    auto nDecimate = decimator.estimateSpace(npts);
+    std::vector<double> yStop(nDecimate), yPass(nDecimate);
+    auto yStopPtr = yStop.data();
+    auto yPassPtr = yPass.data();
+    decimator.apply(npts, stopTone.data(), nDecimate, &ny, &yStopPtr);
+    decimator.apply(npts, passTone.data(), nDecimate, &ny, &yPassPtr);
+    EXPECT_EQ(ny, nDecimate);
+    amax = 0;
+    emax = 0;
+    for (int i=100; i<ny-100; ++i)
+    {
+        amax = std::max(amax, std::abs(yStop[i]));
+        emax = std::max(emax, std::abs(yPass[i] - passTone[4*i]));
+    }
+    EXPECT_LE(amax, 1.e-3);
+    EXPECT_LE(emax, 1.e-3);
+    // A time-varying ratio advances the output positions continuously
+    realTime.resetInitialConditions();
+    std::vector<double> positions;
+    double t = 0;
+    nxloc = 0;
+    y.resize(2*npts);
+    nyloc = 0;
+    double rPrevious = ratio;
+    for (const int nptsPass : {1000, 1000, 1000, 1000})
+    {
+        auto r = ratio*(1 + 1.e-3*nxloc/npts);
+        realTime.setRatio(r);
+        int nyOut = 0;
+        auto yPtr = &y[nyloc];
+        realTime.apply(nptsPass, &x[nxloc], 2*npts - nyloc, &nyOut, &yPtr);
+        for (int i=0; i<nyOut; ++i)
+        {
+            // The first sample after a ratio change keeps the old spacing
+            if (nyloc + i > 0){t = t + ((i == 0) ? 1/rPrevious : 1/r);}
+            positions.push_back(t);
+        }
+        if (nyOut > 0){rPrevious = r;}
+        nxloc = nxloc + nptsPass;
+        nyloc = nyloc + nyOut;
+    }
+    EXPECT_EQ(static_cast<int> (positions.size()), nyloc);
+    RTSeis::Utilities::Interpolation::SincInterpolator<double> interpolator;
+    interpolator.initialize();
+    std::vector<double> yq(nyloc);
+    auto yqPtr = yq.data();
+    interpolator.interpolate(npts, x.data(), nyloc, positions.data(), &yqPtr);
+    emax = 0;
+    for (int i=0; i<nyloc; ++i)
+    {
+        emax = std::max(emax, std::abs(y[i] - yq[i]));
+    }
+    EXPECT_LE(emax, 1.e-9);
+    // Single precision
+    Resampler<float> resampler32;
+    resampler32.initialize(ratio);
+    std::vector<float> x32(x.begin(), x.end()), y32(nyRef);
+    auto y32Ptr = y32.data();
+    resampler32.apply(npts, x32.data(), nyRef, &ny, &y32Ptr);
+    EXPECT_EQ(ny, nyRef);
+    for (int i=0; i<ny; ++i){EXPECT_NEAR(y32[i], yRef[i], 1.e-4);}
+}
+//============================================================================//
 void read_decimate(const int nq, std::vector<double> *xdecim)
 {
     xdecim->resize(0);
@@ -12,6 +12,7 @@
 #include "rtseis/utilities/interpolation/interpolate.hpp"
 #include "rtseis/utilities/interpolation/cubicSpline.hpp"
 #include "rtseis/utilities/interpolation/weightedAverageSlopes.hpp"
+#include "rtseis/utilities/interpolation/sincInterpolator.hpp"
 #include <gtest/gtest.h>
 
 namespace
@@ -288,6 +289,118 @@ TEST(UtilitiesInterpolation, weighedAverageSlopes)
     EXPECT_LE(error, 1.e-8);
 }
 
+TEST(UtilitiesInterpolation, sincInterpolator)
+{
+    // A band-limited signal
+    const int npts = 1000;
+    const std::vector<double> frequencies{0.013, 0.071, 0.1537, 0.32};
+    auto signal = [&frequencies](const double t)
+    {
+        double y = 0;
+        for (int k=0; k<static_cast<int> (frequencies.size()); ++k)
+        {
+            y = y + std::cos(2*M_PI*frequencies[k]*t + k);
+        }
+        return y;
+    };
+    std::vector<double> x(npts);
+    for (int i=0; i<npts; ++i){x[i] = signal(i);}
+    SincInterpolator<double> interpolator;
+    EXPECT_NO_THROW(interpolator.initialize(24));
+    EXPECT_EQ(interpolator.getHalfWidth(), 24);
+    EXPECT_EQ(interpolator.getInitialConditionLength(), 48);
+    // Samples are reproduced
+    const int nq = 5000;
+    std::vector<double> xq(nq), yq(nq);
+    auto yqPtr = yq.data();
+    for (int i=0; i<npts; ++i){xq[i] = i;}
+    interpolator.interpolate(npts, x.data(), npts, xq.data(), &yqPtr);
+    for (int i=0; i<npts; ++i){EXPECT_NEAR(yq[i], x[i], 1.e-14);}
+    // Away from the edges the band-limited signal is recovered
+    srand(3039);
+    for (auto &t : xq){t = uniformRandom(100, npts - 100);}
+    interpolator.interpolate(npts, x.data(), nq, xq.data(), &yqPtr);
+    double emax = 0;
+    for (int i=0; i<nq; ++i)
+    {
+        emax = std::max(emax, std::abs(yq[i] - signal(xq[i])));
+    }
+    EXPECT_LE(emax, 1.e-3);
+    SincInterpolator<double> lanczos;
+    lanczos.initialize(24, SincWindowType::LANCZOS);
+    lanczos.interpolate(npts, x.data(), nq, xq.data(), &yqPtr);
+    emax = 0;
+    for (int i=0; i<nq; ++i)
+    {
+        emax = std::max(emax, std::abs(yq[i] - signal(xq[i])));
+    }
+    EXPECT_LE(emax, 1.e-2);
+    // Regularly spaced points like those from a clock drift
+    const double start =-10.5;
+    const double step = 1.00002;
+    std::vector<double> yr(npts);
+    auto yrPtr = yr.data();
+    for (int i=0; i<npts; ++i){xq[i] = start + i*step;}
+    interpolator.interpolate(npts, x.data(), npts, xq.data(), &yqPtr);
+    interpolator.interpolate(npts, x.data(), npts, start, step, &yrPtr);
+    for (int i=0; i<npts; ++i){EXPECT_NEAR(yq[i], yr[i], 1.e-14);}
+    // Real-time interpolation across packets matches post-processing
+    SincInterpolator<double> realTime;
+    realTime.initialize(24, SincWindowType::KAISER, 1,
+                        RTSeis::ProcessingMode::REAL_TIME);
+    const int halfWidth = realTime.getHalfWidth();
+    std::vector<double> yrt;
+    int i0 = 0;
+    int iq = 0;
+    for (const int packetSize : {70, 1, 150, 279, 500})
+    {
+        // Points that are supported by this packet
+        std::vector<double> xqPacket;
+        while (iq < npts && xq[iq] < i0 + packetSize - halfWidth)
+        {
+            if (xq[iq] >= i0 - halfWidth){xqPacket.push_back(xq[iq] - i0);}
+            iq = iq + 1;
+        }
+        std::vector<double> yqPacket(xqPacket.size());
+        auto yqPacketPtr = yqPacket.data();
+        EXPECT_NO_THROW(realTime.interpolate(packetSize, &x[i0],
+                                             xqPacket.size(),
+                                             xqPacket.data(),
+                                             &yqPacketPtr));
+        yrt.insert(yrt.end(), yqPacket.begin(), yqPacket.end());
+        i0 = i0 + packetSize;
+    }
+    EXPECT_EQ(i0, npts);
+    EXPECT_GT(yrt.size(), 900);
+    // Points before the first sample use the zero initial conditions
+    EXPECT_EQ(static_cast<int> (yrt.size()), iq);
+    for (int i=0; i<iq; ++i){EXPECT_NEAR(yrt[i], yq[i], 1.e-13);}
+    double bad = npts;
+    EXPECT_THROW(realTime.interpolate(10, x.data(), 1, &bad, &yqPtr),
+                 std::invalid_argument);
+    // Changing the cutoff is the same as initializing with it
+    EXPECT_NEAR(interpolator.getCutoff(), 1, 1.e-14);
+    EXPECT_NO_THROW(interpolator.setCutoff(0.7));
+    EXPECT_NEAR(interpolator.getCutoff(), 0.7, 1.e-14);
+    SincInterpolator<double> lowPass;
+    lowPass.initialize(24, SincWindowType::KAISER, 0.7);
+    std::vector<double> yCut(npts), yLow(npts);
+    auto yCutPtr = yCut.data();
+    auto yLowPtr = yLow.data();
+    interpolator.interpolate(npts, x.data(), npts, start, step, &yCutPtr);
+    lowPass.interpolate(npts, x.data(), npts, start, step, &yLowPtr);
+    for (int i=0; i<npts; ++i){EXPECT_NEAR(yCut[i], yLow[i], 1.e-14);}
+    EXPECT_THROW(interpolator.setCutoff(0), std::invalid_argument);
+    // Single precision
+    SincInterpolator<float> interpolator32;
+    interpolator32.initialize(24);
+    SincInterpolator<float> copy(interpolator32);
+    std::vector<float> x32(x.begin(), x.end()), y32(npts);
+    auto y32Ptr = y32.data();
+    copy.interpolate(npts, x32.data(), npts, start, step, &y32Ptr);
+    for (int i=0; i<npts; ++i){EXPECT_NEAR(y32[i], yr[i], 1.e-4);}
+}
+
 /*
 void spline(const std::vector<double> &xIn,
             const std::vector<double> &yIn,
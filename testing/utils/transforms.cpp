@@ -19,11 +19,24 @@
 #include "rtseis/utilities/transforms/hilbert.hpp"
 #include "rtseis/utilities/transforms/envelope.hpp"
 #include "rtseis/utilities/transforms/firEnvelope.hpp"
+#include "rtseis/utilities/transforms/blockEnvelope.hpp"
 #include "rtseis/utilities/transforms/welch.hpp"
+#include "rtseis/utilities/transforms/streamingWelch.hpp"
+#include "rtseis/utilities/transforms/crossSpectrum.hpp"
+#include "rtseis/utilities/transforms/ppsd.hpp"
+#include "rtseis/utilities/transforms/slidingDFTBank.hpp"
+#include "rtseis/utilities/transforms/chirpZTransform.hpp"
+#include "rtseis/utilities/transforms/continuousWaveletTransform.hpp"
+#include "rtseis/utilities/transforms/stockwellTransform.hpp"
+#include "rtseis/utilities/transforms/multitaper.hpp"
+#include "rtseis/utilities/transforms/timeShift.hpp"
+#include "rtseis/utilities/transforms/matchedFilter.hpp"
 #include "rtseis/utilities/transforms/slidingWindowRealDFTParameters.hpp"
 #include "rtseis/utilities/transforms/slidingWindowRealDFT.hpp"
 #include "rtseis/utilities/transforms/utilities.hpp"
 #include "rtseis/utilities/windowFunctions.hpp"
+#include "rtseis/utilities/filterDesign/fir.hpp"
+#include "rtseis/utilities/filterRepresentations/fir.hpp"
 #include <gtest/gtest.h>
 
 namespace
@@ -130,6 +143,30 @@ TEST(UtilitiesTransforms, NextPow2)
     EXPECT_EQ(DFTUtilities::nextPowerOfTwo(131072), 131072);
 }
 
+TEST(UtilitiesTransforms, NextFastLength)
+{
+    EXPECT_EQ(DFTUtilities::nextFastLength(0), 1);
+    EXPECT_EQ(DFTUtilities::nextFastLength(1), 1);
+    EXPECT_EQ(DFTUtilities::nextFastLength(11), 12);
+    EXPECT_EQ(DFTUtilities::nextFastLength(13), 14);
+    EXPECT_EQ(DFTUtilities::nextFastLength(1200), 1200);
+    EXPECT_EQ(DFTUtilities::nextFastLength(1025), 1029);
+    EXPECT_EQ(DFTUtilities::nextFastLength(65537), 65610);
+    // Compare to a brute force search
+    for (int n=2; n<3000; ++n)
+    {
+        int nRef = n;
+        while (true)
+        {
+            int m = nRef;
+            for (int p : {2, 3, 5, 7}){while (m%p == 0){m = m/p;}}
+            if (m == 1){break;}
+            nRef = nRef + 1;
+        }
+        EXPECT_EQ(DFTUtilities::nextFastLength(n), nRef);
+    }
+}
+
 //int transforms_unwrap_test(void)
 TEST(UtilitiesTransforms, Unwrap)
 {
@@ -649,6 +686,105 @@ TEST(UtilitiesTransforms, Envelope)
     ASSERT_LE(errorLower, 1.e-9);
 }
 
+TEST(UtilitiesTransforms, BlockEnvelope)
+{
+    // Broadband signal with a non-zero mean
+    const int npts = 20011;
+    std::vector<double> x(npts);
+    srand(8832);
+    for (auto &xi : x){xi = 3 + static_cast<double> (rand())/RAND_MAX - 0.5;}
+    Envelope<double> envelope;
+    envelope.initialize(npts);
+    std::vector<double> upRef(npts), loRef(npts);
+    auto upRefPtr = upRef.data();
+    auto loRefPtr = loRef.data();
+    envelope.transform(npts, x.data(), &upRefPtr, &loRefPtr);
+    for (int overlap : {128, 512})
+    {
+        BlockEnvelope<double> blockEnvelope;
+        EXPECT_NO_THROW(blockEnvelope.initialize(1000, overlap));
+        EXPECT_EQ(blockEnvelope.getBlockSize(), 1000);
+        EXPECT_GE(blockEnvelope.getTransformLength(), 1000 + 2*overlap);
+        std::vector<double> up(npts), lo(npts);
+        auto upPtr = up.data();
+        auto loPtr = lo.data();
+        EXPECT_NO_THROW(blockEnvelope.transform(npts, x.data(),
+                                                &upPtr, &loPtr));
+        double emax = 0;
+        double emean = 0;
+        for (int i=overlap; i<npts-overlap; ++i)
+        {
+            emax = std::max(emax, std::abs(up[i] - upRef[i]));
+            emean = emean + std::abs(up[i] - upRef[i]);
+            EXPECT_NEAR(lo[i] - loRef[i], -(up[i] - upRef[i]), 1.e-12);
+        }
+        emean = emean/(npts - 2*overlap);
+        fprintf(stdout, "Overlap %d: max error %.4e, mean error %.4e\n",
+                overlap, emax, emean);
+        EXPECT_LE(emax, 0.05);
+        EXPECT_LE(emean, 5.e-3);
+        // Stream the signal in chunks of varying size
+        const int maxy = npts + 1000 + blockEnvelope.getLatency();
+        std::vector<double> ys(maxy);
+        int nOut = 0;
+        int i1 = 0;
+        int chunk = 1;
+        while (i1 < npts)
+        {
+            auto i2 = std::min(npts, i1 + chunk);
+            auto ysPtr = ys.data() + nOut;
+            nOut = nOut + blockEnvelope.update(i2 - i1, &x[i1],
+                                               maxy - nOut, &ysPtr);
+            EXPECT_LE(i2 - nOut, 1000 + blockEnvelope.getLatency());
+            i1 = i2;
+            chunk = (chunk*13)%997 + 1;
+        }
+        auto ysPtr = ys.data() + nOut;
+        nOut = nOut + blockEnvelope.flush(maxy - nOut, &ysPtr);
+        EXPECT_EQ(nOut, npts);
+        emax = 0;
+        emean = 0;
+        for (int i=overlap; i<npts-overlap; ++i)
+        {
+            emax = std::max(emax, std::abs(ys[i] - upRef[i]));
+            emean = emean + std::abs(ys[i] - upRef[i]);
+        }
+        emean = emean/(npts - 2*overlap);
+        fprintf(stdout,
+                "Streaming overlap %d: max error %.4e, mean error %.4e\n",
+                overlap, emax, emean);
+        EXPECT_LE(emax, 0.06);
+        EXPECT_LE(emean, 1.e-2);
+        // The stream was reset so streaming it at once is identical
+        std::vector<double> ys1(maxy);
+        auto ys1Ptr = ys1.data();
+        nOut = blockEnvelope.update(npts, x.data(), maxy, &ys1Ptr);
+        ys1Ptr = ys1.data() + nOut;
+        blockEnvelope.flush(maxy - nOut, &ys1Ptr);
+        for (int i=0; i<npts; ++i){EXPECT_NEAR(ys1[i], ys[i], 1.e-12);}
+    }
+    // A block covering the whole record with no overlap is the
+    // zero-padded analytic signal
+    BlockEnvelope<double> blockEnvelope;
+    EXPECT_NO_THROW(blockEnvelope.initialize(npts, 0));
+    std::vector<double> up(npts);
+    auto upPtr = up.data();
+    blockEnvelope.transform(npts, x.data(), &upPtr);
+    auto nFast = blockEnvelope.getTransformLength();
+    std::vector<double> xPad(nFast, 0);
+    double mean = std::accumulate(x.begin(), x.end(), 0.0)/npts;
+    for (int i=0; i<npts; ++i){xPad[i] = x[i] - mean;}
+    Envelope<double> envelopePad;
+    envelopePad.initialize(nFast);
+    std::vector<double> upPad(nFast);
+    auto upPadPtr = upPad.data();
+    envelopePad.transform(nFast, xPad.data(), &upPadPtr);
+    for (int i=0; i<npts; ++i)
+    {
+        EXPECT_NEAR(up[i], upPad[i] + mean, 1.e-10);
+    }
+}
+
 TEST(UtilitiesTransforms, firEnvelope)
 {
     const std::string fileName1 = "data/envelopeChirpReference300.txt";
@@ -797,6 +933,62 @@ TEST(UtilitiesTransforms, firEnvelope)
     }
 }
 
+TEST(UtilitiesTransforms, firEnvelopeType3)
+{
+    // Compare the type III kernel to a direct application of the taps
+    const int ntaps = 51;
+    const int npts = 3100;
+    auto zfir = RTSeis::Utilities::FilterDesign::FIR::HilbertTransformer(
+                    ntaps - 1, 8);
+    auto hi = zfir.second.getFilterTaps();
+    std::vector<double> x(npts), zi(ntaps - 1);
+    srand(10394);
+    for (auto &xi : x){xi = static_cast<double> (rand())/RAND_MAX - 0.5;}
+    for (auto &z : zi){z = static_cast<double> (rand())/RAND_MAX - 0.5;}
+    // Signal preceded by the initial conditions
+    std::vector<double> xext(zi);
+    xext.insert(xext.end(), x.begin(), x.end());
+    std::vector<double> yRef(npts);
+    for (int i=0; i<npts; ++i)
+    {
+        auto j = i + ntaps - 1;
+        auto yr = xext[j - ntaps/2];
+        double yi = 0;
+        for (int k=0; k<ntaps; ++k){yi = yi + hi[k]*xext[j - k];}
+        yRef[i] = std::hypot(yr, yi);
+    }
+    FIREnvelope<double> env;
+    FIREnvelope<float> envf;
+    EXPECT_NO_THROW(env.initialize(ntaps, RTSeis::ProcessingMode::REAL_TIME));
+    EXPECT_NO_THROW(envf.initialize(ntaps, RTSeis::ProcessingMode::REAL_TIME));
+    EXPECT_EQ(env.getInitialConditionLength(), ntaps - 1);
+    EXPECT_NO_THROW(env.setInitialConditions(zi.size(), zi.data()));
+    EXPECT_NO_THROW(envf.setInitialConditions(zi.size(), zi.data()));
+    std::vector<float> xf(x.begin(), x.end());
+    std::vector<double> y(npts);
+    std::vector<float> yf(npts);
+    for (int job=0; job<2; ++job)
+    {
+        for (int i=0; i<npts;)
+        {
+            auto nPacket = std::min(npts - i, 1 + rand()%1500);
+            auto yPtr = y.data() + i;
+            auto yfPtr = yf.data() + i;
+            EXPECT_NO_THROW(env.transform(nPacket, x.data() + i, &yPtr));
+            EXPECT_NO_THROW(envf.transform(nPacket, xf.data() + i, &yfPtr));
+            i = i + nPacket;
+        }
+        for (int i=0; i<npts; ++i)
+        {
+            EXPECT_NEAR(y[i], yRef[i], 1.e-12);
+            EXPECT_NEAR(yf[i], yRef[i], 1.e-5);
+        }
+        // Resetting should restore the initial conditions
+        env.resetInitialConditions();
+        envf.resetInitialConditions();
+    }
+}
+
 TEST(UtilitiesTransforms, SlidingWindowRealDFTParameters)
 {
     SlidingWindowRealDFTParameters parameters;
@@ -963,6 +1155,67 @@ TEST(UtilitiesTransforms, Spectrogram)
         }
     }
     ASSERT_LE(resmax, 1.e-7);
+    // The compact outputs are computed blockwise and match the complex
+    // spectrogram
+    for (auto outputType : {SlidingWindowOutputType::MAGNITUDE,
+                            SlidingWindowOutputType::POWER,
+                            SlidingWindowOutputType::DECIBEL})
+    {
+        for (auto outputPrecision : {RTSeis::Precision::DOUBLE,
+                                     RTSeis::Precision::FLOAT})
+        {
+            SlidingWindowRealDFTParameters compactParameters(parameters);
+            compactParameters.setOutputType(outputType, outputPrecision);
+            EXPECT_EQ(compactParameters.getOutputType(), outputType);
+            EXPECT_EQ(compactParameters.getOutputPrecision(),
+                      outputPrecision);
+            SlidingWindowRealDFT compact;
+            EXPECT_NO_THROW(compact.initialize(compactParameters));
+            EXPECT_EQ(compact.getOutputType(), outputType);
+            EXPECT_NO_THROW(compact.transform(sig.size(), sig.data()));
+            EXPECT_THROW(compact.getTransform64f(0), std::runtime_error);
+            auto nWindows = compact.getNumberOfTransformWindows();
+            auto nFrequencies = compact.getNumberOfFrequencies();
+            resmax = 0;
+            for (auto i=0; i<nWindows; ++i)
+            {
+                const std::complex<double> *cptr = sdft.getTransform64f(i);
+                const double *yptr64 = nullptr;
+                const float *yptr32 = nullptr;
+                if (outputPrecision == RTSeis::Precision::DOUBLE)
+                {
+                    EXPECT_NO_THROW(yptr64 = compact.getSpectrum64f(i));
+                }
+                else
+                {
+                    EXPECT_NO_THROW(yptr32 = compact.getSpectrum32f(i));
+                }
+                for (auto j=0; j<nFrequencies; ++j)
+                {
+                    double yRef = std::abs(cptr[j]);
+                    if (outputType == SlidingWindowOutputType::POWER)
+                    {
+                        yRef = std::norm(cptr[j]);
+                    }
+                    else if (outputType == SlidingWindowOutputType::DECIBEL)
+                    {
+                        yRef = 10*std::log10(std::norm(cptr[j]));
+                    }
+                    double y = (yptr64 != nullptr) ? yptr64[j] : yptr32[j];
+                    resmax = std::max(resmax,
+                                      std::abs(y - yRef)/(1 + std::abs(yRef)));
+                }
+            }
+            if (outputPrecision == RTSeis::Precision::DOUBLE)
+            {
+                EXPECT_LE(resmax, 1.e-12);
+            }
+            else
+            {
+                EXPECT_LE(resmax, 1.e-6);
+            }
+        }
+    }
 }
 
 TEST(UtilitiesTransforms, Welch)
@@ -998,6 +1251,12 @@ TEST(UtilitiesTransforms, Welch)
     EXPECT_NO_THROW(parameters.setDFTLength(fftLength));
     EXPECT_TRUE(parameters.isValid());
     Welch welch;
+    // Welch needs the complex transform
+    SlidingWindowRealDFTParameters powerParameters(parameters);
+    powerParameters.setOutputType(SlidingWindowOutputType::POWER);
+    EXPECT_THROW(welch.initialize(powerParameters, samplingRate),
+                 std::invalid_argument);
+    EXPECT_FALSE(welch.isInitialized());
     EXPECT_NO_THROW(welch.initialize(parameters, samplingRate));
     EXPECT_EQ(welch.getNumberOfSamples(), nSamples);
     int nFrequencies = welch.getNumberOfFrequencies(); 
@@ -1016,11 +1275,11 @@ TEST(UtilitiesTransforms, Welch)
     // Get and compare results
     std::vector<double> spectrum(nFrequencies); 
     double *sPtr = spectrum.data();
-    EXPECT_NO_THROW(welch.getPowerSpectralDensity(nFrequencies, &sPtr));
+    EXPECT_NO_THROW(welch.getPowerSpectrum(nFrequencies, &sPtr));
     ippsNormDiff_Inf_64f(powerRef1.data(), spectrum.data(),
                          nFrequencies, &error);
     EXPECT_LE(error, 1.e-5);
-    EXPECT_NO_THROW(welch.getPowerSpectrum(nFrequencies, &sPtr));
+    EXPECT_NO_THROW(welch.getPowerSpectralDensity(nFrequencies, &sPtr));
     ippsNormDiff_Inf_64f(psdRef1.data(), spectrum.data(),
                          nFrequencies, &error);
     EXPECT_LE(error, 1.e-5);
@@ -1048,15 +1307,1107 @@ TEST(UtilitiesTransforms, Welch)
     EXPECT_NO_THROW(welch.transform(nSamples, xSineSignal.data()));
     spectrum.resize(nFrequencies);
     sPtr = spectrum.data();
-    EXPECT_NO_THROW(welch.getPowerSpectralDensity(nFrequencies, &sPtr));
+    EXPECT_NO_THROW(welch.getPowerSpectrum(nFrequencies, &sPtr));
     ippsNormDiff_Inf_64f(powerRef2.data(), spectrum.data(),
                          nFrequencies, &error);
     EXPECT_LE(error, 1.e-5);
-    EXPECT_NO_THROW(welch.getPowerSpectrum(nFrequencies, &sPtr));
+    EXPECT_NO_THROW(welch.getPowerSpectralDensity(nFrequencies, &sPtr));
     ippsNormDiff_Inf_64f(psdRef2.data(), spectrum.data(),
                          nFrequencies, &error);
     EXPECT_LE(error, 1.e-5);
 }
+TEST(UtilitiesTransforms, StreamingWelch)
+{
+    double samplingRate = 100;
+    int nSamples = 5000;
+    int nWindowLength = 256;
+    int nSamplesInOverlap = 128;
+    int fftLength = 300;
+    std::vector<double> x(nSamples);
+    srand(4093);
+    for (auto i=0; i<nSamples; ++i)
+    {
+        auto time = static_cast<double> (i)/samplingRate;
+        x[i] = std::sin(2.0*M_PI*time*7.5)
+             + static_cast<double> (rand())/RAND_MAX - 0.5;
+    }
+    SlidingWindowRealDFTParameters parameters;
+    EXPECT_NO_THROW(parameters.setNumberOfSamples(nSamples));
+    EXPECT_NO_THROW(parameters.setWindow(nWindowLength,
+                                         SlidingWindowWindowType::HANN));
+    EXPECT_NO_THROW(parameters.setNumberOfSamplesInOverlap(nSamplesInOverlap));
+    EXPECT_NO_THROW(parameters.setDetrendType(SlidingWindowDetrendType::REMOVE_MEAN));
+    EXPECT_NO_THROW(parameters.setDFTLength(fftLength));
+    // Batch reference
+    Welch welch;
+    EXPECT_NO_THROW(welch.initialize(parameters, samplingRate));
+    EXPECT_NO_THROW(welch.transform(nSamples, x.data()));
+    int nFrequencies = welch.getNumberOfFrequencies();
+    std::vector<double> psdRef(nFrequencies), psd(nFrequencies);
+    double *psdPtr = psdRef.data();
+    welch.getPowerSpectralDensity(nFrequencies, &psdPtr);
+    // Cumulative averaging should reproduce the batch result regardless
+    // of the packet sizes
+    StreamingWelch swelch;
+    EXPECT_NO_THROW(swelch.initialize(parameters, samplingRate));
+    EXPECT_EQ(swelch.getNumberOfFrequencies(), nFrequencies);
+    EXPECT_FALSE(swelch.haveTransform());
+    for (auto i=0; i<nSamples;)
+    {
+        auto nPacket = std::min(nSamples - i, 1 + rand()%300);
+        EXPECT_NO_THROW(swelch.update(nPacket, &x[i]));
+        i = i + nPacket;
+    }
+    int nSegments = (nSamples - nSamplesInOverlap)
+                   /(nWindowLength - nSamplesInOverlap);
+    EXPECT_EQ(swelch.getNumberOfAveragedSegments(), nSegments);
+    psdPtr = psd.data();
+    EXPECT_NO_THROW(swelch.getPowerSpectralDensity(nFrequencies, &psdPtr));
+    double error = 0;
+    ippsNormDiff_Inf_64f(psdRef.data(), psd.data(), nFrequencies, &error);
+    EXPECT_LE(error, 1.e-10);
+    // A moving block of 3 one-segment blocks should match the batch estimate
+    // over the last three segments.
+    int shift = nWindowLength - nSamplesInOverlap;
+    int nLast = 3*shift + nSamplesInOverlap;
+    int i0 = (nSegments - 3)*shift;
+    EXPECT_NO_THROW(parameters.setNumberOfSamples(nLast));
+    EXPECT_NO_THROW(welch.initialize(parameters, samplingRate));
+    EXPECT_NO_THROW(welch.transform(nLast, &x[i0]));
+    psdPtr = psdRef.data();
+    welch.getPowerSpectralDensity(nFrequencies, &psdPtr);
+    EXPECT_NO_THROW(swelch.initializeMovingBlock(parameters, 1, 3,
+                                                 samplingRate));
+    EXPECT_NO_THROW(swelch.update(nSamples, x.data()));
+    EXPECT_EQ(swelch.getNumberOfAveragedSegments(), 3);
+    psdPtr = psd.data();
+    EXPECT_NO_THROW(swelch.getPowerSpectralDensity(nFrequencies, &psdPtr));
+    ippsNormDiff_Inf_64f(psdRef.data(), psd.data(), nFrequencies, &error);
+    EXPECT_LE(error, 1.e-10);
+    // An exponential average with unit weight is the latest segment
+    int nLastSegment = nWindowLength;
+    i0 = (nSegments - 1)*shift;
+    EXPECT_NO_THROW(parameters.setNumberOfSamples(nLastSegment));
+    EXPECT_NO_THROW(welch.initialize(parameters, samplingRate));
+    EXPECT_NO_THROW(welch.transform(nLastSegment, &x[i0]));
+    psdPtr = psdRef.data();
+    welch.getPowerSpectralDensity(nFrequencies, &psdPtr);
+    EXPECT_NO_THROW(swelch.initializeExponential(parameters, 1.0,
+                                                 samplingRate));
+    EXPECT_NO_THROW(swelch.update(nSamples, x.data()));
+    psdPtr = psd.data();
+    EXPECT_NO_THROW(swelch.getPowerSpectralDensity(nFrequencies, &psdPtr));
+    ippsNormDiff_Inf_64f(psdRef.data(), psd.data(), nFrequencies, &error);
+    EXPECT_LE(error, 1.e-10);
+    // Resetting discards the estimate
+    EXPECT_NO_THROW(swelch.reset());
+    EXPECT_FALSE(swelch.haveTransform());
+    EXPECT_THROW(swelch.initializeExponential(parameters, 0.0, samplingRate),
+                 std::invalid_argument);
+}
+TEST(UtilitiesTransforms, CrossSpectrum)
+{
+    double samplingRate = 100;
+    int nSamples = 6000;
+    int nWindowLength = 256;
+    int nSamplesInOverlap = 128;
+    int fftLength = 300;
+    // Channel 1 is a delayed, scaled copy of channel 0 plus a little noise
+    // while channel 2 is independent
+    const int nChannels = 3;
+    const int delay = 5;
+    std::vector<double> x(nChannels*nSamples);
+    srand(3036);
+    std::vector<double> noise(nSamples + delay);
+    for (auto &n : noise){n = static_cast<double> (rand())/RAND_MAX - 0.5;}
+    for (int i=0; i<nSamples; ++i)
+    {
+        x[i] = noise[i + delay];
+        x[nSamples + i] = 2*noise[i]
+                        + 0.01*(static_cast<double> (rand())/RAND_MAX - 0.5);
+        x[2*nSamples + i] = static_cast<double> (rand())/RAND_MAX - 0.5;
+    }
+    SlidingWindowRealDFTParameters parameters;
+    EXPECT_NO_THROW(parameters.setNumberOfSamples(nSamples));
+    EXPECT_NO_THROW(parameters.setWindow(nWindowLength,
+                                         SlidingWindowWindowType::HANN));
+    EXPECT_NO_THROW(parameters.setNumberOfSamplesInOverlap(nSamplesInOverlap));
+    EXPECT_NO_THROW(parameters.setDetrendType(SlidingWindowDetrendType::REMOVE_MEAN));
+    EXPECT_NO_THROW(parameters.setDFTLength(fftLength));
+    // Batch references
+    SlidingWindowRealDFT swdft;
+    EXPECT_NO_THROW(swdft.initialize(parameters));
+    const int nFrequencies = swdft.getNumberOfFrequencies();
+    std::vector<std::vector<std::complex<double>>> transforms(nChannels);
+    int nWindows = 0;
+    for (int c=0; c<nChannels; ++c)
+    {
+        swdft.transform(nSamples, &x[c*nSamples]);
+        nWindows = swdft.getNumberOfTransformWindows();
+        for (int iw=0; iw<nWindows; ++iw)
+        {
+            auto cPtr = swdft.getTransform64f(iw);
+            transforms[c].insert(transforms[c].end(),
+                                 cPtr, cPtr + nFrequencies);
+        }
+    }
+    auto window = parameters.getWindow();
+    double wsum2 = 0;
+    for (const auto &w : window){wsum2 = wsum2 + w*w;}
+    const double xscal = 2.0/(nWindows*samplingRate*wsum2);
+    std::vector<int> pairs{0, 1, 2, 0, 1, 2};
+    const int nPairs = 3;
+    CrossSpectrum cross;
+    EXPECT_NO_THROW(cross.initialize(parameters, nChannels, nPairs,
+                                     pairs.data(), samplingRate));
+    EXPECT_EQ(cross.getNumberOfFrequencies(), nFrequencies);
+    EXPECT_EQ(cross.getNumberOfPairs(), nPairs);
+    EXPECT_FALSE(cross.haveTransform());
+    // Stream the data in random packets
+    std::vector<double> packet;
+    for (int i=0; i<nSamples;)
+    {
+        auto nPacket = std::min(nSamples - i, 1 + rand()%300);
+        packet.resize(nChannels*nPacket);
+        for (int c=0; c<nChannels; ++c)
+        {
+            std::copy(&x[c*nSamples + i], &x[c*nSamples + i + nPacket],
+                      &packet[c*nPacket]);
+        }
+        EXPECT_NO_THROW(cross.update(nChannels, nPacket, packet.data()));
+        i = i + nPacket;
+    }
+    EXPECT_EQ(cross.getNumberOfAveragedSegments(), nWindows);
+    // The power spectral densities match Welch
+    Welch welch;
+    EXPECT_NO_THROW(welch.initialize(parameters, samplingRate));
+    std::vector<double> psdRef(nFrequencies), psd(nFrequencies);
+    for (int c=0; c<nChannels; ++c)
+    {
+        welch.transform(nSamples, &x[c*nSamples]);
+        auto psdPtr = psdRef.data();
+        welch.getPowerSpectralDensity(nFrequencies, &psdPtr);
+        psdPtr = psd.data();
+        EXPECT_NO_THROW(cross.getPowerSpectralDensity(c, nFrequencies,
+                                                      &psdPtr));
+        for (int k=0; k<nFrequencies; ++k)
+        {
+            EXPECT_NEAR(psd[k], psdRef[k], 1.e-12);
+        }
+    }
+    // The cross-spectral densities
+    std::vector<std::complex<double>> csd(nFrequencies);
+    std::vector<double> coherence(nFrequencies);
+    for (int ip=0; ip<nPairs; ++ip)
+    {
+        auto csdPtr = csd.data();
+        EXPECT_NO_THROW(cross.getCrossSpectralDensity(ip, nFrequencies,
+                                                      &csdPtr));
+        auto cx = pairs[2*ip];
+        auto cy = pairs[2*ip+1];
+        for (int k=0; k<nFrequencies; ++k)
+        {
+            std::complex<double> sxy = 0;
+            for (int iw=0; iw<nWindows; ++iw)
+            {
+                sxy = sxy + std::conj(transforms[cx][iw*nFrequencies + k])
+                           *transforms[cy][iw*nFrequencies + k];
+            }
+            EXPECT_NEAR(std::abs(csd[k] - xscal*sxy), 0, 1.e-12);
+        }
+        auto cohPtr = coherence.data();
+        EXPECT_NO_THROW(cross.getCoherence(ip, nFrequencies, &cohPtr));
+        double meanCoherence = 0;
+        for (const auto &c : coherence)
+        {
+            EXPECT_GE(c, 0);
+            EXPECT_LE(c, 1);
+            meanCoherence = meanCoherence + c/nFrequencies;
+        }
+        if (ip == 0)
+        {
+            // The delay is small compared to the window so the channels
+            // are nearly coherent.  The phase is -2 pi f delay/fs.
+            EXPECT_GT(meanCoherence, 0.9);
+            auto k = nFrequencies/4;
+            auto f = k*samplingRate/fftLength;
+            auto phase = std::arg(csd[k]);
+            auto phaseRef = std::remainder(-2*M_PI*f*delay/samplingRate,
+                                           2*M_PI);
+            EXPECT_NEAR(phase, phaseRef, 0.05);
+        }
+        else
+        {
+            EXPECT_LT(meanCoherence, 0.1);
+        }
+    }
+    // The two channel convenience initializer and reset
+    CrossSpectrum pair;
+    EXPECT_NO_THROW(pair.initialize(parameters, samplingRate));
+    EXPECT_EQ(pair.getNumberOfChannels(), 2);
+    EXPECT_NO_THROW(pair.update(2, nSamples, x.data()));
+    auto csdPtr = csd.data();
+    std::vector<std::complex<double>> csdRef(nFrequencies);
+    auto csdRefPtr = csdRef.data();
+    pair.getCrossSpectralDensity(0, nFrequencies, &csdPtr);
+    cross.getCrossSpectralDensity(0, nFrequencies, &csdRefPtr);
+    for (int k=0; k<nFrequencies; ++k)
+    {
+        EXPECT_NEAR(std::abs(csd[k] - csdRef[k]), 0, 1.e-12);
+    }
+    EXPECT_NO_THROW(pair.reset());
+    EXPECT_FALSE(pair.haveTransform());
+    EXPECT_THROW(pair.update(3, nSamples, x.data()), std::invalid_argument);
+}
+TEST(UtilitiesTransforms, PPSD)
+{
+    // White noise uniformly distributed in [-0.5,0.5] has variance 1/12 so
+    // its one-sided power spectral density is 2/(12*fs)
+    double samplingRate = 20;
+    int nSamples = 20000;
+    int segmentLength = 2048;
+    int segmentOverlap = 1024;
+    std::vector<double> x(nSamples);
+    srand(8675);
+    for (auto i=0; i<nSamples; ++i)
+    {
+        x[i] = static_cast<double> (rand())/RAND_MAX - 0.5;
+    }
+    double dBRef = 10*std::log10(2.0/(12.0*samplingRate));
+    SlidingWindowRealDFTParameters parameters;
+    EXPECT_NO_THROW(parameters.setWindow(512, SlidingWindowWindowType::HANN));
+    EXPECT_NO_THROW(parameters.setNumberOfSamplesInOverlap(256));
+    EXPECT_NO_THROW(parameters.setDetrendType(SlidingWindowDetrendType::REMOVE_MEAN));
+    PPSD ppsd;
+    EXPECT_NO_THROW(ppsd.initialize(parameters, segmentLength, segmentOverlap,
+                                    0.2, 10.0, -40.0, 0.0, 1.0, 8,
+                                    samplingRate));
+    EXPECT_TRUE(ppsd.isInitialized());
+    int nPeriods = ppsd.getNumberOfPeriods();
+    int nBins = ppsd.getNumberOfDecibelBins();
+    EXPECT_EQ(nBins, 40);
+    EXPECT_EQ(nPeriods, static_cast<int> (8*std::log2(10.0/0.2)) + 1);
+    std::vector<double> periods(nPeriods), dBs(nBins);
+    double *pPtr = periods.data();
+    double *dPtr = dBs.data();
+    EXPECT_NO_THROW(ppsd.getPeriods(nPeriods, &pPtr));
+    EXPECT_NO_THROW(ppsd.getDecibelBins(nBins, &dPtr));
+    EXPECT_NEAR(periods[0], 0.2, 1.e-14);
+    EXPECT_NEAR(periods[8], 0.4, 1.e-14);
+    EXPECT_NEAR(dBs[0], -39.5, 1.e-14);
+    // Process the data in two pieces and merge
+    int nSegmentsExpected = (nSamples - segmentLength)
+                           /(segmentLength - segmentOverlap) + 1;
+    int nHalf = nSamples/2;
+    PPSD ppsd2(ppsd);
+    int nSegments1 = ppsd.update(nHalf, x.data());
+    int nSegments2 = ppsd2.update(nSamples - nHalf, x.data() + nHalf);
+    EXPECT_NO_THROW(ppsd.merge(ppsd2));
+    EXPECT_EQ(ppsd.getNumberOfSegments(), nSegments1 + nSegments2);
+    PPSD ppsdAll(ppsd2);
+    ppsdAll.resetHistogram();
+    EXPECT_EQ(ppsdAll.update(nSamples, x.data()), nSegmentsExpected);
+    // The mean of each period's distribution should be near the white noise
+    // level
+    std::vector<uint32_t> counts(nPeriods*nBins);
+    std::vector<double> pdf(nPeriods*nBins);
+    uint32_t *cPtr = counts.data();
+    double *pdfPtr = pdf.data();
+    EXPECT_NO_THROW(ppsdAll.getHistogram(nPeriods, nBins, &cPtr));
+    EXPECT_NO_THROW(ppsdAll.getProbabilityDensityFunction(nPeriods, nBins,
+                                                          &pdfPtr));
+    for (int i=0; i<nPeriods; ++i)
+    {
+        int64_t total = 0;
+        double dBMean = 0;
+        for (int j=0; j<nBins; ++j)
+        {
+            total = total + counts[i*nBins + j];
+            dBMean = dBMean + pdf[i*nBins + j]*dBs[j];
+        }
+        EXPECT_EQ(total, nSegmentsExpected);
+        EXPECT_NEAR(dBMean, dBRef, 1.5);
+    }
+    // Serialize and restore the merged histogram
+    auto data = ppsd.serialize();
+    PPSD ppsdRestored(ppsd2);
+    EXPECT_NO_THROW(ppsdRestored.deserialize(data));
+    EXPECT_EQ(ppsdRestored.getNumberOfSegments(), ppsd.getNumberOfSegments());
+    std::vector<uint32_t> counts1(nPeriods*nBins), counts2(nPeriods*nBins);
+    cPtr = counts1.data();
+    ppsd.getHistogram(nPeriods, nBins, &cPtr);
+    cPtr = counts2.data();
+    ppsdRestored.getHistogram(nPeriods, nBins, &cPtr);
+    EXPECT_TRUE(std::equal(counts1.begin(), counts1.end(), counts2.begin()));
+    // Mismatched bins are rejected
+    PPSD ppsdOther;
+    EXPECT_NO_THROW(ppsdOther.initialize(parameters, segmentLength,
+                                         segmentOverlap,
+                                         0.2, 10.0, -40.0, 0.0, 2.0, 8,
+                                         samplingRate));
+    EXPECT_THROW(ppsd.merge(ppsdOther), std::invalid_argument);
+    EXPECT_THROW(ppsdOther.deserialize(data), std::invalid_argument);
+    // Powers outside of the decibel range are not piled into the edge bins
+    PPSD ppsdQuiet;
+    ppsdQuiet.initialize(parameters, segmentLength, segmentOverlap,
+                         0.2, 10.0, -100.0, -60.0, 1.0, 8, samplingRate);
+    EXPECT_EQ(ppsdQuiet.update(nSamples, x.data()), nSegmentsExpected);
+    cPtr = counts.data();
+    ppsdQuiet.getHistogram(nPeriods, nBins, &cPtr);
+    EXPECT_TRUE(std::all_of(counts.begin(), counts.end(),
+                            [](const uint32_t c){return c == 0;}));
+    // Octave bands cannot be truncated at the Nyquist frequency
+    EXPECT_THROW(ppsdQuiet.initialize(parameters, segmentLength,
+                                      segmentOverlap, 0.1, 10.0, -40.0, 0.0,
+                                      1.0, 8, samplingRate),
+                 std::invalid_argument);
+}
+TEST(UtilitiesTransforms, SlidingDFTBank)
+{
+    const int windowLength = 200;
+    const int nSamples = 1500;
+    const int nChannels = 2;
+    const double samplingRate = 40;
+    std::vector<double> frequencies{0, 0.37, 1.2, 5, 13.9, 20};
+    const int nFrequencies = static_cast<int> (frequencies.size());
+    std::vector<double> x(nChannels*nSamples);
+    srand(2112);
+    for (auto &xi : x){xi = static_cast<double> (rand())/RAND_MAX - 0.5;}
+    SlidingDFTBank<double> bank;
+    EXPECT_NO_THROW(bank.initialize(windowLength, nFrequencies,
+                                    frequencies.data(), samplingRate,
+                                    nChannels));
+    EXPECT_EQ(bank.getNumberOfChannels(), nChannels);
+    EXPECT_EQ(bank.getNumberOfFrequencies(), nFrequencies);
+    // Feed the data in packets and save the transform after every sample
+    std::vector<std::complex<double>> y(nChannels*nSamples*nFrequencies);
+    std::vector<std::complex<double>> yPacket;
+    std::vector<double> xPacket;
+    for (int i=0; i<nSamples;)
+    {
+        auto nPacket = std::min(nSamples - i, 1 + rand()%250);
+        xPacket.resize(nChannels*nPacket);
+        yPacket.resize(nChannels*nPacket*nFrequencies);
+        for (int c=0; c<nChannels; ++c)
+        {
+            std::copy(&x[c*nSamples + i], &x[c*nSamples + i + nPacket],
+                      &xPacket[c*nPacket]);
+        }
+        auto yPtr = yPacket.data();
+        EXPECT_NO_THROW(bank.update(nPacket, xPacket.data(), &yPtr));
+        for (int c=0; c<nChannels; ++c)
+        {
+            std::copy(&yPacket[c*nPacket*nFrequencies],
+                      &yPacket[(c + 1)*nPacket*nFrequencies],
+                      &y[(c*nSamples + i)*nFrequencies]);
+        }
+        i = i + nPacket;
+    }
+    // Compare to a direct computation
+    double emax = 0;
+    for (int c=0; c<nChannels; ++c)
+    {
+        for (int n=0; n<nSamples; ++n)
+        {
+            for (int k=0; k<nFrequencies; ++k)
+            {
+                auto omega = 2*M_PI*frequencies[k]/samplingRate;
+                std::complex<double> yRef = 0;
+                for (int m=0; m<windowLength; ++m)
+                {
+                    auto j = n - windowLength + 1 + m;
+                    if (j < 0){continue;}
+                    yRef = yRef + x[c*nSamples + j]
+                                 *std::exp(std::complex<double> (0, -omega*m));
+                }
+                emax = std::max(emax,
+                           std::abs(yRef - y[(c*nSamples + n)*nFrequencies + k]));
+            }
+        }
+    }
+    EXPECT_LE(emax, 1.e-11);
+    // The latest transform matches the last output
+    std::vector<std::complex<double>> yLast(nChannels*nFrequencies);
+    auto yLastPtr = yLast.data();
+    EXPECT_NO_THROW(bank.getTransform(nChannels*nFrequencies, &yLastPtr));
+    for (int c=0; c<nChannels; ++c)
+    {
+        for (int k=0; k<nFrequencies; ++k)
+        {
+            EXPECT_NEAR(std::abs(yLast[c*nFrequencies + k]
+                        - y[(c*nSamples + nSamples - 1)*nFrequencies + k]),
+                        0, 1.e-14);
+        }
+    }
+    // Track a tone in single precision for a long time.  The error should
+    // not grow with the number of samples.
+    const int nLong = 400000;
+    const double toneFrequency = 2.5; // 12.5 cycles in 5 s
+    const float amplitude = 3;
+    std::vector<float> tone(nLong);
+    for (int i=0; i<nLong; ++i)
+    {
+        tone[i] = amplitude*std::cos(2*M_PI*toneFrequency*i/samplingRate);
+    }
+    double trackFrequency = 4.0; // An integer number of cycles in the window
+    for (int i=0; i<nLong; ++i)
+    {
+        tone[i] = tone[i]
+                + amplitude*std::cos(2*M_PI*trackFrequency*i/samplingRate);
+    }
+    SlidingDFTBank<float> bank32;
+    EXPECT_NO_THROW(bank32.initialize(windowLength, 1, &trackFrequency,
+                                      samplingRate));
+    EXPECT_NO_THROW(bank32.update(nLong - 7, tone.data()));
+    float amp;
+    float *ampPtr = &amp;
+    EXPECT_NO_THROW(bank32.getAmplitudes(1, &ampPtr));
+    EXPECT_NEAR(amp, amplitude, 0.2);
+    // Reset clears the state
+    EXPECT_NO_THROW(bank32.reset());
+    EXPECT_NO_THROW(bank32.getAmplitudes(1, &ampPtr));
+    EXPECT_NEAR(amp, 0, 1.e-7);
+    frequencies[0] = samplingRate;
+    EXPECT_THROW(bank.initialize(windowLength, nFrequencies,
+                                 frequencies.data(), samplingRate),
+                 std::invalid_argument);
+}
+TEST(UtilitiesTransforms, ChirpZTransform)
+{
+    const int nSamples = 1000;
+    const double samplingRate = 20;
+    std::vector<double> x(nSamples);
+    srand(4082);
+    for (auto &xi : x){xi = static_cast<double> (rand())/RAND_MAX - 0.5;}
+    // Zoom into a narrow band and compare to a direct evaluation
+    const int nFrequencies = 301;
+    const double f1 = 0.5;
+    const double f2 = 1.25;
+    ChirpZTransform<double> czt;
+    EXPECT_NO_THROW(czt.initialize(nSamples, nFrequencies, f1, f2,
+                                   samplingRate));
+    EXPECT_EQ(czt.getInputLength(), nSamples);
+    EXPECT_EQ(czt.getTransformLength(), nFrequencies);
+    std::vector<double> freqs(nFrequencies);
+    auto fPtr = freqs.data();
+    EXPECT_NO_THROW(czt.getFrequencies(nFrequencies, &fPtr));
+    EXPECT_NEAR(freqs[0], f1, 1.e-14);
+    EXPECT_NEAR(freqs[nFrequencies-1], f2, 1.e-12);
+    std::vector<std::complex<double>> y(nFrequencies);
+    auto yPtr = y.data();
+    EXPECT_NO_THROW(czt.transform(nSamples, x.data(), nFrequencies, &yPtr));
+    double emax = 0;
+    for (int k=0; k<nFrequencies; ++k)
+    {
+        std::complex<double> yRef = 0;
+        auto omega = 2*M_PI*freqs[k]/samplingRate;
+        for (int n=0; n<nSamples; ++n)
+        {
+            yRef = yRef + x[n]*std::exp(std::complex<double> (0, -omega*n));
+        }
+        emax = std::max(emax, std::abs(yRef - y[k]));
+    }
+    EXPECT_LE(emax, 1.e-9);
+    // With the full unit circle this is the DFT
+    DFT<double> dft;
+    dft.initialize(nSamples, FourierTransformImplementation::DFT);
+    std::vector<std::complex<double>> xc(x.begin(), x.end());
+    std::vector<std::complex<double>> yDFT(nSamples);
+    auto yDFTPtr = yDFT.data();
+    dft.forwardTransform(nSamples, xc.data(), nSamples, &yDFTPtr);
+    ChirpZTransform<double> cztDFT;
+    EXPECT_NO_THROW(cztDFT.initialize(nSamples, nSamples,
+                        std::polar(1.0, -2*M_PI/nSamples),
+                        std::complex<double> (1, 0)));
+    std::vector<std::complex<double>> yCZT(nSamples);
+    auto yCZTPtr = yCZT.data();
+    EXPECT_NO_THROW(cztDFT.transform(nSamples, xc.data(), nSamples,
+                                     &yCZTPtr));
+    emax = 0;
+    for (int k=0; k<nSamples; ++k)
+    {
+        emax = std::max(emax, std::abs(yDFT[k] - yCZT[k]));
+    }
+    EXPECT_LE(emax, 1.e-9);
+    // Spiral contour with zero-padding
+    const int nOutput = 37;
+    const int n = 50;
+    auto w = std::polar(0.995, -0.05);
+    auto a = std::polar(1.02, 0.3);
+    ChirpZTransform<double> cztSpiral;
+    EXPECT_NO_THROW(cztSpiral.initialize(64, nOutput, w, a));
+    std::vector<std::complex<double>> ys(nOutput);
+    auto ysPtr = ys.data();
+    EXPECT_NO_THROW(cztSpiral.transform(n, xc.data(), nOutput, &ysPtr));
+    emax = 0;
+    for (int k=0; k<nOutput; ++k)
+    {
+        std::complex<double> yRef = 0;
+        for (int i=0; i<n; ++i)
+        {
+            yRef = yRef + xc[i]*std::pow(a, -i)*std::pow(w, i*k);
+        }
+        emax = std::max(emax, std::abs(yRef - ys[k])/std::abs(yRef));
+    }
+    EXPECT_LE(emax, 1.e-8);
+    // Float version
+    ChirpZTransform<float> cztFloat;
+    EXPECT_NO_THROW(cztFloat.initialize(nSamples, nFrequencies, f1, f2,
+                                        samplingRate));
+    std::vector<float> xf(x.begin(), x.end());
+    std::vector<std::complex<float>> yf(nFrequencies);
+    auto yfPtr = yf.data();
+    EXPECT_NO_THROW(cztFloat.transform(nSamples, xf.data(), nFrequencies,
+                                       &yfPtr));
+    emax = 0;
+    for (int k=0; k<nFrequencies; ++k)
+    {
+        emax = std::max(emax,
+                        std::abs(std::complex<double> (yf[k]) - y[k]));
+    }
+    EXPECT_LE(emax, 1.e-2);
+}
+
+TEST(UtilitiesTransforms, ContinuousWaveletTransform)
+{
+    const int npts = 600;
+    const double samplingRate = 50;
+    const double dt = 1/samplingRate;
+    std::vector<double> x(npts);
+    srand(3033);
+    for (auto &xi : x){xi = static_cast<double> (rand())/RAND_MAX - 0.5;}
+    // Scales are large enough that the wavelets are not aliased
+    std::vector<double> scales{0.2, 0.4, 0.8};
+    const int nScales = static_cast<int> (scales.size());
+    for (auto wavelet : {ContinuousWaveletType::MORLET,
+                         ContinuousWaveletType::PAUL})
+    {
+        ContinuousWaveletTransform<double> cwt;
+        EXPECT_NO_THROW(cwt.initialize(npts, nScales, scales.data(),
+                                       wavelet, samplingRate));
+        EXPECT_EQ(cwt.getNumberOfScales(), nScales);
+        std::vector<std::complex<double>> y(nScales*npts);
+        auto yPtr = y.data();
+        EXPECT_NO_THROW(cwt.transform(npts, x.data(), &yPtr));
+        std::vector<float> amplitude(nScales*npts);
+        auto aPtr = amplitude.data();
+        EXPECT_NO_THROW(cwt.transformAmplitude(npts, x.data(), &aPtr));
+        // Compare to a direct convolution with the normalized wavelet
+        // (Torrence and Compo, 1998)
+        double emax = 0;
+        double ymax = 0;
+        for (int j=0; j<nScales; ++j)
+        {
+            auto s = scales[j];
+            for (int i=0; i<npts; ++i)
+            {
+                std::complex<double> yRef = 0;
+                for (int k=0; k<npts; ++k)
+                {
+                    auto eta = (k - i)*dt/s;
+                    std::complex<double> psi;
+                    if (wavelet == ContinuousWaveletType::MORLET)
+                    {
+                        psi = std::pow(M_PI, -0.25)
+                             *std::exp(std::complex<double> (-0.5*eta*eta,
+                                                             6*eta));
+                    }
+                    else
+                    {
+                        // 2^m i^m m!/sqrt(pi (2m)!) (1 - i eta)^{-(m+1)}
+                        auto c = 16.0*24.0/std::sqrt(M_PI*40320.0);
+                        psi = c*std::pow(std::complex<double> (1, -eta), -5);
+                    }
+                    yRef = yRef + x[k]*std::conj(psi)*std::sqrt(dt/s);
+                }
+                emax = std::max(emax, std::abs(yRef - y[j*npts + i]));
+                ymax = std::max(ymax, std::abs(yRef));
+                EXPECT_NEAR(amplitude[j*npts + i], std::abs(y[j*npts + i]),
+                            1.e-5);
+            }
+        }
+        EXPECT_LE(emax/ymax, 1.e-6);
+    }
+    // A sinusoid should have the most energy at the scale whose Fourier
+    // frequency matches the sinusoid's frequency
+    const double f0 = 5;
+    for (int i=0; i<npts; ++i){x[i] = std::sin(2*M_PI*f0*i*dt);}
+    const int nLogScales = 41;
+    ContinuousWaveletTransform<double> cwt;
+    EXPECT_NO_THROW(cwt.initialize(npts, nLogScales, 0.02, 2.0,
+                                   ContinuousWaveletType::MORLET,
+                                   samplingRate));
+    std::vector<double> freqs(nLogScales), scalesOut(nLogScales);
+    auto fPtr = freqs.data();
+    auto sPtr = scalesOut.data();
+    cwt.getFrequencies(nLogScales, &fPtr);
+    cwt.getScales(nLogScales, &sPtr);
+    EXPECT_NEAR(scalesOut[0], 0.02, 1.e-14);
+    EXPECT_NEAR(scalesOut[nLogScales-1], 2.0, 1.e-14);
+    std::vector<float> amplitude(nLogScales*npts);
+    auto aPtr = amplitude.data();
+    cwt.transformAmplitude(npts, x.data(), &aPtr);
+    int jmax = 0;
+    double pmax = 0;
+    for (int j=0; j<nLogScales; ++j)
+    {
+        // Power normalized by scale in the middle of the signal
+        double power = std::pow(amplitude[j*npts + npts/2], 2)/scalesOut[j];
+        if (power > pmax){pmax = power; jmax = j;}
+    }
+    EXPECT_NEAR(freqs[jmax], f0, 0.5);
+}
+
+TEST(UtilitiesTransforms, StockwellTransform)
+{
+    const double samplingRate = 20;
+    srand(3034);
+    for (auto npts : {64, 75})
+    {
+        std::vector<double> x(npts);
+        for (auto &xi : x){xi = static_cast<double> (rand())/RAND_MAX - 0.5;}
+        // Compute all voices through the frequency band
+        StockwellTransform<double> st;
+        EXPECT_NO_THROW(st.initialize(npts, 0.0, samplingRate/2,
+                                      samplingRate));
+        const int nVoices = npts/2 + 1;
+        EXPECT_EQ(st.getNumberOfVoices(), nVoices);
+        EXPECT_EQ(st.getNumberOfSamples(), npts);
+        std::vector<double> freqs(nVoices);
+        auto fPtr = freqs.data();
+        st.getFrequencies(nVoices, &fPtr);
+        std::vector<std::complex<double>> y(nVoices*npts);
+        auto yPtr = y.data();
+        EXPECT_NO_THROW(st.transform(npts, x.data(), &yPtr));
+        std::vector<float> amplitude(nVoices*npts);
+        auto aPtr = amplitude.data();
+        EXPECT_NO_THROW(st.transformAmplitude(npts, x.data(), &aPtr));
+        // Reference from the definition (Stockwell et al., 1996)
+        std::vector<std::complex<double>> h(npts, 0);
+        for (int k=0; k<npts; ++k)
+        {
+            for (int i=0; i<npts; ++i)
+            {
+                h[k] = h[k] + x[i]*std::exp(std::complex<double>
+                                            (0, -2*M_PI*k*i/npts));
+            }
+            h[k] = h[k]/static_cast<double> (npts);
+        }
+        double emax = 0;
+        for (int k=0; k<nVoices; ++k)
+        {
+            EXPECT_NEAR(freqs[k], k*samplingRate/npts, 1.e-12);
+            for (int j=0; j<npts; ++j)
+            {
+                std::complex<double> sRef = 0;
+                if (k == 0)
+                {
+                    sRef = h[0];
+                }
+                else
+                {
+                    for (int m=-npts/2; m<npts - npts/2; ++m)
+                    {
+                        auto g = std::exp(-2*M_PI*M_PI*m*m/(1.0*k*k));
+                        auto e = std::exp(std::complex<double>
+                                          (0, 2*M_PI*m*j/npts));
+                        sRef = sRef + h[(m + k + npts)%npts]*g*e;
+                    }
+                }
+                emax = std::max(emax, std::abs(sRef - y[k*npts + j]));
+                EXPECT_NEAR(amplitude[k*npts + j], std::abs(y[k*npts + j]),
+                            1.e-5);
+            }
+        }
+        EXPECT_LE(emax, 1.e-12);
+        // Subset of voices and copy
+        std::vector<int> voices{npts/2, 3, 0};
+        StockwellTransform<double> stSubset;
+        EXPECT_NO_THROW(stSubset.initialize(npts, 3, voices.data(),
+                                            samplingRate));
+        auto stCopy = stSubset;
+        std::vector<std::complex<double>> ySubset(3*npts);
+        auto ySubsetPtr = ySubset.data();
+        EXPECT_NO_THROW(stCopy.transform(npts, x.data(), &ySubsetPtr));
+        emax = 0;
+        for (int j=0; j<3; ++j)
+        {
+            for (int i=0; i<npts; ++i)
+            {
+                emax = std::max(emax, std::abs(ySubset[j*npts + i]
+                                             - y[voices[j]*npts + i]));
+            }
+        }
+        EXPECT_LE(emax, 1.e-14);
+        // Single precision
+        std::vector<float> x32(x.begin(), x.end());
+        StockwellTransform<float> st32;
+        EXPECT_NO_THROW(st32.initialize(npts, 3, voices.data(),
+                                        samplingRate));
+        std::vector<std::complex<float>> y32(3*npts);
+        auto y32Ptr = y32.data();
+        EXPECT_NO_THROW(st32.transform(npts, x32.data(), &y32Ptr));
+        emax = 0;
+        for (int i=0; i<3*npts; ++i)
+        {
+            emax = std::max(emax,
+                            std::abs(std::complex<double> (y32[i])
+                                   - ySubset[i]));
+        }
+        EXPECT_LE(emax, 1.e-5);
+    }
+}
+
+TEST(UtilitiesTransforms, Multitaper)
+{
+    const int npts = 200;
+    const double nw = 3.5;
+    const int nTapers = 6;
+    const double samplingRate = 40;
+    Multitaper<double> mt;
+    EXPECT_NO_THROW(mt.initialize(npts, nw, nTapers, samplingRate,
+                                  MultitaperWeightingType::UNITY));
+    EXPECT_EQ(mt.getNumberOfTapers(), nTapers);
+    EXPECT_EQ(mt.getNumberOfSamples(), npts);
+    const int nFrequencies = mt.getNumberOfFrequencies();
+    EXPECT_EQ(nFrequencies, npts/2 + 1);
+    std::vector<double> tapers(nTapers*npts), lambdas(nTapers);
+    auto tPtr = tapers.data();
+    auto lPtr = lambdas.data();
+    mt.getTapers(nTapers, npts, &tPtr);
+    mt.getConcentrations(nTapers, &lPtr);
+    // The tapers are orthonormal eigenvectors of the sinc kernel
+    // (Percival and Walden, 1993 Eqn 378) whose eigenvalues are the
+    // concentrations
+    const double w = nw/npts;
+    double emax = 0;
+    for (int k=0; k<nTapers; ++k)
+    {
+        const double *v = &tapers[k*npts];
+        for (int j=0; j<nTapers; ++j)
+        {
+            double dot = 0;
+            for (int i=0; i<npts; ++i){dot = dot + v[i]*tapers[j*npts + i];}
+            EXPECT_NEAR(dot, (j == k) ? 1 : 0, 1.e-10);
+        }
+        for (int i=0; i<npts; ++i)
+        {
+            double av = 0;
+            for (int j=0; j<npts; ++j)
+            {
+                auto a = 2*w;
+                if (i != j){a = std::sin(2*M_PI*w*(i - j))/(M_PI*(i - j));}
+                av = av + a*v[j];
+            }
+            emax = std::max(emax, std::abs(av - lambdas[k]*v[i]));
+        }
+        if (k > 0){EXPECT_LT(lambdas[k], lambdas[k-1]);}
+        // Sign conventions
+        double sum = 0;
+        for (int i=0; i<npts; ++i){sum = sum + v[i];}
+        if (k%2 == 0){EXPECT_GT(sum, 0);}
+    }
+    EXPECT_LE(emax, 1.e-10);
+    EXPECT_GT(lambdas[0], 0.9999999);
+    EXPECT_LT(lambdas[nTapers-1], 0.99);
+    // Unity weighting is the average of the tapered periodograms
+    std::vector<double> x(npts);
+    srand(3035);
+    for (auto &xi : x){xi = static_cast<double> (rand())/RAND_MAX - 0.5;}
+    std::vector<double> psd(nFrequencies);
+    auto psdPtr = psd.data();
+    EXPECT_NO_THROW(mt.transform(npts, x.data(), nFrequencies, &psdPtr));
+    auto xmean = std::accumulate(x.begin(), x.end(), 0.0)/npts;
+    emax = 0;
+    for (int f=0; f<nFrequencies; ++f)
+    {
+        double sRef = 0;
+        for (int k=0; k<nTapers; ++k)
+        {
+            std::complex<double> yk = 0;
+            for (int i=0; i<npts; ++i)
+            {
+                yk = yk + tapers[k*npts + i]*(x[i] - xmean)
+                         *std::exp(std::complex<double> (0, -2*M_PI*f*i/npts));
+            }
+            sRef = sRef + std::norm(yk);
+        }
+        sRef = sRef/(nTapers*samplingRate);
+        if (f > 0 && f < nFrequencies - 1){sRef = 2*sRef;}
+        emax = std::max(emax, std::abs(sRef - psd[f])/sRef);
+    }
+    EXPECT_LE(emax, 1.e-10);
+    // A sinusoid in white noise.  The adaptive estimate should find the
+    // sinusoid and integrate to the signal's variance.
+    const double f0 = 7.3;
+    for (int i=0; i<npts; ++i)
+    {
+        x[i] = std::sin(2*M_PI*f0*i/samplingRate)
+             + 0.1*(static_cast<double> (rand())/RAND_MAX - 0.5);
+    }
+    std::vector<double> freqs(nFrequencies);
+    auto fPtr = freqs.data();
+    for (auto weighting : {MultitaperWeightingType::ADAPTIVE,
+                           MultitaperWeightingType::EIGENVALUE})
+    {
+        Multitaper<double> mtw;
+        EXPECT_NO_THROW(mtw.initialize(npts, nw, 0, samplingRate, weighting));
+        EXPECT_EQ(mtw.getNumberOfTapers(), 6);
+        mtw.getFrequencies(nFrequencies, &fPtr);
+        mtw.transform(npts, x.data(), nFrequencies, &psdPtr);
+        auto fmax = std::distance(psd.begin(),
+                                  std::max_element(psd.begin(), psd.end()));
+        EXPECT_NEAR(freqs[fmax], f0, samplingRate/npts);
+        double power = 0;
+        for (const auto &p : psd){power = power + p*samplingRate/npts;}
+        double mean = std::accumulate(x.begin(), x.end(), 0.0)/npts;
+        double variance = 0;
+        for (const auto &xi : x)
+        {
+            variance = variance + (xi - mean)*(xi - mean)/npts;
+        }
+        EXPECT_NEAR(power, variance, 0.05*variance);
+        // A DC offset does not change the estimate
+        std::vector<double> xOffset(x);
+        for (auto &xi : xOffset){xi = xi + 10;}
+        std::vector<double> psdOffset(nFrequencies);
+        auto psdOffsetPtr = psdOffset.data();
+        mtw.transform(npts, xOffset.data(), nFrequencies, &psdOffsetPtr);
+        for (int f=0; f<nFrequencies; ++f)
+        {
+            EXPECT_NEAR(psdOffset[f], psd[f], 1.e-10*psd[fmax]);
+        }
+    }
+    // Multiple channels, reinitialization, and single precision
+    const int nChannels = 3;
+    std::vector<double> xc(nChannels*npts);
+    for (auto &xi : xc){xi = static_cast<double> (rand())/RAND_MAX - 0.5;}
+    Multitaper<double> mtc;
+    mtc.initialize(npts, nw, nTapers, samplingRate);
+    mtc.initialize(npts, nw, nTapers, samplingRate,
+                   MultitaperWeightingType::ADAPTIVE, 256);
+    EXPECT_EQ(mtc.getNumberOfFrequencies(), 129);
+    std::vector<double> psdc(nChannels*129);
+    auto psdcPtr = psdc.data();
+    EXPECT_NO_THROW(mtc.transform(nChannels, npts, xc.data(), 129, &psdcPtr));
+    Multitaper<float> mt32;
+    mt32.initialize(npts, nw, nTapers, samplingRate,
+                    MultitaperWeightingType::ADAPTIVE, 256);
+    std::vector<float> x32(xc.begin(), xc.end());
+    std::vector<float> psd32(129);
+    auto psd32Ptr = psd32.data();
+    for (int c=0; c<nChannels; ++c)
+    {
+        std::vector<double> psd1(129);
+        auto psd1Ptr = psd1.data();
+        mtc.transform(npts, &xc[c*npts], 129, &psd1Ptr);
+        mt32.transform(npts, &x32[c*npts], 129, &psd32Ptr);
+        for (int f=0; f<129; ++f)
+        {
+            EXPECT_NEAR(psd1[f], psdc[c*129 + f], 1.e-14*psd1[f]);
+            EXPECT_NEAR(psd32[f], psd1[f], 1.e-3*psd1[f]);
+        }
+    }
+}
+
+TEST(UtilitiesTransforms, TimeShift)
+{
+    const int npts = 301;
+    const double samplingRate = 20;
+    const double maxShift = 1;
+    TimeShift<double> shifter;
+    EXPECT_NO_THROW(shifter.initialize(npts, maxShift, samplingRate));
+    EXPECT_EQ(shifter.getNumberOfSamples(), npts);
+    EXPECT_NEAR(shifter.getMaximumShift(), maxShift, 1.e-14);
+    // Whole sample shifts are exact
+    std::vector<double> x(npts), y(npts);
+    srand(3038);
+    for (auto &xi : x){xi = static_cast<double> (rand())/RAND_MAX - 0.5;}
+    auto yPtr = y.data();
+    for (int lag : {-20, -3, 0, 1, 7, 20})
+    {
+        EXPECT_NO_THROW(shifter.transform(npts, x.data(), lag/samplingRate,
+                                          &yPtr));
+        double emax = 0;
+        for (int i=0; i<npts; ++i)
+        {
+            double yRef = 0;
+            if (i - lag >= 0 && i - lag < npts){yRef = x[i - lag];}
+            emax = std::max(emax, std::abs(y[i] - yRef));
+        }
+        EXPECT_LE(emax, 1.e-12);
+    }
+    EXPECT_THROW(shifter.transform(npts, x.data(), 1.01*maxShift, &yPtr),
+                 std::invalid_argument);
+    // Fractional shifts of a Gaussian pulse, which is effectively
+    // band-limited, in a single batch
+    const int nSignals = 5;
+    const double sigma = 0.25;
+    const double t0 = 0.5*(npts - 1)/samplingRate;
+    const std::vector<double> shifts{-0.9731, -0.0125, 0.0333, 0.5071, 1};
+    std::vector<double> pulses(nSignals*npts), yb(nSignals*npts);
+    for (int j=0; j<nSignals; ++j)
+    {
+        for (int i=0; i<npts; ++i)
+        {
+            auto t = i/samplingRate - t0;
+            pulses[j*npts + i] = std::exp(-0.5*t*t/(sigma*sigma));
+        }
+    }
+    auto ybPtr = yb.data();
+    EXPECT_NO_THROW(shifter.transform(nSignals, npts, pulses.data(),
+                                      shifts.data(), &ybPtr));
+    for (int j=0; j<nSignals; ++j)
+    {
+        double emax = 0;
+        for (int i=0; i<npts; ++i)
+        {
+            auto t = i/samplingRate - t0 - shifts[j];
+            auto yRef = std::exp(-0.5*t*t/(sigma*sigma));
+            emax = std::max(emax, std::abs(yb[j*npts + i] - yRef));
+        }
+        EXPECT_LE(emax, 1.e-10);
+        shifter.transform(npts, &pulses[j*npts], shifts[j], &yPtr);
+        for (int i=0; i<npts; ++i)
+        {
+            EXPECT_NEAR(y[i], yb[j*npts + i], 1.e-14);
+        }
+    }
+    // A taper does not change the pulse, which is zero at the ends, and
+    // single precision
+    TimeShift<double> tapered;
+    tapered.initialize(npts, maxShift, samplingRate, 20);
+    TimeShift<float> shifter32;
+    shifter32.initialize(npts, maxShift, samplingRate, 20);
+    TimeShift<float> copy(shifter32);
+    std::vector<float> pulse32(pulses.begin(), pulses.begin() + npts);
+    std::vector<float> y32(npts);
+    auto y32Ptr = y32.data();
+    tapered.transform(npts, pulses.data(), shifts[3], &yPtr);
+    copy.transform(npts, pulse32.data(), shifts[3], &y32Ptr);
+    for (int i=0; i<npts; ++i)
+    {
+        EXPECT_NEAR(y[i], yb[3*npts + i], 1.e-8);
+        EXPECT_NEAR(y32[i], y[i], 1.e-5);
+    }
+}
+
+TEST(UtilitiesTransforms, MatchedFilter)
+{
+    const int nTemplates = 7;
+    const int templateLength = 50;
+    const int nRecords = 3;
+    const int n = 1203;
+    // Random templates and records with an offset
+    srand(4082);
+    std::vector<double> templates(nTemplates*templateLength);
+    for (auto &t : templates){t = static_cast<double> (rand())/RAND_MAX - 0.5;}
+    std::vector<std::vector<double>> x(nRecords, std::vector<double> (n));
+    for (auto &record : x)
+    {
+        for (auto &xi : record)
+        {
+            xi = 10 + static_cast<double> (rand())/RAND_MAX - 0.5;
+        }
+    }
+    // Bury a scaled copy of template 2 in record 1 and a dead segment
+    // in record 2
+    const int lag = 617;
+    for (int i=0; i<templateLength; ++i)
+    {
+        x[1][lag + i] = 3*templates[2*templateLength + i] - 4;
+    }
+    const int deadStart = 300;
+    const int deadEnd = 420;
+    std::fill(x[2].begin() + deadStart, x[2].begin() + deadEnd, 0);
+    MatchedFilter<double> filter;
+    EXPECT_NO_THROW(filter.initialize(nTemplates, templateLength,
+                                      templates.data(), 200));
+    EXPECT_EQ(filter.getNumberOfTemplates(), nTemplates);
+    EXPECT_EQ(filter.getTemplateLength(), templateLength);
+    EXPECT_GE(filter.getTransformLength(), 200);
+    auto nLags = filter.getOutputLength(n);
+    EXPECT_EQ(nLags, n - templateLength + 1);
+    std::vector<std::vector<double>>
+        y(nRecords, std::vector<double> (nTemplates*nLags));
+    std::vector<const double *> xPtrs;
+    std::vector<double *> yPtrs;
+    for (int ir=0; ir<nRecords; ++ir)
+    {
+        xPtrs.push_back(x[ir].data());
+        yPtrs.push_back(y[ir].data());
+    }
+    EXPECT_NO_THROW(filter.correlate(nRecords, n,
+                                     xPtrs.data(), yPtrs.data()));
+    // Compare with a direct computation
+    for (int ir=0; ir<nRecords; ++ir)
+    {
+        for (int it=0; it<nTemplates; ++it)
+        {
+            auto t = &templates[it*templateLength];
+            auto tmean = std::accumulate(t, t + templateLength, 0.0)
+                        /templateLength;
+            double tnorm = 0;
+            for (int i=0; i<templateLength; ++i)
+            {
+                tnorm = tnorm + (t[i] - tmean)*(t[i] - tmean);
+            }
+            tnorm = std::sqrt(tnorm);
+            double emax = 0;
+            for (int k=0; k<nLags; ++k)
+            {
+                auto xk = &x[ir][k];
+                auto xmean = std::accumulate(xk, xk + templateLength, 0.0)
+                            /templateLength;
+                double xy = 0;
+                double xnorm = 0;
+                for (int i=0; i<templateLength; ++i)
+                {
+                    xy = xy + (t[i] - tmean)*(xk[i] - xmean);
+                    xnorm = xnorm + (xk[i] - xmean)*(xk[i] - xmean);
+                }
+                double cc = 0;
+                if (xnorm > 1.e-20){cc = xy/(tnorm*std::sqrt(xnorm));}
+                emax = std::max(emax, std::abs(y[ir][it*nLags + k] - cc));
+            }
+            EXPECT_LE(emax, 1.e-10);
+        }
+    }
+    EXPECT_NEAR(y[1][2*nLags + lag], 1, 1.e-12);
+    for (int k=deadStart; k<=deadEnd - templateLength; ++k)
+    {
+        EXPECT_EQ(y[2][k], 0);
+    }
+    // Single record and single precision
+    MatchedFilter<double> copy(filter);
+    std::vector<double> y1(nTemplates*nLags);
+    auto y1Ptr = y1.data();
+    EXPECT_NO_THROW(copy.correlate(n, x[1].data(), &y1Ptr));
+    for (int i=0; i<nTemplates*nLags; ++i)
+    {
+        EXPECT_NEAR(y1[i], y[1][i], 1.e-14);
+    }
+    std::vector<float> templates32(templates.begin(), templates.end());
+    std::vector<float> x32(x[1].begin(), x[1].end());
+    std::vector<float> y32(nTemplates*nLags);
+    auto y32Ptr = y32.data();
+    MatchedFilter<float> filter32;
+    EXPECT_NO_THROW(filter32.initialize(nTemplates, templateLength,
+                                        templates32.data()));
+    EXPECT_NO_THROW(filter32.correlate(n, x32.data(), &y32Ptr));
+    for (int i=0; i<nTemplates*nLags; ++i)
+    {
+        EXPECT_NEAR(y32[i], y[1][i], 1.e-4);
+    }
+    // Errors
+    std::vector<double> constant(templateLength, 1);
+    EXPECT_THROW(filter.initialize(1, templateLength, constant.data()),
+                 std::invalid_argument);
+    EXPECT_FALSE(filter.isInitialized());
+    EXPECT_THROW(copy.correlate(templateLength - 1, x[1].data(), &y1Ptr),
+                 std::invalid_argument);
+}
+
 //============================================================================//
 //                              Private functions                             //
 //============================================================================//